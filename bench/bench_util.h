@@ -0,0 +1,51 @@
+/**
+ * @file bench_util.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief ベンチマーク用のユーティリティ。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_BENCH_BENCH_UTIL_H_
+#define OCTANE_API_CLIENT_BENCH_BENCH_UTIL_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+namespace octane::bench {
+  /**
+   * @brief 関数をiterations回実行し、一回あたりの所要時間を出力する。
+   *
+   * @tparam F 計測する関数の型
+   * @param[in] name 出力に使う名前
+   * @param[in] iterations 実行回数
+   * @param[in] f 計測する関数
+   * @return double 一回あたりの所要時間(ナノ秒)
+   */
+  template <typename F>
+  double measure(std::string_view name, std::uint64_t iterations, F&& f) {
+    // ウォームアップ
+    for (std::uint64_t i = 0; i < iterations / 10 + 1; ++i) {
+      f();
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double ns
+      = std::chrono::duration<double, std::nano>(end - begin).count()
+        / iterations;
+    std::printf("%-40.*s %12.1f ns/op\n",
+                static_cast<int>(name.size()),
+                name.data(),
+                ns);
+    return ns;
+  }
+} // namespace octane::bench
+
+#endif // OCTANE_API_CLIENT_BENCH_BENCH_UTIL_H_
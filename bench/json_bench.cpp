@@ -0,0 +1,82 @@
+/**
+ * @file json_bench.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief JSONのバックエンドごとにレスポンスのパースにかかる時間を計測する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include <rapidjson/document.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "./bench_util.h"
+#include "include/internal/json.h"
+
+namespace octane::bench {
+  namespace {
+    constexpr auto STATUS_PAYLOAD = R"(
+      {
+        "device": "soon's thinkpad",
+        "timestamp": 1666000000,
+        "type": "file",
+        "name": "report.pdf",
+        "mime": "application/pdf",
+        "hash": "a61ad9c914a0a68c50c5f87537ae152c6d233ebb79ad321ad3e89787d7279aa2"
+      }
+    )";
+
+    /**
+     * @brief GET /room/{id}のレスポンスを模したJSONを作成する。
+     *
+     * @param[in] devices ルームに接続しているデバイスの数
+     * @return std::string JSON文字列
+     */
+    std::string makeRoomPayload(std::size_t devices) {
+      std::string payload = R"({"id": 7040782538, "name": "soon's room", )";
+      payload += R"("devices": [)";
+      for (std::size_t i = 0; i < devices; ++i) {
+        if (i != 0) payload += ", ";
+        payload += R"({"name": "device-)" + std::to_string(i)
+                   + R"(", "timestamp": )" + std::to_string(1666000000 + i)
+                   + "}";
+      }
+      payload += "]}";
+      return payload;
+    }
+
+    void run(std::string_view name,
+             std::string_view payload,
+             std::uint64_t iterations) {
+      std::printf("%.*s (%zu bytes)\n",
+                  static_cast<int>(name.size()),
+                  name.data(),
+                  payload.size());
+      // 比較のため、以前の実装と同様にrapidjson::Documentへパースした場合
+      measure("  rapidjson::Document", iterations, [&] {
+        rapidjson::Document doc;
+        doc.Parse(payload.data(), payload.size());
+        if (doc.HasParseError()) std::abort();
+      });
+      measure(std::string("  parseJson (") + internal::jsonBackendName() + ")",
+              iterations,
+              [&] {
+                if (!internal::parseJson(payload)) std::abort();
+              });
+    }
+  } // namespace
+} // namespace octane::bench
+
+int main() {
+  using namespace octane::bench;
+
+  std::printf("backend: %s\n", octane::internal::jsonBackendName());
+  run("status", STATUS_PAYLOAD, 200000);
+  run("room (4 devices)", makeRoomPayload(4), 200000);
+  run("room (64 devices)", makeRoomPayload(64), 20000);
+  run("room (1024 devices)", makeRoomPayload(1024), 2000);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file multi_file_bench.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 圧縮のコーデックとレベルごとに、アーカイブの圧縮率と速度を計測する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./bench_util.h"
+#include "include/internal/multi_file.h"
+
+namespace octane::bench {
+  namespace {
+    using internal::MultiFileCompressor;
+    using internal::MultiFileDecompressor;
+
+    /**
+     * @brief ソースコードのような繰り返しの多いファイルを作成する。
+     *
+     */
+    std::vector<FileInfo> makeSourceFiles(std::size_t size) {
+      std::vector<std::uint8_t> data;
+      data.reserve(size);
+      for (std::size_t line = 0; data.size() < size; ++line) {
+        const auto text = "  int value" + std::to_string(line % 97)
+                        + " = compute(values[" + std::to_string(line)
+                        + "]);\n";
+        data.insert(data.end(), text.begin(), text.end());
+      }
+      data.resize(size);
+      return { FileInfo{ .filename = "source.cpp", .data = std::move(data) } };
+    }
+    /**
+     * @brief 写真や圧縮済みのファイルのように、圧縮できないファイルを作成する。
+     *
+     */
+    std::vector<FileInfo> makeRandomFiles(std::size_t size) {
+      std::mt19937 engine(42);
+      std::vector<std::uint8_t> data(size);
+      for (auto& byte : data) {
+        byte = static_cast<std::uint8_t>(engine());
+      }
+      return { FileInfo{ .filename = "photo.jpg", .data = std::move(data) } };
+    }
+    /**
+     * @brief 小さなファイルを多数作成する。
+     *
+     */
+    std::vector<FileInfo> makeSmallFiles(std::size_t count) {
+      std::vector<FileInfo> files;
+      files.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto text = "{\"id\": " + std::to_string(i) + "}\n";
+        files.push_back(FileInfo{
+          .filename = "notes/" + std::to_string(i) + ".json",
+          .data     = std::vector<std::uint8_t>(text.begin(), text.end()),
+        });
+      }
+      return files;
+    }
+
+    std::size_t totalSize(const std::vector<FileInfo>& files) {
+      std::size_t size = 0;
+      for (const auto& file : files) {
+        size += file.data.size();
+      }
+      return size;
+    }
+
+    void run(std::string_view name,
+             const std::vector<FileInfo>& files,
+             std::uint64_t iterations) {
+      const auto size = totalSize(files);
+      std::printf("%.*s (%zu files, %zu bytes)\n",
+                  static_cast<int>(name.size()),
+                  name.data(),
+                  files.size(),
+                  size);
+
+      struct Level {
+        std::string_view name;
+        int level;
+      };
+      for (const auto codec : { CompressionCodec::None,
+                                CompressionCodec::Gzip,
+                                CompressionCodec::Xz,
+                                CompressionCodec::Zstd }) {
+        for (const auto [levelName, level] :
+             { Level{ "default", DEFAULT_COMPRESSION_LEVEL },
+               Level{ "fast", 1 },
+               Level{ "max", 9 } }) {
+          // 無圧縮ではレベルに意味がない。
+          if (codec == CompressionCodec::None
+              && level != DEFAULT_COMPRESSION_LEVEL) {
+            continue;
+          }
+
+          const CompressionOptions options{ .codec = codec, .level = level };
+          const auto archive = MultiFileCompressor::compress(files, options);
+          const auto mime    = MultiFileCompressor::mime(codec);
+          if (!archive) {
+            std::printf("  %-18.*s %-8.*s unavailable\n",
+                        static_cast<int>(mime.size()),
+                        mime.data(),
+                        static_cast<int>(levelName.size()),
+                        levelName.data());
+            continue;
+          }
+          std::printf("  %-18.*s %-8.*s %10zu bytes (%5.1f%%)\n",
+                      static_cast<int>(mime.size()),
+                      mime.data(),
+                      static_cast<int>(levelName.size()),
+                      levelName.data(),
+                      archive.get().size(),
+                      100.0 * archive.get().size() / size);
+
+          const auto label = "    " + std::string(levelName);
+          const double compressNs
+            = measure(label + " compress", iterations, [&] {
+                if (!MultiFileCompressor::compress(files, options)) {
+                  std::abort();
+                }
+              });
+          const double decompressNs
+            = measure(label + " decompress", iterations, [&] {
+                if (!MultiFileDecompressor::decompress(archive.get())) {
+                  std::abort();
+                }
+              });
+          // バイト/ナノ秒 = 1000 MB/s
+          std::printf("    %.1f MB/s compress, %.1f MB/s decompress\n",
+                      size / compressNs * 1000,
+                      size / decompressNs * 1000);
+        }
+      }
+    }
+  } // namespace
+} // namespace octane::bench
+
+int main() {
+  using namespace octane::bench;
+
+  run("source", makeSourceFiles(1 << 20), 10);
+  run("random", makeRandomFiles(1 << 20), 10);
+  run("small files", makeSmallFiles(1000), 10);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file schema_validation_bench.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 検証のモードごとにレスポンスの処理にかかる時間を計測する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include <rapidjson/document.h>
+#include <rapidjson/schema.h>
+
+#include <cstdlib>
+
+#include "./bench_util.h"
+#include "include/internal/api_bridge.h"
+#include "include/internal/api_schema.h"
+
+namespace octane::bench {
+  namespace {
+    constexpr auto STATUS_PAYLOAD = R"(
+      {
+        "device": "soon's thinkpad",
+        "timestamp": 1666000000,
+        "type": "file",
+        "name": "report.pdf",
+        "mime": "application/pdf",
+        "hash": "a61ad9c914a0a68c50c5f87537ae152c6d233ebb79ad321ad3e89787d7279aa2"
+      }
+    )";
+
+    /**
+     * @brief 通信を行わず、常に同じステータスを返すFetch。
+     *
+     */
+    class StaticFetch : public internal::FetchBase {
+    public:
+      virtual Result<_, ErrorResponse> init() override {
+        return ok();
+      }
+      virtual FetchResult request(internal::HttpMethod,
+                                  std::string_view) override {
+        return ok(internal::FetchResponse{
+          .body       = internal::parseJson(STATUS_PAYLOAD).get(),
+          .mime       = "application/json",
+          .statusCode = 200,
+          .statusLine = "HTTP/2 200 OK",
+        });
+      }
+      virtual FetchResult request(internal::HttpMethod,
+                                  std::string_view,
+                                  const internal::Json&) override {
+        std::abort();
+      }
+      virtual FetchResult request(internal::HttpMethod,
+                                  std::string_view,
+                                  std::string_view,
+                                  const std::vector<std::uint8_t>&) override {
+        std::abort();
+      }
+    };
+  } // namespace
+} // namespace octane::bench
+
+int main() {
+  using namespace octane;
+  using namespace octane::bench;
+
+  constexpr std::uint64_t iterations = 100000;
+
+  const auto json = internal::parseJson(STATUS_PAYLOAD).get();
+
+  measure("parse only", iterations, [] {
+    if (!internal::parseJson(STATUS_PAYLOAD)) std::abort();
+  });
+  // 以前の実装と同様に、検証のたびにスキーマをコンパイルした場合
+  rapidjson::Document doc;
+  doc.Parse(STATUS_PAYLOAD);
+  measure("validate (compile per call)", iterations, [&] {
+    rapidjson::Document sd;
+    sd.Parse(internal::SCHEMA_ROOM_ID_STATUS_GET);
+    rapidjson::SchemaDocument schemaDoc(sd);
+    rapidjson::SchemaValidator validator(schemaDoc);
+    if (!doc.Accept(validator)) std::abort();
+  });
+  measure("validate (registry)", iterations, [&] {
+    if (internal::SchemaRegistry::instance().validate(
+          json, internal::SchemaId::RoomIdStatusGet)) {
+      std::abort();
+    }
+  });
+
+  StaticFetch fetch;
+  internal::ApiBridge bridge(&fetch);
+  const std::pair<ValidationMode, const char*> modes[] = {
+    { ValidationMode::Full, "roomIdStatusGet (full)" },
+    { ValidationMode::Sampled, "roomIdStatusGet (sampled 1/16)" },
+    { ValidationMode::Off, "roomIdStatusGet (off)" },
+  };
+  for (const auto& [mode, name] : modes) {
+    bridge.setValidationMode(mode, 16);
+    measure(name, iterations, [&] {
+      if (!bridge.roomIdStatusGet(7040782538)) std::abort();
+    });
+  }
+}
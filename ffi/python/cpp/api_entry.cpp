@@ -362,4 +362,40 @@ OCTANE_API bool octane_api_client__upload_content(
   }
   return true;
 }
+
+/**
+ * @brief パスのファイルをメモリにマップしたまま、ルームにアップロードする。
+ * @details
+ * ファイルの内容はPython側にもC++側にもコピーされない。
+ * contentのdataは使用せず、typeはFileかClipboardでなければならない。
+ * 失敗した場合はfalseを返すので{@link
+ * octane_api_client__get_last_error}を呼び出して詳細を取得すること。
+ *
+ * @param api [c_void_p] {@link octane_api_client__init}の戻り値
+ * @param content [POINTER(Content)] アップロードするコンテンツの状態
+ * @param path [c_char_p] アップロードするファイルのパス(UTF-8)
+ * @return bool [c_bool] 成功したかどうか
+ */
+OCTANE_API bool octane_api_client__upload_file(
+  void* api,
+  OctaneApiClientContentStructure* content,
+  char* path) {
+  clearError();
+  auto obj = (OctaneApiClientRootStructure*)api;
+
+  octane::ContentStatus status{
+    .device    = content->device,
+    .timestamp = content->timestamp,
+    .type      = (octane::ContentType)content->type,
+    .name      = content->name,
+    .mime      = content->mime,
+  };
+  auto result = obj->client.uploadFile(
+    status, std::filesystem::path(reinterpret_cast<const char8_t*>(path)));
+  if (!result) {
+    makeError(result.err());
+    return false;
+  }
+  return true;
+}
 }
\ No newline at end of file
@@ -109,6 +109,13 @@ class Api:
         ]
         self.api.octane_api_client__upload_content.restype = ctypes.c_bool
 
+        self.api.octane_api_client__upload_file.argtypes = [
+            ctypes.c_void_p,
+            ctypes.POINTER(Content),
+            ctypes.c_char_p,
+        ]
+        self.api.octane_api_client__upload_file.restype = ctypes.c_bool
+
     def __raise_api_error(self) -> None:
         error = self.api.octane_api_client__get_last_error()
         raise ApiError(error.code, error.reason)
@@ -186,3 +193,22 @@ class Api:
         content.data = ContentData()
         content.data.clipboard = ctypes.c_char_p(text.encode("utf-8"))
         self.upload_content(content)
+
+    # uploads the file at path without reading it into Python.
+    def upload_file(
+        self, path: str, mime: str = "application/octet-stream"
+    ) -> None:
+        content = Content()
+        content.device = ctypes.c_char_p(socket.gethostname().encode("utf-8"))
+        content.timestamp = ctypes.c_uint64(int(time.time()))
+        # 0 = File, 1 = Clipboard(Text), 2 = Multi file
+        content.type = ctypes.c_int32(0)
+        content.name = ctypes.c_char_p(os.path.basename(path).encode("utf-8"))
+        content.mime = ctypes.c_char_p(mime.encode("utf-8"))
+        res = self.api.octane_api_client__upload_file(
+            self.key,
+            ctypes.byref(content),
+            ctypes.c_char_p(os.fsencode(path)),
+        )
+        if res == False:
+            self.__raise_api_error()
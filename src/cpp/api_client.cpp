@@ -13,26 +13,401 @@
 
 #include "include/api_client.h"
 
-#include <chrono>
+#include <span>
 
 #include "include/error_code.h"
+#include "include/internal/content_codec.h"
+#include "include/internal/content_watcher.h"
+#include "include/internal/mapped_file.h"
 #include "include/internal/multi_file.h"
+#include "include/internal/parallel.h"
+#include "include/internal/room_subscriber.h"
+#include "include/internal/temporary_file.h"
 
 namespace octane {
+  namespace {
+    /**
+     * @brief idsの各要素についてfを並行に呼び出し、結果をidsと同じ順序で返す。
+     *
+     * @tparam T 各要素の結果の型
+     * @tparam F Result<T, ErrorResponse>(std::uint64_t)として呼び出せる型
+     * @param[in] ids ルームのid
+     * @param[in] concurrency 最大の並行数
+     * @param[in] f 各要素について呼び出す関数
+     * @return std::vector<Result<T, ErrorResponse>> 各要素の結果
+     */
+    template <typename T, typename F>
+    std::vector<Result<T, ErrorResponse>> runBatch(
+      std::span<const std::uint64_t> ids,
+      std::size_t concurrency,
+      F&& f) {
+      // Resultはデフォルト構築できないので、一度optionalに受けてから詰め直す。
+      std::vector<std::optional<Result<T, ErrorResponse>>> slots(ids.size());
+      internal::parallelFor(ids.size(), concurrency, [&](std::size_t i) {
+        slots[i].emplace(f(ids[i]));
+      });
+      std::vector<Result<T, ErrorResponse>> results;
+      results.reserve(slots.size());
+      for (auto& slot : slots) {
+        results.push_back(std::move(slot.value()));
+      }
+      return results;
+    }
+
+    /**
+     * @brief キャッシュにあるコンテンツをデコードする。
+     * @details
+     * ContentCache::lookupがハッシュ値を検証するので、ここでは検証しない。
+     * キャッシュが無効か、コンテンツがキャッシュになければnulloptを返す。
+     */
+    std::optional<Result<Content, ErrorResponse>> decodeCachedContent(
+      const internal::ContentCache* cache,
+      const ContentStatus& contentStatus,
+      std::string_view hash) {
+      if (cache == nullptr) return std::nullopt;
+      const auto file = cache->lookup(hash);
+      if (!file) return std::nullopt;
+      const auto bytes = file->bytes();
+      return internal::decodeContent(
+        ContentStatus(contentStatus),
+        hash,
+        hash,
+        std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+    }
+    /**
+     * @brief internal::decodeContentと同様にデコードし、ハッシュ値が一致すればキャッシュにも保存する。
+     *
+     */
+    Result<Content, ErrorResponse> decodeAndCache(
+      const internal::ContentCache* cache,
+      ContentStatus&& contentStatus,
+      std::string_view hash,
+      std::string_view digest,
+      std::vector<std::uint8_t>&& data) {
+      if (cache != nullptr && hash == digest) {
+        cache->store(hash, data);
+      }
+      return internal::decodeContent(
+        std::move(contentStatus), hash, digest, std::move(data));
+    }
+    /**
+     * @brief プリフェッチしたコンテンツのコピーを返す。
+     * @details
+     * プリフェッチが無効か、同じコンテンツをプリフェッチしていなければnulloptを返す。
+     */
+    std::optional<Result<Content, ErrorResponse>> findPrefetchedContent(
+      const internal::ContentPrefetcher* prefetcher,
+      std::uint64_t id,
+      const ContentStatus& contentStatus,
+      std::string_view hash) {
+      if (prefetcher == nullptr) return std::nullopt;
+      const auto content = prefetcher->find(internal::ContentObservation{
+        .roomId        = id,
+        .contentStatus = contentStatus,
+        .hash          = std::string(hash),
+      });
+      if (content == nullptr) return std::nullopt;
+      return ok(Content(*content));
+    }
+    /**
+     * @brief 取得したコンテンツを、次に求められたときのためにプリフェッチした結果として覚える。
+     *
+     */
+    void offerPrefetchedContent(internal::ContentPrefetcher* prefetcher,
+                                std::uint64_t id,
+                                const ContentStatus& contentStatus,
+                                std::string_view hash,
+                                const Result<Content, ErrorResponse>& content) {
+      if (prefetcher == nullptr || !content) return;
+      prefetcher->offer(
+        internal::ContentObservation{
+          .roomId        = id,
+          .contentStatus = contentStatus,
+          .hash          = std::string(hash),
+        },
+        content.get());
+    }
+    /**
+     * @brief 状態が分かっているコンテンツを、プリフェッチした結果にもキャッシュにもなければ取得してデコードする。
+     *
+     */
+    Result<Content, ErrorResponse> fetchContent(
+      internal::ApiBridge& bridge,
+      const internal::ContentCache* cache,
+      internal::ContentPrefetcher* prefetcher,
+      std::uint64_t id,
+      const ContentStatus& contentStatus,
+      std::string_view hash) {
+      if (auto prefetched
+          = findPrefetchedContent(prefetcher, id, contentStatus, hash)) {
+        return std::move(prefetched.value());
+      }
+      if (auto cached = decodeCachedContent(cache, contentStatus, hash)) {
+        offerPrefetchedContent(
+          prefetcher, id, contentStatus, hash, cached.value());
+        return std::move(cached.value());
+      }
+      internal::Hasher hasher;
+      std::vector<std::uint8_t> data;
+      auto result = bridge.roomIdContentGet(
+        id, [&hasher, &data](std::span<const std::uint8_t> chunk) {
+          hasher.update(chunk);
+          data.insert(data.end(), chunk.begin(), chunk.end());
+        });
+      if (!result) {
+        return error(result.err());
+      }
+      auto content = decodeAndCache(cache,
+                                    ContentStatus(contentStatus),
+                                    hash,
+                                    hasher.finish(),
+                                    std::move(data));
+      offerPrefetchedContent(prefetcher, id, contentStatus, hash, content);
+      return content;
+    }
+    /**
+     * @brief {@link fetchContent}の非同期版。
+     *
+     */
+    Task<Result<Content, ErrorResponse>> fetchContentAsync(
+      internal::ApiBridge& bridge,
+      internal::AsyncContext context,
+      std::shared_ptr<const internal::ContentCache> cache,
+      std::shared_ptr<internal::ContentPrefetcher> prefetcher,
+      std::uint64_t id,
+      ContentStatus contentStatus,
+      std::string hash) {
+      if (auto prefetched
+          = findPrefetchedContent(prefetcher.get(), id, contentStatus, hash)) {
+        co_return std::move(prefetched.value());
+      }
+      if (auto cached = decodeCachedContent(cache.get(), contentStatus, hash)) {
+        offerPrefetchedContent(
+          prefetcher.get(), id, contentStatus, hash, cached.value());
+        co_return std::move(cached.value());
+      }
+      internal::Hasher hasher;
+      std::vector<std::uint8_t> data;
+      const internal::BodyObserver observer
+        = [&hasher, &data](std::span<const std::uint8_t> chunk) {
+            hasher.update(chunk);
+            data.insert(data.end(), chunk.begin(), chunk.end());
+          };
+      auto result
+        = co_await bridge.roomIdContentGetAsync(std::move(context), id, observer);
+      if (!result) {
+        co_return error(result.err());
+      }
+      auto content = decodeAndCache(cache.get(),
+                                    ContentStatus(contentStatus),
+                                    hash,
+                                    hasher.finish(),
+                                    std::move(data));
+      offerPrefetchedContent(prefetcher.get(), id, contentStatus, hash, content);
+      co_return std::move(content);
+    }
+
+    /**
+     * @brief ダウンロード先のパスから、末尾の区切り文字を取り除く。
+     *
+     */
+    std::filesystem::path downloadTarget(const std::filesystem::path& path) {
+      return path.has_filename() ? path : path.parent_path();
+    }
+    /**
+     * @brief 一時ファイルに受信したコンテンツをハッシュ値で検証し、targetに置く。
+     * @details
+     * 複数ファイルであればtargetのディレクトリに展開し、それ以外はtargetを一時ファイルで置き換える。
+     * ハッシュ値が一致しない場合はtargetを変更しない。
+     *
+     * @param[in] contentStatus コンテンツの状態
+     * @param[in] hash コンテンツの状態に記録されていたハッシュ値
+     * @param[in] digest 受信しながら計算したコンテンツのハッシュ値
+     * @param[in] file 受信したコンテンツを書き込んだ一時ファイル
+     * @param[in] target ダウンロード先のパス
+     */
+    Result<_, ErrorResponse> storeContent(const ContentStatus& contentStatus,
+                                          std::string_view hash,
+                                          std::string_view digest,
+                                          internal::TemporaryFile& file,
+                                          const std::filesystem::path& target) {
+      if (hash != digest) {
+        return makeError(ERR_CONTENT_HASH_MISMATCH,
+                         "Content data doesn't match with its own hash value");
+      }
+      if (contentStatus.type != ContentType::MultiFile) {
+        return file.commit(target);
+      }
+      const auto closed = file.close();
+      if (!closed) {
+        return error(closed.err());
+      }
+      return internal::MultiFileDecompressor::extract(file.path(), target);
+    }
+
+    /**
+     * @brief ルームにある状態を、アップロードしようとしている状態で更新する必要があるかを返す。
+     * @details
+     * タイムスタンプだけが異なる場合は更新しない。
+     * 名前は状態のPUTで送信していないため比較しない。
+     *
+     * @param[in] local アップロードしようとしている状態
+     * @param[in] mime アップロードするMIME
+     * @param[in] remote ルームにある状態
+     */
+    bool needsStatusUpdate(const ContentStatus& local,
+                           std::string_view mime,
+                           const ContentStatus& remote) {
+      return local.device != remote.device || local.type != remote.type
+          || mime != remote.mime;
+    }
+    /**
+     * @brief dataのハッシュ値を計算する。
+     * @details
+     * ステータスのGETと並べて待つことで、受信中にハッシュ値を計算する。
+     * dataはタスクが完了するまで有効でなければならない。
+     *
+     */
+    Task<std::string> generateHashAsync(std::span<const std::uint8_t> data) {
+      co_return internal::generateHash(data);
+    }
+    /**
+     * @brief dataのハッシュ値を計算してから、ステータスをPUTする。
+     * @details
+     * コンテンツのPUTと並べて待つことで、送信中にハッシュ値を計算する。
+     * contentStatusとdataはタスクが完了するまで有効でなければならない。
+     *
+     */
+    Task<Result<_, ErrorResponse>> putStatusAfterHash(
+      internal::ApiBridge& bridge,
+      internal::AsyncContext context,
+      std::uint64_t id,
+      const ContentStatus& contentStatus,
+      std::span<const std::uint8_t> data) {
+      co_return co_await bridge.roomIdStatusPutAsync(
+        context, id, contentStatus, internal::generateHash(data));
+    }
+
+    /**
+     * @brief 共有のHealthMonitorがヘルスチェックに使う通信経路。
+     * @details
+     * HealthMonitorはそれを作成したApiClientより長く生存しうるため、
+     * ApiClientとは独立した通信経路を持つ。
+     *
+     */
+    struct HealthProbe {
+      internal::HttpClient client;
+      internal::Fetch fetch;
+      internal::ApiBridge bridge;
+      Result<_, ErrorResponse> initResult;
+
+      HealthProbe(std::string_view token,
+                  std::string_view origin,
+                  std::string_view baseUrl)
+        : fetch(token, origin, baseUrl, &client),
+          bridge(&fetch),
+          initResult(bridge.init()) {}
+    };
+    /**
+     * @brief 共有のHealthMonitorを識別するキーを返す。
+     * @details
+     * ヘルスチェックは最初に作成したクライアントのトークンで行うので、トークンもキーに含める。
+     * トークンはプロセス全体のレジストリに残るので、そのままではなくハッシュ値を使う。
+     */
+    std::string healthMonitorKey(std::string_view token,
+                                 std::string_view origin,
+                                 std::string_view baseUrl) {
+      return std::string(origin) + std::string(baseUrl) + "#"
+           + internal::generateHash(std::span(
+             reinterpret_cast<const std::uint8_t*>(token.data()),
+             token.size()));
+    }
+  } // namespace
+
   ApiClient::ApiClient(std::string_view token,
                        std::string_view origin,
                        std::string_view baseUrl)
     : bridge(
       new internal::Fetch(token, origin, baseUrl, new internal::HttpClient())),
-      lastCheckedTime(0),
-      connectionStatus(ConnectionStatus{
-        .isConnected = false,
-      }) {}
+      healthMonitor(internal::HealthMonitor::shared(
+        healthMonitorKey(token, origin, baseUrl),
+        [&]() -> internal::HealthMonitor::Probe {
+          auto probe = std::make_shared<HealthProbe>(token, origin, baseUrl);
+          return [probe]() -> Result<HealthResult, ErrorResponse> {
+            if (!probe->initResult) {
+              return error(probe->initResult.err());
+            }
+            return probe->bridge.healthGet();
+          };
+        })),
+      connectionStatus(
+        std::make_shared<const ConnectionStatus>(ConnectionStatus{
+          .isConnected = false,
+        })),
+      executor(&defaultExecutor()) {}
+
+  ApiClient::ApiClient(std::string_view token,
+                       std::string_view origin,
+                       std::string_view baseUrl,
+                       internal::HttpClientBase* client)
+    : bridge(new internal::Fetch(token, origin, baseUrl, client)),
+      // 注入された通信経路は他のクライアントと共有できないので、専用のモニタを持つ。
+      healthMonitor(std::make_shared<internal::HealthMonitor>(
+        [this]() { return bridge.healthGet(); })),
+      connectionStatus(
+        std::make_shared<const ConnectionStatus>(ConnectionStatus{
+          .isConnected = false,
+        })),
+      executor(&defaultExecutor()) {}
+
+  ApiClient::ApiClient(std::string_view token,
+                       std::string_view origin,
+                       std::string_view baseUrl,
+                       EventLoop& loop)
+    : loopTransport(std::make_unique<internal::HttpClient>(loop)),
+      bridge(new internal::Fetch(token, origin, baseUrl, loopTransport.get())),
+      // イベントループのスレッド以外ではスレッドを作成しない。
+      healthMonitor(std::make_shared<internal::HealthMonitor>(
+        [this]() { return bridge.healthGet(); },
+        internal::HealthMonitorOptions{ .backgroundRefresh = false })),
+      connectionStatus(
+        std::make_shared<const ConnectionStatus>(ConnectionStatus{
+          .isConnected = false,
+        })),
+      executor(&inlineExecutor()) {}
 
   ApiClient::~ApiClient() noexcept {
-    if (connectionStatus.isConnected == true) {
-      disconnectRoom(connectionStatus.id, connectionStatus.name);
+    if (loopTransport != nullptr) {
+      // プリフェッチのスレッドはキャンセルできない同期のリクエストを発行するので、
+      // 止める前に期限を設けておく。期限は通信中のリクエストにも適用される。
+      loopTransport->setRequestTimeout(DEFAULT_SHUTDOWN_TIMEOUT);
+    }
+    // プリフェッチのスレッドはメンバに触れるので、どの経路でも最初に止める。
+    if (const auto prefetcher = loadContentPrefetcher()) {
+      prefetcher->stop();
+    }
+    if (shutdownSource.isCancelled()) {
+      if (loopTransport != nullptr) {
+        // ループを駆動する者がいないので、通信中のリクエストをキャンセルとして完了させる。
+        loopTransport.reset();
+      }
+      // 実行中の終了処理はメンバに触れるので、完了するまで破棄できない。
+      shutdownLatch.wait();
+      return;
+    }
+    if (loopTransport != nullptr) {
+      // ループを駆動する者がいないので非同期には切断できない。
+      // せめてヘルスチェックは省き、期限を過ぎたら諦める。
+      const auto status = loadConnectionStatus();
+      if (status->isConnected) {
+        bridge.roomIdPost(status->id, status->name, "disconnect");
+      }
+      return;
     }
+    // executorのスレッドで破棄されても待ち合わないように、I/Oスレッドで再開する。
+    syncWait(shutdownOn(
+      inlineExecutor(),
+      std::chrono::steady_clock::now() + DEFAULT_SHUTDOWN_TIMEOUT));
   }
 
   Result<Response, ErrorResponse> ApiClient::init() {
@@ -51,37 +426,7 @@ namespace octane {
   }
 
   Result<HealthResult, ErrorResponse> ApiClient::checkHealth() {
-    uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
-                     std::chrono::system_clock::now().time_since_epoch())
-                     .count();
-    if (now - lastCheckedTime < 1800) {
-      return ok(lastCheckedHealth);
-    }
-
-    auto healthResult = health();
-    if (!healthResult) {
-      return error(healthResult.err());
-    }
-
-    const auto& [health, message] = healthResult.get();
-    if (health == Health::Faulty) {
-      return makeError(ERR_SERVER_HEALTH_STATUS_FAULTY, message.value_or(""));
-    }
-
-    if (health != Health::Healthy && health != Health::Degraded) {
-      std::abort();
-    }
-    lastCheckedHealth = std::move(healthResult.get());
-    lastCheckedTime   = now;
-    return ok(lastCheckedHealth);
-  }
-
-  Result<HealthResult, ErrorResponse> ApiClient::health() {
-    auto result = bridge.healthGet();
-    if (!result) {
-      return error(result.err());
-    }
-    return ok(result.get());
+    return internal::verifyHealth(healthMonitor->current());
   }
 
   Result<RoomId, ErrorResponse> ApiClient::createRoom(std::string_view name) {
@@ -107,13 +452,23 @@ namespace octane {
       return error(checkHealthResult.err());
     }
     auto result = bridge.roomIdPost(id, name, "connect");
+    invalidateRoomStatus(id);
     if (!result) {
       return error(result.err());
     }
 
-    connectionStatus.id          = id;
-    connectionStatus.isConnected = true;
-    connectionStatus.name        = std::move(name);
+    if (!recordConnection(id, std::string(name))) {
+      if (loopTransport != nullptr) {
+        // イベントループのスレッドでは待ち合わせられないので、同期的に切断する。
+        [[maybe_unused]] const auto disconnected
+          = bridge.roomIdPost(id, name, "disconnect");
+        invalidateRoomStatus(id);
+      } else {
+        [[maybe_unused]] const auto disconnected = syncWait(
+          disconnectAfterShutdown(inlineExecutor(), id, std::string(name)));
+      }
+      return makeError(ERR_CANCELLED, "The operation was cancelled.");
+    }
     return ok(Response{
       .health  = checkHealthResult.get().health,
       .message = std::move(checkHealthResult.get().message),
@@ -127,12 +482,15 @@ namespace octane {
       return error(checkHealthResult.err());
     }
     auto result = bridge.roomIdPost(id, name, "disconnect");
+    invalidateRoomStatus(id);
     if (!result) {
       return error(result.err());
     }
-    connectionStatus.id          = 0;
-    connectionStatus.isConnected = false;
-    connectionStatus.name        = "";
+    storeConnectionStatus(ConnectionStatus{
+      .isConnected = false,
+      .id          = 0,
+      .name        = "",
+    });
     return ok(Response{
       .health  = checkHealthResult.get().health,
       .message = std::move(checkHealthResult.get().message),
@@ -145,13 +503,13 @@ namespace octane {
     if (!checkHealthResult) {
       return error(checkHealthResult.err());
     }
-    if (!id.has_value() && !connectionStatus.isConnected) {
+    const auto status = loadConnectionStatus();
+    if (!id.has_value() && !status->isConnected) {
       return makeError(
         ERR_ROOM_ID_UNDEFINED,
         "Room id is undefined even though this device is disconnected from a room");
     }
-    auto result
-      = bridge.roomIdGet(id.has_value() ? id.value() : connectionStatus.id);
+    auto result = fetchRoomStatus(id.has_value() ? id.value() : status->id);
     if (!result) {
       return error(result.err());
     }
@@ -168,13 +526,15 @@ namespace octane {
     if (!checkHealthResult) {
       return error(checkHealthResult.err());
     }
-    if (!id.has_value() && !connectionStatus.isConnected) {
+    const auto status = loadConnectionStatus();
+    if (!id.has_value() && !status->isConnected) {
       return makeError(
         ERR_ROOM_ID_UNDEFINED,
         "Room id is undefined even though this device is disconnected from a room");
     }
-    auto result
-      = bridge.roomIdDelete(id.has_value() ? id.value() : connectionStatus.id);
+    const auto roomId = id.has_value() ? id.value() : status->id;
+    auto result       = bridge.roomIdDelete(roomId);
+    invalidateRoomStatus(roomId);
     if (!result) {
       return error(result.err());
     }
@@ -184,53 +544,161 @@ namespace octane {
     });
   }
 
+  Result<std::vector<Result<RoomStatus, ErrorResponse>>, ErrorResponse>
+  ApiClient::getRoomStatuses(std::span<const std::uint64_t> ids,
+                             std::size_t concurrency) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    const auto& health = checkHealthResult.get();
+    return ok(runBatch<RoomStatus>(
+      ids,
+      concurrency,
+      [&](std::uint64_t id) -> Result<RoomStatus, ErrorResponse> {
+        auto result = fetchRoomStatus(id);
+        if (!result) {
+          return error(result.err());
+        }
+        auto& response   = result.get();
+        response.health  = health.health;
+        response.message = health.message;
+        return ok(std::move(response));
+      }));
+  }
+
+  Result<std::vector<Result<Response, ErrorResponse>>, ErrorResponse>
+  ApiClient::deleteRooms(std::span<const std::uint64_t> ids,
+                         std::size_t concurrency) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    const auto& health = checkHealthResult.get();
+    return ok(runBatch<Response>(
+      ids,
+      concurrency,
+      [&](std::uint64_t id) -> Result<Response, ErrorResponse> {
+        auto result = bridge.roomIdDelete(id);
+        invalidateRoomStatus(id);
+        if (!result) {
+          return error(result.err());
+        }
+        return ok(Response{
+          .health  = health.health,
+          .message = health.message,
+        });
+      }));
+  }
+
   Result<Content, ErrorResponse> ApiClient::getContent() {
     const auto checkHealthResult = checkHealth();
     if (!checkHealthResult) {
       return error(checkHealthResult.err());
     }
-    if (!connectionStatus.isConnected) {
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
       return makeError(ERR_ROOM_DISCONNECTED,
                        "This device is disconnected from the room");
     }
 
-    Content content;
-
-    auto status = bridge.roomIdStatusGet(connectionStatus.id);
-    if (!status) {
-      return error(status.err());
+    const auto cache      = loadContentCache();
+    const auto prefetcher = loadContentPrefetcher();
+    if (cache != nullptr || prefetcher != nullptr) {
+      // キャッシュやプリフェッチした結果を引くにはハッシュ値が必要なので、先にステータスだけを取得する。
+      auto contentStatus = bridge.roomIdStatusGet(status->id);
+      if (!contentStatus) {
+        return error(contentStatus.err());
+      }
+      auto content = fetchContent(bridge,
+                                  cache.get(),
+                                  prefetcher.get(),
+                                  status->id,
+                                  contentStatus.get().first,
+                                  contentStatus.get().second);
+      if (!content) {
+        return error(content.err());
+      }
+      content.get().health  = checkHealthResult.get().health;
+      content.get().message = std::move(checkHealthResult.get().message);
+      return ok(std::move(content.get()));
     }
-    content.contentStatus = std::move(status.get().first);
 
-    auto result = bridge.roomIdContentGet(connectionStatus.id);
+    // ステータスとコンテンツは互いに依存しないので、並行して取得する。
+    // コンテンツのハッシュ値は受信しながら計算し、両方が揃ったら比べる。
+    const auto id      = status->id;
+    auto statusRequest = startRoomStatusGet(id);
+    internal::Hasher hasher;
+    std::vector<std::uint8_t> data;
+    auto result        = bridge.roomIdContentGet(
+      id, [&hasher, &data](std::span<const std::uint8_t> chunk) {
+        hasher.update(chunk);
+        data.insert(data.end(), chunk.begin(), chunk.end());
+      });
+    auto contentStatus = statusRequest.get();
+    if (!contentStatus) {
+      return error(contentStatus.err());
+    }
     if (!result) {
       return error(result.err());
     }
-    auto hash = internal::generateHash(result.get());
-    if (status.get().second != hash) {
-      return makeError(ERR_CONTENT_HASH_MISMATCH,
-                       "Content data doesn't match with its own hash value");
+    auto content
+      = internal::decodeContent(std::move(contentStatus.get().first),
+                                contentStatus.get().second,
+                                hasher.finish(),
+                                std::move(data));
+    if (!content) {
+      return error(content.err());
     }
 
-    if (content.contentStatus.type == ContentType::File) {
-      content.data = std::move(result.get());
-    } else if (content.contentStatus.type == ContentType::Clipboard) {
-      std::string str;
-      str.resize(result.get().size());
-      std::copy(result.get().begin(), result.get().end(), str.begin());
-      content.data = std::move(str);
-    } else {
-      auto data = internal::MultiFileDecompressor::decompress(result.get());
-      if (!data) {
-        return error(data.err());
-      }
-      content.data = std::move(data.get());
-    }
+    content.get().health  = checkHealthResult.get().health;
+    content.get().message = std::move(checkHealthResult.get().message);
 
-    content.health  = checkHealthResult.get().health;
-    content.message = std::move(checkHealthResult.get().message);
+    return ok(std::move(content.get()));
+  }
+
+  Result<ContentStatus, ErrorResponse> ApiClient::downloadContent(
+    const std::filesystem::path& path) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
+      return makeError(ERR_ROOM_DISCONNECTED,
+                       "This device is disconnected from the room");
+    }
 
-    return ok(std::move(content));
+    // 名前の変更だけで置き換えられるように、一時ファイルはダウンロード先と同じ場所に作る。
+    const auto target = downloadTarget(path);
+    auto file         = internal::TemporaryFile::create(target.parent_path());
+    if (!file) {
+      return error(file.err());
+    }
+    const auto id      = status->id;
+    auto statusRequest = startRoomStatusGet(id);
+    internal::Hasher hasher;
+    auto result        = bridge.roomIdContentGet(
+      id, [&hasher, &file](std::span<const std::uint8_t> chunk) {
+        hasher.update(chunk);
+        file.get().write(chunk);
+      });
+    auto contentStatus = statusRequest.get();
+    if (!contentStatus) {
+      return error(contentStatus.err());
+    }
+    if (!result) {
+      return error(result.err());
+    }
+    const auto stored = storeContent(contentStatus.get().first,
+                                     contentStatus.get().second,
+                                     hasher.finish(),
+                                     file.get(),
+                                     target);
+    if (!stored) {
+      return error(stored.err());
+    }
+    return ok(std::move(contentStatus.get().first));
   }
 
   Result<Response, ErrorResponse> ApiClient::deleteContent() {
@@ -238,11 +706,12 @@ namespace octane {
     if (!checkHealthResult) {
       return error(checkHealthResult.err());
     }
-    if (!connectionStatus.isConnected) {
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
       return makeError(ERR_ROOM_DISCONNECTED,
                        "This device is disconnected from the room");
     }
-    auto result = bridge.roomIdContentDelete(connectionStatus.id);
+    auto result = bridge.roomIdContentDelete(status->id);
     if (!result) {
       return error(result.err());
     }
@@ -254,73 +723,871 @@ namespace octane {
   }
 
   Result<Response, ErrorResponse> ApiClient::uploadContent(
-    const Content& content) {
+    const Content& content,
+    UploadOptions options) {
+    const auto body = internal::prepareUpload(content, options.compression);
+    if (!body) {
+      return error(body.err());
+    }
+    return uploadBytes(
+      body.get().contentStatus, body.get().bytes(), body.get().mime, options);
+  }
+  Result<Response, ErrorResponse> ApiClient::uploadContent(
+    const ContentStatus& contentStatus,
+    std::span<const std::byte> data,
+    UploadOptions options) {
+    const auto body = internal::prepareUpload(
+      contentStatus,
+      std::span(reinterpret_cast<const std::uint8_t*>(data.data()),
+                data.size()));
+    if (!body) {
+      return error(body.err());
+    }
+    return uploadBytes(
+      contentStatus, body.get().bytes(), body.get().mime, options);
+  }
+  Result<Response, ErrorResponse> ApiClient::uploadContent(
+    const ContentStatus& contentStatus,
+    std::string_view data,
+    UploadOptions options) {
+    return uploadContent(contentStatus, std::as_bytes(std::span(data)), options);
+  }
+  Result<Response, ErrorResponse> ApiClient::uploadFile(
+    const ContentStatus& contentStatus,
+    const std::filesystem::path& path,
+    UploadOptions options) {
+    const auto file = internal::MappedFile::open(path);
+    if (!file) {
+      return error(file.err());
+    }
+    return uploadContent(
+      contentStatus, std::as_bytes(file.get().bytes()), options);
+  }
+
+  Result<Response, ErrorResponse> ApiClient::uploadBytes(
+    const ContentStatus& contentStatus,
+    std::span<const std::uint8_t> data,
+    std::string_view mime,
+    UploadOptions options) {
     const auto checkHealthResult = checkHealth();
     if (!checkHealthResult) {
       return error(checkHealthResult.err());
     }
-    if (!connectionStatus.isConnected) {
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
       return makeError(ERR_ROOM_DISCONNECTED,
                        "This device is disconnected from the room");
     }
+    const auto id = status->id;
+
+    std::optional<std::string> hash;
+
+    if (options.skipUnchanged) {
+      // ルームの状態は小さいので、ハッシュ値の計算と並行して取得しておく。
+      auto remoteRequest = startRoomStatusGet(id);
+      // 状態を取得できなかった場合(まだコンテンツがない場合を含む)は、ふつうにアップロードする。
+      hash.emplace(internal::generateHash(data));
+      const auto remote = remoteRequest.get();
+      if (remote && remote.get().second == hash.value()) {
+        if (needsStatusUpdate(contentStatus, mime, remote.get().first)) {
+          const auto resultS
+            = bridge.roomIdStatusPut(id, contentStatus, hash.value());
+          if (!resultS) {
+            return error(resultS.err());
+          }
+        }
+        return ok(Response{
+          .health  = checkHealthResult.get().health,
+          .message = std::move(checkHealthResult.get().message),
+        });
+      }
+    }
+
+    // コンテンツのPUTはハッシュ値に依存しないので、送信と並行してハッシュ値を計算し、
+    // 計算し終えたらステータスをPUTする。
+    auto contentRequest = startContentPut(id, data, mime);
+    const auto resultS  = bridge.roomIdStatusPut(
+      id,
+      contentStatus,
+      hash.has_value() ? hash.value() : internal::generateHash(data));
+    const auto result   = contentRequest.get();
+    if (!resultS) {
+      return error(resultS.err());
+    }
+    if (!result) {
+      return error(result.err());
+    }
+
+    return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
 
-    const auto send = [&](const std::vector<std::uint8_t>& data)
-      -> Result<Response, ErrorResponse> {
-      std::string hash = internal::generateHash(data);
-      auto resultS     = bridge.roomIdStatusPut(
-        connectionStatus.id, content.contentStatus, hash);
-      if (!resultS) {
-        return error(resultS.err());
+  ContentWatch ApiClient::watchContent(
+    std::function<void(Result<Content, ErrorResponse>)> callback,
+    WatchOptions options) {
+    // 状態だけを取得し、コンテンツの取得は変化したときまで行わない。
+    auto poll = [this]() -> Result<internal::ContentObservation, ErrorResponse> {
+      const auto checkHealthResult = checkHealth();
+      if (!checkHealthResult) {
+        return error(checkHealthResult.err());
       }
-      // TODO: mime関係の処理が歪すぎるのでどうにかしましょう
-      std::string mime = content.contentStatus.mime;
-      if (content.contentStatus.type == ContentType::Clipboard) {
-        mime = "text/plain";
-      } else if (content.contentStatus.type == ContentType::MultiFile) {
-        mime = "application/x-7z-compressed";
+      const auto status = loadConnectionStatus();
+      if (!status->isConnected) {
+        return makeError(ERR_ROOM_DISCONNECTED,
+                         "This device is disconnected from the room");
       }
-      auto result = bridge.roomIdContentPut(connectionStatus.id, data, mime);
+      auto result = bridge.roomIdStatusGet(status->id);
       if (!result) {
         return error(result.err());
       }
-
-      return ok(Response{
-        .health  = checkHealthResult.get().health,
-        .message = std::move(checkHealthResult.get().message),
+      return ok(internal::ContentObservation{
+        .roomId        = status->id,
+        .contentStatus = std::move(result.get().first),
+        .hash          = std::move(result.get().second),
       });
     };
+    auto download = [this](const internal::ContentObservation& observation)
+      -> Result<Content, ErrorResponse> {
+      const auto checkHealthResult = checkHealth();
+      if (!checkHealthResult) {
+        return error(checkHealthResult.err());
+      }
+      auto content = fetchContent(bridge,
+                                  loadContentCache().get(),
+                                  loadContentPrefetcher().get(),
+                                  observation.roomId,
+                                  observation.contentStatus,
+                                  observation.hash);
+      if (!content) {
+        return error(content.err());
+      }
+      content.get().health  = checkHealthResult.get().health;
+      content.get().message = std::move(checkHealthResult.get().message);
+      return ok(std::move(content.get()));
+    };
+    return ContentWatch(
+      std::make_unique<internal::ContentWatcher>(std::move(poll),
+                                                 std::move(download),
+                                                 std::move(callback),
+                                                 options));
+  }
+  RoomSubscription ApiClient::subscribeRoom(
+    std::function<void(Result<RoomEvent, ErrorResponse>)> callback,
+    SubscribeOptions options) {
+    auto stream = [this](CancellationToken token,
+                         const internal::RoomSubscriber::EventSink& sink)
+      -> Result<_, ErrorResponse> {
+      const auto status = loadConnectionStatus();
+      if (!status->isConnected) {
+        return makeError(ERR_ROOM_DISCONNECTED,
+                         "This device is disconnected from the room");
+      }
+      return bridge.roomIdEventsGet(status->id, std::move(token), sink);
+    };
+    auto poll = [this]() -> Result<internal::RoomSnapshot, ErrorResponse> {
+      const auto checkHealthResult = checkHealth();
+      if (!checkHealthResult) {
+        return error(checkHealthResult.err());
+      }
+      const auto status = loadConnectionStatus();
+      if (!status->isConnected) {
+        return makeError(ERR_ROOM_DISCONNECTED,
+                         "This device is disconnected from the room");
+      }
+      auto room = bridge.roomIdGet(status->id);
+      if (!room) {
+        return error(room.err());
+      }
+      internal::RoomSnapshot snapshot{
+        .roomId  = status->id,
+        .content = std::nullopt,
+        .devices = std::move(room.get().devices),
+      };
+      // ルームを取得できた後の状態の取得の失敗は、まだコンテンツがないものとして扱う。
+      auto content = bridge.roomIdStatusGet(status->id);
+      if (content) {
+        snapshot.content.emplace(std::move(content.get()));
+      }
+      return ok(std::move(snapshot));
+    };
+    // 新しいコンテンツが届いたら、利用者に通知する前にプリフェッチを始める。
+    auto notify = [this, callback = std::move(callback)](
+                    Result<RoomEvent, ErrorResponse> event) {
+      const auto prefetcher = loadContentPrefetcher();
+      if (prefetcher != nullptr && event
+          && event.get().type == RoomEventType::ContentChanged
+          && event.get().contentStatus.has_value()) {
+        prefetcher->notify(internal::ContentObservation{
+          .roomId        = event.get().roomId,
+          .contentStatus = event.get().contentStatus.value(),
+          .hash          = event.get().hash,
+        });
+      }
+      callback(std::move(event));
+    };
+    return RoomSubscription(
+      std::make_unique<internal::RoomSubscriber>(std::move(stream),
+                                                 std::move(poll),
+                                                 std::move(notify),
+                                                 options));
+  }
+
+  Task<Result<RoomId, ErrorResponse>> ApiClient::createRoomAsync(
+    std::string name,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    auto result = co_await bridge.roomPostAsync(context, std::move(name));
+    if (!result) {
+      co_return error(result.err());
+    }
+    auto& response   = result.get();
+    response.health  = checkHealthResult.get().health;
+    response.message = std::move(checkHealthResult.get().message);
+    co_return ok(std::move(response));
+  }
+
+  Task<Result<Response, ErrorResponse>> ApiClient::connectRoomAsync(
+    std::uint64_t id,
+    std::string name,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    auto result = co_await bridge.roomIdPostAsync(context, id, name, "connect");
+    invalidateRoomStatus(id);
+    if (!result) {
+      co_return error(result.err());
+    }
+
+    if (!recordConnection(id, name)) {
+      auto disconnect
+        = disconnectAfterShutdown(*context.executor, id, std::move(name));
+      [[maybe_unused]] const auto disconnected
+        = co_await std::move(disconnect);
+      co_return makeError(ERR_CANCELLED, "The operation was cancelled.");
+    }
+    co_return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+  Task<Result<Response, ErrorResponse>> ApiClient::disconnectRoomAsync(
+    std::uint64_t id,
+    std::string name,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    auto result
+      = co_await bridge.roomIdPostAsync(context, id, std::move(name), "disconnect");
+    invalidateRoomStatus(id);
+    if (!result) {
+      co_return error(result.err());
+    }
+    storeConnectionStatus(ConnectionStatus{
+      .isConnected = false,
+      .id          = 0,
+      .name        = "",
+    });
+    co_return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Task<Result<RoomStatus, ErrorResponse>> ApiClient::getRoomStatusAsync(
+    std::optional<std::uint64_t> id,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!id.has_value() && !status->isConnected) {
+      co_return makeError(
+        ERR_ROOM_ID_UNDEFINED,
+        "Room id is undefined even though this device is disconnected from a room");
+    }
+    auto result = co_await fetchRoomStatusAsync(
+      context, id.has_value() ? id.value() : status->id);
+    if (!result) {
+      co_return error(result.err());
+    }
+
+    auto& response   = result.get();
+    response.health  = checkHealthResult.get().health;
+    response.message = std::move(checkHealthResult.get().message);
+    co_return ok(std::move(response));
+  }
+
+  Task<Result<Response, ErrorResponse>> ApiClient::deleteRoomAsync(
+    std::optional<std::uint64_t> id,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!id.has_value() && !status->isConnected) {
+      co_return makeError(
+        ERR_ROOM_ID_UNDEFINED,
+        "Room id is undefined even though this device is disconnected from a room");
+    }
+    const auto roomId = id.has_value() ? id.value() : status->id;
+    auto result       = co_await bridge.roomIdDeleteAsync(context, roomId);
+    invalidateRoomStatus(roomId);
+    if (!result) {
+      co_return error(result.err());
+    }
+    co_return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Task<Result<Content, ErrorResponse>> ApiClient::getContentAsync(
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
+      co_return makeError(ERR_ROOM_DISCONNECTED,
+                          "This device is disconnected from the room");
+    }
+
+    auto cache      = loadContentCache();
+    auto prefetcher = loadContentPrefetcher();
+    if (cache != nullptr || prefetcher != nullptr) {
+      auto contentStatus
+        = co_await bridge.roomIdStatusGetAsync(context, status->id);
+      if (!contentStatus) {
+        co_return error(contentStatus.err());
+      }
+      auto content = co_await fetchContentAsync(
+        bridge,
+        context,
+        std::move(cache),
+        std::move(prefetcher),
+        status->id,
+        std::move(contentStatus.get().first),
+        std::move(contentStatus.get().second));
+      if (!content) {
+        co_return error(content.err());
+      }
+      content.get().health  = checkHealthResult.get().health;
+      content.get().message = checkHealthResult.get().message;
+      co_return ok(std::move(content.get()));
+    }
+
+    // コンテンツのハッシュ値はI/Oスレッドで受信しながら計算する。
+    internal::Hasher hasher;
+    std::vector<std::uint8_t> data;
+    const internal::BodyObserver observer
+      = [&hasher, &data](std::span<const std::uint8_t> chunk) {
+          hasher.update(chunk);
+          data.insert(data.end(), chunk.begin(), chunk.end());
+        };
+    auto [contentStatus, result] = co_await whenAll(
+      bridge.roomIdStatusGetAsync(context, status->id),
+      bridge.roomIdContentGetAsync(context, status->id, observer));
+    if (!contentStatus) {
+      co_return error(contentStatus.err());
+    }
+    if (!result) {
+      co_return error(result.err());
+    }
+    auto content
+      = internal::decodeContent(std::move(contentStatus.get().first),
+                                contentStatus.get().second,
+                                hasher.finish(),
+                                std::move(data));
+    if (!content) {
+      co_return error(content.err());
+    }
+
+    content.get().health  = checkHealthResult.get().health;
+    content.get().message = std::move(checkHealthResult.get().message);
+
+    co_return ok(std::move(content.get()));
+  }
+
+  Task<Result<ContentStatus, ErrorResponse>> ApiClient::downloadContentAsync(
+    std::filesystem::path path,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
+      co_return makeError(ERR_ROOM_DISCONNECTED,
+                          "This device is disconnected from the room");
+    }
+
+    const auto target = downloadTarget(path);
+    auto file         = internal::TemporaryFile::create(target.parent_path());
+    if (!file) {
+      co_return error(file.err());
+    }
+    // コンテンツはI/Oスレッドで受信しながらハッシュ値を計算し、一時ファイルに書き込む。
+    internal::Hasher hasher;
+    const internal::BodyObserver observer
+      = [&hasher, &file](std::span<const std::uint8_t> chunk) {
+          hasher.update(chunk);
+          file.get().write(chunk);
+        };
+    auto [contentStatus, result] = co_await whenAll(
+      bridge.roomIdStatusGetAsync(context, status->id),
+      bridge.roomIdContentGetAsync(context, status->id, observer));
+    if (!contentStatus) {
+      co_return error(contentStatus.err());
+    }
+    if (!result) {
+      co_return error(result.err());
+    }
+    const auto stored = storeContent(contentStatus.get().first,
+                                     contentStatus.get().second,
+                                     hasher.finish(),
+                                     file.get(),
+                                     target);
+    if (!stored) {
+      co_return error(stored.err());
+    }
+    co_return ok(std::move(contentStatus.get().first));
+  }
+
+  Task<Result<Response, ErrorResponse>> ApiClient::deleteContentAsync(
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
+      co_return makeError(ERR_ROOM_DISCONNECTED,
+                          "This device is disconnected from the room");
+    }
+    auto result = co_await bridge.roomIdContentDeleteAsync(context, status->id);
+    if (!result) {
+      co_return error(result.err());
+    }
+
+    co_return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Task<Result<Response, ErrorResponse>> ApiClient::uploadContentAsync(
+    Content content,
+    CancellationToken token,
+    UploadOptions options) {
+    const auto body = internal::prepareUpload(content, options.compression);
+    if (!body) {
+      co_return error(body.err());
+    }
+    co_return co_await uploadBytesAsync(makeContext(std::move(token)),
+                                        body.get().contentStatus,
+                                        body.get().bytes(),
+                                        body.get().mime,
+                                        options);
+  }
+  Task<Result<Response, ErrorResponse>> ApiClient::uploadContentAsync(
+    ContentStatus contentStatus,
+    std::span<const std::byte> data,
+    CancellationToken token,
+    UploadOptions options) {
+    const auto body = internal::prepareUpload(
+      contentStatus,
+      std::span(reinterpret_cast<const std::uint8_t*>(data.data()),
+                data.size()));
+    if (!body) {
+      co_return error(body.err());
+    }
+    co_return co_await uploadBytesAsync(makeContext(std::move(token)),
+                                        contentStatus,
+                                        body.get().bytes(),
+                                        body.get().mime,
+                                        options);
+  }
+  Task<Result<Response, ErrorResponse>> ApiClient::uploadContentAsync(
+    ContentStatus contentStatus,
+    std::string_view data,
+    CancellationToken token,
+    UploadOptions options) {
+    co_return co_await uploadContentAsync(std::move(contentStatus),
+                                          std::as_bytes(std::span(data)),
+                                          std::move(token),
+                                          options);
+  }
+  Task<Result<Response, ErrorResponse>> ApiClient::uploadFileAsync(
+    ContentStatus contentStatus,
+    std::filesystem::path path,
+    CancellationToken token,
+    UploadOptions options) {
+    // マッピングはこのコルーチンのフレームに置き、送信が終わるまで保持する。
+    const auto file = internal::MappedFile::open(path);
+    if (!file) {
+      co_return error(file.err());
+    }
+    co_return co_await uploadContentAsync(std::move(contentStatus),
+                                          std::as_bytes(file.get().bytes()),
+                                          std::move(token),
+                                          options);
+  }
+
+  Task<Result<Response, ErrorResponse>> ApiClient::uploadBytesAsync(
+    internal::AsyncContext context,
+    const ContentStatus& contentStatus,
+    std::span<const std::uint8_t> data,
+    std::string mime,
+    UploadOptions options) {
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
+      co_return makeError(ERR_ROOM_DISCONNECTED,
+                          "This device is disconnected from the room");
+    }
+
+    std::optional<std::string> hash;
+    if (options.skipUnchanged) {
+      // ステータスのGETを先に始め、I/Oスレッドが受信している間にハッシュ値を計算する。
+      // 状態を取得できなかった場合(まだコンテンツがない場合を含む)は、ふつうにアップロードする。
+      auto [remote, localHash] = co_await whenAll(
+        bridge.roomIdStatusGetAsync(context, status->id),
+        generateHashAsync(data));
+      if (!remote && remote.err().code == ERR_CANCELLED) {
+        co_return error(remote.err());
+      }
+      if (remote && remote.get().second == localHash) {
+        if (needsStatusUpdate(contentStatus, mime, remote.get().first)) {
+          const auto resultS = co_await bridge.roomIdStatusPutAsync(
+            context, status->id, contentStatus, std::move(localHash));
+          if (!resultS) {
+            co_return error(resultS.err());
+          }
+        }
+        co_return ok(Response{
+          .health  = checkHealthResult.get().health,
+          .message = std::move(checkHealthResult.get().message),
+        });
+      }
+      hash.emplace(std::move(localHash));
+    }
+
+    // コンテンツのPUTを先に始め、I/Oスレッドが送信している間にハッシュ値を計算する。
+    // 計算済みであれば、そのままステータスもPUTする。
+    auto putStatus
+      = hash.has_value()
+        ? bridge.roomIdStatusPutAsync(
+          context, status->id, contentStatus, std::move(hash.value()))
+        : putStatusAfterHash(bridge, context, status->id, contentStatus, data);
+    auto [result, resultS] = co_await whenAll(
+      bridge.roomIdContentPutAsync(context, status->id, data, mime),
+      std::move(putStatus));
+    if (!resultS) {
+      co_return error(resultS.err());
+    }
+    if (!result) {
+      co_return error(result.err());
+    }
+
+    co_return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Task<Result<HealthResult, ErrorResponse>> ApiClient::checkHealthAsync(
+    internal::AsyncContext context) {
+    if (context.token.isCancelled()) {
+      co_return makeError(ERR_CANCELLED, "The operation was cancelled.");
+    }
+    const auto snapshot = healthMonitor->peek();
+    if (snapshot != nullptr
+        && internal::HealthMonitor::Clock::now() < snapshot->expiresAt) {
+      co_return internal::verifyHealth(ok(snapshot->health));
+    }
+    if (loopTransport != nullptr) {
+      // イベントループをブロックしないよう、ヘルスチェックも非同期に行う。
+      auto result = co_await bridge.healthGetAsync(context);
+      healthMonitor->update(result);
+      co_return internal::verifyHealth(std::move(result));
+    }
+    // キャッシュが無効な場合のヘルスチェックはブロックするので、executorのスレッドに移ってから行う。
+    co_await internal::ScheduleOn{ *context.executor };
+    co_return internal::verifyHealth(healthMonitor->current());
+  }
+  Task<Result<_, ErrorResponse>> ApiClient::shutdownAsync(
+    std::chrono::steady_clock::time_point deadline) {
+    return shutdownOn(*executor.load(std::memory_order_acquire), deadline);
+  }
+  Task<Result<_, ErrorResponse>> ApiClient::shutdownOn(
+    Executor& executor,
+    std::chrono::steady_clock::time_point deadline) {
+    // 途中で破棄された場合も含めて、抜けるときに完了を記録する。
+    const internal::ShutdownLatch::Guard finished(shutdownLatch);
+    shutdownDeadline.store(deadline, std::memory_order_relaxed);
+    // 実行中の非同期の処理と、以降に始まる非同期の処理を中断する。
+    shutdownSource.cancel();
+    if (const auto prefetcher = loadContentPrefetcher()) {
+      prefetcher->stop();
+    }
+    const auto status = loadConnectionStatus();
+    if (!status->isConnected) {
+      co_return ok();
+    }
+    storeConnectionStatus(ConnectionStatus{
+      .isConnected = false,
+      .id          = 0,
+      .name        = "",
+    });
+    // ヘルスチェックは行わず、期限を過ぎたら切断のリクエストも中断する。
+    const internal::AsyncContext context{
+      .executor = &executor,
+      .token    = CancellationToken().withDeadline(deadline),
+    };
+    auto result = co_await bridge.roomIdPostAsync(
+      context, status->id, status->name, "disconnect");
+    invalidateRoomStatus(status->id);
+    if (!result) {
+      co_return error(result.err());
+    }
+    co_return ok();
+  }
+
+  internal::AsyncContext ApiClient::makeContext(CancellationToken token) const {
+    return internal::AsyncContext{
+      .executor = executor.load(std::memory_order_acquire),
+      .token    = token.linkedWith(shutdownSource.token()),
+    };
+  }
+
+  internal::Pending<
+    Result<std::pair<ContentStatus, std::string>, ErrorResponse>>
+  ApiClient::startRoomStatusGet(std::uint64_t id) {
+    if (loopTransport != nullptr) {
+      return internal::Pending<
+        Result<std::pair<ContentStatus, std::string>, ErrorResponse>>::
+        ready(bridge.roomIdStatusGet(id));
+    }
+    return internal::Pending(
+      bridge.roomIdStatusGetAsync(internal::overlappedContext(), id));
+  }
+  internal::Pending<Result<_, ErrorResponse>> ApiClient::startContentPut(
+    std::uint64_t id,
+    std::span<const std::uint8_t> data,
+    std::string_view mime) {
+    if (loopTransport != nullptr) {
+      return internal::Pending<Result<_, ErrorResponse>>::ready(
+        bridge.roomIdContentPut(id, data, mime));
+    }
+    return internal::Pending(bridge.roomIdContentPutAsync(
+      internal::overlappedContext(), id, data, std::string(mime)));
+  }
+
+  std::shared_ptr<const ApiClient::ConnectionStatus>
+  ApiClient::loadConnectionStatus() const {
+    std::lock_guard lock(connectionMutex);
+    return connectionStatus;
+  }
+  void ApiClient::storeConnectionStatus(ConnectionStatus status) {
+    auto next = std::make_shared<const ConnectionStatus>(std::move(status));
+    std::lock_guard lock(connectionMutex);
+    connectionStatus.swap(next);
+  }
+  bool ApiClient::recordConnection(std::uint64_t id, std::string name) {
+    auto next = std::make_shared<const ConnectionStatus>(ConnectionStatus{
+      .isConnected = true,
+      .id          = id,
+      .name        = std::move(name),
+    });
+    std::lock_guard lock(connectionMutex);
+    if (shutdownSource.isCancelled()) return false;
+    connectionStatus.swap(next);
+    return true;
+  }
+  Task<Result<_, ErrorResponse>> ApiClient::disconnectAfterShutdown(
+    Executor& executor,
+    std::uint64_t id,
+    std::string name) {
+    const internal::AsyncContext context{
+      .executor = &executor,
+      .token    = CancellationToken().withDeadline(
+        shutdownDeadline.load(std::memory_order_relaxed)),
+    };
+    auto result
+      = co_await bridge.roomIdPostAsync(context, id, name, "disconnect");
+    invalidateRoomStatus(id);
+    co_return result;
+  }
+
+  std::shared_ptr<const internal::ContentCache> ApiClient::loadContentCache()
+    const {
+    std::lock_guard lock(cacheMutex);
+    return contentCache;
+  }
+  std::shared_ptr<internal::RoomStatusCache> ApiClient::loadRoomStatusCache()
+    const {
+    std::lock_guard lock(cacheMutex);
+    return roomStatusCache;
+  }
+  std::shared_ptr<internal::ContentPrefetcher>
+  ApiClient::loadContentPrefetcher() const {
+    std::lock_guard lock(cacheMutex);
+    return contentPrefetcher;
+  }
+  Result<RoomStatus, ErrorResponse> ApiClient::fetchRoomStatus(
+    std::uint64_t id) {
+    const auto cache = loadRoomStatusCache();
+    if (cache == nullptr) {
+      return bridge.roomIdGet(id);
+    }
+    return cache->get(id, [&] { return bridge.roomIdGet(id); });
+  }
+  Task<Result<RoomStatus, ErrorResponse>> ApiClient::fetchRoomStatusAsync(
+    internal::AsyncContext context,
+    std::uint64_t id) {
+    const auto cache = loadRoomStatusCache();
+    if (cache == nullptr) {
+      co_return co_await bridge.roomIdGetAsync(context, id);
+    }
+    // GCCはco_awaitの式の中のラムダを含む一時オブジェクトを早く破棄するので、一度変数に受ける。
+    auto task = cache->getAsync(
+      id, *context.executor, context.token, [this, context, id] {
+        return bridge.roomIdGetAsync(context, id);
+      });
+    co_return co_await std::move(task);
+  }
+  void ApiClient::invalidateRoomStatus(std::uint64_t id) {
+    if (const auto cache = loadRoomStatusCache()) {
+      cache->invalidate(id);
+    }
+  }
+
+  void ApiClient::setExecutor(Executor& executor) {
+    this->executor.store(&executor, std::memory_order_release);
+  }
+
+  void ApiClient::onSocketEvent(NativeSocket socket, SocketEvents events) {
+    if (loopTransport != nullptr) {
+      loopTransport->onSocketEvent(socket, events);
+    }
+  }
+  void ApiClient::onTimeout() {
+    if (loopTransport != nullptr) {
+      loopTransport->onTimeout();
+    }
+  }
+
+  void ApiClient::setValidationMode(ValidationMode mode,
+                                    std::uint32_t sampleInterval) {
+    bridge.setValidationMode(mode, sampleInterval);
+  }
 
-    if (content.contentStatus.type == ContentType::Clipboard
-        || content.contentStatus.type == ContentType::File) {
-      if (std::holds_alternative<std::string>(content.data)) {
-        auto& str = std::get<std::string>(content.data);
-        std::vector<std::uint8_t> data;
-        data.resize(str.size());
-        std::copy(str.begin(), str.end(), data.begin());
-        return send(data);
-      } else if (std::holds_alternative<std::vector<std::uint8_t>>(
-                   content.data)) {
-        return send(std::get<std::vector<std::uint8_t>>(content.data));
-      } else if (std::holds_alternative<std::vector<FileInfo>>(content.data)) {
-        return makeError(
-          ERR_CONTENT_TYPE_DATA_MISMATCH,
-          "The specified type of content.contentStatus.type doesn't match content.data");
-      }
-    } else if (content.contentStatus.type == ContentType::MultiFile) {
-      if (!std::holds_alternative<std::vector<FileInfo>>(content.data)) {
-        return makeError(
-          ERR_CONTENT_TYPE_DATA_MISMATCH,
-          "The specified type of content.contentStatus.type doesn't match content.data");
-      }
-      auto data = internal::MultiFileCompressor::compress(
-        std::get<std::vector<FileInfo>>(content.data));
-      if (!data) {
-        return error(data.err());
-      }
-      return send(data.get());
-    }
-
-    // 到達不能コードのはず
-    std::abort();
+  Result<_, ErrorResponse> ApiClient::enableContentCache(
+    ContentCacheOptions options) {
+    auto cache
+      = internal::ContentCache::open(options.directory, options.maxBytes);
+    if (!cache) {
+      return error(cache.err());
+    }
+    std::shared_ptr<const internal::ContentCache> next = std::move(cache.get());
+    std::lock_guard lock(cacheMutex);
+    contentCache.swap(next);
+    return ok();
+  }
+  void ApiClient::disableContentCache() {
+    std::shared_ptr<const internal::ContentCache> next;
+    std::lock_guard lock(cacheMutex);
+    contentCache.swap(next);
+  }
+  void ApiClient::enableRoomStatusCache(RoomStatusCacheOptions options) {
+    auto next = std::make_shared<internal::RoomStatusCache>(options.ttl,
+                                                            options.shards);
+    std::lock_guard lock(cacheMutex);
+    roomStatusCache.swap(next);
+  }
+  void ApiClient::disableRoomStatusCache() {
+    std::shared_ptr<internal::RoomStatusCache> next;
+    std::lock_guard lock(cacheMutex);
+    roomStatusCache.swap(next);
+  }
+  void ApiClient::enableContentPrefetch(PrefetchOptions options) {
+    auto download = [this, maxBytes = options.maxBytes](
+                      const internal::ContentObservation& observation,
+                      CancellationSource cancellation)
+      -> Result<Content, ErrorResponse> {
+      const auto cache = loadContentCache();
+      if (auto cached = decodeCachedContent(
+            cache.get(), observation.contentStatus, observation.hash)) {
+        return std::move(cached.value());
+      }
+      internal::Hasher hasher;
+      std::vector<std::uint8_t> data;
+      const internal::BodyObserver observer
+        = [&, maxBytes](std::span<const std::uint8_t> chunk) {
+            if (cancellation.isCancelled()) return;
+            if (data.size() + chunk.size() > maxBytes) {
+              // 上限を超えるコンテンツは覚えないので、受信を打ち切る。
+              cancellation.cancel();
+              return;
+            }
+            hasher.update(chunk);
+            data.insert(data.end(), chunk.begin(), chunk.end());
+          };
+      // イベントループで駆動するクライアントは、ループのスレッド以外で非同期のリクエストを始められない。
+      // その場合は受信をキャンセルできないので、取得し終えてから捨てる。
+      auto result
+        = loopTransport != nullptr
+          ? bridge.roomIdContentGet(observation.roomId, observer)
+          : syncWait(bridge.roomIdContentGetAsync(
+            internal::AsyncContext{
+              .executor = &inlineExecutor(),
+              .token    = cancellation.token(),
+            },
+            observation.roomId,
+            observer));
+      if (!result) {
+        return error(result.err());
+      }
+      if (cancellation.isCancelled()) {
+        return makeError(ERR_CANCELLED, "The operation was cancelled.");
+      }
+      return decodeAndCache(cache.get(),
+                            ContentStatus(observation.contentStatus),
+                            observation.hash,
+                            hasher.finish(),
+                            std::move(data));
+    };
+    auto next = std::make_shared<internal::ContentPrefetcher>(
+      std::move(download), options.maxBytes);
+    std::lock_guard lock(cacheMutex);
+    contentPrefetcher.swap(next);
+  }
+  void ApiClient::disableContentPrefetch() {
+    std::shared_ptr<internal::ContentPrefetcher> next;
+    std::lock_guard lock(cacheMutex);
+    contentPrefetcher.swap(next);
   }
 } // namespace octane
\ No newline at end of file
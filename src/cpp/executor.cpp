@@ -0,0 +1,77 @@
+/**
+ * @file executor.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief executor.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/executor.h"
+
+#include <algorithm>
+
+namespace octane {
+  Executor::~Executor() {}
+
+  void InlineExecutor::post(std::function<void()> task) {
+    task();
+  }
+
+  ThreadPoolExecutor::ThreadPoolExecutor(std::size_t threadCount)
+    : stopping(false) {
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+      threads.emplace_back([this] { run(); });
+    }
+  }
+  ThreadPoolExecutor::~ThreadPoolExecutor() noexcept {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    available.notify_all();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void ThreadPoolExecutor::post(std::function<void()> task) {
+    {
+      std::lock_guard lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+  }
+
+  void ThreadPoolExecutor::run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mutex);
+        available.wait(lock, [this] { return stopping || !tasks.empty(); });
+        // 停止する前に、既に積まれているタスクは全て実行する。
+        if (tasks.empty()) return;
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  Executor& defaultExecutor() {
+    // NOTE: 静的変数として持つとApiClientのデストラクタより先に破棄されてしまうため、
+    // 意図的に解放しない。
+    static auto executor = new ThreadPoolExecutor(
+      std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 4));
+    return *executor;
+  }
+  Executor& inlineExecutor() {
+    // NOTE: 静的変数として持つとApiClientのデストラクタより先に破棄されてしまうため、
+    // 意図的に解放しない。
+    static auto executor = new InlineExecutor();
+    return *executor;
+  }
+} // namespace octane
@@ -11,320 +11,567 @@
 
 #include "include/internal/api_bridge.h"
 
-#include <rapidjson/document.h>
-#include <rapidjson/schema.h>
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
-
-#include <iostream>
-#include <map>
+#include <optional>
+#include <type_traits>
 
 #include "include/error_code.h"
-#include "include/internal/api_schema.h"
 
 namespace octane::internal {
   namespace {
-    std::optional<ErrorResponse> verifyJson(const rapidjson::Document& json,
-                                            std::string_view schema) {
-      rapidjson::Document sd;
-      assert(!sd.Parse(schema.data(), schema.size()).HasParseError());
-      rapidjson::SchemaDocument schemaDoc(sd);
-      rapidjson::SchemaValidator validator(schemaDoc);
+    /**
+     * @brief エンドポイントごとに覚えておく、304に対して返す結果の数の上限。
+     *
+     */
+    constexpr std::size_t REVALIDATION_CACHE_CAPACITY = 64;
+    /** @brief GETのリクエストとして渡す、寿命がプログラム全体にわたる空のボディ。*/
+    constexpr NoBody NO_BODY{};
 
-      if (json.Accept(validator)) {
-        return std::nullopt;
+    Json encode(const RoomPostRequest& request) {
+      return Json::object().set("name", request.name);
+    }
+    Json encode(const RoomIdPostRequest& request) {
+      return Json::object()
+        .set("name", request.name)
+        .set("request", request.request);
+    }
+    Json encode(const RoomIdStatusPutRequest& request) {
+      const auto& contentStatus = request.contentStatus;
+      auto json                 = Json::object();
+      json.set("device", contentStatus.device)
+        .set("timestamp", contentStatus.timestamp)
+        .set("name", "");
+      if (contentStatus.type == ContentType::File) {
+        json.set("mime", contentStatus.mime).set("type", "file");
+      } else if (contentStatus.type == ContentType::Clipboard) {
+        json.set("mime", "text/plain").set("type", "clipboard");
+      } else if (contentStatus.type == ContentType::MultiFile) {
+        // MIMEはアーカイブの圧縮方法を表す。
+        json.set("mime", contentStatus.mime).set("type", "multi-file");
+      } else {
+        std::abort();
       }
+      json.set("hash", request.hash);
+      return json;
+    }
 
-      std::string msg;
-
-      rapidjson::StringBuffer buf;
-      validator.GetInvalidSchemaPointer().StringifyUriFragment(buf);
-      msg += "\n\t\tInvalid schema: ";
-      msg += buf.GetString();
-      msg += "\n\t\tInvalid keyword: ";
-      msg += validator.GetInvalidSchemaKeyword();
-
-      buf.Clear();
-      validator.GetInvalidDocumentPointer().StringifyUriFragment(buf);
-      msg += "\n\t\tInvalid document: ";
-      msg += buf.GetString();
+    // NOTE: staticなstd::mapを使うとApiClientのデストラクタでこけるので分岐で書く
+    // スキーマの検証を省略できるので、知らない値はnulloptとして呼び出し元でエラーにする。
+    std::optional<Health> toHealth(std::string_view health) {
+      if (health == "healthy") return Health::Healthy;
+      if (health == "degraded") return Health::Degraded;
+      if (health == "faulty") return Health::Faulty;
+      return std::nullopt;
+    }
+    std::optional<ContentType> toContentType(std::string_view type) {
+      if (type == "file") return ContentType::File;
+      if (type == "clipboard") return ContentType::Clipboard;
+      if (type == "multi-file") return ContentType::MultiFile;
+      return std::nullopt;
+    }
+    std::optional<RoomEventType> toDeviceEventType(std::string_view type) {
+      if (type == "joined") return RoomEventType::DeviceJoined;
+      if (type == "left") return RoomEventType::DeviceLeft;
+      return std::nullopt;
+    }
 
-      return ErrorResponse{
-        .code   = ERR_INVALID_RESPONSE,
-        .reason = msg,
+    Result<HealthResult, ErrorResponse> decode(
+      const Json& json,
+      std::type_identity<HealthResult>) {
+      const auto health = json["health"].getString();
+      const auto value  = toHealth(health);
+      if (!value) {
+        return makeError(
+          ERR_INVALID_RESPONSE,
+          "Invalid response, unknown health " + std::string(health));
+      }
+      HealthResult result{
+        .health = value.value(),
       };
+      if (auto message = json.find("message")) {
+        result.message = std::string(message->getString());
+      }
+      return ok(std::move(result));
+    }
+    Result<RoomId, ErrorResponse> decode(const Json& json,
+                                         std::type_identity<RoomId>) {
+      return ok(RoomId{ .id = json["id"].getUint64() });
+    }
+    Result<RoomStatus, ErrorResponse> decode(const Json& json,
+                                             std::type_identity<RoomStatus>) {
+      std::vector<Device> devices;
+      const auto& array = json["devices"].getArray();
+      devices.reserve(array.size());
+      for (const auto& device : array) {
+        devices.push_back(Device{
+          .name      = std::string(device["name"].getString()),
+          .timestamp = device["timestamp"].getUint64(),
+        });
+      }
+      return ok(RoomStatus{
+        .name    = std::string(json["name"].getString()),
+        .devices = std::move(devices),
+        .id      = json["id"].getUint64(),
+      });
+    }
+    Result<std::pair<ContentStatus, std::string>, ErrorResponse> decode(
+      const Json& json,
+      std::type_identity<std::pair<ContentStatus, std::string>>) {
+      const auto typeName = json["type"].getString();
+      const auto type     = toContentType(typeName);
+      if (!type) {
+        return makeError(
+          ERR_INVALID_RESPONSE,
+          "Invalid response, unknown content type " + std::string(typeName));
+      }
+      ContentStatus status{
+        .device    = std::string(json["device"].getString()),
+        .timestamp = json["timestamp"].getUint64(),
+        .type      = type.value(),
+        .name      = "",
+        .mime      = std::string(json["mime"].getString()),
+      };
+      if (status.type == ContentType::File) {
+        status.name = std::string(json["name"].getString());
+      }
+      return ok(std::make_pair(std::move(status),
+                               std::string(json["hash"].getString())));
     }
   } // namespace
 
-  ApiBridge::ApiBridge(FetchBase* fetch) : fetch(fetch) {}
+  ApiBridge::ApiBridge(FetchBase* fetch)
+    : fetch(fetch),
+      roomCache(REVALIDATION_CACHE_CAPACITY),
+      statusCache(REVALIDATION_CACHE_CAPACITY) {}
   Result<_, ErrorResponse> ApiBridge::init() {
     return fetch->init();
   }
-  Result<HealthResult, ErrorResponse> ApiBridge::healthGet() {
-    using namespace std::string_literals;
-    auto response = fetch->request(internal::HttpMethod::Get, "/health");
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    if (!std::holds_alternative<rapidjson::Document>(response.get().body)) {
-      return makeError(ERR_INVALID_RESPONSE,
-                       "Invalid response, json not returned");
+  void ApiBridge::setValidationMode(ValidationMode mode,
+                                    std::uint32_t sampleInterval) {
+    validationPolicy.set(mode, sampleInterval);
+  }
+  template <typename Endpoint, typename... PathParams>
+  Result<typename Endpoint::ResponseType, ErrorResponse> ApiBridge::call(
+    const typename Endpoint::RequestType& request,
+    PathParams... params) {
+    const auto path = Endpoint::path(params...);
+    if constexpr (Endpoint::method == HttpMethod::Get) {
+      // 同じGETが実行中であれば、新たに送らずにその結果を受け取る。
+      return flightsOf<Endpoint>().run(
+        path, [&] { return send<Endpoint>(request, path); });
+    } else {
+      return send<Endpoint>(request, path);
     }
-    rapidjson::Document& json
-      = std::get<rapidjson::Document>(response.get().body);
+  }
+  template <typename Endpoint>
+  Result<typename Endpoint::ResponseType, ErrorResponse> ApiBridge::send(
+    const typename Endpoint::RequestType& request,
+    const std::string& path) {
+    using Request = typename Endpoint::RequestType;
 
-    if (auto err = verifyJson(json, SCHEMA_HEALTH_GET)) {
-      return error(err.value());
+    if constexpr (isRevalidated<Endpoint>) {
+      auto response = fetch->revalidate(path);
+      if (auto result = decodeRevalidated<Endpoint>(path, response)) {
+        return std::move(result.value());
+      }
+      // 前回の結果を覚えていないので、検証子を捨てて全体を受け取り直す。
+      fetch->forgetValidators(path);
+      auto retried = fetch->revalidate(path);
+      if (auto result = decodeRevalidated<Endpoint>(path, retried)) {
+        return std::move(result.value());
+      }
+      return makeError(ERR_INVALID_RESPONSE,
+                       "Invalid response, 304 returned for " + path);
+    } else {
+      auto response = [&]() {
+        if constexpr (std::is_same_v<Request, NoBody>) {
+          return fetch->request(Endpoint::method, path);
+        } else if constexpr (std::is_same_v<Request, RoomIdContentPutRequest>) {
+          return fetch->request(
+            Endpoint::method, path, request.mime, request.data);
+        } else {
+          return fetch->request(Endpoint::method, path, encode(request));
+        }
+      }();
+      return decodeResponse<Endpoint>(response);
     }
-
-    // NOTE: staticつけるとApiClientのデストラクタでこける
-    const std::map<std::string, Health> healthMap = {
-      { "healthy", Health::Healthy },
-      { "degraded", Health::Degraded },
-      { "faulty", Health::Faulty },
-    };
-
-    return ok(HealthResult{
-      .health  = healthMap.at(json["health"].GetString()),
-      .message = json["message"].GetString(),
-    });
   }
-  Result<RoomId, ErrorResponse> ApiBridge::roomPost(std::string_view name) {
-    rapidjson::Document uploadJson(rapidjson::kObjectType);
-    uploadJson.AddMember("name",
-                         rapidjson::StringRef(name.data(), name.size()),
-                         uploadJson.GetAllocator());
-    auto response
-      = fetch->request(internal::HttpMethod::Post, "/room", uploadJson);
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    if (!std::holds_alternative<rapidjson::Document>(response.get().body)) {
-      return makeError(ERR_INVALID_RESPONSE,
-                       "Invalid response, json not returned");
+  template <typename Endpoint, typename... PathParams>
+  Task<Result<typename Endpoint::ResponseType, ErrorResponse>>
+  ApiBridge::callAsync(AsyncContext context,
+                       const typename Endpoint::RequestType& request,
+                       PathParams... params) {
+    auto path = Endpoint::path(params...);
+    if constexpr (Endpoint::method == HttpMethod::Get) {
+      // sendAsyncはrequestを参照で保持したまま遅れて始まるので、一時オブジェクトではなくNO_BODYを渡す。
+      // また、GCCはco_awaitの式の中のラムダを含む一時オブジェクトを早く破棄するので、一度変数に受ける。
+      auto& flights = flightsOf<Endpoint>();
+      auto task     = flights.runAsync(
+        path, *context.executor, context.token, [this, context, path] {
+          return sendAsync<Endpoint>(context, NO_BODY, path);
+        });
+      co_return co_await std::move(task);
+    } else {
+      co_return co_await sendAsync<Endpoint>(
+        std::move(context), request, std::move(path));
     }
-    rapidjson::Document& json
-      = std::get<rapidjson::Document>(response.get().body);
-    if (auto err = verifyJson(json, SCHEMA_ROOM_POST)) {
-      return error(err.value());
+  }
+  template <typename Endpoint>
+  Task<Result<typename Endpoint::ResponseType, ErrorResponse>>
+  ApiBridge::sendAsync(AsyncContext context,
+                       const typename Endpoint::RequestType& request,
+                       std::string path) {
+    using Request = typename Endpoint::RequestType;
+
+    std::optional<FetchBase::FetchResult> response;
+    if constexpr (isRevalidated<Endpoint>) {
+      response.emplace(co_await fetch->revalidateAsync(context, path));
+      if (auto result = decodeRevalidated<Endpoint>(path, response.value())) {
+        co_return std::move(result.value());
+      }
+      // 前回の結果を覚えていないので、検証子を捨てて全体を受け取り直す。
+      fetch->forgetValidators(path);
+      response.emplace(co_await fetch->revalidateAsync(context, path));
+      if (auto result = decodeRevalidated<Endpoint>(path, response.value())) {
+        co_return std::move(result.value());
+      }
+      co_return makeError(ERR_INVALID_RESPONSE,
+                          "Invalid response, 304 returned for " + path);
+    } else if constexpr (std::is_same_v<Request, NoBody>) {
+      response.emplace(co_await fetch->requestAsync(
+        context, Endpoint::method, std::move(path)));
+    } else if constexpr (std::is_same_v<Request, RoomIdContentPutRequest>) {
+      response.emplace(co_await fetch->requestAsync(context,
+                                                    Endpoint::method,
+                                                    std::move(path),
+                                                    std::string(request.mime),
+                                                    request.data));
+    } else {
+      response.emplace(co_await fetch->requestAsync(
+        context, Endpoint::method, std::move(path), encode(request)));
     }
-    return ok(RoomId{ .id = json["id"].GetUint64() });
+    co_return decodeResponse<Endpoint>(response.value());
   }
-  Result<RoomStatus, ErrorResponse> ApiBridge::roomIdGet(std::uint64_t id) {
-    auto response = fetch->request(internal::HttpMethod::Get,
-                                   "/room/" + std::to_string(id));
+  template <typename Endpoint>
+  Result<typename Endpoint::ResponseType, ErrorResponse>
+  ApiBridge::decodeResponse(FetchBase::FetchResult& response) {
+    using Response = typename Endpoint::ResponseType;
+
     if (!response) {
       return error(response.err());
     }
     if (auto err = checkStatusCode(response.get())) {
       return err.value();
     }
-    if (!std::holds_alternative<rapidjson::Document>(response.get().body)) {
-      return makeError(ERR_INVALID_RESPONSE,
-                       "Invalid response, json not returned");
-    }
-    rapidjson::Document& json
-      = std::get<rapidjson::Document>(response.get().body);
-
-    if (auto err = verifyJson(json, SCHEMA_ROOM_ID_GET)) {
-      return error(err.value());
-    }
 
-    std::vector<Device> devices;
-    for (const auto& device : json["devices"].GetArray()) {
-      devices.push_back(Device{
-        .name      = device["name"].GetString(),
-        .timestamp = device["timestamp"].GetUint64(),
-      });
+    auto& body = response.get().body;
+    if constexpr (std::is_same_v<Response, _>) {
+      return ok();
+    } else if constexpr (std::is_same_v<Response, std::vector<std::uint8_t>>) {
+      if (!std::holds_alternative<std::vector<std::uint8_t>>(body)) {
+        return makeError(ERR_INVALID_RESPONSE,
+                         "Invalid response, binary not returned");
+      }
+      return ok(std::move(std::get<std::vector<std::uint8_t>>(body)));
+    } else {
+      if (!std::holds_alternative<Json>(body)) {
+        return makeError(ERR_INVALID_RESPONSE,
+                         "Invalid response, json not returned");
+      }
+      const auto& json = std::get<Json>(body);
+      if constexpr (Endpoint::hasSchema) {
+        if (auto err = verifyJson(json, Endpoint::schema)) {
+          return error(err.value());
+        }
+      }
+      return decode(json, std::type_identity<Response>{});
     }
-    return ok(RoomStatus{
-      .name    = json["name"].GetString(),
-      .devices = std::move(devices),
-      .id      = json["id"].GetUint64(),
-    });
   }
-  Result<_, ErrorResponse> ApiBridge::roomIdDelete(std::uint64_t id) {
-    auto response = fetch->request(internal::HttpMethod::Delete,
-                                   "/room/" + std::to_string(id));
-    if (!response) {
-      return error(response.err());
+  template <typename Endpoint>
+    requires isRevalidated<Endpoint>
+  std::optional<Result<typename Endpoint::ResponseType, ErrorResponse>>
+  ApiBridge::decodeRevalidated(const std::string& path,
+                               FetchBase::FetchResult& response) {
+    auto& cache = revalidationCache<Endpoint>();
+    if (response && response.get().statusCode == 304) {
+      auto cached = cache.find(path,
+                               response.get().findHeader("ETag"),
+                               response.get().findHeader("Last-Modified"));
+      if (!cached) return std::nullopt;
+      return ok(std::move(cached.value()));
+    }
+    auto result = decodeResponse<Endpoint>(response);
+    if (result) {
+      const auto evicted
+        = cache.store(path,
+                      response.get().findHeader("ETag"),
+                      response.get().findHeader("Last-Modified"),
+                      result.get());
+      // 結果を捨てたURLの検証子も捨てる。残っていると、304を受けてから取り直すことになる。
+      if (evicted) fetch->forgetValidators(evicted.value());
+    }
+    return result;
+  }
+  template <typename Endpoint>
+  ApiBridge::Flights<Endpoint>& ApiBridge::flightsOf() {
+    if constexpr (std::is_same_v<Endpoint, endpoint::HealthGet>) {
+      return healthFlights;
+    } else if constexpr (std::is_same_v<Endpoint, endpoint::RoomIdGet>) {
+      return roomFlights;
+    } else if constexpr (std::is_same_v<Endpoint, endpoint::RoomIdContentGet>) {
+      return contentFlights;
+    } else {
+      static_assert(std::is_same_v<Endpoint, endpoint::RoomIdStatusGet>,
+                    "Every GET endpoint needs its own flights.");
+      return statusFlights;
     }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
+  }
+  template <typename Endpoint>
+    requires isRevalidated<Endpoint>
+  RevalidationCache<typename Endpoint::ResponseType>&
+  ApiBridge::revalidationCache() {
+    if constexpr (std::is_same_v<Endpoint, endpoint::RoomIdGet>) {
+      return roomCache;
+    } else {
+      return statusCache;
     }
-    return ok();
+  }
+  Result<HealthResult, ErrorResponse> ApiBridge::healthGet() {
+    return call<endpoint::HealthGet>(NoBody{});
+  }
+  Result<RoomId, ErrorResponse> ApiBridge::roomPost(std::string_view name) {
+    return call<endpoint::RoomPost>(RoomPostRequest{ .name = name });
+  }
+  Result<RoomStatus, ErrorResponse> ApiBridge::roomIdGet(std::uint64_t id) {
+    return call<endpoint::RoomIdGet>(NoBody{}, id);
+  }
+  Result<_, ErrorResponse> ApiBridge::roomIdDelete(std::uint64_t id) {
+    return call<endpoint::RoomIdDelete>(NoBody{}, id);
   }
   Result<_, ErrorResponse> ApiBridge::roomIdPost(std::uint64_t id,
                                                  std::string_view name,
                                                  std::string_view request) {
-    rapidjson::Document uploadJson(rapidjson::kObjectType);
-    uploadJson.AddMember("name",
-                         rapidjson::StringRef(name.data(), name.size()),
-                         uploadJson.GetAllocator());
-    uploadJson.AddMember("request",
-                         rapidjson::StringRef(request.data(), request.size()),
-                         uploadJson.GetAllocator());
-    auto response = fetch->request(
-      internal::HttpMethod::Post, "/room/" + std::to_string(id), uploadJson);
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    return ok();
+    return call<endpoint::RoomIdPost>(
+      RoomIdPostRequest{ .name = name, .request = request }, id);
   }
   Result<std::vector<std::uint8_t>, ErrorResponse> ApiBridge::roomIdContentGet(
     std::uint64_t id) {
-    auto response = fetch->request(internal::HttpMethod::Get,
-                                   "/room/" + std::to_string(id) + "/content");
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    if (!std::holds_alternative<std::vector<std::uint8_t>>(
-          response.get().body)) {
-      return makeError(ERR_INVALID_RESPONSE,
-                       "Invalid response, binary not returned");
-    }
-    return ok(
-      std::move(std::get<std::vector<std::uint8_t>>(response.get().body)));
+    return call<endpoint::RoomIdContentGet>(NoBody{}, id);
   }
-  Result<_, ErrorResponse> ApiBridge::roomIdContentDelete(std::uint64_t id) {
-    auto response = fetch->request(internal::HttpMethod::Delete,
-                                   "/room/" + std::to_string(id) + "/content");
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
+  Result<_, ErrorResponse> ApiBridge::roomIdContentGet(
+    std::uint64_t id,
+    const BodyObserver& observer) {
+    auto response
+      = fetch->download(endpoint::RoomIdContentGet::path(id), observer);
+    const auto result = decodeResponse<endpoint::RoomIdContentGet>(response);
+    if (!result) {
+      return error(result.err());
     }
     return ok();
   }
+  Result<_, ErrorResponse> ApiBridge::roomIdContentDelete(std::uint64_t id) {
+    return call<endpoint::RoomIdContentDelete>(NoBody{}, id);
+  }
   Result<_, ErrorResponse> ApiBridge::roomIdContentPut(
     std::uint64_t id,
-    const std::vector<std::uint8_t>& contentData,
+    std::span<const std::uint8_t> contentData,
     std::string_view mime) {
-    auto response = fetch->request(internal::HttpMethod::Put,
-                                   "/room/" + std::to_string(id) + "/content",
-                                   mime,
-                                   contentData);
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    return ok();
+    return call<endpoint::RoomIdContentPut>(
+      RoomIdContentPutRequest{ .data = contentData, .mime = mime }, id);
   }
   Result<std::pair<ContentStatus, std::string>, ErrorResponse>
   ApiBridge::roomIdStatusGet(std::uint64_t id) {
-    using namespace std::string_literals;
-    auto response = fetch->request(internal::HttpMethod::Get,
-                                   "/room/" + std::to_string(id) + "/status");
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    if (!std::holds_alternative<rapidjson::Document>(response.get().body)) {
-      return makeError(ERR_INVALID_RESPONSE,
-                       "Invalid response, json not returned");
-    }
-    rapidjson::Document& json
-      = std::get<rapidjson::Document>(response.get().body);
-
-    if (auto err = verifyJson(json, SCHEMA_ROOM_ID_STATUS_GET)) {
-      return error(err.value());
-    }
-
-    const std::map<std::string, ContentType> typeMap = {
-      { "file", ContentType::File },
-      { "clipboard", ContentType::Clipboard },
-      { "multi-file", ContentType::MultiFile },
-    };
-
-    ContentStatus status{
-      .device    = json["device"].GetString(),
-      .timestamp = json["timestamp"].GetUint64(),
-      .type      = typeMap.at(json["type"].GetString()),
-      .name      = "",
-      .mime      = json["mime"].GetString(),
-    };
-    if (status.type == ContentType::File) {
-      status.name = json["name"].GetString();
-    }
-    return ok(std::make_pair<ContentStatus, std::string>(
-      std::move(status), json["hash"].GetString()));
+    return call<endpoint::RoomIdStatusGet>(NoBody{}, id);
   }
   Result<_, ErrorResponse> ApiBridge::roomIdStatusDelete(std::uint64_t id) {
-    auto response = fetch->request(internal::HttpMethod::Delete,
-                                   "/room/" + std::to_string(id) + "/status");
-    if (!response) {
-      return error(response.err());
-    }
-    if (auto err = checkStatusCode(response.get())) {
-      return err.value();
-    }
-    return ok();
+    return call<endpoint::RoomIdStatusDelete>(NoBody{}, id);
   }
   Result<_, ErrorResponse> ApiBridge::roomIdStatusPut(
     std::uint64_t id,
     const ContentStatus& contentStatus,
     std::string_view hash) {
-    rapidjson::Document uploadJson(rapidjson::kObjectType);
-    uploadJson.AddMember("device",
-                         rapidjson::StringRef(contentStatus.device.data(),
-                                              contentStatus.device.size()),
-                         uploadJson.GetAllocator());
-    uploadJson.AddMember("timestamp",
-                         rapidjson::Value().SetUint64(contentStatus.timestamp),
-                         uploadJson.GetAllocator());
-    uploadJson.AddMember("name", "", uploadJson.GetAllocator());
-    if (contentStatus.type == ContentType::File) {
-      uploadJson.AddMember("mime",
-                           rapidjson::StringRef(contentStatus.mime.data(),
-                                                contentStatus.mime.size()),
-                           uploadJson.GetAllocator());
-      uploadJson.AddMember("type", "file", uploadJson.GetAllocator());
-    } else if (contentStatus.type == ContentType::Clipboard) {
-      uploadJson.AddMember("mime", "text/plain", uploadJson.GetAllocator());
-      uploadJson.AddMember("type", "clipboard", uploadJson.GetAllocator());
-    } else if (contentStatus.type == ContentType::MultiFile) {
-      uploadJson.AddMember(
-        "mime", "application/x-7z-compressed", uploadJson.GetAllocator());
-      uploadJson.AddMember("type", "multi-file", uploadJson.GetAllocator());
-    } else {
-      std::abort();
-    }
-    uploadJson.AddMember("hash",
-                         rapidjson::StringRef(hash.data(), hash.size()),
-                         uploadJson.GetAllocator());
-    auto response = fetch->request(internal::HttpMethod::Put,
-                                   "/room/" + std::to_string(id) + "/status",
-                                   uploadJson);
+    return call<endpoint::RoomIdStatusPut>(
+      RoomIdStatusPutRequest{ .contentStatus = contentStatus, .hash = hash },
+      id);
+  }
+  Result<_, ErrorResponse> ApiBridge::roomIdEventsGet(
+    std::uint64_t id,
+    CancellationToken token,
+    const std::function<void(RoomEvent)>& onEvent) {
+    EventStreamParser parser;
+    // 壊れたイベントを受け取ったら、そこで受信を打ち切ってエラーを返す。
+    std::optional<ErrorResponse> failure;
+    const auto onData = [&](std::string_view chunk) {
+      parser.feed(chunk, [&](StreamEvent&& event) {
+        if (failure.has_value()) return;
+        auto decoded = decodeEvent(id, event);
+        if (!decoded) {
+          failure = decoded.err();
+        } else if (decoded.get().has_value()) {
+          onEvent(std::move(decoded.get().value()));
+        }
+      });
+      return !failure.has_value();
+    };
+
+    auto response = fetch->stream(
+      endpoint::RoomIdEventsGet::path(id), std::move(token), onData);
     if (!response) {
       return error(response.err());
     }
+    if (failure.has_value()) {
+      return error(failure.value());
+    }
+    const auto statusCode = response.get().statusCode;
+    if (statusCode == 404 || statusCode == 405 || statusCode == 501) {
+      return makeError(ERR_EVENT_STREAM_UNAVAILABLE,
+                       "The server does not provide the event stream.");
+    }
     if (auto err = checkStatusCode(response.get())) {
       return err.value();
     }
+    if (response.get().mime != "text/event-stream") {
+      return makeError(ERR_EVENT_STREAM_UNAVAILABLE,
+                       "The server did not respond with an event stream.");
+    }
     return ok();
   }
+  Task<Result<HealthResult, ErrorResponse>> ApiBridge::healthGetAsync(
+    AsyncContext context) {
+    co_return co_await callAsync<endpoint::HealthGet>(context, NoBody{});
+  }
+  Task<Result<RoomId, ErrorResponse>> ApiBridge::roomPostAsync(
+    AsyncContext context,
+    std::string name) {
+    const RoomPostRequest request{ .name = name };
+    co_return co_await callAsync<endpoint::RoomPost>(context, request);
+  }
+  Task<Result<RoomStatus, ErrorResponse>> ApiBridge::roomIdGetAsync(
+    AsyncContext context,
+    std::uint64_t id) {
+    co_return co_await callAsync<endpoint::RoomIdGet>(context, NoBody{}, id);
+  }
+  Task<Result<_, ErrorResponse>> ApiBridge::roomIdDeleteAsync(
+    AsyncContext context,
+    std::uint64_t id) {
+    co_return co_await callAsync<endpoint::RoomIdDelete>(context, NoBody{}, id);
+  }
+  Task<Result<_, ErrorResponse>> ApiBridge::roomIdPostAsync(
+    AsyncContext context,
+    std::uint64_t id,
+    std::string name,
+    std::string request) {
+    const RoomIdPostRequest body{ .name = name, .request = request };
+    co_return co_await callAsync<endpoint::RoomIdPost>(context, body, id);
+  }
+  Task<Result<std::vector<std::uint8_t>, ErrorResponse>>
+  ApiBridge::roomIdContentGetAsync(AsyncContext context, std::uint64_t id) {
+    co_return co_await callAsync<endpoint::RoomIdContentGet>(
+      context, NoBody{}, id);
+  }
+  Task<Result<_, ErrorResponse>> ApiBridge::roomIdContentGetAsync(
+    AsyncContext context,
+    std::uint64_t id,
+    const BodyObserver& observer) {
+    auto response = co_await fetch->downloadAsync(
+      context, endpoint::RoomIdContentGet::path(id), observer);
+    const auto result = decodeResponse<endpoint::RoomIdContentGet>(response);
+    if (!result) {
+      co_return error(result.err());
+    }
+    co_return ok();
+  }
+  Task<Result<_, ErrorResponse>> ApiBridge::roomIdContentDeleteAsync(
+    AsyncContext context,
+    std::uint64_t id) {
+    co_return co_await callAsync<endpoint::RoomIdContentDelete>(
+      context, NoBody{}, id);
+  }
+  Task<Result<_, ErrorResponse>> ApiBridge::roomIdContentPutAsync(
+    AsyncContext context,
+    std::uint64_t id,
+    std::span<const std::uint8_t> contentData,
+    std::string mime) {
+    const RoomIdContentPutRequest request{ .data = contentData, .mime = mime };
+    co_return co_await callAsync<endpoint::RoomIdContentPut>(
+      context, request, id);
+  }
+  Task<Result<std::pair<ContentStatus, std::string>, ErrorResponse>>
+  ApiBridge::roomIdStatusGetAsync(AsyncContext context, std::uint64_t id) {
+    co_return co_await callAsync<endpoint::RoomIdStatusGet>(
+      context, NoBody{}, id);
+  }
+  Task<Result<_, ErrorResponse>> ApiBridge::roomIdStatusPutAsync(
+    AsyncContext context,
+    std::uint64_t id,
+    ContentStatus contentStatus,
+    std::string hash) {
+    const RoomIdStatusPutRequest request{ .contentStatus = contentStatus,
+                                          .hash          = hash };
+    co_return co_await callAsync<endpoint::RoomIdStatusPut>(
+      context, request, id);
+  }
+  Result<std::optional<RoomEvent>, ErrorResponse> ApiBridge::decodeEvent(
+    std::uint64_t id,
+    const StreamEvent& event) {
+    const bool isContent = event.event == "content";
+    if (!isContent && event.event != "device") {
+      return ok(std::nullopt);
+    }
+    auto json = parseJson(event.data);
+    if (!json) {
+      return error(json.err());
+    }
+    if (isContent) {
+      if (auto err = verifyJson(json.get(), SchemaId::RoomIdStatusGet)) {
+        return error(err.value());
+      }
+      auto decoded = decode(
+        json.get(), std::type_identity<std::pair<ContentStatus, std::string>>{});
+      if (!decoded) return error(decoded.err());
+      auto& [contentStatus, hash] = decoded.get();
+      return ok(RoomEvent{
+        .type          = RoomEventType::ContentChanged,
+        .roomId        = id,
+        .contentStatus = std::move(contentStatus),
+        .hash          = std::move(hash),
+        .device        = std::nullopt,
+      });
+    }
+    if (auto err = verifyJson(json.get(), endpoint::RoomIdEventsGet::schema)) {
+      return error(err.value());
+    }
+    const auto& body     = json.get();
+    const auto typeName  = body["type"].getString();
+    const auto eventType = toDeviceEventType(typeName);
+    if (!eventType) {
+      return makeError(
+        ERR_INVALID_RESPONSE,
+        "Invalid response, unknown device event " + std::string(typeName));
+    }
+    return ok(RoomEvent{
+      .type          = eventType.value(),
+      .roomId        = id,
+      .contentStatus = std::nullopt,
+      .hash          = "",
+      .device        = Device{
+               .name      = std::string(body["name"].getString()),
+               .timestamp = body["timestamp"].getUint64(),
+      },
+    });
+  }
+  std::optional<ErrorResponse> ApiBridge::verifyJson(
+    const Json& json,
+    SchemaId schema) {
+    if (!validationPolicy.shouldValidate()) {
+      return std::nullopt;
+    }
+    return SchemaRegistry::instance().validate(json, schema);
+  }
   std::optional<error_t<ErrorResponse>> ApiBridge::checkStatusCode(
     const internal::FetchResponse& response) {
     if (100 <= response.statusCode && response.statusCode < 300)
       return std::nullopt;
-    if (!std::holds_alternative<rapidjson::Document>(response.body)) {
+    if (!std::holds_alternative<Json>(response.body)) {
       auto& vec = std::get<std::vector<std::uint8_t>>(response.body);
       std::string body;
       body.resize(vec.size());
@@ -342,11 +589,12 @@ namespace octane::internal {
                          + "status line = " + response.statusLine
                          + " body = " + body);
     }
-    const rapidjson::Document& json
-      = std::get<rapidjson::Document>(response.body);
-    if (auto err = verifyJson(json, SCHEMA_ERROR_RESPONSE)) {
+    const auto& json = std::get<Json>(response.body);
+    // エラーレスポンスは検証のモードにかかわらず常に検証する。
+    if (auto err = SchemaRegistry::instance().validate(
+          json, SchemaId::ErrorResponse)) {
       return error(err.value());
     }
-    return makeError(json["code"].GetString(), json["reason"].GetString());
+    return makeError(json["code"].getString(), json["reason"].getString());
   }
 } // namespace octane::internal
\ No newline at end of file
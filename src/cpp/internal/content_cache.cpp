@@ -0,0 +1,150 @@
+/**
+ * @file content_cache.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief content_cache.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/content_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "include/error_code.h"
+#include "include/internal/hash.h"
+#include "include/internal/temporary_file.h"
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief これより古い一時ファイルは、書き込み中に終了したプロセスが残したものとみなす。
+     *
+     */
+    constexpr auto STALE_TEMPORARY_AGE = std::chrono::hours(1);
+  } // namespace
+
+  ContentCache::ContentCache(std::filesystem::path directory,
+                             std::uint64_t maxBytes)
+    : directory(std::move(directory)),
+      maxBytes(maxBytes) {}
+
+  Result<std::shared_ptr<ContentCache>, ErrorResponse> ContentCache::open(
+    const std::filesystem::path& directory,
+    std::uint64_t maxBytes) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory / "objects", ec);
+    if (!ec) {
+      std::filesystem::create_directories(directory / "tmp", ec);
+    }
+    if (ec) {
+      return makeError(ERR_FILE_WRITE_FAILED,
+                       "Failed to create the content cache in "
+                         + directory.string() + ": " + ec.message());
+    }
+    return ok(
+      std::shared_ptr<ContentCache>(new ContentCache(directory, maxBytes)));
+  }
+
+  std::optional<MappedFile> ContentCache::lookup(std::string_view hash) const {
+    const auto path = objectPath(hash);
+    if (!path) return std::nullopt;
+    auto file = MappedFile::open(path.value());
+    if (!file) return std::nullopt;
+    std::optional<MappedFile> mapped(std::move(file.get()));
+    std::error_code ec;
+    // 書き込み中の電源断やディスクの破損で壊れていることがあるので、返す前に検証する。
+    if (generateHash(mapped->bytes()) != hash) {
+      // マップしたままでは削除できない環境があるので、先に解除する。
+      mapped.reset();
+      std::filesystem::remove(path.value(), ec);
+      return std::nullopt;
+    }
+    // 使われた順に削除するために、更新時刻を最後に使われた時刻として扱う。
+    std::filesystem::last_write_time(
+      path.value(), std::filesystem::file_time_type::clock::now(), ec);
+    return mapped;
+  }
+
+  void ContentCache::store(std::string_view hash,
+                           std::span<const std::uint8_t> data) const {
+    const auto path = objectPath(hash);
+    if (!path || data.size() > maxBytes) return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(path->parent_path(), ec);
+    if (ec) return;
+    auto file = TemporaryFile::create(directory / "tmp");
+    if (!file) return;
+    file.get().write(data);
+    // 同じコンテンツを別のプロセスが同時に保存しても、どちらかが完全な内容で残る。
+    if (!file.get().commit(path.value())) return;
+    evict();
+  }
+
+  std::optional<std::filesystem::path> ContentCache::objectPath(
+    std::string_view hash) const {
+    // ハッシュ値はサーバから届くので、パスとして解釈される文字を含むものは扱わない。
+    const bool valid
+      = hash.size() > 2 && std::all_of(hash.begin(), hash.end(), [](char c) {
+          return ('0' <= c && c <= '9') || ('a' <= c && c <= 'f');
+        });
+    if (!valid) return std::nullopt;
+    return directory / "objects" / std::string(hash.substr(0, 2))
+         / std::string(hash);
+  }
+
+  void ContentCache::evict() const {
+    struct Object {
+      std::filesystem::file_time_type lastUsed;
+      std::uint64_t size;
+      std::filesystem::path path;
+    };
+    std::vector<Object> objects;
+    std::uint64_t total = 0;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(
+           directory / "objects", ec);
+         !ec && it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec)) {
+      std::error_code entryError;
+      if (!it->is_regular_file(entryError)) continue;
+      const auto size = it->file_size(entryError);
+      const auto time = it->last_write_time(entryError);
+      if (entryError) continue;
+      objects.push_back(
+        Object{ .lastUsed = time, .size = size, .path = it->path() });
+      total += size;
+    }
+
+    if (total > maxBytes) {
+      std::sort(objects.begin(),
+                objects.end(),
+                [](const Object& a, const Object& b) {
+                  return a.lastUsed < b.lastUsed;
+                });
+      for (const auto& object : objects) {
+        if (total <= maxBytes) break;
+        // 他のプロセスが先に削除していても、マップ中で削除できなくても構わない。
+        std::filesystem::remove(object.path, ec);
+        total -= object.size;
+      }
+    }
+
+    const auto stale
+      = std::filesystem::file_time_type::clock::now() - STALE_TEMPORARY_AGE;
+    for (auto it = std::filesystem::directory_iterator(directory / "tmp", ec);
+         !ec && it != std::filesystem::directory_iterator();
+         it.increment(ec)) {
+      std::error_code timeError;
+      if (it->last_write_time(timeError) < stale && !timeError) {
+        std::filesystem::remove(it->path(), timeError);
+      }
+    }
+  }
+} // namespace octane::internal
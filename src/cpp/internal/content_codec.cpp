@@ -0,0 +1,126 @@
+/**
+ * @file content_codec.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief content_codec.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/content_codec.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <variant>
+
+#include "include/error_code.h"
+#include "include/internal/multi_file.h"
+
+namespace octane::internal {
+  Result<Content, ErrorResponse> decodeContent(
+    ContentStatus&& contentStatus,
+    std::string_view hash,
+    std::string_view digest,
+    std::vector<std::uint8_t>&& data) {
+    if (hash != digest) {
+      return makeError(ERR_CONTENT_HASH_MISMATCH,
+                       "Content data doesn't match with its own hash value");
+    }
+
+    Content content;
+    content.contentStatus = std::move(contentStatus);
+    if (content.contentStatus.type == ContentType::File) {
+      content.data = std::move(data);
+    } else if (content.contentStatus.type == ContentType::Clipboard) {
+      std::string str;
+      str.resize(data.size());
+      std::copy(data.begin(), data.end(), str.begin());
+      content.data = std::move(str);
+    } else {
+      auto files = MultiFileDecompressor::decompress(data);
+      if (!files) {
+        return error(files.err());
+      }
+      content.data = std::move(files.get());
+    }
+    return ok(std::move(content));
+  }
+
+  std::string uploadMime(const ContentStatus& contentStatus,
+                         CompressionCodec codec) {
+    // TODO: mime関係の処理が歪すぎるのでどうにかしましょう
+    if (contentStatus.type == ContentType::Clipboard) {
+      return "text/plain";
+    } else if (contentStatus.type == ContentType::MultiFile) {
+      return std::string(MultiFileCompressor::mime(codec));
+    }
+    return contentStatus.mime;
+  }
+
+  Result<UploadBody, ErrorResponse> prepareUpload(
+    const ContentStatus& contentStatus,
+    std::span<const std::uint8_t> data) {
+    if (contentStatus.type == ContentType::MultiFile) {
+      return makeError(
+        ERR_CONTENT_TYPE_DATA_MISMATCH,
+        "The specified type of content.contentStatus.type doesn't match content.data");
+    }
+    return ok(UploadBody{
+      .contentStatus = contentStatus,
+      .storage       = {},
+      .borrowed      = data,
+      .mime          = uploadMime(contentStatus),
+    });
+  }
+
+  Result<UploadBody, ErrorResponse> prepareUpload(
+    const Content& content,
+    CompressionOptions compression) {
+    const auto& contentStatus = content.contentStatus;
+    if (contentStatus.type == ContentType::Clipboard
+        || contentStatus.type == ContentType::File) {
+      if (std::holds_alternative<std::string>(content.data)) {
+        const auto& str = std::get<std::string>(content.data);
+        return prepareUpload(
+          contentStatus,
+          std::span(reinterpret_cast<const std::uint8_t*>(str.data()),
+                    str.size()));
+      } else if (std::holds_alternative<std::vector<std::uint8_t>>(
+                   content.data)) {
+        return prepareUpload(
+          contentStatus, std::get<std::vector<std::uint8_t>>(content.data));
+      } else if (std::holds_alternative<std::vector<FileInfo>>(
+                   content.data)) {
+        return makeError(
+          ERR_CONTENT_TYPE_DATA_MISMATCH,
+          "The specified type of content.contentStatus.type doesn't match content.data");
+      }
+    } else if (contentStatus.type == ContentType::MultiFile) {
+      if (!std::holds_alternative<std::vector<FileInfo>>(content.data)) {
+        return makeError(
+          ERR_CONTENT_TYPE_DATA_MISMATCH,
+          "The specified type of content.contentStatus.type doesn't match content.data");
+      }
+      auto data = MultiFileCompressor::compress(
+        std::get<std::vector<FileInfo>>(content.data), compression);
+      if (!data) {
+        return error(data.err());
+      }
+      // ルームの状態にも、アーカイブの圧縮方法が分かるMIMEを載せる。
+      auto mime   = uploadMime(contentStatus, compression.codec);
+      auto status = contentStatus;
+      status.mime = mime;
+      return ok(UploadBody{
+        .contentStatus = std::move(status),
+        .storage       = std::move(data.get()),
+        .borrowed      = std::nullopt,
+        .mime          = std::move(mime),
+      });
+    }
+
+    // 到達不能コードのはず
+    std::abort();
+  }
+} // namespace octane::internal
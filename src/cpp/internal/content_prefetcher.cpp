@@ -0,0 +1,143 @@
+/**
+ * @file content_prefetcher.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief content_prefetcher.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/content_prefetcher.h"
+
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief aとbが同じコンテンツを指すかを返す。
+     *
+     */
+    bool isSameContent(const ContentObservation& a,
+                       const ContentObservation& b) {
+      return a.roomId == b.roomId && a.hash == b.hash
+          && a.contentStatus.timestamp == b.contentStatus.timestamp;
+    }
+    bool isSameContent(const std::optional<ContentObservation>& a,
+                       const ContentObservation& b) {
+      return a.has_value() && isSameContent(a.value(), b);
+    }
+  } // namespace
+
+  ContentPrefetcher::ContentPrefetcher(Download download,
+                                       std::uint64_t maxBytes)
+    : download(std::move(download)),
+      maxBytes(maxBytes),
+      stopping(false),
+      worker([this] { run(); }) {}
+
+  ContentPrefetcher::~ContentPrefetcher() noexcept {
+    stop();
+  }
+
+  void ContentPrefetcher::notify(const ContentObservation& observation) {
+    {
+      std::lock_guard lock(mutex);
+      if ((prepared.has_value()
+           && isSameContent(prepared->observation, observation))
+          || isSameContent(running, observation)
+          || isSameContent(pending, observation)) {
+        return;
+      }
+      // 新しいコンテンツが現れたので、覚えている結果も取得中のコンテンツも古い。
+      prepared.reset();
+      if (running.has_value()) {
+        cancellation.cancel();
+      }
+      pending.emplace(observation);
+    }
+    wake.notify_one();
+  }
+
+  void ContentPrefetcher::offer(const ContentObservation& observation,
+                                const Content& content) {
+    if (sizeOf(content) > maxBytes) return;
+    auto shared = std::make_shared<const Content>(content);
+    std::lock_guard lock(mutex);
+    if (isSameContent(running, observation)) {
+      cancellation.cancel();
+    }
+    if (isSameContent(pending, observation)) {
+      pending.reset();
+    }
+    prepared.emplace(Prepared{
+      .observation = observation,
+      .content     = std::move(shared),
+    });
+  }
+
+  std::shared_ptr<const Content> ContentPrefetcher::find(
+    const ContentObservation& observation) const {
+    std::lock_guard lock(mutex);
+    if (prepared.has_value()
+        && isSameContent(prepared->observation, observation)) {
+      return prepared->content;
+    }
+    return nullptr;
+  }
+
+  void ContentPrefetcher::stop() noexcept {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+      cancellation.cancel();
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  std::uint64_t ContentPrefetcher::sizeOf(const Content& content) {
+    return std::visit(
+      [](const auto& data) -> std::uint64_t {
+        using Data = std::decay_t<decltype(data)>;
+        if constexpr (std::is_same_v<Data, std::vector<FileInfo>>) {
+          std::uint64_t size = 0;
+          for (const auto& file : data) {
+            size += file.filename.size() + file.data.size();
+          }
+          return size;
+        } else {
+          return data.size();
+        }
+      },
+      content.data);
+  }
+
+  void ContentPrefetcher::run() {
+    std::unique_lock lock(mutex);
+    while (true) {
+      wake.wait(lock, [this] { return stopping || pending.has_value(); });
+      if (stopping) return;
+      running.swap(pending);
+      pending.reset();
+      cancellation           = CancellationSource();
+      const auto observation = running.value();
+      const auto source      = cancellation;
+      lock.unlock();
+      auto content = download(observation, source);
+      lock.lock();
+      running.reset();
+      // 取得中に新しいコンテンツが通知されたか、呼び出し元が同じものを取得し終えていればキャンセルされている。
+      if (source.isCancelled() || !content) continue;
+      if (sizeOf(content.get()) > maxBytes) continue;
+      prepared.emplace(Prepared{
+        .observation = observation,
+        .content = std::make_shared<const Content>(std::move(content.get())),
+      });
+    }
+  }
+} // namespace octane::internal
@@ -0,0 +1,129 @@
+/**
+ * @file content_watcher.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief content_watcher.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/content_watcher.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "include/content_watch.h"
+#include "include/error_code.h"
+
+namespace octane::internal {
+  ContentWatcher::ContentWatcher(Poll poll,
+                                 Download download,
+                                 Callback callback,
+                                 WatchOptions options)
+    : poll(std::move(poll)),
+      download(std::move(download)),
+      callback(std::move(callback)),
+      options(options),
+      stopping(false),
+      worker([this] { run(); }) {}
+
+  ContentWatcher::~ContentWatcher() noexcept {
+    stop();
+  }
+
+  void ContentWatcher::stop() noexcept {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  std::chrono::milliseconds ContentWatcher::nextInterval(
+    std::chrono::milliseconds interval,
+    const WatchOptions& options) {
+    const auto next = std::chrono::milliseconds(static_cast<std::int64_t>(
+      static_cast<double>(interval.count()) * options.backoffFactor));
+    return std::clamp(next, options.minInterval, options.maxInterval);
+  }
+
+  void ContentWatcher::run() {
+    struct Seen {
+      std::uint64_t roomId;
+      std::string hash;
+      std::uint64_t timestamp;
+
+      bool operator==(const Seen&) const = default;
+    };
+    std::optional<Seen> last;
+    // ハッシュ値が一致せずに取得し直した状態。同じ状態で二度目の不一致は通知する。
+    std::optional<Seen> retried;
+    auto interval = options.minInterval;
+
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+      lock.unlock();
+      auto observed = poll();
+      if (!observed) {
+        callback(error(observed.err()));
+        interval = nextInterval(interval, options);
+      } else {
+        const auto& observation = observed.get();
+        Seen seen{
+          .roomId    = observation.roomId,
+          .hash      = observation.hash,
+          .timestamp = observation.contentStatus.timestamp,
+        };
+        const bool changed
+          = last.has_value() ? last.value() != seen : options.notifyInitial;
+        if (!changed) {
+          // 最初の状態は通知しない場合でも、比較の基準として覚えておく。
+          last.emplace(std::move(seen));
+          interval = nextInterval(interval, options);
+        } else {
+          auto content     = download(observation);
+          interval         = options.minInterval;
+          const bool raced = !content
+                          && content.err().code == ERR_CONTENT_HASH_MISMATCH
+                          && retried != seen;
+          if (raced) {
+            // 状態を取得した後に更新された可能性が高いので、基準を更新せずにすぐ取得し直す。
+            retried.emplace(std::move(seen));
+            interval = std::chrono::milliseconds::zero();
+          } else {
+            last.emplace(std::move(seen));
+            callback(std::move(content));
+          }
+        }
+      }
+      lock.lock();
+      wake.wait_for(lock, interval, [this] { return stopping; });
+    }
+  }
+} // namespace octane::internal
+
+namespace octane {
+  ContentWatch::ContentWatch() noexcept = default;
+  ContentWatch::ContentWatch(std::unique_ptr<internal::ContentWatcher> watcher)
+    : watcher(std::move(watcher)) {}
+  ContentWatch::ContentWatch(ContentWatch&& other) noexcept = default;
+  ContentWatch& ContentWatch::operator=(ContentWatch&& other) noexcept {
+    if (this != &other) {
+      stop();
+      watcher = std::move(other.watcher);
+    }
+    return *this;
+  }
+  ContentWatch::~ContentWatch() noexcept = default;
+
+  void ContentWatch::stop() noexcept {
+    watcher.reset();
+  }
+  bool ContentWatch::isActive() const noexcept {
+    return watcher != nullptr;
+  }
+} // namespace octane
@@ -0,0 +1,70 @@
+/**
+ * @file event_stream.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief event_stream.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/event_stream.h"
+
+namespace octane::internal {
+  void EventStreamParser::feed(
+    std::string_view chunk,
+    const std::function<void(StreamEvent&&)>& onEvent) {
+    for (const char c : chunk) {
+      if (pendingCr) {
+        pendingCr = false;
+        if (c == '\n') continue;
+      }
+      if (c == '\r' || c == '\n') {
+        pendingCr = c == '\r';
+        processLine(onEvent);
+        line.clear();
+      } else {
+        line.push_back(c);
+      }
+    }
+  }
+
+  void EventStreamParser::reset() noexcept {
+    line.clear();
+    current   = StreamEvent{};
+    hasData   = false;
+    pendingCr = false;
+  }
+
+  void EventStreamParser::processLine(
+    const std::function<void(StreamEvent&&)>& onEvent) {
+    // 空行でイベントが完成する。
+    if (line.empty()) {
+      if (hasData) {
+        if (current.event.empty()) current.event = "message";
+        onEvent(std::move(current));
+      }
+      current = StreamEvent{};
+      hasData = false;
+      return;
+    }
+    // コメント
+    if (line.front() == ':') return;
+
+    std::string_view view(line);
+    const auto colon = view.find(':');
+    auto field       = view.substr(0, colon);
+    std::string_view value;
+    if (colon != std::string_view::npos) {
+      value = view.substr(colon + 1);
+      if (value.starts_with(' ')) value.remove_prefix(1);
+    }
+    if (field == "event") {
+      current.event = value;
+    } else if (field == "data") {
+      if (hasData) current.data.push_back('\n');
+      current.data += value;
+      hasData = true;
+    }
+  }
+} // namespace octane::internal
@@ -10,15 +10,220 @@
  */
 #include "include/internal/fetch.h"
 
-#include <rapidjson/error/en.h>
-
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <optional>
 #include <regex>
+#include <span>
 
 #include "include/error_code.h"
 
 namespace octane::internal {
+  namespace {
+    const std::vector<std::uint8_t> EMPTY_BODY;
+    /**
+     * @brief 覚えておく検証子の数の上限。
+     * @details
+     * 検証子はルームごとに増えるので、長く動き続けるクライアントでも際限なく増えないようにする。
+     */
+    constexpr std::size_t MAX_VALIDATORS = 256;
+
+    /**
+     * @brief 304のレスポンスに、送った検証子を補う。
+     * @details
+     * 304はETagを省略でき、Last-Modifiedはふつう含まない。
+     * 呼び出し元がどの結果に対する304かを照合できるように、送った検証子をそのレスポンスの検証子とする。
+     */
+    void completeNotModified(const std::map<std::string, std::string>& headers,
+                             Fetch::FetchResult& result) {
+      if (!result || result.get().statusCode != 304) return;
+      auto& response = result.get();
+      for (const auto& [condition, validator] :
+           { std::pair<std::string_view, std::string_view>{ "If-None-Match",
+                                                            "ETag" },
+             { "If-Modified-Since", "Last-Modified" } }) {
+        const auto sent = headers.find(std::string(condition));
+        if (sent != headers.end() && response.findHeader(validator) == nullptr) {
+          response.header.emplace(validator, sent->second);
+        }
+      }
+    }
+
+    /**
+     * @brief 3xx番台のレスポンスであれば、Locationからリダイレクト先のオリジンとURLを返す。
+     *
+     */
+    std::optional<std::pair<std::string, std::string>> redirectTarget(
+      HttpResponse& response,
+      std::string_view origin) {
+      if (response.statusCode < 300 || 400 <= response.statusCode) {
+        return std::nullopt;
+      }
+      if (response.headerField.find("Location") == response.headerField.end()) {
+        return std::nullopt;
+      }
+      const auto& location = response.headerField["Location"];
+      std::smatch regexResults;
+      if (!std::regex_search(location,
+                             regexResults,
+                             std::regex(R"(^(https?://[^/]+)?(/.*)?)"))) {
+        return std::nullopt;
+      }
+      auto _origin = regexResults[1].str();
+      auto _url    = regexResults[2].str();
+      if (_origin.empty()) _origin = origin;
+      if (_url.empty()) _url = "/";
+      return std::make_pair(std::move(_origin), std::move(_url));
+    }
+
+    /**
+     * @brief HttpClientのレスポンスをFetchのレスポンスに変換する。
+     * @details
+     * observedがtrueであれば、2xxのボディ部はobserverに渡して格納していないので、
+     * Content-Typeに関わらず空のバイナリとする。
+     */
+    FetchBase::FetchResult makeFetchResponse(HttpResponse&& response,
+                                             bool observed = false) {
+      FetchResponse fetchResponse;
+      fetchResponse.statusLine = response.statusLine;
+      fetchResponse.statusCode = response.statusCode;
+      fetchResponse.header     = response.headerField;
+      std::string contentType  = response.headerField["Content-Type"];
+      auto pos                 = contentType.find("; ");
+      fetchResponse.mime       = contentType.substr(0, pos);
+      // curlして返ってきた結果のHTTPヘッダにContent-Type:
+      // application/jsonがあるときにはFetchResponse.bodyにjsonを代入する
+      if (fetchResponse.mime == "application/json"
+          && !(observed && response.statusCode / 100 == 2)) {
+        auto json = parseJson(
+          std::string_view(reinterpret_cast<const char*>(response.body.data()),
+                           response.body.size()));
+        if (!json) {
+          return error(json.err());
+        }
+        fetchResponse.body = std::move(json.get());
+      }
+      //そうでない時にはFetchResponse.bodyにバイナリを代入する
+      else {
+        fetchResponse.body = std::move(response.body);
+      }
+      return ok(std::move(fetchResponse));
+    }
+
+    /**
+     * @brief 2xxのレスポンスのバイナリのボディ部をまとめてobserverに渡し、返り値からは取り除く。
+     *
+     */
+    void observeBody(FetchBase::FetchResult& result,
+                     const BodyObserver& observer) {
+      if (!result || result.get().statusCode / 100 != 2) return;
+      auto& body = result.get().body;
+      if (auto data = std::get_if<std::vector<std::uint8_t>>(&body)) {
+        observer(*data);
+        data->clear();
+        data->shrink_to_fit();
+      }
+    }
+
+    /**
+     * @brief レスポンスに格納された2xxのボディ部をobserverに渡し、responseからは取り除く。
+     * @details
+     * HttpRequest::bodyObserverに対応していないHttpClientもあるので、
+     * 受信中に渡されずに格納された部分は受信し終えてからここで渡す。
+     */
+    void flushObserved(HttpResponse& response, const BodyObserver* observer) {
+      if (observer == nullptr || response.statusCode / 100 != 2) return;
+      if (!response.body.empty()) {
+        (*observer)(response.body);
+        response.body.clear();
+        response.body.shrink_to_fit();
+      }
+    }
+  } // namespace
+
+  const std::string* FetchResponse::findHeader(std::string_view name) const {
+    const auto it
+      = std::find_if(header.begin(), header.end(), [&](const auto& field) {
+          return std::equal(field.first.begin(),
+                            field.first.end(),
+                            name.begin(),
+                            name.end(),
+                            [](unsigned char a, unsigned char b) {
+                              return std::tolower(a) == std::tolower(b);
+                            });
+        });
+    return it == header.end() ? nullptr : &it->second;
+  }
+
   FetchBase::~FetchBase() {}
+  Task<FetchBase::FetchResult> FetchBase::requestAsync(AsyncContext context,
+                                                       HttpMethod method,
+                                                       std::string url) {
+    if (context.token.isCancelled()) {
+      co_return makeError(ERR_CANCELLED, "The request was cancelled.");
+    }
+    co_return request(method, url);
+  }
+  Task<FetchBase::FetchResult> FetchBase::requestAsync(AsyncContext context,
+                                                       HttpMethod method,
+                                                       std::string url,
+                                                       Json body) {
+    if (context.token.isCancelled()) {
+      co_return makeError(ERR_CANCELLED, "The request was cancelled.");
+    }
+    co_return request(method, url, body);
+  }
+  Task<FetchBase::FetchResult> FetchBase::requestAsync(
+    AsyncContext context,
+    HttpMethod method,
+    std::string url,
+    std::string mimeType,
+    std::span<const std::uint8_t> body) {
+    if (context.token.isCancelled()) {
+      co_return makeError(ERR_CANCELLED, "The request was cancelled.");
+    }
+    co_return request(method, url, mimeType, body);
+  }
+  FetchBase::FetchResult FetchBase::request(HttpMethod method,
+                                            std::string_view url,
+                                            std::string_view mimeType,
+                                            std::span<const std::uint8_t> body) {
+    return request(
+      method, url, mimeType, std::vector<std::uint8_t>(body.begin(), body.end()));
+  }
+  FetchBase::FetchResult FetchBase::stream(
+    std::string_view,
+    CancellationToken,
+    const HttpClientBase::StreamCallback&) {
+    return makeError(ERR_EVENT_STREAM_UNAVAILABLE,
+                     "This fetch does not support event streams.");
+  }
+  FetchBase::FetchResult FetchBase::download(std::string_view url,
+                                             const BodyObserver& observer) {
+    auto result = request(HttpMethod::Get, url);
+    observeBody(result, observer);
+    return result;
+  }
+  Task<FetchBase::FetchResult> FetchBase::downloadAsync(
+    AsyncContext context,
+    std::string url,
+    const BodyObserver& observer) {
+    auto result
+      = co_await requestAsync(std::move(context), HttpMethod::Get, std::move(url));
+    observeBody(result, observer);
+    co_return std::move(result);
+  }
+  FetchBase::FetchResult FetchBase::revalidate(std::string_view url) {
+    return request(HttpMethod::Get, url);
+  }
+  Task<FetchBase::FetchResult> FetchBase::revalidateAsync(AsyncContext context,
+                                                          std::string url) {
+    co_return co_await requestAsync(
+      std::move(context), HttpMethod::Get, std::move(url));
+  }
+  void FetchBase::forgetValidators(std::string_view) {}
+
   Fetch::Fetch(std::string_view token,
                std::string_view origin,
                std::string_view baseUrl,
@@ -38,21 +243,14 @@ namespace octane::internal {
   }
   Fetch::FetchResult Fetch::request(HttpMethod method,
                                     std::string_view url,
-                                    const rapidjson::Document& body) {
+                                    const Json& body) {
     if (method != HttpMethod::Post && method != HttpMethod::Put) {
       return makeError(
         ERR_INCORRECT_HTTP_METHOD,
         "Only Post and Put requests are allowed for requests with a body parts.");
     }
-    std::vector<std::uint8_t> decoded;
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    body.Accept(writer);
-
-    decoded.resize(buffer.GetSize());
-    std::copy(buffer.GetString(),
-              buffer.GetString() + buffer.GetSize(),
-              decoded.begin());
+    const auto text = body.stringify();
+    std::vector<std::uint8_t> decoded(text.begin(), text.end());
 
     return request(method,
                    origin,
@@ -65,6 +263,12 @@ namespace octane::internal {
                                     std::string_view url,
                                     std::string_view mimeType,
                                     const std::vector<std::uint8_t>& body) {
+    return request(method, url, mimeType, std::span<const std::uint8_t>(body));
+  }
+  Fetch::FetchResult Fetch::request(HttpMethod method,
+                                    std::string_view url,
+                                    std::string_view mimeType,
+                                    std::span<const std::uint8_t> body) {
     if (method != HttpMethod::Post && method != HttpMethod::Put) {
       return makeError(
         ERR_INCORRECT_HTTP_METHOD,
@@ -82,13 +286,15 @@ namespace octane::internal {
     std::string_view origin,
     std::string_view url,
     const std::map<std::string, std::string>& headers,
-    const std::vector<std::uint8_t>& body) {
+    std::span<const std::uint8_t> body,
+    const BodyObserver* observer) {
     HttpRequest request{
-      .method      = method,
-      .version     = HttpVersion::Http2,
-      .uri         = std::string(url),
-      .headerField = headers,
-      .body        = &body,
+      .method       = method,
+      .version      = HttpVersion::Http2,
+      .uri          = std::string(url),
+      .headerField  = headers,
+      .body         = body,
+      .bodyObserver = observer,
     };
     auto result = client->request(origin, request);
     if (!result) {
@@ -96,47 +302,224 @@ namespace octane::internal {
     }
 
     auto& response = result.get();
-    if (300 <= response.statusCode && response.statusCode < 400) {
-      if (response.headerField.find("Location") != response.headerField.end()) {
-        const auto& location = response.headerField["Location"];
-        std::smatch regexResults;
-        if (std::regex_search(location,
-                              regexResults,
-                              std::regex(R"(^(https?://[^/]+)?(/.*)?)"))) {
-          auto _origin = regexResults[1].str();
-          auto _url    = regexResults[2].str();
-          if (_origin.empty()) _origin = origin;
-          if (_url.empty()) _url = "/";
-          return this->request(method, _origin, _url, headers, body);
-        }
+    if (auto target = redirectTarget(response, origin)) {
+      return this->request(
+        method, target->first, target->second, headers, body, observer);
+    }
+    flushObserved(response, observer);
+    return makeFetchResponse(std::move(response), observer != nullptr);
+  }
+  Fetch::FetchResult Fetch::download(std::string_view url,
+                                     const BodyObserver& observer) {
+    return request(HttpMethod::Get,
+                   origin,
+                   baseUrl + std::string(url),
+                   { { "X-Octane-API-Token", token } },
+                   EMPTY_BODY,
+                   &observer);
+  }
+
+  Task<Fetch::FetchResult> Fetch::requestAsync(AsyncContext context,
+                                               HttpMethod method,
+                                               std::string url) {
+    // GCCはco_awaitの引数に書いた初期化子リストを正しく扱えないので、一度変数に受ける。
+    std::map<std::string, std::string> headers{ { "X-Octane-API-Token",
+                                                  token } };
+    co_return co_await requestAsync(std::move(context),
+                                    method,
+                                    origin,
+                                    baseUrl + url,
+                                    std::move(headers),
+                                    EMPTY_BODY);
+  }
+  Task<Fetch::FetchResult> Fetch::requestAsync(AsyncContext context,
+                                               HttpMethod method,
+                                               std::string url,
+                                               Json body) {
+    if (method != HttpMethod::Post && method != HttpMethod::Put) {
+      co_return makeError(
+        ERR_INCORRECT_HTTP_METHOD,
+        "Only Post and Put requests are allowed for requests with a body parts.");
+    }
+    const auto text = body.stringify();
+    const std::vector<std::uint8_t> encoded(text.begin(), text.end());
+
+    std::map<std::string, std::string> headers{
+      { "X-Octane-API-Token", token },
+      { "Content-Type", "application/json" },
+    };
+    co_return co_await requestAsync(std::move(context),
+                                    method,
+                                    origin,
+                                    baseUrl + url,
+                                    std::move(headers),
+                                    encoded);
+  }
+  Task<Fetch::FetchResult> Fetch::requestAsync(
+    AsyncContext context,
+    HttpMethod method,
+    std::string url,
+    std::string mimeType,
+    std::span<const std::uint8_t> body) {
+    if (method != HttpMethod::Post && method != HttpMethod::Put) {
+      co_return makeError(
+        ERR_INCORRECT_HTTP_METHOD,
+        "Only Post and Put requests are allowed for requests with a body parts.");
+    }
+    std::map<std::string, std::string> headers{
+      { "X-Octane-API-Token", token },
+      { "Content-Type", std::move(mimeType) },
+    };
+    co_return co_await requestAsync(std::move(context),
+                                    method,
+                                    origin,
+                                    baseUrl + url,
+                                    std::move(headers),
+                                    body);
+  }
+  Task<Fetch::FetchResult> Fetch::requestAsync(
+    AsyncContext context,
+    HttpMethod method,
+    std::string origin,
+    std::string url,
+    std::map<std::string, std::string> headers,
+    std::span<const std::uint8_t> body,
+    const BodyObserver* observer) {
+    const HttpRequest request{
+      .method       = method,
+      .version      = HttpVersion::Http2,
+      .uri          = url,
+      .headerField  = headers,
+      .body         = body,
+      .bodyObserver = observer,
+    };
+    auto result = co_await HttpRequestAwaiter(client, origin, request, context);
+    if (!result) {
+      co_return error(result.err());
+    }
+
+    auto& response = result.get();
+    if (auto target = redirectTarget(response, origin)) {
+      co_return co_await requestAsync(std::move(context),
+                                      method,
+                                      std::move(target->first),
+                                      std::move(target->second),
+                                      std::move(headers),
+                                      body,
+                                      observer);
+    }
+    flushObserved(response, observer);
+    co_return makeFetchResponse(std::move(response), observer != nullptr);
+  }
+  Task<Fetch::FetchResult> Fetch::downloadAsync(AsyncContext context,
+                                                std::string url,
+                                                const BodyObserver& observer) {
+    std::map<std::string, std::string> headers{ { "X-Octane-API-Token",
+                                                  token } };
+    co_return co_await requestAsync(std::move(context),
+                                    HttpMethod::Get,
+                                    origin,
+                                    baseUrl + url,
+                                    std::move(headers),
+                                    EMPTY_BODY,
+                                    &observer);
+  }
+
+  Fetch::FetchResult Fetch::revalidate(std::string_view url) {
+    const auto target  = baseUrl + std::string(url);
+    const auto headers = conditionalHeaders(target);
+    auto result        = request(HttpMethod::Get, origin, target, headers, {});
+    rememberValidators(target, result);
+    completeNotModified(headers, result);
+    return result;
+  }
+  Task<Fetch::FetchResult> Fetch::revalidateAsync(AsyncContext context,
+                                                  std::string url) {
+    auto target  = baseUrl + url;
+    auto headers = conditionalHeaders(target);
+    auto result  = co_await requestAsync(
+      std::move(context), HttpMethod::Get, origin, target, headers, EMPTY_BODY);
+    rememberValidators(target, result);
+    completeNotModified(headers, result);
+    co_return std::move(result);
+  }
+  void Fetch::forgetValidators(std::string_view url) {
+    std::lock_guard lock(validatorsMutex);
+    eraseValidators(baseUrl + std::string(url));
+  }
+  std::map<std::string, std::string> Fetch::conditionalHeaders(
+    const std::string& url) {
+    std::map<std::string, std::string> headers{ { "X-Octane-API-Token",
+                                                  token } };
+    std::lock_guard lock(validatorsMutex);
+    if (auto it = validators.find(url); it != validators.end()) {
+      if (!it->second.etag.empty()) {
+        headers.emplace("If-None-Match", it->second.etag);
+      }
+      if (!it->second.lastModified.empty()) {
+        headers.emplace("If-Modified-Since", it->second.lastModified);
       }
     }
+    return headers;
+  }
+  void Fetch::rememberValidators(const std::string& url,
+                                 const FetchResult& result) {
+    // 304は前回の検証子がまだ有効であることを示すだけなので、覚え直さない。
+    if (!result || result.get().statusCode / 100 != 2) return;
+    const auto etag         = result.get().findHeader("ETag");
+    const auto lastModified = result.get().findHeader("Last-Modified");
 
-    FetchResponse fetchResponse;
-    fetchResponse.statusLine = response.statusLine;
-    fetchResponse.statusCode = response.statusCode;
-    fetchResponse.header     = response.headerField;
-    std::string contentType  = response.headerField["Content-Type"];
-    auto pos                 = contentType.find("; ");
-    fetchResponse.mime       = contentType.substr(0, pos);
-    // curlして返ってきた結果のHTTPヘッダにContent-Type:
-    // application/jsonがあるときにはFetchResponse.bodyにjsonを代入する
-    if (fetchResponse.mime == "application/json") {
-      rapidjson::Document json;
-      json.Parse((char*)response.body.data(), response.body.size());
-      if (json.HasParseError()) {
-        const auto offset  = json.GetErrorOffset();
-        const auto message = rapidjson::GetParseError_En(json.GetParseError());
-        return makeError(
-          ERR_JSON_PARSE_FAILED,
-          message + std::string("\noffset: ") + std::to_string(offset));
+    std::lock_guard lock(validatorsMutex);
+    if (etag == nullptr && lastModified == nullptr) {
+      eraseValidators(url);
+      return;
+    }
+    if (!validators.contains(url)) {
+      if (validators.size() >= MAX_VALIDATORS) {
+        validators.erase(validatorOrder.front());
+        validatorOrder.pop_front();
       }
-      fetchResponse.body = std::move(json);
+      validatorOrder.push_back(url);
     }
-    //そうでない時にはFetchResponse.bodyにバイナリを代入する
-    else {
-      fetchResponse.body = std::move(response.body);
+    validators[url] = Validators{
+      .etag         = etag != nullptr ? *etag : "",
+      .lastModified = lastModified != nullptr ? *lastModified : "",
+    };
+  }
+  void Fetch::eraseValidators(const std::string& url) {
+    if (validators.erase(url) > 0) {
+      std::erase(validatorOrder, url);
+    }
+  }
+
+  Fetch::FetchResult Fetch::stream(
+    std::string_view url,
+    CancellationToken token,
+    const HttpClientBase::StreamCallback& onData) {
+    return stream(origin, baseUrl + std::string(url), token, onData);
+  }
+  Fetch::FetchResult Fetch::stream(
+    std::string_view origin,
+    std::string_view url,
+    const CancellationToken& token,
+    const HttpClientBase::StreamCallback& onData) {
+    HttpRequest request{
+      .method      = HttpMethod::Get,
+      .version     = HttpVersion::Http2,
+      .uri         = std::string(url),
+      .headerField = { { "X-Octane-API-Token", this->token },
+                       { "Accept", "text/event-stream" } },
+      .body        = {},
+    };
+    auto result = client->stream(origin, request, token, onData);
+    if (!result) {
+      return error(result.err());
+    }
+
+    auto& response = result.get();
+    if (auto target = redirectTarget(response, origin)) {
+      return stream(target->first, target->second, token, onData);
     }
-    return ok(std::move(fetchResponse));
+    return makeFetchResponse(std::move(response));
   }
 } // namespace octane::internal
\ No newline at end of file
@@ -31,14 +31,30 @@ namespace octane::internal {
     }
     return ans;
   }
-  std::string generateHash(const std::vector<std::uint8_t>& src) {
-    std::vector<std::uint8_t> digest;
+  std::string generateHash(std::span<const std::uint8_t> src) {
+    Hasher hasher;
+    hasher.update(src);
+    return hasher.finish();
+  }
+
+  struct Hasher::State {
+    CryptoPP::BLAKE2b blake2;
 
-    CryptoPP::BLAKE2b blake2(32u);
-    blake2.Update(src.data(), src.size());
-    digest.resize(blake2.DigestSize());
-    blake2.Final(digest.data());
+    State() : blake2(32u) {}
+  };
+  Hasher::Hasher() : state(std::make_unique<State>()) {}
+  Hasher::Hasher(Hasher&& other) noexcept = default;
+  Hasher& Hasher::operator=(Hasher&& other) noexcept = default;
+  Hasher::~Hasher() noexcept = default;
 
+  void Hasher::update(std::span<const std::uint8_t> data) {
+    state->blake2.Update(data.data(), data.size());
+  }
+  std::string Hasher::finish() {
+    std::vector<std::uint8_t> digest;
+    // Finalは内部の状態を初期化するので、続けて別のデータに使える。
+    digest.resize(state->blake2.DigestSize());
+    state->blake2.Final(digest.data());
     return convToHex(digest);
   }
 } // namespace octane::internal
\ No newline at end of file
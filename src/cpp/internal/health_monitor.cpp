@@ -0,0 +1,173 @@
+/**
+ * @file health_monitor.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief health_monitor.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/health_monitor.h"
+
+#include <cstdlib>
+#include <map>
+#include <string>
+
+#include "include/error_code.h"
+
+namespace octane::internal {
+  HealthMonitor::HealthMonitor(Probe probe, HealthMonitorOptions options)
+    : probe(std::move(probe)),
+      options(options),
+      snapshot(nullptr),
+      stopping(false),
+      worker(options.backgroundRefresh ? std::thread([this] { run(); })
+                                       : std::thread()) {}
+
+  HealthMonitor::~HealthMonitor() noexcept {
+    {
+      std::lock_guard lock(wakeMutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  Result<HealthResult, ErrorResponse> HealthMonitor::current() {
+    if (auto state = load();
+        state && Clock::now() < state->expiresAt) {
+      return ok(state->health);
+    }
+
+    std::lock_guard lock(refreshMutex);
+    // 待っている間に他のスレッドが更新しているかもしれない。
+    if (auto state = load();
+        state && Clock::now() < state->expiresAt) {
+      return ok(state->health);
+    }
+    return refreshLocked();
+  }
+
+  std::shared_ptr<const HealthMonitor::Snapshot> HealthMonitor::peek()
+    const noexcept {
+    return load();
+  }
+  void HealthMonitor::update(const Result<HealthResult, ErrorResponse>& result) {
+    apply(result);
+  }
+
+  std::shared_ptr<HealthMonitor> HealthMonitor::shared(
+    std::string_view key,
+    const std::function<Probe()>& makeProbe) {
+    struct Registry {
+      std::mutex mutex;
+      std::map<std::string, std::weak_ptr<HealthMonitor>, std::less<>> monitors;
+    };
+    // NOTE: 静的変数として持つとApiClientのデストラクタより先に破棄されてしまうため、
+    // 意図的に解放しない。
+    static auto registry = new Registry();
+
+    std::lock_guard lock(registry->mutex);
+    if (auto itr = registry->monitors.find(key);
+        itr != registry->monitors.end()) {
+      if (auto monitor = itr->second.lock()) {
+        return monitor;
+      }
+    }
+    std::erase_if(registry->monitors,
+                  [](const auto& entry) { return entry.second.expired(); });
+    auto monitor = std::make_shared<HealthMonitor>(makeProbe());
+    registry->monitors.insert_or_assign(std::string(key), monitor);
+    return monitor;
+  }
+
+  Result<HealthResult, ErrorResponse> HealthMonitor::refreshLocked() {
+    auto result = probe();
+    apply(result);
+    return result;
+  }
+  void HealthMonitor::apply(const Result<HealthResult, ErrorResponse>& result) {
+    const auto now = Clock::now();
+    if (result) {
+      const auto& health = result.get();
+      auto next          = std::make_shared<Snapshot>(Snapshot{
+                 .health    = health,
+                 .checkedAt = now,
+      });
+      if (health.health == Health::Healthy) {
+        next->expiresAt     = now + options.ttl;
+        next->nextRefreshAt = next->expiresAt - options.refreshAhead;
+      } else if (health.health == Health::Degraded) {
+        next->expiresAt     = now + options.ttl;
+        next->nextRefreshAt = now + options.degradedInterval;
+      } else {
+        // Faultyの結果は短い間だけ保持し、APIへの無駄なリクエストを抑える。
+        next->expiresAt     = now + options.degradedInterval;
+        next->nextRefreshAt = next->expiresAt;
+      }
+      store(std::move(next));
+    } else if (auto prev = load()) {
+      auto next           = std::make_shared<Snapshot>(*prev);
+      next->nextRefreshAt = now + options.retryInterval;
+      store(std::move(next));
+    }
+  }
+
+  std::shared_ptr<const HealthMonitor::Snapshot> HealthMonitor::load() const {
+    return snapshot.load(std::memory_order_acquire);
+  }
+  void HealthMonitor::store(std::shared_ptr<const Snapshot> next) {
+    snapshot.store(std::move(next), std::memory_order_release);
+    // wakeMutexを経由することで、バックグラウンドのスレッドが通知を取りこぼさないようにする。
+    { std::lock_guard lock(wakeMutex); }
+    wake.notify_all();
+  }
+
+  void HealthMonitor::run() {
+    std::unique_lock lock(wakeMutex);
+    while (!stopping) {
+      const auto state = load();
+      if (!state) {
+        // 最初の結果は呼び出し元のスレッドで得られるのを待つ。
+        wake.wait(lock, [&] {
+          return stopping || load();
+        });
+        continue;
+      }
+      const bool changed = wake.wait_until(lock, state->nextRefreshAt, [&] {
+        return stopping || load() != state;
+      });
+      if (changed) continue;
+
+      lock.unlock();
+      {
+        std::lock_guard refresh(refreshMutex);
+        // 待っている間に呼び出し元のスレッドが更新していれば何もしない。
+        if (load() == state) {
+          [[maybe_unused]] auto result = refreshLocked();
+        }
+      }
+      lock.lock();
+    }
+  }
+
+  Result<HealthResult, ErrorResponse> verifyHealth(
+    Result<HealthResult, ErrorResponse> result) {
+    if (!result) {
+      return error(result.err());
+    }
+
+    const auto& [health, message] = result.get();
+    if (health == Health::Faulty) {
+      return makeError(ERR_SERVER_HEALTH_STATUS_FAULTY, message.value_or(""));
+    }
+
+    if (health != Health::Healthy && health != Health::Degraded) {
+      std::abort();
+    }
+    return result;
+  }
+} // namespace octane::internal
@@ -17,8 +17,14 @@
 #include <curl/curl.h>
 
 #include <algorithm>
+#include <charconv>
 #include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <thread>
 
 #include "include/error_code.h"
 
@@ -123,8 +129,146 @@ namespace octane::internal {
       return 0;
     }
   } // namespace
+  struct HttpClient::Connections {
+    /** @brief idleとidleMultiplexedを保護するミューテックス。*/
+    std::mutex mutex;
+    /** @brief 使用されていない、同期のリクエストに使うハンドル。自身の接続を持つ。*/
+    std::vector<CURL*> idle;
+    /** @brief 使用されていない、マルチハンドルで通信するハンドル。*/
+    std::vector<CURL*> idleMultiplexed;
+
+    std::vector<CURL*>& poolOf(bool multiplexed) {
+      return multiplexed ? idleMultiplexed : idle;
+    }
+    /** @brief ハンドル間で共有するキャッシュ。*/
+    CURLSH* share = nullptr;
+    /** @brief 共有するデータの種類ごとのロック。*/
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+
+    static void lock(CURL*, curl_lock_data data, curl_lock_access, void* ptr) {
+      static_cast<Connections*>(ptr)->locks[data].lock();
+    }
+    static void unlock(CURL*, curl_lock_data data, void* ptr) {
+      static_cast<Connections*>(ptr)->locks[data].unlock();
+    }
+  };
+
+  /**
+   * @brief 一つのリクエストに必要なデータをまとめた構造体。
+   * @details
+   * CURLのオプションはこの構造体のメンバを指すため、通信が終わるまで移動してはならない。
+   * 破棄するとハンドルをプールに返す。
+   */
+  struct HttpClient::Transfer {
+    HttpClient* owner;
+    /** @brief マルチハンドルで通信するか。*/
+    bool multiplexed    = false;
+    CURL* handle        = nullptr;
+    curl_slist* headers = nullptr;
+    std::string uri;
+    /** @brief PUTメソッドで送信するボディ部と、送信済みのバイト数。*/
+    std::pair<std::span<const std::uint8_t>, size_t> upload;
+    HttpResponse response;
+    /** @brief 受信しながらボディ部を渡す関数。*/
+    const BodyObserver* observer = nullptr;
+    CancellationToken token;
+    RequestCallback callback;
+
+    explicit Transfer(HttpClient* owner) : owner(owner), upload({}, 0) {}
+    ~Transfer() noexcept {
+      curl_slist_free_all(headers);
+      owner->release(handle, multiplexed);
+    }
+  };
+  struct HttpClient::Multi {
+    /** @brief handleの作成とpending、stoppingを保護するミューテックス。*/
+    std::mutex mutex;
+    CURLM* handle = nullptr;
+    std::thread thread;
+    /** @brief I/Oスレッドにまだ渡されていないリクエスト。*/
+    std::vector<std::unique_ptr<Transfer>> pending;
+    bool stopping = false;
+    /**
+     * @brief 通信を駆動するイベントループ。
+     * @details
+     * nullptrでない場合はI/Oスレッドを作成せず、以下のメンバはイベントループのスレッドからのみ触れる。
+     */
+    EventLoop* loop = nullptr;
+    /** @brief イベントループで通信中のリクエスト。*/
+    std::map<CURL*, std::unique_ptr<Transfer>> running;
+  };
+
   HttpClientBase::~HttpClientBase() {}
+  void HttpClientBase::requestAsync(std::string_view origin,
+                                    const HttpRequest& request,
+                                    CancellationToken token,
+                                    RequestCallback callback) {
+    if (token.isCancelled()) {
+      callback(makeError(ERR_CANCELLED, "The request was cancelled."));
+      return;
+    }
+    callback(this->request(origin, request));
+  }
+  Result<HttpResponse, ErrorResponse> HttpClientBase::stream(
+    std::string_view origin,
+    const HttpRequest& request,
+    CancellationToken token,
+    const StreamCallback& onData) {
+    if (token.isCancelled()) {
+      return makeError(ERR_CANCELLED, "The request was cancelled.");
+    }
+    auto result = this->request(origin, request);
+    if (!result) return result;
+    auto& response = result.get();
+    if (response.statusCode / 100 == 2) {
+      onData(std::string_view(reinterpret_cast<const char*>(response.body.data()),
+                              response.body.size()));
+      response.body.clear();
+    }
+    return result;
+  }
+
+  HttpClient::HttpClient()
+    : connections(std::make_unique<Connections>()),
+      multi(std::make_unique<Multi>()) {}
+  HttpClient::HttpClient(EventLoop& loop) : HttpClient() {
+    multi->loop = &loop;
+  }
   HttpClient::~HttpClient() {
+    if (multi->loop != nullptr) {
+      // 残っているリクエストはキャンセル扱いで完了させる。
+      // コールバックの中で発行されたリクエストも受け付けずにキャンセルする。
+      multi->stopping = true;
+      auto running = std::move(multi->running);
+      for (auto& [handle, transfer] : running) {
+        curl_multi_remove_handle(multi->handle, handle);
+        complete(std::move(transfer),
+                 makeError(ERR_CANCELLED, "The request was cancelled."));
+      }
+      if (multi->handle != nullptr) {
+        multi->loop->setTimer(std::nullopt);
+        curl_multi_cleanup(multi->handle);
+      }
+    } else if (multi->handle != nullptr) {
+      // 通信中のリクエストがハンドルを持っているので、先にI/Oスレッドを止める。
+      {
+        std::lock_guard lock(multi->mutex);
+        multi->stopping = true;
+      }
+      curl_multi_wakeup(multi->handle);
+      multi->thread.join();
+      curl_multi_cleanup(multi->handle);
+    }
+    // 共有キャッシュは全てのハンドルを解放した後に解放しなければならない。
+    for (auto handle : connections->idle) {
+      curl_easy_cleanup(handle);
+    }
+    for (auto handle : connections->idleMultiplexed) {
+      curl_easy_cleanup(handle);
+    }
+    if (connections->share != nullptr) {
+      curl_share_cleanup(connections->share);
+    }
     curl_global_cleanup();
   }
   Result<_, ErrorResponse> HttpClient::init() noexcept {
@@ -133,17 +277,213 @@ namespace octane::internal {
       return makeError(ERR_CURL_INITIALIZATION_FAILED,
                        curl_easy_strerror(code));
     }
+    // 共有キャッシュは最適化なので、作成できなくても通信はできる。
+    if (auto share = curl_share_init()) {
+      curl_share_setopt(share, CURLSHOPT_LOCKFUNC, Connections::lock);
+      curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, Connections::unlock);
+      curl_share_setopt(share, CURLSHOPT_USERDATA, connections.get());
+      // 接続のキャッシュは同時に通信するハンドル間で共有できないので、
+      // ハンドル自身(とマルチハンドル)のキャッシュに任せる。
+      curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+      curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+      connections->share = share;
+    }
+    // イベントループで駆動する場合は、ソケットの監視をイベントループに任せる。
+    if (multi->loop != nullptr) {
+      multi->handle = curl_multi_init();
+      if (multi->handle == nullptr) {
+        return makeError(ERR_CURL_INITIALIZATION_FAILED, "curl_multi is nullptr");
+      }
+      curl_multi_setopt(multi->handle, CURLMOPT_SOCKETFUNCTION, socketCallback);
+      curl_multi_setopt(multi->handle, CURLMOPT_SOCKETDATA, this);
+    }
     return ok();
   }
 
   Result<HttpResponse, ErrorResponse> HttpClient::request(
     std::string_view origin,
     const HttpRequest& request) {
-    // CURLの初期化。ふつうは失敗しないはず。
-    const auto curl = curl_easy_init();
-    if (curl == nullptr) {
-      return makeError(ERR_CURL_INITIALIZATION_FAILED, "curl is nullptr");
+    Transfer transfer(this);
+    if (auto err = prepare(transfer, origin, request)) {
+      return error(err.value());
     }
+    // 期限は通信中に設定されることもあるので、CURLに渡さずに進捗のたびに確かめる。
+    struct Deadline {
+      const std::atomic<long>* timeoutMs;
+      std::chrono::steady_clock::time_point start;
+
+      static int progress(Deadline* deadline,
+                          curl_off_t,
+                          curl_off_t,
+                          curl_off_t,
+                          curl_off_t) {
+        // 0以外を返すと通信が中断される。CURLは少なくとも1秒ごとに呼び出す。
+        const auto timeout
+          = deadline->timeoutMs->load(std::memory_order_relaxed);
+        return timeout > 0
+                   && std::chrono::steady_clock::now() - deadline->start
+                        >= std::chrono::milliseconds(timeout)
+                 ? 1
+                 : 0;
+      }
+    } deadline{ .timeoutMs = &timeoutMs,
+                .start     = std::chrono::steady_clock::now() };
+    curl_easy_setopt(transfer.handle, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(
+      transfer.handle, CURLOPT_XFERINFOFUNCTION, Deadline::progress);
+    curl_easy_setopt(transfer.handle, CURLOPT_XFERINFODATA, &deadline);
+    // 通信を開始する。
+    const CURLcode code = curl_easy_perform(transfer.handle);
+    return finish(transfer, code);
+  }
+
+  void HttpClient::requestAsync(std::string_view origin,
+                                const HttpRequest& request,
+                                CancellationToken token,
+                                RequestCallback callback) {
+    if (token.isCancelled()) {
+      callback(makeError(ERR_CANCELLED, "The request was cancelled."));
+      return;
+    }
+    auto transfer         = std::make_unique<Transfer>(this);
+    transfer->multiplexed = true;
+    if (auto err = prepare(*transfer, origin, request)) {
+      transfer.reset();
+      callback(error(err.value()));
+      return;
+    }
+    transfer->token    = std::move(token);
+    transfer->callback = std::move(callback);
+
+    if (multi->loop != nullptr) {
+      if (multi->stopping) {
+        complete(std::move(transfer),
+                 makeError(ERR_CANCELLED, "The request was cancelled."));
+        return;
+      }
+      if (multi->handle == nullptr) {
+        complete(
+          std::move(transfer),
+          makeError(ERR_CURL_INITIALIZATION_FAILED, "curl_multi is nullptr"));
+        return;
+      }
+      const auto handle = transfer->handle;
+      curl_multi_add_handle(multi->handle, handle);
+      multi->running.emplace(handle, std::move(transfer));
+      // 通信はイベントループのタイマーが満了したときに開始される。
+      armLoopTimer();
+      return;
+    }
+
+    bool queued = false;
+    {
+      std::lock_guard lock(multi->mutex);
+      // I/Oスレッドは最初の非同期リクエストで作成する。
+      if (multi->handle == nullptr) {
+        multi->handle = curl_multi_init();
+        if (multi->handle != nullptr) {
+          multi->thread = std::thread([this] { runLoop(); });
+        }
+      }
+      if (multi->handle != nullptr && !multi->stopping) {
+        multi->pending.push_back(std::move(transfer));
+        queued = true;
+      }
+    }
+    if (!queued) {
+      auto failed = std::move(transfer->callback);
+      transfer.reset();
+      failed(makeError(ERR_CURL_INITIALIZATION_FAILED, "curl_multi is nullptr"));
+      return;
+    }
+    curl_multi_wakeup(multi->handle);
+  }
+
+  Result<HttpResponse, ErrorResponse> HttpClient::stream(
+    std::string_view origin,
+    const HttpRequest& request,
+    CancellationToken token,
+    const StreamCallback& onData) {
+    if (token.isCancelled()) {
+      return makeError(ERR_CANCELLED, "The request was cancelled.");
+    }
+    Transfer transfer(this);
+    if (auto err = prepare(transfer, origin, request)) {
+      return error(err.value());
+    }
+    transfer.token = std::move(token);
+
+    struct Receiver {
+      Transfer* transfer;
+      const StreamCallback* onData;
+      /** @brief onDataが受信を打ち切ったかどうか。*/
+      bool stopped = false;
+
+      static size_t write(char* buffer,
+                          size_t size,
+                          size_t nmemb,
+                          Receiver* receiver) {
+        long status = 0;
+        curl_easy_getinfo(
+          receiver->transfer->handle, CURLINFO_RESPONSE_CODE, &status);
+        // エラーのレスポンスはふつうのリクエストと同様に溜めておく。
+        if (status / 100 != 2) {
+          return writeCallback(
+            buffer, size, nmemb, &receiver->transfer->response);
+        }
+        if (!(*receiver->onData)(std::string_view(buffer, size * nmemb))) {
+          receiver->stopped = true;
+          return 0;
+        }
+        return size * nmemb;
+      }
+      static int progress(Receiver* receiver,
+                          curl_off_t,
+                          curl_off_t,
+                          curl_off_t,
+                          curl_off_t) {
+        // 0以外を返すと通信が中断される。CURLは少なくとも1秒ごとに呼び出すので、
+        // データが届かない間のキャンセルもその間隔で検出される。
+        return receiver->transfer->token.isCancelled() ? 1 : 0;
+      }
+    } receiver{ .transfer = &transfer, .onData = &onData };
+
+    const auto curl = transfer.handle;
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Receiver::write);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &receiver);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, Receiver::progress);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &receiver);
+
+    const CURLcode code = curl_easy_perform(curl);
+    if (code == CURLE_ABORTED_BY_CALLBACK) {
+      return makeError(ERR_CANCELLED, "The request was cancelled.");
+    }
+    // onDataが打ち切った場合は書き込みエラーになるが、正常な終了として扱う。
+    return finish(transfer,
+                  receiver.stopped && code == CURLE_WRITE_ERROR ? CURLE_OK
+                                                                : code);
+  }
+
+  std::optional<ErrorResponse> HttpClient::prepare(
+    Transfer& transfer,
+    std::string_view origin,
+    const HttpRequest& request) {
+    const bool hasBody = !request.body.empty();
+    if ((request.method == HttpMethod::Get
+         || request.method == HttpMethod::Delete)
+        && hasBody) {
+      return ErrorResponse{ .code   = ERR_INCORRECT_HTTP_METHOD,
+                            .reason = "Request body must be empty." };
+    }
+
+    // プールからハンドルを借りる。ふつうは失敗しないはず。
+    transfer.handle = static_cast<CURL*>(acquire(transfer.multiplexed));
+    if (transfer.handle == nullptr) {
+      return ErrorResponse{ .code   = ERR_CURL_INITIALIZATION_FAILED,
+                            .reason = "curl is nullptr" };
+    }
+    const auto curl = transfer.handle;
 
 #ifndef NDEBUG
     // struct data config;
@@ -155,91 +495,341 @@ namespace octane::internal {
 #endif // #ifndef NDEBUG
 
     // HTTPヘッダを定義する。
-    curl_slist* list = nullptr;
     for (const auto& [key, value] : request.headerField) {
-      list = curl_slist_append(list, (key + ": " + value).c_str());
+      transfer.headers
+        = curl_slist_append(transfer.headers, (key + ": " + value).c_str());
     }
-    list = curl_slist_append(list, "Expect:");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, list);
+    transfer.headers = curl_slist_append(transfer.headers, "Expect:");
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
 
     // PUTメソッド用
-    std::pair<const std::vector<std::uint8_t>*, size_t> pair(request.body, 0);
+    // CURLOPT_POSTFIELDSにnullptrを渡すと標準入力から読むので、空でも有効なポインタを渡す。
+    static const std::uint8_t EMPTY[1] = {};
+    transfer.upload = { hasBody ? request.body
+                                : std::span<const std::uint8_t>(EMPTY, 0),
+                        0 };
 
     // HTTPメソッドごとに処理を分岐。
     switch (request.method) {
       case HttpMethod::Get:
-        if (!request.body->empty()) {
-          return makeError(ERR_INCORRECT_HTTP_METHOD,
-                           "Request body must be empty.");
-        }
         break;
       case HttpMethod::Post:
         curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body->data());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, request.body->size());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, transfer.upload.first.data());
+        curl_easy_setopt(
+          curl, CURLOPT_POSTFIELDSIZE, transfer.upload.first.size());
         break;
       case HttpMethod::Put:
         curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
-        curl_easy_setopt(curl, CURLOPT_READDATA, &pair);
-        curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, request.body->size());
+        curl_easy_setopt(curl, CURLOPT_READDATA, &transfer.upload);
+        curl_easy_setopt(
+          curl, CURLOPT_INFILESIZE_LARGE, transfer.upload.first.size());
         curl_easy_setopt(curl, CURLOPT_READFUNCTION, readCallback);
         break;
       case HttpMethod::Delete:
-        if (!request.body->empty()) {
-          return makeError(ERR_INCORRECT_HTTP_METHOD,
-                           "Request body must be empty.");
-        }
         curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
         break;
       default:
-        curl_easy_cleanup(curl);
-        return makeError(
-          ERR_INCORRECT_HTTP_METHOD,
-          "An undefined method was specified. Available methods are GET, POST, PUT, and DELETE.");
+        return ErrorResponse{
+          .code = ERR_INCORRECT_HTTP_METHOD,
+          .reason
+          = "An undefined method was specified. Available methods are GET, POST, PUT, and DELETE.",
+        };
     }
 
-    HttpResponse response;
-
-    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer.response);
     curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
 
     // レスポンスのボディを受け取るための準備
-    const std::string uri = std::string(origin) + request.uri;
-    curl_easy_setopt(curl, CURLOPT_URL, uri.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    // 通信を開始する。
-    const CURLcode code = curl_easy_perform(curl);
-
-    // 終了処理。
-    curl_slist_free_all(list);
-    curl_easy_cleanup(curl);
+    transfer.uri = std::string(origin) + request.uri;
+    curl_easy_setopt(curl, CURLOPT_URL, transfer.uri.c_str());
+    if (request.bodyObserver != nullptr) {
+      transfer.observer = request.bodyObserver;
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, observedWriteCallback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+    } else {
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer.response);
+    }
+    return std::nullopt;
+  }
 
+  Result<HttpResponse, ErrorResponse> HttpClient::finish(Transfer& transfer,
+                                                         int code) {
     if (code != CURLE_OK) {
-      return makeError(ERR_CURL_CONNECTION_FAILED, curl_easy_strerror(code));
+      return makeError(ERR_CURL_CONNECTION_FAILED,
+                       curl_easy_strerror(static_cast<CURLcode>(code)));
     }
     //レスポンスを正しい形にして返す。
-    return makeHttpResponse(std::move(response));
+    return makeHttpResponse(std::move(transfer.response));
+  }
+
+  void HttpClient::runLoop() {
+    auto& state = *multi;
+    std::map<CURL*, std::unique_ptr<Transfer>> running;
+
+    const auto cancelled = [] {
+      return makeError(ERR_CANCELLED, "The request was cancelled.");
+    };
+
+    while (true) {
+      std::vector<std::unique_ptr<Transfer>> incoming;
+      {
+        std::lock_guard lock(state.mutex);
+        if (state.stopping) break;
+        incoming.swap(state.pending);
+      }
+      for (auto& transfer : incoming) {
+        const auto handle = transfer->handle;
+        curl_multi_add_handle(state.handle, handle);
+        running.emplace(handle, std::move(transfer));
+      }
+
+      for (auto itr = running.begin(); itr != running.end();) {
+        if (!itr->second->token.isCancelled()) {
+          ++itr;
+          continue;
+        }
+        curl_multi_remove_handle(state.handle, itr->first);
+        auto transfer = std::move(itr->second);
+        itr           = running.erase(itr);
+        complete(std::move(transfer), cancelled());
+      }
+
+      int active = 0;
+      curl_multi_perform(state.handle, &active);
+      int queued = 0;
+      while (CURLMsg* message = curl_multi_info_read(state.handle, &queued)) {
+        if (message->msg != CURLMSG_DONE) continue;
+        const auto itr = running.find(message->easy_handle);
+        if (itr == running.end()) continue;
+        // メッセージはハンドルを取り除くと無効になる。
+        const auto code = message->data.result;
+        curl_multi_remove_handle(state.handle, itr->first);
+        auto transfer = std::move(itr->second);
+        running.erase(itr);
+        auto result = finish(*transfer, code);
+        complete(std::move(transfer), std::move(result));
+      }
+
+      // 新しいリクエストと停止はcurl_multi_wakeupで知らされ、
+      // 通信の期限はCURLが待機時間を短くして守るので、キャンセルを確かめるとき以外は起きなくてよい。
+      const bool cancellable
+        = std::any_of(running.begin(), running.end(), [](auto& entry) {
+            return entry.second->token.canBeCancelled();
+          });
+      curl_multi_poll(state.handle,
+                      nullptr,
+                      0,
+                      cancellable ? POLL_INTERVAL_MS
+                                  : std::numeric_limits<int>::max(),
+                      nullptr);
+    }
+
+    // 停止するときは、残っているリクエストを全てキャンセル扱いで完了させる。
+    for (auto& [handle, transfer] : running) {
+      curl_multi_remove_handle(state.handle, handle);
+      complete(std::move(transfer), cancelled());
+    }
+    std::vector<std::unique_ptr<Transfer>> pending;
+    {
+      std::lock_guard lock(state.mutex);
+      pending.swap(state.pending);
+    }
+    for (auto& transfer : pending) {
+      complete(std::move(transfer), cancelled());
+    }
+  }
+
+  void HttpClient::onSocketEvent(NativeSocket socket, SocketEvents events) {
+    if (multi->loop == nullptr || multi->handle == nullptr) return;
+    int mask = 0;
+    if ((events & SocketEvents::Read) != SocketEvents::None) {
+      mask |= CURL_CSELECT_IN;
+    }
+    if ((events & SocketEvents::Write) != SocketEvents::None) {
+      mask |= CURL_CSELECT_OUT;
+    }
+    int active = 0;
+    curl_multi_socket_action(multi->handle, socket, mask, &active);
+    processLoopEvents();
+  }
+  void HttpClient::onTimeout() {
+    if (multi->loop == nullptr || multi->handle == nullptr) return;
+    int active = 0;
+    curl_multi_socket_action(multi->handle, CURL_SOCKET_TIMEOUT, 0, &active);
+    processLoopEvents();
+  }
+
+  void HttpClient::setRequestTimeout(
+    std::chrono::milliseconds timeout) noexcept {
+    timeoutMs.store(static_cast<long>(timeout.count()),
+                    std::memory_order_relaxed);
+  }
+
+  void HttpClient::processLoopEvents() {
+    auto& state = *multi;
+    // コールバックの中で次のリクエストが発行されてrunningが変更されうるので、
+    // 完了したものを先に全て取り出してからコールバックを呼び出す。
+    std::vector<
+      std::pair<std::unique_ptr<Transfer>, Result<HttpResponse, ErrorResponse>>>
+      finished;
+    for (auto itr = state.running.begin(); itr != state.running.end();) {
+      if (!itr->second->token.isCancelled()) {
+        ++itr;
+        continue;
+      }
+      curl_multi_remove_handle(state.handle, itr->first);
+      finished.emplace_back(
+        std::move(itr->second),
+        makeError(ERR_CANCELLED, "The request was cancelled."));
+      itr = state.running.erase(itr);
+    }
+    int queued = 0;
+    while (CURLMsg* message = curl_multi_info_read(state.handle, &queued)) {
+      if (message->msg != CURLMSG_DONE) continue;
+      const auto itr = state.running.find(message->easy_handle);
+      if (itr == state.running.end()) continue;
+      // メッセージはハンドルを取り除くと無効になる。
+      const auto code = message->data.result;
+      curl_multi_remove_handle(state.handle, itr->first);
+      auto transfer = std::move(itr->second);
+      state.running.erase(itr);
+      auto result = finish(*transfer, code);
+      finished.emplace_back(std::move(transfer), std::move(result));
+    }
+    for (auto& [transfer, result] : finished) {
+      complete(std::move(transfer), std::move(result));
+    }
+    armLoopTimer();
+  }
+  void HttpClient::armLoopTimer() {
+    auto& state = *multi;
+    if (state.running.empty()) {
+      state.loop->setTimer(std::nullopt);
+      return;
+    }
+    // TIMERFUNCTIONは値が変わったときにしか呼ばれず、
+    // キャンセルを検出するための間隔を挟めないので、毎回curl_multi_timeoutで計算する。
+    long timeout = -1;
+    curl_multi_timeout(state.handle, &timeout);
+    const bool cancellable
+      = std::any_of(state.running.begin(), state.running.end(), [](auto& entry) {
+          return entry.second->token.canBeCancelled();
+        });
+    if (cancellable && (timeout < 0 || timeout > POLL_INTERVAL_MS)) {
+      timeout = POLL_INTERVAL_MS;
+    }
+    if (timeout < 0) {
+      state.loop->setTimer(std::nullopt);
+    } else {
+      state.loop->setTimer(std::chrono::milliseconds(timeout));
+    }
+  }
+  void HttpClient::complete(std::unique_ptr<Transfer> transfer,
+                            Result<HttpResponse, ErrorResponse> result) {
+    auto callback = std::move(transfer->callback);
+    transfer.reset();
+    callback(std::move(result));
+  }
+  int HttpClient::socketCallback(void*,
+                                 NativeSocket socket,
+                                 int what,
+                                 HttpClient* client,
+                                 void*) {
+    auto events = SocketEvents::None;
+    if (what == CURL_POLL_IN) {
+      events = SocketEvents::Read;
+    } else if (what == CURL_POLL_OUT) {
+      events = SocketEvents::Write;
+    } else if (what == CURL_POLL_INOUT) {
+      events = SocketEvents::ReadWrite;
+    }
+    client->multi->loop->watchSocket(socket, events);
+    return 0;
+  }
+
+  void* HttpClient::acquire(bool multiplexed) {
+    CURL* handle = nullptr;
+    {
+      std::lock_guard lock(connections->mutex);
+      auto& idle = connections->poolOf(multiplexed);
+      if (!idle.empty()) {
+        handle = idle.back();
+        idle.pop_back();
+      }
+    }
+    if (handle == nullptr) {
+      handle = curl_easy_init();
+      if (handle == nullptr) return nullptr;
+    }
+    if (connections->share != nullptr) {
+      curl_easy_setopt(handle, CURLOPT_SHARE, connections->share);
+    }
+    return handle;
+  }
+  void HttpClient::release(void* handle, bool multiplexed) noexcept {
+    if (handle == nullptr) return;
+    // リクエストごとのオプションはスタック上のデータを指しているので消しておく。
+    // 接続やキャッシュはcurl_easy_resetの後も保持される。
+    curl_easy_reset(handle);
+    {
+      std::lock_guard lock(connections->mutex);
+      auto& idle = connections->poolOf(multiplexed);
+      if (idle.size() < MAX_IDLE_HANDLES) {
+        idle.push_back(handle);
+        return;
+      }
+    }
+    curl_easy_cleanup(handle);
   }
 
   size_t HttpClient::writeCallback(char* buffer,
                                    size_t size,
                                    size_t nmemb,
                                    HttpResponse* response) {
+    if (response->body.empty()) {
+      // Content-Lengthが分かれば、上限までは先にまとめて確保しておく。
+      // 受信しながらボディ部を渡す場合はここを通らないので、大きなファイルでも確保しない。
+      const auto it = response->headerField.find("Content-Length");
+      if (it != response->headerField.end()) {
+        const auto& value  = it->second;
+        std::size_t length = 0;
+        const auto parsed  = std::from_chars(
+          value.data(), value.data() + value.size(), length);
+        if (parsed.ec == std::errc()) {
+          response->body.reserve(std::min(length, MAX_RESERVED_BODY_SIZE));
+        }
+      }
+    }
     response->body.resize(response->body.size() + nmemb);
     std::copy_n(
       buffer, nmemb, response->body.begin() + (response->body.size() - nmemb));
     return size * nmemb;
   }
 
+  size_t HttpClient::observedWriteCallback(char* buffer,
+                                           size_t size,
+                                           size_t nmemb,
+                                           Transfer* transfer) {
+    long status = 0;
+    curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &status);
+    // リダイレクトやエラーのボディ部は観測せず、デコードできるように格納する。
+    if (status / 100 != 2) {
+      return writeCallback(buffer, size, nmemb, &transfer->response);
+    }
+    (*transfer->observer)(std::span<const std::uint8_t>(
+      reinterpret_cast<const std::uint8_t*>(buffer), size * nmemb));
+    return size * nmemb;
+  }
+
   size_t HttpClient::readCallback(
     char* buffer,
     size_t size,
     size_t nmemb,
-    std::pair<const std::vector<std::uint8_t>*, size_t>* stream) {
-    size_t len = std::min(stream->first->size() - stream->second, size * nmemb);
-    auto itr   = stream->first->begin() + stream->second;
+    std::pair<std::span<const std::uint8_t>, size_t>* stream) {
+    size_t len = std::min(stream->first.size() - stream->second, size * nmemb);
+    auto itr   = stream->first.begin() + stream->second;
     std::copy(itr, itr + len, buffer);
     stream->second += len;
     return len;
@@ -259,9 +849,6 @@ namespace octane::internal {
       buf = buf.substr(pos + 2);
       std::string val(buf.substr(0, buf.size() - 2));
       response->headerField[key] = val;
-      if (key == "Content-Length") {
-        response->body.reserve(std::stoll(val));
-      }
     }
     return size * nmemb;
   }
@@ -290,7 +877,8 @@ namespace octane::internal {
     if (a.version != b.version) return false;
     if (a.uri != b.uri) return false;
     if (a.headerField != b.headerField) return false;
-    if (a.body != b.body) return false;
+    // ボディ部はどこを指しているかではなく、内容で比べる。
+    if (!std::ranges::equal(a.body, b.body)) return false;
     return true;
   }
   bool operator==(const HttpResponse& a, const HttpResponse& b) {
@@ -349,9 +937,7 @@ namespace octane::internal {
     }
     headers += "}";
 
-    std::string body;
-    body.resize(request.body->size());
-    std::copy(request.body->begin(), request.body->end(), body.begin());
+    const std::string body(request.body.begin(), request.body.end());
 
     stream << "method = " << method << ", version = " << version
            << ", uri = " << request.uri << ", headers = " << headers
@@ -0,0 +1,217 @@
+/**
+ * @file json.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief json.hのうち、バックエンドに依存しない部分の実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/json.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace octane::internal {
+  namespace {
+    void writeString(std::string& out, std::string_view str) {
+      constexpr char HEX[] = "0123456789abcdef";
+      out.push_back('"');
+      for (const char c : str) {
+        switch (c) {
+          case '"':
+            out.append("\\\"");
+            break;
+          case '\\':
+            out.append("\\\\");
+            break;
+          case '\b':
+            out.append("\\b");
+            break;
+          case '\f':
+            out.append("\\f");
+            break;
+          case '\n':
+            out.append("\\n");
+            break;
+          case '\r':
+            out.append("\\r");
+            break;
+          case '\t':
+            out.append("\\t");
+            break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+              out.append("\\u00");
+              out.push_back(HEX[(c >> 4) & 0xf]);
+              out.push_back(HEX[c & 0xf]);
+            } else {
+              out.push_back(c);
+            }
+            break;
+        }
+      }
+      out.push_back('"');
+    }
+    template <typename T>
+    void writeNumber(std::string& out, T value) {
+      char buf[32];
+      const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+      assert(ec == std::errc());
+      out.append(buf, end);
+    }
+    void write(std::string& out, const Json& json) {
+      if (json.isNull()) {
+        out.append("null");
+      } else if (json.isBool()) {
+        out.append(json.getBool() ? "true" : "false");
+      } else if (json.isUint64()) {
+        writeNumber(out, json.getUint64());
+      } else if (json.isInt64()) {
+        writeNumber(out, json.getInt64());
+      } else if (json.isDouble()) {
+        const auto value = json.getDouble();
+        // JSONはNaNと無限大を表現できない。
+        if (std::isfinite(value)) {
+          writeNumber(out, value);
+        } else {
+          out.append("null");
+        }
+      } else if (json.isString()) {
+        writeString(out, json.getString());
+      } else if (json.isArray()) {
+        out.push_back('[');
+        bool first = true;
+        for (const auto& element : json.getArray()) {
+          if (!first) out.push_back(',');
+          first = false;
+          write(out, element);
+        }
+        out.push_back(']');
+      } else {
+        out.push_back('{');
+        bool first = true;
+        for (const auto& [key, member] : json.getObject()) {
+          if (!first) out.push_back(',');
+          first = false;
+          writeString(out, key);
+          out.push_back(':');
+          write(out, member);
+        }
+        out.push_back('}');
+      }
+    }
+  } // namespace
+
+  Json::Json(std::int64_t value) noexcept {
+    // 同じ整数が常に同じ表現になるよう、0以上の値は符号なし整数として持つ。
+    if (value >= 0) {
+      this->value = static_cast<std::uint64_t>(value);
+    } else {
+      this->value = value;
+    }
+  }
+
+  bool Json::getBool() const {
+    assert(isBool());
+    return std::get<bool>(value);
+  }
+  std::int64_t Json::getInt64() const {
+    if (isUint64()) {
+      assert(std::get<std::uint64_t>(value)
+             <= static_cast<std::uint64_t>(
+               std::numeric_limits<std::int64_t>::max()));
+      return static_cast<std::int64_t>(std::get<std::uint64_t>(value));
+    }
+    assert(isInt64());
+    return std::get<std::int64_t>(value);
+  }
+  std::uint64_t Json::getUint64() const {
+    assert(isUint64());
+    return std::get<std::uint64_t>(value);
+  }
+  double Json::getDouble() const {
+    if (isUint64()) return static_cast<double>(std::get<std::uint64_t>(value));
+    if (isInt64()) return static_cast<double>(std::get<std::int64_t>(value));
+    assert(isDouble());
+    return std::get<double>(value);
+  }
+  std::string_view Json::getString() const {
+    assert(isString());
+    return std::get<std::string>(value);
+  }
+  const Json::Array& Json::getArray() const {
+    assert(isArray());
+    return std::get<Array>(value);
+  }
+  const Json::Object& Json::getObject() const {
+    assert(isObject());
+    return std::get<Object>(value);
+  }
+
+  const Json* Json::find(std::string_view key) const noexcept {
+    if (!isObject()) return nullptr;
+    for (const auto& [name, member] : std::get<Object>(value)) {
+      if (name == key) return &member;
+    }
+    return nullptr;
+  }
+  const Json& Json::operator[](std::string_view key) const {
+    if (auto member = find(key)) {
+      return *member;
+    }
+    assert(false && "No such member.");
+    // NOTE: 静的変数として持つとApiClientのデストラクタより先に破棄されてしまうため、
+    // 意図的に解放しない。
+    static auto null = new Json();
+    return *null;
+  }
+
+  Json& Json::set(std::string_view key, Json member) & {
+    assert(isObject());
+    auto& object = std::get<Object>(value);
+    for (auto& [name, current] : object) {
+      if (name == key) {
+        current = std::move(member);
+        return *this;
+      }
+    }
+    object.emplace_back(std::string(key), std::move(member));
+    return *this;
+  }
+  void Json::append(std::string&& key, Json&& member) {
+    assert(isObject());
+    std::get<Object>(value).emplace_back(std::move(key), std::move(member));
+  }
+  void Json::push(Json&& element) {
+    assert(isArray());
+    std::get<Array>(value).push_back(std::move(element));
+  }
+
+  std::string Json::stringify() const {
+    std::string out;
+    write(out, *this);
+    return out;
+  }
+
+  bool operator==(const Json& a, const Json& b) {
+    if (a.isObject() && b.isObject()) {
+      // メンバの順序は問わない。
+      const auto& x = a.getObject();
+      const auto& y = b.getObject();
+      if (x.size() != y.size()) return false;
+      return std::all_of(x.begin(), x.end(), [&](const auto& member) {
+        const auto other = b.find(member.first);
+        return other != nullptr && member.second == *other;
+      });
+    }
+    return a.value == b.value;
+  }
+  std::ostream& operator<<(std::ostream& stream, const Json& json) {
+    return stream << json.stringify();
+  }
+} // namespace octane::internal
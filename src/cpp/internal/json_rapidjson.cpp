@@ -0,0 +1,120 @@
+/**
+ * @file json_rapidjson.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief rapidjsonを用いたparseJsonの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include <rapidjson/encodedstream.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+
+#include <optional>
+
+#include "include/error_code.h"
+#include "include/internal/json.h"
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief rapidjsonのSAXイベントから{@link Json}を組み立てるハンドラ。
+     * @details
+     * rapidjson::Documentを経由しないため、値のコピーは一度で済む。
+     *
+     */
+    class JsonBuilder
+      : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonBuilder> {
+      std::vector<Json> stack;
+      std::vector<std::string> keys;
+
+    public:
+      std::optional<Json> root;
+
+      bool Null() {
+        return add(Json());
+      }
+      bool Bool(bool b) {
+        return add(Json(b));
+      }
+      bool Int(int i) {
+        return add(Json(static_cast<std::int64_t>(i)));
+      }
+      bool Uint(unsigned u) {
+        return add(Json(static_cast<std::uint64_t>(u)));
+      }
+      bool Int64(std::int64_t i) {
+        return add(Json(i));
+      }
+      bool Uint64(std::uint64_t u) {
+        return add(Json(u));
+      }
+      bool Double(double d) {
+        return add(Json(d));
+      }
+      bool String(const char* str, rapidjson::SizeType length, bool) {
+        return add(Json(std::string(str, length)));
+      }
+      bool StartObject() {
+        stack.push_back(Json::object());
+        return true;
+      }
+      bool Key(const char* str, rapidjson::SizeType length, bool) {
+        keys.emplace_back(str, length);
+        return true;
+      }
+      bool EndObject(rapidjson::SizeType) {
+        return pop();
+      }
+      bool StartArray() {
+        stack.push_back(Json::array());
+        return true;
+      }
+      bool EndArray(rapidjson::SizeType) {
+        return pop();
+      }
+
+    private:
+      bool add(Json&& value) {
+        if (stack.empty()) {
+          root = std::move(value);
+        } else if (stack.back().isArray()) {
+          stack.back().push(std::move(value));
+        } else {
+          stack.back().append(std::move(keys.back()), std::move(value));
+          keys.pop_back();
+        }
+        return true;
+      }
+      bool pop() {
+        auto value = std::move(stack.back());
+        stack.pop_back();
+        return add(std::move(value));
+      }
+    };
+  } // namespace
+
+  Result<Json, ErrorResponse> parseJson(std::string_view text) {
+    rapidjson::MemoryStream ms(text.data(), text.size());
+    rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream>
+      is(ms);
+    rapidjson::Reader reader;
+    JsonBuilder builder;
+    const auto result = reader.Parse(is, builder);
+    if (result.IsError()) {
+      const auto offset  = result.Offset();
+      const auto message = rapidjson::GetParseError_En(result.Code());
+      return makeError(
+        ERR_JSON_PARSE_FAILED,
+        message + std::string("\noffset: ") + std::to_string(offset));
+    }
+    return ok(std::move(builder.root.value()));
+  }
+
+  const char* jsonBackendName() noexcept {
+    return "rapidjson";
+  }
+} // namespace octane::internal
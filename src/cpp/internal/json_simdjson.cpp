@@ -0,0 +1,142 @@
+/**
+ * @file json_simdjson.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief simdjson(On Demand API)を用いたparseJsonの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include <simdjson.h>
+
+#include "include/error_code.h"
+#include "include/internal/json.h"
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief simdjsonの値を{@link Json}に変換する。
+     * @details
+     * ドキュメントのルートとその他の値で同じ処理を使うため、テンプレートにしている。
+     *
+     * @tparam Value simdjson::ondemand::documentもしくはsimdjson::ondemand::value
+     * @param[in] value 変換する値
+     * @param[out] out 変換結果
+     * @return simdjson::error_code 成功した場合はSUCCESS
+     */
+    template <typename Value>
+    simdjson::error_code convert(Value& value, Json& out) {
+      simdjson::ondemand::json_type type;
+      if (auto err = value.type().get(type)) return err;
+
+      switch (type) {
+        case simdjson::ondemand::json_type::object: {
+          simdjson::ondemand::object object;
+          if (auto err = value.get_object().get(object)) return err;
+          out = Json::object();
+          for (auto result : object) {
+            simdjson::ondemand::field field;
+            if (auto err = std::move(result).get(field)) return err;
+            std::string_view key;
+            if (auto err = field.unescaped_key().get(key)) return err;
+            Json member;
+            if (auto err = convert(field.value(), member)) return err;
+            out.append(std::string(key), std::move(member));
+          }
+          return simdjson::SUCCESS;
+        }
+        case simdjson::ondemand::json_type::array: {
+          simdjson::ondemand::array array;
+          if (auto err = value.get_array().get(array)) return err;
+          out = Json::array();
+          for (auto result : array) {
+            simdjson::ondemand::value element;
+            if (auto err = std::move(result).get(element)) return err;
+            Json converted;
+            if (auto err = convert(element, converted)) return err;
+            out.push(std::move(converted));
+          }
+          return simdjson::SUCCESS;
+        }
+        case simdjson::ondemand::json_type::number: {
+          simdjson::ondemand::number number;
+          if (auto err = value.get_number().get(number)) return err;
+          switch (number.get_number_type()) {
+            case simdjson::ondemand::number_type::signed_integer:
+              out = Json(number.get_int64());
+              break;
+            case simdjson::ondemand::number_type::unsigned_integer:
+              out = Json(number.get_uint64());
+              break;
+            default:
+              out = Json(number.get_double());
+              break;
+          }
+          return simdjson::SUCCESS;
+        }
+        case simdjson::ondemand::json_type::string: {
+          std::string_view str;
+          if (auto err = value.get_string().get(str)) return err;
+          out = Json(str);
+          return simdjson::SUCCESS;
+        }
+        case simdjson::ondemand::json_type::boolean: {
+          bool b;
+          if (auto err = value.get_bool().get(b)) return err;
+          out = Json(b);
+          return simdjson::SUCCESS;
+        }
+        case simdjson::ondemand::json_type::null: {
+          bool isNull;
+          if (auto err = value.is_null().get(isNull)) return err;
+          if (!isNull) return simdjson::INCORRECT_TYPE;
+          out = Json();
+          return simdjson::SUCCESS;
+        }
+        default:
+          return simdjson::INCORRECT_TYPE;
+      }
+    }
+  } // namespace
+
+  Result<Json, ErrorResponse> parseJson(std::string_view text) {
+    // rapidjsonと同様に、末尾のゼロ終端はドキュメントの終わりとして扱う。
+    while (!text.empty() && text.back() == '\0') {
+      text.remove_suffix(1);
+    }
+
+    // パーサとパディング付きのバッファはスレッドごとに使い回し、
+    // パースのたびにメモリを確保しないようにする。
+    thread_local simdjson::ondemand::parser parser;
+    thread_local std::string buffer;
+    buffer.assign(text);
+    buffer.resize(text.size() + simdjson::SIMDJSON_PADDING, '\0');
+    simdjson::padded_string_view padded(buffer.data(),
+                                        text.size(),
+                                        buffer.size());
+
+    simdjson::ondemand::document doc;
+    if (auto err = parser.iterate(padded).get(doc)) {
+      return makeError(ERR_JSON_PARSE_FAILED, simdjson::error_message(err));
+    }
+    Json json;
+    auto err = convert(doc, json);
+    if (!err && !doc.at_end()) {
+      err = simdjson::TRAILING_CONTENT;
+    }
+    if (err) {
+      std::string message = simdjson::error_message(err);
+      const char* location;
+      if (!doc.current_location().get(location)) {
+        message += "\noffset: " + std::to_string(location - buffer.data());
+      }
+      return makeError(ERR_JSON_PARSE_FAILED, message);
+    }
+    return ok(std::move(json));
+  }
+
+  const char* jsonBackendName() noexcept {
+    return "simdjson";
+  }
+} // namespace octane::internal
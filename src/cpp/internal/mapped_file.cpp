@@ -0,0 +1,154 @@
+/**
+ * @file mapped_file.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief mapped_file.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/mapped_file.h"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "include/error_code.h"
+
+namespace octane::internal {
+  namespace {
+    ErrorResponse openError(const std::filesystem::path& path,
+                            std::string_view what,
+                            int code) {
+      return ErrorResponse{
+        .code   = ERR_FILE_OPEN_FAILED,
+        .reason = "Failed to " + std::string(what) + " " + path.string() + ": "
+                + std::system_category().message(code),
+      };
+    }
+  } // namespace
+
+  MappedFile::MappedFile() noexcept : data(nullptr), size(0) {}
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)),
+      size(std::exchange(other.size, 0)) {}
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data = std::exchange(other.data, nullptr);
+      size = std::exchange(other.size, 0);
+    }
+    return *this;
+  }
+  MappedFile::~MappedFile() noexcept {
+    unmap();
+  }
+
+  std::span<const std::uint8_t> MappedFile::bytes() const noexcept {
+    return std::span(data, size);
+  }
+
+#ifdef _WIN32
+  Result<MappedFile, ErrorResponse> MappedFile::open(
+    const std::filesystem::path& path) {
+    const auto file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN,
+                                  nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return error(openError(path, "open", static_cast<int>(GetLastError())));
+    }
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length)) {
+      const auto code = static_cast<int>(GetLastError());
+      CloseHandle(file);
+      return error(openError(path, "stat", code));
+    }
+    MappedFile mapped;
+    // 大きさが0のファイルはマップできないので、空のままにする。
+    if (length.QuadPart > 0) {
+      const auto mapping
+        = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping == nullptr) {
+        const auto code = static_cast<int>(GetLastError());
+        CloseHandle(file);
+        return error(openError(path, "map", code));
+      }
+      const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      const auto code = static_cast<int>(GetLastError());
+      // ビューがマッピングを参照し続けるので、ハンドルはすぐに閉じてよい。
+      CloseHandle(mapping);
+      if (view == nullptr) {
+        CloseHandle(file);
+        return error(openError(path, "map", code));
+      }
+      mapped.data = static_cast<const std::uint8_t*>(view);
+      mapped.size = static_cast<std::size_t>(length.QuadPart);
+    }
+    CloseHandle(file);
+    return ok(std::move(mapped));
+  }
+
+  void MappedFile::unmap() noexcept {
+    if (data != nullptr) {
+      UnmapViewOfFile(data);
+      data = nullptr;
+      size = 0;
+    }
+  }
+#else
+  Result<MappedFile, ErrorResponse> MappedFile::open(
+    const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return error(openError(path, "open", errno));
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+      const int code = errno;
+      ::close(fd);
+      return error(openError(path, "stat", code));
+    }
+    MappedFile mapped;
+    // 大きさが0のファイルはマップできないので、空のままにする。
+    if (status.st_size > 0) {
+      const auto size = static_cast<std::size_t>(status.st_size);
+      void* view      = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (view == MAP_FAILED) {
+        const int code = errno;
+        ::close(fd);
+        return error(openError(path, "map", code));
+      }
+      // ハッシュ値の計算も送信も先頭から一度だけ読むので、先読みを増やしてもらう。
+      ::madvise(view, size, MADV_SEQUENTIAL);
+      mapped.data = static_cast<const std::uint8_t*>(view);
+      mapped.size = size;
+    }
+    // マップした後はファイル記述子を閉じてもマッピングは残る。
+    ::close(fd);
+    return ok(std::move(mapped));
+  }
+
+  void MappedFile::unmap() noexcept {
+    if (data != nullptr) {
+      ::munmap(const_cast<std::uint8_t*>(data), size);
+      data = nullptr;
+      size = 0;
+    }
+  }
+#endif
+} // namespace octane::internal
@@ -5,16 +5,83 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
 
 #include "include/error_code.h"
 
 namespace octane::internal {
   namespace {
-    Result<FILE*, ErrorResponse> tar(const std::vector<FileInfo>& files) {
+    /**
+     * @brief libarchiveが書き出したブロックを、clientDataのバッファの末尾に追加する。
+     *
+     */
+    la_ssize_t appendBlock(archive*,
+                           void* clientData,
+                           const void* buffer,
+                           size_t length) {
+      auto& data       = *static_cast<std::vector<uint8_t>*>(clientData);
+      const auto bytes = static_cast<const uint8_t*>(buffer);
+      data.insert(data.end(), bytes, bytes + length);
+      return static_cast<la_ssize_t>(length);
+    }
+
+    /**
+     * @brief optionsのコーデックとレベルをアーカイブに設定する。
+     *
+     */
+    int addFilter(archive* arch, const CompressionOptions& options) {
+      int res = ARCHIVE_OK;
+      switch (options.codec) {
+        case CompressionCodec::None:
+          return ARCHIVE_OK;
+        case CompressionCodec::Gzip:
+          res = archive_write_add_filter_gzip(arch);
+          break;
+        case CompressionCodec::Xz:
+          res = archive_write_add_filter_xz(arch);
+          break;
+        case CompressionCodec::Zstd:
+          // libzstdがなければ外部のzstdコマンドで代用しようとしてARCHIVE_WARNを返すが、それは使わない。
+          res = archive_write_add_filter_zstd(arch);
+          break;
+      }
+      if (res == ARCHIVE_OK && options.level != DEFAULT_COMPRESSION_LEVEL) {
+        res = archive_write_set_filter_option(
+          arch,
+          nullptr,
+          "compression-level",
+          std::to_string(options.level).c_str());
+      }
+      return res;
+    }
+
+    /**
+     * @brief filesをtar形式でメモリ上のバッファに書き出す。
+     * @details
+     * 一時ファイルを経由しないので、ディスクに書き込めない環境でも動作する。
+     * optionsのコーデックで圧縮しながら書き出す。
+     */
+    Result<std::vector<uint8_t>, ErrorResponse> tar(
+      const std::vector<FileInfo>& files,
+      const CompressionOptions& options) {
+      std::vector<uint8_t> data;
+      // ヘッダとブロック境界までの詰め物を見込んで、先にまとめて確保しておく。
+      // 圧縮する場合は大きさが分からないので、必要に応じて伸ばす。
+      if (options.codec == CompressionCodec::None) {
+        std::size_t estimate = 1024;
+        for (const auto& file : files) {
+          estimate += 1024 + file.filename.size() + file.data.size();
+        }
+        data.reserve(estimate);
+      }
+
       archive* arch        = nullptr;
       archive_entry* entry = nullptr;
-      auto file            = tmpfile();
 
       const auto defer = [&]() {
         if (entry) {
@@ -22,7 +89,6 @@ namespace octane::internal {
           entry = nullptr;
         }
         if (arch) {
-          archive_write_close(arch);
           archive_write_free(arch);
         }
       };
@@ -35,7 +101,14 @@ namespace octane::internal {
         res = archive_write_set_format_pax_restricted(arch);
       }
       if (res == ARCHIVE_OK) {
-        res = archive_write_open_FILE(arch, file);
+        res = addFilter(arch, options);
+      }
+      if (res == ARCHIVE_OK) {
+        // 最後のブロックを詰め物で10KiBまで埋めない。
+        res = archive_write_set_bytes_in_last_block(arch, 1);
+      }
+      if (res == ARCHIVE_OK) {
+        res = archive_write_open(arch, &data, nullptr, appendBlock, nullptr);
       }
 
       if (res == ARCHIVE_OK) {
@@ -48,13 +121,24 @@ namespace octane::internal {
           archive_entry_set_size(entry, file.data.size());
           archive_entry_set_filetype(entry, AE_IFREG);
           res = archive_write_header(arch, entry);
-          archive_write_data(arch, file.data.data(), file.data.size());
+          if (res == ARCHIVE_OK) {
+            const auto written
+              = archive_write_data(arch, file.data.data(), file.data.size());
+            if (written < 0
+                || static_cast<size_t>(written) != file.data.size()) {
+              res = ARCHIVE_FATAL;
+            }
+          }
           archive_entry_clear(entry);
           if (res != ARCHIVE_OK) {
             break;
           }
         }
       }
+      if (res == ARCHIVE_OK) {
+        // 残っているブロックと終端はcloseで書き出される。
+        res = archive_write_close(arch);
+      }
 
       if (res != ARCHIVE_OK) {
         auto e = archive_error_string(arch);
@@ -62,32 +146,59 @@ namespace octane::internal {
           e = strerror(archive_errno(arch));
         }
 
+        auto err = makeError(ERR_COMPRESSION_FAILED, e);
         defer();
-        return makeError(ERR_COMPRESSION_FAILED, e);
+        return err;
       }
 
       defer();
 
-      return ok(file);
+      return ok(std::move(data));
+    }
+
+    /**
+     * @brief アーカイブのエントリのパスを、rootの中のパスに変換する。
+     * @details
+     * 絶対パスや..を含むパス、既存のシンボリックリンクを辿るとrootの外に出るパスであればnulloptを返す。
+     */
+    std::optional<std::filesystem::path> entryPath(
+      const std::filesystem::path& root,
+      const char* pathname) {
+      if (pathname == nullptr) return std::nullopt;
+      const std::filesystem::path relative(
+        reinterpret_cast<const char8_t*>(pathname));
+      if (relative.empty() || relative.has_root_path()) return std::nullopt;
+      for (const auto& part : relative) {
+        if (part == "..") return std::nullopt;
+      }
+      std::error_code ec;
+      auto target = std::filesystem::weakly_canonical(root / relative, ec);
+      if (ec) return std::nullopt;
+      const auto inside = target.lexically_relative(root);
+      if (inside.empty() || *inside.begin() == "..") {
+        return std::nullopt;
+      }
+      return target;
     }
   } // namespace
 
   Result<std::vector<uint8_t>, ErrorResponse> MultiFileCompressor::compress(
-    const std::vector<FileInfo>& files) {
-    auto tarResult = tar(files);
-    if (!tarResult) {
-      return error(tarResult.err());
+    const std::vector<FileInfo>& files,
+    CompressionOptions options) {
+    return tar(files, options);
+  }
+  std::string_view MultiFileCompressor::mime(CompressionCodec codec) {
+    switch (codec) {
+      case CompressionCodec::None:
+        return "application/x-tar";
+      case CompressionCodec::Gzip:
+        return "application/gzip";
+      case CompressionCodec::Xz:
+        return "application/x-xz";
+      case CompressionCodec::Zstd:
+        return "application/zstd";
     }
-    auto tarFile = tarResult.get();
-    auto len     = ftell(tarFile);
-    fseek(tarFile, 0, SEEK_SET);
-
-    std::vector<uint8_t> data;
-    data.resize(len);
-    fread(data.data(), 1, len, tarFile);
-    fclose(tarFile);
-
-    return ok(std::move(data));
+    std::abort();
   }
   Result<std::vector<FileInfo>, ErrorResponse>
   MultiFileDecompressor::decompress(const std::vector<uint8_t>& data) {
@@ -109,6 +220,9 @@ namespace octane::internal {
     if (res == ARCHIVE_OK) {
       res = archive_read_support_format_all(arch);
     }
+    if (res == ARCHIVE_OK) {
+      res = archive_read_support_filter_all(arch);
+    }
     if (res == ARCHIVE_OK) {
       res = archive_read_open_memory(arch, data.data(), data.size());
     }
@@ -157,4 +271,108 @@ namespace octane::internal {
 
     return ok(std::move(files));
   }
+  Result<_, ErrorResponse> MultiFileDecompressor::extract(
+    const std::filesystem::path& archivePath,
+    const std::filesystem::path& directory) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    const auto root = std::filesystem::weakly_canonical(directory, ec);
+    if (ec) {
+      return makeError(ERR_FILE_WRITE_FAILED,
+                       "Failed to create " + directory.string() + ": "
+                         + ec.message());
+    }
+
+    archive* arch        = archive_read_new();
+    archive_entry* entry = nullptr;
+    const auto defer     = [&]() {
+      archive_read_close(arch);
+      archive_read_free(arch);
+    };
+    const auto archiveError = [&]() {
+      auto e = archive_error_string(arch);
+      if (e == nullptr) {
+        e = strerror(archive_errno(arch));
+      }
+      auto err = makeError(ERR_DECOMPRESSION_FAILED, e);
+      defer();
+      return err;
+    };
+
+    int res = archive_read_support_format_all(arch);
+    if (res == ARCHIVE_OK) {
+      res = archive_read_support_filter_all(arch);
+    }
+    if (res == ARCHIVE_OK) {
+#ifdef _WIN32
+      res = archive_read_open_filename_w(arch, archivePath.c_str(), 1 << 16);
+#else
+      res = archive_read_open_filename(arch, archivePath.c_str(), 1 << 16);
+#endif
+    }
+    if (res != ARCHIVE_OK) {
+      return archiveError();
+    }
+    while (true) {
+      res = archive_read_next_header(arch, &entry);
+      if (res == ARCHIVE_EOF) {
+        break;
+      }
+      if (res != ARCHIVE_OK) {
+        return archiveError();
+      }
+
+      const auto pathname = archive_entry_pathname(entry);
+      const auto type     = archive_entry_filetype(entry);
+      const auto target   = entryPath(root, pathname);
+      // シンボリックリンクやハードリンクを作らせると、後続のエントリで外に書き込めてしまう。
+      if (!target || (type != AE_IFREG && type != AE_IFDIR)) {
+        auto err = makeError(ERR_DECOMPRESSION_FAILED,
+                             "Refused to extract an unsafe entry: "
+                               + std::string(pathname ? pathname : ""));
+        defer();
+        return err;
+      }
+      if (type == AE_IFDIR) {
+        std::filesystem::create_directories(target.value(), ec);
+      } else {
+        std::filesystem::create_directories(target->parent_path(), ec);
+      }
+      if (ec) {
+        defer();
+        return makeError(ERR_FILE_WRITE_FAILED,
+                         "Failed to create " + target->string() + ": "
+                           + ec.message());
+      }
+      if (type == AE_IFDIR) {
+        continue;
+      }
+
+      std::ofstream out(target.value(), std::ios::binary | std::ios::trunc);
+      const void* buf;
+      size_t size;
+      la_int64_t offset;
+      while (out) {
+        res = archive_read_data_block(arch, &buf, &size, &offset);
+        if (res == ARCHIVE_EOF) {
+          break;
+        }
+        if (res != ARCHIVE_OK) {
+          return archiveError();
+        }
+        // 疎なファイルでは、ブロックの間が空いていることがある。
+        out.seekp(offset);
+        out.write(static_cast<const char*>(buf), size);
+      }
+      out.close();
+      if (!out) {
+        defer();
+        return makeError(ERR_FILE_WRITE_FAILED,
+                         "Failed to write " + target->string());
+      }
+    }
+
+    defer();
+    return ok();
+  }
 } // namespace octane::internal
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * @file room_status_cache.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief room_status_cache.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/room_status_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace octane::internal {
+  RoomStatusCache::RoomStatusCache(std::chrono::milliseconds ttl,
+                                   std::size_t shardCount)
+    : ttl(ttl),
+      shardCount(std::max<std::size_t>(shardCount, 1)),
+      shards(std::make_unique<Shard[]>(this->shardCount)) {}
+
+  Result<RoomStatus, ErrorResponse> RoomStatusCache::get(std::uint64_t id,
+                                                         const Fetch& fetch) {
+    if (auto cached = find(id)) {
+      return ok(std::move(cached.value()));
+    }
+    return flights.run(id, [&]() -> Result<RoomStatus, ErrorResponse> {
+      // 前の取得が完了した直後であれば、その結果を使う。
+      if (auto cached = find(id)) {
+        return ok(std::move(cached.value()));
+      }
+      const auto generation = generationOf(id);
+      auto result           = fetch();
+      if (result) {
+        store(id, result.get(), generation);
+      }
+      return result;
+    });
+  }
+
+  Task<Result<RoomStatus, ErrorResponse>> RoomStatusCache::getAsync(
+    std::uint64_t id,
+    Executor& executor,
+    CancellationToken token,
+    FetchAsync fetch) {
+    if (auto cached = find(id)) {
+      co_return ok(std::move(cached.value()));
+    }
+    // GCCはco_awaitの式の中のラムダを含む一時オブジェクトを早く破棄するので、一度変数に受ける。
+    auto task = flights.runAsync(
+      id, executor, std::move(token), [this, id, fetch] {
+        return fetchAndStore(id, fetch);
+      });
+    co_return co_await std::move(task);
+  }
+  Task<Result<RoomStatus, ErrorResponse>> RoomStatusCache::fetchAndStore(
+    std::uint64_t id,
+    FetchAsync fetch) {
+    if (auto cached = find(id)) {
+      co_return ok(std::move(cached.value()));
+    }
+    const auto generation = generationOf(id);
+    auto result           = co_await fetch();
+    if (result) {
+      store(id, result.get(), generation);
+    }
+    co_return std::move(result);
+  }
+
+  void RoomStatusCache::invalidate(std::uint64_t id) {
+    {
+      auto& shard = shardOf(id);
+      std::lock_guard lock(shard.mutex);
+      shard.entries.erase(id);
+      ++shard.generation;
+    }
+    flights.forget(id);
+  }
+
+  RoomStatusCache::Shard& RoomStatusCache::shardOf(std::uint64_t id) const {
+    return shards[id % shardCount];
+  }
+
+  std::optional<RoomStatus> RoomStatusCache::find(std::uint64_t id) const {
+    auto& shard = shardOf(id);
+    std::lock_guard lock(shard.mutex);
+    const auto it = shard.entries.find(id);
+    if (it == shard.entries.end()) return std::nullopt;
+    if (it->second.expiresAt <= Clock::now()) {
+      shard.entries.erase(it);
+      return std::nullopt;
+    }
+    return it->second.status;
+  }
+
+  std::uint64_t RoomStatusCache::generationOf(std::uint64_t id) const {
+    auto& shard = shardOf(id);
+    std::lock_guard lock(shard.mutex);
+    return shard.generation;
+  }
+
+  void RoomStatusCache::store(std::uint64_t id,
+                              const RoomStatus& status,
+                              std::uint64_t generation) const {
+    auto& shard = shardOf(id);
+    std::lock_guard lock(shard.mutex);
+    if (shard.generation != generation) return;
+    const auto now = Clock::now();
+    // 新しいidを覚えるときに期限切れのものを捨て、引かれなくなったidが溜まらないようにする。
+    if (!shard.entries.contains(id)) {
+      std::erase_if(shard.entries, [&](const auto& entry) {
+        return entry.second.expiresAt <= now;
+      });
+    }
+    shard.entries.insert_or_assign(
+      id, Entry{ .status = status, .expiresAt = now + ttl });
+  }
+} // namespace octane::internal
@@ -0,0 +1,196 @@
+/**
+ * @file room_subscriber.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief room_subscriber.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/room_subscriber.h"
+
+#include <algorithm>
+
+#include "include/room_subscription.h"
+
+namespace octane::internal {
+  RoomSubscriber::RoomSubscriber(Stream stream,
+                                 Poll poll,
+                                 Callback callback,
+                                 SubscribeOptions options)
+    : stream(std::move(stream)),
+      poll(std::move(poll)),
+      callback(std::move(callback)),
+      options(options),
+      stopping(false),
+      worker([this] { run(); }) {}
+
+  RoomSubscriber::~RoomSubscriber() noexcept {
+    stop();
+  }
+
+  void RoomSubscriber::stop() noexcept {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    cancellation.cancel();
+    wake.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  void RoomSubscriber::run() {
+    using Clock = std::chrono::steady_clock;
+
+    // 最初の状態は基準として覚えるだけで通知しない。
+    refresh();
+    auto delay = options.reconnectInterval;
+
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+      lock.unlock();
+      bool received = false;
+      // 結果は使わない。失敗した場合も切断された場合も、ポーリングに切り替えて接続し直す。
+      [[maybe_unused]] auto result
+        = stream(cancellation.token(), [&](RoomEvent event) {
+            received = true;
+            if (apply(event)) {
+              callback(ok(std::move(event)));
+            }
+          });
+      if (received) delay = options.reconnectInterval;
+      const auto reconnectAt = Clock::now() + delay;
+      delay = std::min(delay * 2, options.maxReconnectInterval);
+
+      // 切断されている間の変化はポーリングで拾う。
+      lock.lock();
+      while (!stopping) {
+        lock.unlock();
+        refresh();
+        lock.lock();
+        const auto now = Clock::now();
+        if (now >= reconnectAt) break;
+        const auto wait
+          = std::min<Clock::duration>(options.pollInterval, reconnectAt - now);
+        wake.wait_for(lock, wait, [this] { return stopping; });
+        if (Clock::now() >= reconnectAt) break;
+      }
+    }
+  }
+
+  void RoomSubscriber::refresh() {
+    auto snapshot = poll();
+    if (!snapshot) {
+      // 基準がないうちは通知しても比較できないので、次のポーリングに任せる。
+      if (baseline.has_value()) {
+        callback(error(snapshot.err()));
+      }
+      return;
+    }
+    auto& room = snapshot.get();
+    std::optional<std::pair<std::string, std::uint64_t>> content;
+    if (room.content.has_value()) {
+      content.emplace(room.content->second, room.content->first.timestamp);
+    }
+    std::set<std::string> devices;
+    for (const auto& device : room.devices) {
+      devices.insert(device.name);
+    }
+    // 別のルームに接続し直した場合は、差分を取らずに基準を置き換える。
+    if (!baseline.has_value() || baseline->roomId != room.roomId) {
+      baseline.emplace(Baseline{
+        .roomId  = room.roomId,
+        .content = std::move(content),
+        .devices = std::move(devices),
+      });
+      return;
+    }
+
+    std::vector<RoomEvent> events;
+    if (content.has_value() && content != baseline->content) {
+      events.push_back(RoomEvent{
+        .type          = RoomEventType::ContentChanged,
+        .roomId        = room.roomId,
+        .contentStatus = std::move(room.content->first),
+        .hash          = std::move(room.content->second),
+        .device        = std::nullopt,
+      });
+    }
+    for (const auto& device : room.devices) {
+      if (!baseline->devices.contains(device.name)) {
+        events.push_back(RoomEvent{
+          .type          = RoomEventType::DeviceJoined,
+          .roomId        = room.roomId,
+          .contentStatus = std::nullopt,
+          .hash          = "",
+          .device        = device,
+        });
+      }
+    }
+    for (const auto& name : baseline->devices) {
+      if (!devices.contains(name)) {
+        // 切断したデバイスの接続時刻はもう分からない。
+        events.push_back(RoomEvent{
+          .type          = RoomEventType::DeviceLeft,
+          .roomId        = room.roomId,
+          .contentStatus = std::nullopt,
+          .hash          = "",
+          .device        = Device{ .name = name, .timestamp = 0 },
+        });
+      }
+    }
+    for (auto& event : events) {
+      apply(event);
+      callback(ok(std::move(event)));
+    }
+  }
+
+  bool RoomSubscriber::apply(const RoomEvent& event) {
+    if (!baseline.has_value() || baseline->roomId != event.roomId) {
+      baseline.emplace(Baseline{ .roomId = event.roomId });
+    }
+    switch (event.type) {
+      case RoomEventType::ContentChanged: {
+        std::pair<std::string, std::uint64_t> content(
+          event.hash, event.contentStatus->timestamp);
+        if (baseline->content == content) return false;
+        baseline->content.emplace(std::move(content));
+        return true;
+      }
+      case RoomEventType::DeviceJoined:
+        return baseline->devices.insert(event.device->name).second;
+      case RoomEventType::DeviceLeft:
+        return baseline->devices.erase(event.device->name) > 0;
+      default:
+        return false;
+    }
+  }
+} // namespace octane::internal
+
+namespace octane {
+  RoomSubscription::RoomSubscription() noexcept = default;
+  RoomSubscription::RoomSubscription(
+    std::unique_ptr<internal::RoomSubscriber> subscriber)
+    : subscriber(std::move(subscriber)) {}
+  RoomSubscription::RoomSubscription(RoomSubscription&& other) noexcept
+    = default;
+  RoomSubscription& RoomSubscription::operator=(
+    RoomSubscription&& other) noexcept {
+    if (this != &other) {
+      stop();
+      subscriber = std::move(other.subscriber);
+    }
+    return *this;
+  }
+  RoomSubscription::~RoomSubscription() noexcept = default;
+
+  void RoomSubscription::stop() noexcept {
+    subscriber.reset();
+  }
+  bool RoomSubscription::isActive() const noexcept {
+    return subscriber != nullptr;
+  }
+} // namespace octane
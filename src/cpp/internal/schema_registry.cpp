@@ -0,0 +1,198 @@
+/**
+ * @file schema_registry.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief schema_registry.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/schema_registry.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/schema.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+#include "include/error_code.h"
+#include "include/internal/api_schema.h"
+
+namespace octane::internal {
+  namespace {
+    const char* schemaSource(SchemaId id) {
+      switch (id) {
+        case SchemaId::ErrorResponse:
+          return SCHEMA_ERROR_RESPONSE;
+        case SchemaId::HealthGet:
+          return SCHEMA_HEALTH_GET;
+        case SchemaId::RoomPost:
+          return SCHEMA_ROOM_POST;
+        case SchemaId::RoomIdGet:
+          return SCHEMA_ROOM_ID_GET;
+        case SchemaId::RoomIdDelete:
+          return SCHEMA_ROOM_ID_DELETE;
+        case SchemaId::RoomIdPost:
+          return SCHEMA_ROOM_ID_POST;
+        case SchemaId::RoomIdStatusGet:
+          return SCHEMA_ROOM_ID_STATUS_GET;
+        case SchemaId::RoomIdStatusPut:
+          return SCHEMA_ROOM_ID_STATUS_PUT;
+        case SchemaId::RoomIdStatusDelete:
+          return SCHEMA_ROOM_ID_STATUS_DELETE;
+        case SchemaId::RoomIdEventsDevice:
+          return SCHEMA_ROOM_ID_EVENTS_DEVICE;
+        default:
+          std::abort();
+      }
+    }
+
+    /**
+     * @brief {@link Json}をSAXイベントとしてハンドラに渡す。
+     *
+     * @tparam Handler rapidjsonのHandlerコンセプトを満たす型
+     * @param[in] json 渡すJSON
+     * @param[in] handler イベントを受け取るハンドラ
+     * @return true 全てのイベントをハンドラが受理したとき
+     * @return false ハンドラが途中でイベントを拒否したとき
+     */
+    template <typename Handler>
+    bool accept(const Json& json, Handler& handler) {
+      if (json.isNull()) return handler.Null();
+      if (json.isBool()) return handler.Bool(json.getBool());
+      if (json.isUint64()) return handler.Uint64(json.getUint64());
+      if (json.isInt64()) return handler.Int64(json.getInt64());
+      if (json.isDouble()) return handler.Double(json.getDouble());
+      if (json.isString()) {
+        const auto str = json.getString();
+        return handler.String(
+          str.data(), static_cast<rapidjson::SizeType>(str.size()), false);
+      }
+      if (json.isArray()) {
+        const auto& array = json.getArray();
+        if (!handler.StartArray()) return false;
+        for (const auto& element : array) {
+          if (!accept(element, handler)) return false;
+        }
+        return handler.EndArray(static_cast<rapidjson::SizeType>(array.size()));
+      }
+      const auto& object = json.getObject();
+      if (!handler.StartObject()) return false;
+      for (const auto& [key, member] : object) {
+        if (!handler.Key(key.data(),
+                         static_cast<rapidjson::SizeType>(key.size()),
+                         false)) {
+          return false;
+        }
+        if (!accept(member, handler)) return false;
+      }
+      return handler.EndObject(static_cast<rapidjson::SizeType>(object.size()));
+    }
+  } // namespace
+
+  struct SchemaRegistry::Entry {
+    rapidjson::Document source;
+    std::unique_ptr<rapidjson::SchemaDocument> document;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<rapidjson::SchemaValidator>> pool;
+
+    std::unique_ptr<rapidjson::SchemaValidator> acquire() {
+      {
+        std::lock_guard lock(mutex);
+        if (!pool.empty()) {
+          auto validator = std::move(pool.back());
+          pool.pop_back();
+          return validator;
+        }
+      }
+      return std::make_unique<rapidjson::SchemaValidator>(*document);
+    }
+    void release(std::unique_ptr<rapidjson::SchemaValidator>&& validator) {
+      validator->Reset();
+      std::lock_guard lock(mutex);
+      pool.push_back(std::move(validator));
+    }
+  };
+
+  SchemaRegistry::SchemaRegistry()
+    : entries(std::make_unique<Entry[]>(SCHEMA_COUNT)) {
+    for (std::size_t i = 0; i < SCHEMA_COUNT; ++i) {
+      auto& entry = entries[i];
+      entry.source.Parse(schemaSource(static_cast<SchemaId>(i)));
+      assert(!entry.source.HasParseError());
+      entry.document
+        = std::make_unique<rapidjson::SchemaDocument>(entry.source);
+    }
+  }
+
+  SchemaRegistry::~SchemaRegistry() = default;
+
+  SchemaRegistry& SchemaRegistry::instance() {
+    // NOTE: 静的変数として持つとApiClientのデストラクタより先に破棄されてしまうため、
+    // 意図的に解放しない。
+    static auto registry = new SchemaRegistry();
+    return *registry;
+  }
+
+  std::optional<ErrorResponse> SchemaRegistry::validate(const Json& json,
+                                                        SchemaId id) {
+    auto& entry    = entries[static_cast<std::size_t>(id)];
+    auto validator = entry.acquire();
+
+    if (accept(json, *validator)) {
+      entry.release(std::move(validator));
+      return std::nullopt;
+    }
+
+    std::string msg;
+
+    rapidjson::StringBuffer buf;
+    validator->GetInvalidSchemaPointer().StringifyUriFragment(buf);
+    msg += "\n\t\tInvalid schema: ";
+    msg += buf.GetString();
+    msg += "\n\t\tInvalid keyword: ";
+    msg += validator->GetInvalidSchemaKeyword();
+
+    buf.Clear();
+    validator->GetInvalidDocumentPointer().StringifyUriFragment(buf);
+    msg += "\n\t\tInvalid document: ";
+    msg += buf.GetString();
+
+    entry.release(std::move(validator));
+
+    return ErrorResponse{
+      .code   = ERR_INVALID_RESPONSE,
+      .reason = msg,
+    };
+  }
+
+  SchemaValidationPolicy::SchemaValidationPolicy()
+    : mode(ValidationMode::Full),
+      sampleInterval(DEFAULT_VALIDATION_SAMPLE_INTERVAL),
+      counter(0) {}
+
+  void SchemaValidationPolicy::set(ValidationMode mode,
+                                   std::uint32_t sampleInterval) {
+    this->sampleInterval.store(sampleInterval == 0 ? 1 : sampleInterval,
+                               std::memory_order_relaxed);
+    this->mode.store(mode, std::memory_order_relaxed);
+  }
+
+  bool SchemaValidationPolicy::shouldValidate() noexcept {
+    switch (mode.load(std::memory_order_relaxed)) {
+      case ValidationMode::Full:
+        return true;
+      case ValidationMode::Sampled:
+        return counter.fetch_add(1, std::memory_order_relaxed)
+                 % sampleInterval.load(std::memory_order_relaxed)
+               == 0;
+      case ValidationMode::Off:
+        return false;
+      default:
+        return true;
+    }
+  }
+} // namespace octane::internal
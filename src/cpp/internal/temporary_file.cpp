@@ -0,0 +1,161 @@
+/**
+ * @file temporary_file.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief temporary_file.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/internal/temporary_file.h"
+
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "include/error_code.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief 他の一時ファイルと衝突しないファイル名を返す。
+     *
+     */
+    std::string temporaryName() {
+      static constexpr char HEX[] = "0123456789abcdef";
+      std::random_device device;
+      std::uniform_int_distribution<int> digit(0, 15);
+      std::string name = ".octane-";
+      for (int i = 0; i < 16; ++i) {
+        name.push_back(HEX[digit(device)]);
+      }
+      return name + ".tmp";
+    }
+    /**
+     * @brief pathの内容をディスクに書き出す。
+     * @details
+     * 書き出す前に名前を変更すると、電源断の後に中身が空のファイルが残ることがある。
+     */
+    bool syncFile(const std::filesystem::path& path) noexcept {
+#ifdef _WIN32
+      const auto handle = CreateFileW(path.c_str(),
+                                      GENERIC_WRITE,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                      nullptr,
+                                      OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL,
+                                      nullptr);
+      if (handle == INVALID_HANDLE_VALUE) return false;
+      const bool synced = FlushFileBuffers(handle) != 0;
+      CloseHandle(handle);
+      return synced;
+#else
+      const int fd = ::open(path.c_str(), O_WRONLY);
+      if (fd < 0) return false;
+      const bool synced = ::fsync(fd) == 0;
+      ::close(fd);
+      return synced;
+#endif
+    }
+  } // namespace
+
+  TemporaryFile::TemporaryFile(std::filesystem::path location,
+                               std::ofstream stream)
+    : location(std::move(location)),
+      stream(std::move(stream)),
+      failed(false) {}
+
+  Result<TemporaryFile, ErrorResponse> TemporaryFile::create(
+    const std::filesystem::path& directory) {
+    auto location = (directory.empty() ? "." : directory) / temporaryName();
+    std::ofstream stream(location, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+      return makeError(ERR_FILE_WRITE_FAILED,
+                       "Failed to create a temporary file in "
+                         + directory.string());
+    }
+    return ok(TemporaryFile(std::move(location), std::move(stream)));
+  }
+
+  TemporaryFile::TemporaryFile(TemporaryFile&& other) noexcept
+    : location(std::exchange(other.location, {})),
+      stream(std::move(other.stream)),
+      failed(other.failed) {}
+  TemporaryFile& TemporaryFile::operator=(TemporaryFile&& other) noexcept {
+    if (this != &other) {
+      discard();
+      location = std::exchange(other.location, {});
+      stream   = std::move(other.stream);
+      failed   = other.failed;
+    }
+    return *this;
+  }
+  TemporaryFile::~TemporaryFile() noexcept {
+    discard();
+  }
+
+  const std::filesystem::path& TemporaryFile::path() const noexcept {
+    return location;
+  }
+
+  void TemporaryFile::write(std::span<const std::uint8_t> data) {
+    if (failed) return;
+    stream.write(reinterpret_cast<const char*>(data.data()),
+                 static_cast<std::streamsize>(data.size()));
+    failed = !stream;
+  }
+
+  Result<_, ErrorResponse> TemporaryFile::close() {
+    if (stream.is_open()) {
+      stream.close();
+      failed = failed || !stream;
+    }
+    if (failed) {
+      return makeError(ERR_FILE_WRITE_FAILED,
+                       "Failed to write to " + location.string());
+    }
+    return ok();
+  }
+
+  void TemporaryFile::discard() noexcept {
+    if (stream.is_open()) {
+      stream.close();
+    }
+    if (!location.empty()) {
+      std::error_code ec;
+      std::filesystem::remove(location, ec);
+      location.clear();
+    }
+  }
+
+  Result<_, ErrorResponse> TemporaryFile::commit(
+    const std::filesystem::path& destination) {
+    const auto closed = close();
+    if (!closed) {
+      return error(closed.err());
+    }
+    if (!syncFile(location)) {
+      return makeError(ERR_FILE_WRITE_FAILED,
+                       "Failed to flush " + location.string());
+    }
+    std::error_code ec;
+    // 同じディレクトリ内での名前の変更なので、置き換えは不可分に行われる。
+    std::filesystem::rename(location, destination, ec);
+    if (ec) {
+      return makeError(ERR_FILE_WRITE_FAILED,
+                       "Failed to move the downloaded file to "
+                         + destination.string() + ": " + ec.message());
+    }
+    location.clear();
+    return ok();
+  }
+} // namespace octane::internal
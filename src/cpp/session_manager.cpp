@@ -0,0 +1,427 @@
+/**
+ * @file session_manager.cpp
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief session_manager.hの実装
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "include/session_manager.h"
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "include/error_code.h"
+#include "include/internal/content_codec.h"
+#include "include/internal/hash.h"
+
+namespace octane {
+  namespace {
+    /**
+     * @brief 接続していないルームを操作しようとしたときのエラー。
+     *
+     */
+    error_t<ErrorResponse> disconnectedError(std::uint64_t id) {
+      return makeError(ERR_ROOM_DISCONNECTED,
+                       "This device is disconnected from the room "
+                         + std::to_string(id));
+    }
+  } // namespace
+
+  SessionManager::SessionManager(std::string_view token,
+                                 std::string_view origin,
+                                 std::string_view baseUrl,
+                                 SessionManagerOptions options)
+    : transport(std::make_unique<internal::HttpClient>()),
+      fetch(std::make_unique<internal::Fetch>(
+        token, origin, baseUrl, transport.get())),
+      bridge(fetch.get()),
+      // 全てのルームで一つのモニタを共有する。
+      healthMonitor(std::make_shared<internal::HealthMonitor>(
+        [this]() { return bridge.healthGet(); })),
+      executor(&defaultExecutor()),
+      shardCount(std::max<std::size_t>(options.shards, 1)),
+      shards(std::make_unique<Shard[]>(shardCount)) {}
+
+  SessionManager::SessionManager(std::string_view token,
+                                 std::string_view origin,
+                                 std::string_view baseUrl,
+                                 internal::HttpClientBase* client,
+                                 SessionManagerOptions options)
+    : fetch(std::make_unique<internal::Fetch>(token, origin, baseUrl, client)),
+      bridge(fetch.get()),
+      healthMonitor(std::make_shared<internal::HealthMonitor>(
+        [this]() { return bridge.healthGet(); })),
+      executor(&defaultExecutor()),
+      shardCount(std::max<std::size_t>(options.shards, 1)),
+      shards(std::make_unique<Shard[]>(shardCount)) {}
+
+  SessionManager::~SessionManager() noexcept {
+    if (shutdownSource.isCancelled()) {
+      // 実行中の終了処理はメンバに触れるので、完了するまで破棄できない。
+      shutdownLatch.wait();
+      return;
+    }
+    // executorのスレッドで破棄されても待ち合わないように、I/Oスレッドで再開する。
+    syncWait(shutdownOn(
+      inlineExecutor(),
+      std::chrono::steady_clock::now() + DEFAULT_SHUTDOWN_TIMEOUT));
+  }
+
+  Result<Response, ErrorResponse> SessionManager::init() {
+    auto result = bridge.init();
+    if (!result) {
+      return error(result.err());
+    }
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Result<Response, ErrorResponse> SessionManager::connect(
+    std::uint64_t id,
+    std::string_view name) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    auto result = bridge.roomIdPost(id, name, "connect");
+    if (!result) {
+      return error(result.err());
+    }
+    bool recorded = false;
+    {
+      auto& shard = shardOf(id);
+      std::lock_guard lock(shard.mutex);
+      // 終了処理はキャンセルしてからセッションを集めるので、
+      // 同じロックの中で確かめれば、記録したセッションは必ず終了処理が切断する。
+      recorded = !shutdownSource.isCancelled();
+      if (recorded) {
+        shard.sessions.insert_or_assign(id,
+                                        Session{ .name = std::string(name) });
+      }
+    }
+    if (!recorded) {
+      // 終了処理からは見えないので、終了処理と同じ期限でここで切断する。
+      const internal::AsyncContext context{
+        .executor = &inlineExecutor(),
+        .token    = CancellationToken().withDeadline(
+          shutdownDeadline.load(std::memory_order_relaxed)),
+      };
+      [[maybe_unused]] const auto disconnected = syncWait(
+        bridge.roomIdPostAsync(context, id, std::string(name), "disconnect"));
+      return makeError(ERR_CANCELLED, "The operation was cancelled.");
+    }
+    return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+  Result<Response, ErrorResponse> SessionManager::disconnect(std::uint64_t id) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    const auto name = findSession(id);
+    if (!name.has_value()) {
+      return disconnectedError(id);
+    }
+    auto result = bridge.roomIdPost(id, name.value(), "disconnect");
+    if (!result) {
+      return error(result.err());
+    }
+    {
+      auto& shard = shardOf(id);
+      std::lock_guard lock(shard.mutex);
+      // 切断している間に別の名前で接続し直されていれば、そちらを残す。
+      const auto it = shard.sessions.find(id);
+      if (it != shard.sessions.end() && it->second.name == name.value()) {
+        shard.sessions.erase(it);
+      }
+    }
+    return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+  bool SessionManager::isConnected(std::uint64_t id) const {
+    return findSession(id).has_value();
+  }
+  std::vector<std::uint64_t> SessionManager::rooms() const {
+    std::vector<std::uint64_t> ids;
+    for (std::size_t i = 0; i < shardCount; ++i) {
+      std::lock_guard lock(shards[i].mutex);
+      for (const auto& [id, session] : shards[i].sessions) {
+        ids.push_back(id);
+      }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  Result<RoomStatus, ErrorResponse> SessionManager::getRoomStatus(
+    std::uint64_t id) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    auto result = bridge.roomIdGet(id);
+    if (!result) {
+      return error(result.err());
+    }
+
+    auto& response   = result.get();
+    response.health  = checkHealthResult.get().health;
+    response.message = std::move(checkHealthResult.get().message);
+    return ok(std::move(response));
+  }
+
+  Result<Content, ErrorResponse> SessionManager::getContent(std::uint64_t id) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    if (!isConnected(id)) {
+      return disconnectedError(id);
+    }
+
+    // ステータスとコンテンツは互いに依存しないので、並行して取得する。
+    // ステータスはI/Oスレッドで取得し、その間にこのスレッドでコンテンツを受信する。
+    internal::Pending statusRequest(
+      bridge.roomIdStatusGetAsync(internal::overlappedContext(), id));
+    internal::Hasher hasher;
+    std::vector<std::uint8_t> data;
+    auto result        = bridge.roomIdContentGet(
+      id, [&hasher, &data](std::span<const std::uint8_t> chunk) {
+        hasher.update(chunk);
+        data.insert(data.end(), chunk.begin(), chunk.end());
+      });
+    auto contentStatus = statusRequest.get();
+    if (!contentStatus) {
+      return error(contentStatus.err());
+    }
+    if (!result) {
+      return error(result.err());
+    }
+    auto content
+      = internal::decodeContent(std::move(contentStatus.get().first),
+                                contentStatus.get().second,
+                                hasher.finish(),
+                                std::move(data));
+    if (!content) {
+      return error(content.err());
+    }
+
+    content.get().health  = checkHealthResult.get().health;
+    content.get().message = std::move(checkHealthResult.get().message);
+    return ok(std::move(content.get()));
+  }
+
+  Result<Response, ErrorResponse> SessionManager::uploadContent(
+    std::uint64_t id,
+    const Content& content,
+    CompressionOptions compression) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    if (!isConnected(id)) {
+      return disconnectedError(id);
+    }
+    const auto body = internal::prepareUpload(content, compression);
+    if (!body) {
+      return error(body.err());
+    }
+
+    // コンテンツの送信と並行してハッシュ値を計算し、計算し終えたらステータスをPUTする。
+    // コンテンツはI/Oスレッドで送信する。
+    const auto data = body.get().bytes();
+    internal::Pending contentRequest(bridge.roomIdContentPutAsync(
+      internal::overlappedContext(), id, data, body.get().mime));
+    const auto resultS = bridge.roomIdStatusPut(
+      id, body.get().contentStatus, internal::generateHash(data));
+    const auto result  = contentRequest.get();
+    if (!resultS) {
+      return error(resultS.err());
+    }
+    if (!result) {
+      return error(result.err());
+    }
+
+    return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Result<Response, ErrorResponse> SessionManager::deleteContent(
+    std::uint64_t id) {
+    const auto checkHealthResult = checkHealth();
+    if (!checkHealthResult) {
+      return error(checkHealthResult.err());
+    }
+    if (!isConnected(id)) {
+      return disconnectedError(id);
+    }
+    auto result = bridge.roomIdContentDelete(id);
+    if (!result) {
+      return error(result.err());
+    }
+
+    return ok(Response{
+      .health  = checkHealthResult.get().health,
+      .message = std::move(checkHealthResult.get().message),
+    });
+  }
+
+  Task<Result<RoomStatus, ErrorResponse>> SessionManager::getRoomStatusAsync(
+    std::uint64_t id,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    auto result = co_await bridge.roomIdGetAsync(context, id);
+    if (!result) {
+      co_return error(result.err());
+    }
+
+    auto& response   = result.get();
+    response.health  = checkHealthResult.get().health;
+    response.message = std::move(checkHealthResult.get().message);
+    co_return ok(std::move(response));
+  }
+
+  Task<Result<Content, ErrorResponse>> SessionManager::getContentAsync(
+    std::uint64_t id,
+    CancellationToken token) {
+    const auto context           = makeContext(std::move(token));
+    const auto checkHealthResult = co_await checkHealthAsync(context);
+    if (!checkHealthResult) {
+      co_return error(checkHealthResult.err());
+    }
+    if (!isConnected(id)) {
+      co_return disconnectedError(id);
+    }
+
+    // コンテンツのハッシュ値はI/Oスレッドで受信しながら計算する。
+    internal::Hasher hasher;
+    std::vector<std::uint8_t> data;
+    const internal::BodyObserver observer
+      = [&hasher, &data](std::span<const std::uint8_t> chunk) {
+          hasher.update(chunk);
+          data.insert(data.end(), chunk.begin(), chunk.end());
+        };
+    auto [contentStatus, result]
+      = co_await whenAll(bridge.roomIdStatusGetAsync(context, id),
+                         bridge.roomIdContentGetAsync(context, id, observer));
+    if (!contentStatus) {
+      co_return error(contentStatus.err());
+    }
+    if (!result) {
+      co_return error(result.err());
+    }
+    auto content
+      = internal::decodeContent(std::move(contentStatus.get().first),
+                                contentStatus.get().second,
+                                hasher.finish(),
+                                std::move(data));
+    if (!content) {
+      co_return error(content.err());
+    }
+
+    content.get().health  = checkHealthResult.get().health;
+    content.get().message = std::move(checkHealthResult.get().message);
+    co_return ok(std::move(content.get()));
+  }
+
+  void SessionManager::setExecutor(Executor& executor) {
+    this->executor.store(&executor, std::memory_order_release);
+  }
+
+  Task<Result<_, ErrorResponse>> SessionManager::shutdownAsync(
+    std::chrono::steady_clock::time_point deadline) {
+    return shutdownOn(*executor.load(std::memory_order_acquire), deadline);
+  }
+  Task<Result<_, ErrorResponse>> SessionManager::shutdownOn(
+    Executor& executor,
+    std::chrono::steady_clock::time_point deadline) {
+    // 途中で破棄された場合も含めて、抜けるときに完了を記録する。
+    const internal::ShutdownLatch::Guard finished(shutdownLatch);
+    shutdownDeadline.store(deadline, std::memory_order_relaxed);
+    // 実行中の非同期の処理と、以降に始まる非同期の処理を中断する。
+    shutdownSource.cancel();
+    std::map<std::uint64_t, Session> sessions;
+    for (std::size_t i = 0; i < shardCount; ++i) {
+      std::lock_guard lock(shards[i].mutex);
+      sessions.merge(shards[i].sessions);
+    }
+
+    // ヘルスチェックは行わず、全てのルームから並行に切断する。
+    // 期限を過ぎたら残っているリクエストを中断する。
+    const internal::AsyncContext context{
+      .executor = &executor,
+      .token    = CancellationToken().withDeadline(deadline),
+    };
+    std::vector<Task<Result<_, ErrorResponse>>> disconnections;
+    disconnections.reserve(sessions.size());
+    for (const auto& [id, session] : sessions) {
+      disconnections.push_back(
+        bridge.roomIdPostAsync(context, id, session.name, "disconnect"));
+    }
+    const auto results = co_await whenAll(std::move(disconnections));
+    for (const auto& result : results) {
+      if (!result) {
+        co_return error(result.err());
+      }
+    }
+    co_return ok();
+  }
+
+  Result<HealthResult, ErrorResponse> SessionManager::checkHealth() {
+    return internal::verifyHealth(healthMonitor->current());
+  }
+  Task<Result<HealthResult, ErrorResponse>> SessionManager::checkHealthAsync(
+    internal::AsyncContext context) {
+    if (context.token.isCancelled()) {
+      co_return makeError(ERR_CANCELLED, "The operation was cancelled.");
+    }
+    const auto snapshot = healthMonitor->peek();
+    if (snapshot != nullptr
+        && internal::HealthMonitor::Clock::now() < snapshot->expiresAt) {
+      co_return internal::verifyHealth(ok(snapshot->health));
+    }
+    // キャッシュが無効な場合のヘルスチェックはブロックするので、executorのスレッドに移ってから行う。
+    co_await internal::ScheduleOn{ *context.executor };
+    co_return internal::verifyHealth(healthMonitor->current());
+  }
+  internal::AsyncContext SessionManager::makeContext(
+    CancellationToken token) const {
+    return internal::AsyncContext{
+      .executor = executor.load(std::memory_order_acquire),
+      .token    = token.linkedWith(shutdownSource.token()),
+    };
+  }
+
+  SessionManager::Shard& SessionManager::shardOf(std::uint64_t id) const {
+    return shards[id % shardCount];
+  }
+  std::optional<std::string> SessionManager::findSession(
+    std::uint64_t id) const {
+    auto& shard = shardOf(id);
+    std::lock_guard lock(shard.mutex);
+    const auto it = shard.sessions.find(id);
+    if (it == shard.sessions.end()) return std::nullopt;
+    return it->second.name;
+  }
+} // namespace octane
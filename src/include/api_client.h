@@ -11,17 +11,83 @@
 #ifndef OCTANE_API_CLIENT_API_CLIENT_H_
 #define OCTANE_API_CLIENT_API_CLIENT_H_
 
+#include <gtest/gtest_prod.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "./api_options.h"
 #include "./api_result_types.h"
+#include "./cancellation.h"
 #include "./config.h"
+#include "./content_watch.h"
 #include "./error_response.h"
+#include "./event_loop.h"
+#include "./executor.h"
 #include "./internal/api_bridge.h"
+#include "./internal/async.h"
+#include "./internal/content_cache.h"
+#include "./internal/content_prefetcher.h"
 #include "./internal/hash.h"
+#include "./internal/health_monitor.h"
+#include "./internal/room_status_cache.h"
+#include "./internal/shutdown_latch.h"
 #include "./result.h"
+#include "./room_subscription.h"
+#include "./task.h"
 namespace octane {
+  /**
+   * @brief Client for OctaneServer
+   * @details
+   * Except for init() and the destructor, every method may be called from
+   * multiple threads at once on the same instance. Requests are not
+   * serialized: the transport keeps a pool of connections, the health of the
+   * server is cached without blocking readers, and the connected room is
+   * published as an immutable snapshot. Each method reads that snapshot once,
+   * so a concurrent connectRoom() or disconnectRoom() never mixes the id of
+   * one room with the device name of another.
+   *
+   * Each operation also has an asynchronous counterpart suffixed with Async,
+   * which returns a {@link Task} to be awaited from a coroutine:
+   * @code
+   * auto content = co_await client.getContentAsync(source.token());
+   * @endcode
+   * The requests of these methods are multiplexed on the I/O thread of the
+   * transport, and the awaiting coroutines are resumed on the executor
+   * selected with setExecutor(), so a few threads can drive a large number of
+   * operations. The client must outlive every task it returns.
+   *
+   * A client constructed with an {@link EventLoop} creates no I/O thread.
+   * Its asynchronous requests are driven by the application's loop through
+   * onSocketEvent() and onTimeout(), and the coroutines are resumed inside
+   * those calls, on the loop's thread. With such a client, asynchronous
+   * methods must be started on the loop's thread.
+   *
+   */
   class ApiClient {
+    FRIEND_TEST(ApiClientContentPrefetchTest, GetContentUsesPrefetchedContent);
+
+    /**
+     * @brief Transport driven by the application's event loop.
+     * @details
+     * Null unless the client is constructed with an {@link EventLoop}.
+     *
+     */
+    std::unique_ptr<internal::HttpClient> loopTransport;
     internal::ApiBridge bridge;
-    std::uint64_t lastCheckedTime;
-    HealthResult lastCheckedHealth;
+    /**
+     * @brief Health monitor shared by every client with the same origin,
+     * base URL and token.
+     *
+     */
+    std::shared_ptr<internal::HealthMonitor> healthMonitor;
     struct ConnectionStatus {
       bool isConnected;
       /**
@@ -35,7 +101,75 @@ namespace octane {
        */
       std::string name;
     };
-    ConnectionStatus connectionStatus;
+    /**
+     * @brief Room this client is connected to.
+     * @details
+     * The pointee is never modified once published. Updates replace the
+     * pointer while holding connectionMutex, which is also held just long
+     * enough to copy the pointer when reading it.
+     *
+     */
+    std::shared_ptr<const ConnectionStatus> connectionStatus;
+    mutable std::mutex connectionMutex;
+    /**
+     * @brief Executor which resumes the asynchronous methods.
+     *
+     */
+    std::atomic<Executor*> executor;
+    /**
+     * @brief Guards the caches and the prefetcher below.
+     * @details
+     * Declared before them so that it outlives them; the prefetcher's thread
+     * locks it until the prefetcher is stopped.
+     *
+     */
+    mutable std::mutex cacheMutex;
+    /**
+     * @brief Cache of the contents, or null if it is disabled.
+     * @details
+     * Replaced while holding cacheMutex, like connectionStatus.
+     *
+     */
+    std::shared_ptr<const internal::ContentCache> contentCache;
+    /**
+     * @brief Cache of the room statuses, or null if it is disabled.
+     * @details
+     * Replaced while holding cacheMutex, like contentCache.
+     *
+     */
+    std::shared_ptr<internal::RoomStatusCache> roomStatusCache;
+    /**
+     * @brief Prefetcher of the contents, or null if it is disabled.
+     * @details
+     * Replaced while holding cacheMutex, like contentCache.
+     *
+     */
+    std::shared_ptr<internal::ContentPrefetcher> contentPrefetcher;
+    /**
+     * @brief Cancelled by shutdownAsync().
+     * @details
+     * Every asynchronous operation observes it in addition to the token
+     * passed by the caller.
+     *
+     */
+    CancellationSource shutdownSource;
+    /**
+     * @brief Deadline passed to shutdownAsync().
+     * @details
+     * Stored before shutdownSource is cancelled. A connection completed
+     * after the shutdown started is undone within this deadline.
+     *
+     */
+    std::atomic<std::chrono::steady_clock::time_point> shutdownDeadline;
+    /**
+     * @brief Released once shutdownAsync() has finished.
+     * @details
+     * shutdownSource only tells that the shutdown has started. The
+     * destructor waits for this instead, since the shutdown still touches
+     * the members until it finishes.
+     *
+     */
+    internal::ShutdownLatch shutdownLatch;
 
   public:
     /**
@@ -48,8 +182,50 @@ namespace octane {
     ApiClient(std::string_view token   = DEFAULT_API_TOKEN,
               std::string_view origin  = DEFAULT_API_ORIGIN,
               std::string_view baseUrl = DEFAULT_API_BASE_URL);
+    /**
+     * @brief Construct a new Api Client object with the given transport
+     * @details
+     * The client does not take ownership of the transport, which must outlive
+     * the client and accept concurrent requests. The health of the server is
+     * checked through this transport and is not shared with other clients.
+     *
+     * @param[in] token
+     * @param[in] origin http://localhost:3000
+     * @param[in] baseUrl /api/v1
+     * @param[in] client Transport used for every request
+     */
+    ApiClient(std::string_view token,
+              std::string_view origin,
+              std::string_view baseUrl,
+              internal::HttpClientBase* client);
+    /**
+     * @brief Construct a new Api Client object driven by an event loop
+     * @details
+     * The loop must outlive the client. The asynchronous methods are resumed
+     * with {@link inlineExecutor} unless another executor is selected, and
+     * the health of the server is refreshed on demand instead of on a
+     * background thread.
+     *
+     * @param[in] token
+     * @param[in] origin http://localhost:3000
+     * @param[in] baseUrl /api/v1
+     * @param[in] loop Event loop which drives the asynchronous requests
+     */
+    ApiClient(std::string_view token,
+              std::string_view origin,
+              std::string_view baseUrl,
+              EventLoop& loop);
     /**
      * @brief Destroy the Api Client object
+     * @details
+     * If shutdownAsync() has been started, the destructor waits for it to
+     * finish, which its deadline bounds as long as its executor runs.
+     * Otherwise the room still connected is disconnected as by
+     * shutdownAsync(), waiting at most {@link DEFAULT_SHUTDOWN_TIMEOUT}.
+     * A client driven by an event loop cannot wait for its loop here. It
+     * cancels the requests of a shutdown in flight, or else disconnects
+     * synchronously, giving up after {@link DEFAULT_SHUTDOWN_TIMEOUT}; let
+     * shutdownAsync() complete on the loop beforehand to avoid blocking.
      *
      */
     ~ApiClient() noexcept;
@@ -99,6 +275,8 @@ namespace octane {
      * fails, the following error response will be returned.
      * - ERR_CURL_CONNECTION_FAILED
      * - ERR_SERVER_HEALTH_STATUS_FAULTY
+     * - ERR_CANCELLED: shutdownAsync() started before the connection was
+     *   recorded. The room is disconnected again before returning.
      * Additionaly, when a response other than 2xx is returned, the
      * error passed from the server in the form of error response is returned.
      * @param[in] id Room id
@@ -165,10 +343,62 @@ namespace octane {
      */
     Result<Response, ErrorResponse> deleteRoom(std::optional<std::uint64_t> id
                                                = std::nullopt);
+    /**
+     * @brief Gets the statuses of many rooms at once
+     * @details
+     * This method returns the {@link RoomStatus} of every room in ids.
+     * At most concurrency requests are in flight at the same time, and they
+     * share one health check and the pooled connections.
+     * The result of each room is returned in the same order as ids, so a
+     * room which fails does not affect the others. Each item can fail with
+     * the error responses of {@link getRoomStatus}.
+     * The whole call fails only when the health check fails, with the
+     * following error response.
+     * - ERR_JSON_PARSE_FAILED
+     * - ERR_INVALID_RESPONSE
+     * - ERR_CURL_CONNECTION_FAILED
+     * - ERR_SERVER_HEALTH_STATUS_FAULTY
+     * @param[in] ids Room ids
+     * @param[in] concurrency Maximum number of requests in flight
+     * @return Result<std::vector<Result<RoomStatus, ErrorResponse>>,
+     * ErrorResponse>
+     * On success, it will return the result of each room.
+     * On failure, it will return the error response written above.
+     */
+    Result<std::vector<Result<RoomStatus, ErrorResponse>>, ErrorResponse>
+    getRoomStatuses(std::span<const std::uint64_t> ids,
+                    std::size_t concurrency = DEFAULT_BATCH_CONCURRENCY);
+    /**
+     * @brief Deletes many rooms at once
+     * @details
+     * This method deletes every room in ids.
+     * At most concurrency requests are in flight at the same time, and they
+     * share one health check and the pooled connections.
+     * The result of each room is returned in the same order as ids, so a
+     * room which fails does not affect the others. Each item can fail with
+     * the error responses of {@link deleteRoom}.
+     * The whole call fails only when the health check fails, with the
+     * following error response.
+     * - ERR_JSON_PARSE_FAILED
+     * - ERR_INVALID_RESPONSE
+     * - ERR_CURL_CONNECTION_FAILED
+     * - ERR_SERVER_HEALTH_STATUS_FAULTY
+     * @param[in] ids Room ids
+     * @param[in] concurrency Maximum number of requests in flight
+     * @return Result<std::vector<Result<Response, ErrorResponse>>,
+     * ErrorResponse>
+     * On success, it will return the result of each room.
+     * On failure, it will return the error response written above.
+     */
+    Result<std::vector<Result<Response, ErrorResponse>>, ErrorResponse>
+    deleteRooms(std::span<const std::uint64_t> ids,
+                std::size_t concurrency = DEFAULT_BATCH_CONCURRENCY);
     /**
      * @brief Gets the room's content
      * @details
      * This method returns the room's {@link Content}.
+     * The status and the content are requested concurrently, and the hash is
+     * checked once both have arrived.
      * If it fails, the following error response will be returned.
      * - ERR_JSON_PARSE_FAILED
      * - ERR_INVALID_RESPONSE
@@ -182,6 +412,27 @@ namespace octane {
      * On failure, it will return the error response written above.
      */
     Result<Content, ErrorResponse> getContent();
+    /**
+     * @brief Downloads the room's content to a file
+     * @details
+     * Same as {@link getContent}, but the content is written to a temporary
+     * file next to path while it is received and hashed, instead of being
+     * held in memory, so the memory used does not grow with the size of the
+     * content. Once the hash matches, a file or clipboard content replaces
+     * the file at path by renaming the temporary file, so path never holds a
+     * partial content. A multiple file content is extracted into the
+     * directory at path instead, which is created if missing; entries that
+     * would be written outside of it are refused. In addition to the errors
+     * of {@link getContent}, the following error response will be returned.
+     * - ERR_FILE_WRITE_FAILED
+     * - ERR_DECOMPRESSION_FAILED
+     * @param[in] path File to write, or directory to extract into
+     * @return Result<ContentStatus, ErrorResponse>
+     * On success, it will return the status of the downloaded content.
+     * On failure, it will return the error response written above.
+     */
+    Result<ContentStatus, ErrorResponse> downloadContent(
+      const std::filesystem::path& path);
     /**
      * @brief Deletes the room's content
      * @details
@@ -201,46 +452,416 @@ namespace octane {
      * @brief Uploads content to the room
      * @details
      * This method uploads the content (file or clipboard) to the room, by
-     * passing it {@link Content}. If it fails, the following error response
-     * will be returned.
+     * passing it {@link Content}. The status and the content are sent
+     * concurrently. With {@link UploadOptions::skipUnchanged}, the status of
+     * the room is fetched while the content is hashed, and the content is not
+     * sent if the room already holds the same hash; the status is then only
+     * sent if the device, type or MIME differs. If it fails, the following
+     * error response will be returned.
      * - ERR_CURL_CONNECTION_FAILED
      * - ERR_SERVER_HEALTH_STATUS_FAULTY
      * - ERR_ROOM_DISCONNECTED
      * Additionaly, when a response other than 2xx is returned, the
      * error passed from the server in the form of error response is returned.
      * @param[in] content Content you want to upload
+     * @param[in] options Whether unchanged content is skipped
      * @return Result<Response, ErrorResponse>
      * On success, it will return {@link Response}.
      * On failure, it will return the error response written above.
      */
-    Result<Response, ErrorResponse> uploadContent(const Content& content);
-
-  private:
+    Result<Response, ErrorResponse> uploadContent(const Content& content,
+                                                  UploadOptions options = {});
     /**
-     * @brief Returns the server's status
+     * @brief Uploads a borrowed buffer to the room
      * @details
-     * This pricate method returns the server's status in type {@link
-     * HealthResult}. If it fails, the following error response will be
-     * returned.
-     * - ERR_JSON_PARSE_FAILED
-     * - ERR_INVALID_RESPONSE
-     * - ERR_CURL_CONNECTION_FAILED
-     * - ERR_SERVER_HEALTH_STATUS_FAULTY
-     * Additionaly, when a response other than 2xx is returned, the
-     * error passed from the server in the form of error response is returned.
-     * @return Result<HealthResult, ErrorResponse>
-     * On success, it will return {@link HealthResult}.
+     * Same as {@link uploadContent(const Content&, UploadOptions)}, but the
+     * data of a file or clipboard is taken as a span of the caller's buffer.
+     * The buffer is hashed and sent in place without being copied, so it
+     * must stay valid and unchanged until this method returns. Since a
+     * multiple file content has to be compressed, contentStatus.type must not
+     * be {@link ContentType::MultiFile}; otherwise the following error
+     * response will be returned in addition to those of {@link
+     * uploadContent(const Content&, UploadOptions)}.
+     * - ERR_CONTENT_TYPE_DATA_MISMATCH
+     * @param[in] contentStatus Status of the content you want to upload
+     * @param[in] data Data of the content
+     * @param[in] options Whether unchanged content is skipped
+     * @return Result<Response, ErrorResponse>
+     * On success, it will return {@link Response}.
      * On failure, it will return the error response written above.
      */
-    Result<HealthResult, ErrorResponse> health();
+    Result<Response, ErrorResponse> uploadContent(
+      const ContentStatus& contentStatus,
+      std::span<const std::byte> data,
+      UploadOptions options = {});
     /**
-     * @brief Calls health if this method was previously called more than 30
-     * minutes ago
+     * @brief Uploads a borrowed string to the room
      * @details
-     * This private method checks if the client has called this method more than
-     * 30 minutes ago, and if so, this method calls health, and if the server is
-     * not faulty, it returns {@link HealthResult}.
-     * If it fails, the following error response will be returned.
+     * Same as {@link uploadContent(const ContentStatus&,
+     * std::span<const std::byte>, UploadOptions)} with the bytes of data.
+     * @param[in] contentStatus Status of the content you want to upload
+     * @param[in] data Data of the content
+     * @param[in] options Whether unchanged content is skipped
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> uploadContent(
+      const ContentStatus& contentStatus,
+      std::string_view data,
+      UploadOptions options = {});
+    /**
+     * @brief Uploads a file to the room without reading it into memory
+     * @details
+     * Same as {@link uploadContent(const ContentStatus&,
+     * std::span<const std::byte>, UploadOptions)}, but the data is the file
+     * at path. The file is mapped into memory instead of being read, and is
+     * hashed and sent from the mapping, so the memory used does not grow
+     * with the size of the file. The file must not be modified until this
+     * method returns. In addition to the errors of {@link uploadContent(const
+     * ContentStatus&, std::span<const std::byte>, UploadOptions)}, the
+     * following error response will be returned.
+     * - ERR_FILE_OPEN_FAILED
+     * @param[in] contentStatus Status of the content you want to upload
+     * @param[in] path Path of the file to upload
+     * @param[in] options Whether unchanged content is skipped
+     * @return Result<Response, ErrorResponse>
+     * On success, it will return {@link Response}.
+     * On failure, it will return the error response written above.
+     */
+    Result<Response, ErrorResponse> uploadFile(
+      const ContentStatus& contentStatus,
+      const std::filesystem::path& path,
+      UploadOptions options = {});
+    /**
+     * @brief Watches the content of the connected room
+     * @details
+     * This method polls the status of the connected room on a thread of the
+     * watch, and downloads the content only when its hash or timestamp (or
+     * the connected room) changes. The content is then passed to callback,
+     * with the same errors as {@link getContent}. The polling interval starts
+     * at {@link WatchOptions::minInterval}, grows while nothing changes, and
+     * is reset on a change. Errors while polling, such as
+     * ERR_ROOM_DISCONNECTED, are also passed to callback and the watch goes
+     * on. The client must outlive the returned handle.
+     * @param[in] callback Function called on the thread of the watch with
+     * the new content or an error
+     * @param[in] options Polling intervals and whether the initial content is
+     * reported
+     * @return ContentWatch Handle which stops the watch when destroyed
+     */
+    ContentWatch watchContent(
+      std::function<void(Result<Content, ErrorResponse>)> callback,
+      WatchOptions options = {});
+    /**
+     * @brief Subscribes to changes of the connected room
+     * @details
+     * This method connects to the event stream of the connected room
+     * (GET /room/{id}/events, see README) on a thread of the subscription,
+     * and passes each change to callback as a {@link RoomEvent}: new content,
+     * and devices joining or leaving. The room is looked up whenever the
+     * stream connects.
+     * While the stream is unavailable or disconnected, the room is polled
+     * every {@link SubscribeOptions::pollInterval} instead and the
+     * differences are reported, so a server without the event stream still
+     * works. The stream is retried with a growing delay. A change is never
+     * reported twice, and the state when the subscription starts is not
+     * reported. Errors while polling, such as ERR_ROOM_DISCONNECTED, are
+     * passed to callback and the subscription goes on. The client must
+     * outlive the returned handle.
+     * @param[in] callback Function called on the thread of the subscription
+     * with each change or an error
+     * @param[in] options Polling and reconnection intervals
+     * @return RoomSubscription Handle which stops the subscription when
+     * destroyed
+     */
+    RoomSubscription subscribeRoom(
+      std::function<void(Result<RoomEvent, ErrorResponse>)> callback,
+      SubscribeOptions options = {});
+    /**
+     * @brief Asynchronous version of {@link createRoom}
+     * @details
+     * Every asynchronous method returns the same error responses as its
+     * synchronous version. In addition, ERR_CANCELLED is returned when token
+     * is cancelled before the operation completes; requests in flight are
+     * aborted. The task does not start until it is awaited.
+     * @param[in] name Room name
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<RoomId, ErrorResponse>>
+     */
+    Task<Result<RoomId, ErrorResponse>> createRoomAsync(
+      std::string name,
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link connectRoom}
+     *
+     * @param[in] id Room id
+     * @param[in] name Device name
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> connectRoomAsync(
+      std::uint64_t id,
+      std::string name,
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link disconnectRoom}
+     *
+     * @param[in] id Room id
+     * @param[in] name Device name
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> disconnectRoomAsync(
+      std::uint64_t id,
+      std::string name,
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link getRoomStatus}
+     *
+     * @param[in] id Room id. If omitted, the connected room is used.
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<RoomStatus, ErrorResponse>>
+     */
+    Task<Result<RoomStatus, ErrorResponse>> getRoomStatusAsync(
+      std::optional<std::uint64_t> id = std::nullopt,
+      CancellationToken token         = {});
+    /**
+     * @brief Asynchronous version of {@link deleteRoom}
+     *
+     * @param[in] id Room id. If omitted, the connected room is used.
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> deleteRoomAsync(
+      std::optional<std::uint64_t> id = std::nullopt,
+      CancellationToken token         = {});
+    /**
+     * @brief Asynchronous version of {@link getContent}
+     * @details
+     * The status and the content are requested concurrently.
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<Content, ErrorResponse>>
+     */
+    Task<Result<Content, ErrorResponse>> getContentAsync(
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link downloadContent}
+     * @details
+     * The content is written to the file on the I/O thread as it arrives.
+     * @param[in] path File to write, or directory to extract into
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<ContentStatus, ErrorResponse>>
+     */
+    Task<Result<ContentStatus, ErrorResponse>> downloadContentAsync(
+      std::filesystem::path path,
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link deleteContent}
+     *
+     * @param[in] token Token to cancel the operation
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> deleteContentAsync(
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link uploadContent}
+     * @details
+     * The content is taken by value so that it stays valid until the task
+     * completes. The status and the content are sent concurrently.
+     * @param[in] content Content you want to upload
+     * @param[in] token Token to cancel the operation
+     * @param[in] options Whether unchanged content is skipped
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> uploadContentAsync(
+      Content content,
+      CancellationToken token = {},
+      UploadOptions options   = {});
+    /**
+     * @brief Asynchronous version of {@link uploadContent(const
+     * ContentStatus&, std::span<const std::byte>, UploadOptions)}
+     * @details
+     * The buffer is not copied, so it must stay valid and unchanged until the
+     * task completes.
+     * @param[in] contentStatus Status of the content you want to upload
+     * @param[in] data Data of the content
+     * @param[in] token Token to cancel the operation
+     * @param[in] options Whether unchanged content is skipped
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> uploadContentAsync(
+      ContentStatus contentStatus,
+      std::span<const std::byte> data,
+      CancellationToken token = {},
+      UploadOptions options   = {});
+    /**
+     * @brief Asynchronous version of {@link uploadContent(const
+     * ContentStatus&, std::string_view, UploadOptions)}
+     * @details
+     * The string is not copied, so it must stay valid and unchanged until the
+     * task completes.
+     * @param[in] contentStatus Status of the content you want to upload
+     * @param[in] data Data of the content
+     * @param[in] token Token to cancel the operation
+     * @param[in] options Whether unchanged content is skipped
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> uploadContentAsync(
+      ContentStatus contentStatus,
+      std::string_view data,
+      CancellationToken token = {},
+      UploadOptions options   = {});
+    /**
+     * @brief Asynchronous version of {@link uploadFile}
+     * @details
+     * The file is mapped when the task starts and stays mapped until the
+     * task completes, so it must not be modified until then.
+     * @param[in] contentStatus Status of the content you want to upload
+     * @param[in] path Path of the file to upload
+     * @param[in] token Token to cancel the operation
+     * @param[in] options Whether unchanged content is skipped
+     * @return Task<Result<Response, ErrorResponse>>
+     */
+    Task<Result<Response, ErrorResponse>> uploadFileAsync(
+      ContentStatus contentStatus,
+      std::filesystem::path path,
+      CancellationToken token = {},
+      UploadOptions options   = {});
+    /**
+     * @brief Selects the executor which resumes the asynchronous methods
+     * @details
+     * By default, {@link defaultExecutor} is used. The executor must outlive
+     * every task started after this call. Tasks already started keep the
+     * executor they were started with.
+     * @param[in] executor Executor to use
+     */
+    void setExecutor(Executor& executor);
+    /**
+     * @brief Shuts the client down before it is destroyed
+     * @details
+     * Cancels every asynchronous operation in flight, which completes with
+     * ERR_CANCELLED, as does every asynchronous operation started
+     * afterwards. Prefetching is stopped. Then the room this client is
+     * connected to, if any, is disconnected without checking the health of
+     * the server first. The request is aborted with ERR_CANCELLED once
+     * deadline has passed. The room is forgotten even if the request fails.
+     *
+     * Synchronous requests already in flight cannot be cancelled and run to
+     * completion. Subscriptions and watches must be stopped by their owners.
+     * @param[in] deadline Time after which the disconnection is given up
+     * @return Task<Result<_, ErrorResponse>>
+     * On failure, it will return the error response of the disconnection.
+     */
+    Task<Result<_, ErrorResponse>> shutdownAsync(
+      std::chrono::steady_clock::time_point deadline);
+    /**
+     * @brief Reports that a socket watched through {@link
+     * EventLoop::watchSocket} is ready
+     * @details
+     * Call this on the loop's thread. Completed operations are resumed
+     * before this method returns. Does nothing unless the client was
+     * constructed with an {@link EventLoop}.
+     * @param[in] socket Socket which became ready
+     * @param[in] events Whether it is readable and/or writable
+     */
+    void onSocketEvent(NativeSocket socket, SocketEvents events);
+    /**
+     * @brief Reports that the timer armed through {@link
+     * EventLoop::setTimer} expired
+     * @details
+     * Call this on the loop's thread. Does nothing unless the client was
+     * constructed with an {@link EventLoop}.
+     */
+    void onTimeout();
+    /**
+     * @brief Sets how responses from the server are validated
+     * @details
+     * By default every response is validated against its JSON schema
+     * ({@link ValidationMode::Full}). With {@link ValidationMode::Sampled} only
+     * one in every sampleInterval responses is validated, and with {@link
+     * ValidationMode::Off} validation is skipped. Error responses from the
+     * server are always validated.
+     * @param[in] mode Validation mode
+     * @param[in] sampleInterval Interval used with {@link
+     * ValidationMode::Sampled}
+     */
+    void setValidationMode(ValidationMode mode,
+                           std::uint32_t sampleInterval
+                           = DEFAULT_VALIDATION_SAMPLE_INTERVAL);
+    /**
+     * @brief Caches the downloaded contents on disk
+     * @details
+     * Once enabled, {@link getContent}, {@link getContentAsync} and {@link
+     * watchContent} look the hash from the status of the room up in the
+     * cache, and download the content only when it is missing. Since the hash
+     * is needed first, the status and the content are then requested one
+     * after the other. Downloaded contents are stored once their hash is
+     * verified. Cached contents are mapped into memory when read. Calling
+     * this method again replaces the cache. If it fails, the following error
+     * response will be returned.
+     * - ERR_FILE_WRITE_FAILED
+     * @param[in] options Directory and size limit of the cache
+     * @return Result<_, ErrorResponse>
+     */
+    Result<_, ErrorResponse> enableContentCache(ContentCacheOptions options);
+    /**
+     * @brief Stops using the content cache
+     * @details
+     * The cached contents are left on disk.
+     */
+    void disableContentCache();
+    /**
+     * @brief Caches the room statuses in memory
+     * @details
+     * Once enabled, {@link getRoomStatus}, {@link getRoomStatusAsync} and
+     * {@link getRoomStatuses} return the status fetched within the last
+     * options.ttl without a request. Concurrent calls for a room which is not
+     * cached share one request. {@link connectRoom}, {@link disconnectRoom},
+     * {@link deleteRoom}, their asynchronous versions and {@link deleteRooms}
+     * of this client drop the status of the room, so they are seen at once.
+     * Changes made by other clients are seen after up to options.ttl.
+     * Calling this method again replaces the cache with an empty one.
+     * @param[in] options Time to live and number of shards of the cache
+     */
+    void enableRoomStatusCache(RoomStatusCacheOptions options = {});
+    /**
+     * @brief Stops caching the room statuses
+     *
+     */
+    void disableRoomStatusCache();
+    /**
+     * @brief Downloads new contents in the background
+     * @details
+     * Once enabled, a new hash reported by {@link subscribeRoom}, either
+     * pushed by the event stream or found by polling, starts downloading the
+     * content on a thread of the prefetcher. The content is verified,
+     * decompressed and held in memory, and so is the content downloaded by
+     * {@link watchContent}. {@link getContent} and {@link getContentAsync}
+     * then request the status first, and return the held content without
+     * downloading it when the hash and timestamp match. When a newer content
+     * is reported, the download in progress is cancelled and the held
+     * content is dropped. Only one content is held, and not one larger than
+     * options.maxBytes. A failed download is not reported; the content is
+     * simply downloaded when requested. Calling this method again replaces
+     * the prefetcher with an empty one.
+     * @param[in] options Size limit of the prefetched content
+     */
+    void enableContentPrefetch(PrefetchOptions options = {});
+    /**
+     * @brief Stops prefetching the contents
+     * @details
+     * The download in progress, if any, is cancelled and waited for.
+     */
+    void disableContentPrefetch();
+
+  private:
+    /**
+     * @brief Returns the cached health of the server
+     * @details
+     * This private method returns the {@link HealthResult} held by the shared
+     * health monitor, which refreshes it in the background before it expires.
+     * Only when no valid result is cached, this method calls /health on the
+     * calling thread. If the server is faulty or the check fails, the
+     * following error response will be returned.
      * - ERR_JSON_PARSE_FAILED
      * - ERR_INVALID_RESPONSE
      * - ERR_CURL_CONNECTION_FAILED
@@ -252,6 +873,117 @@ namespace octane {
      * On failure, it will return the error response written above.
      */
     Result<HealthResult, ErrorResponse> checkHealth();
+    /**
+     * @brief Asynchronous version of {@link checkHealth}
+     * @details
+     * A valid cached result is returned without suspending. Otherwise the
+     * check blocks, so it is run on a thread of the executor. A client driven
+     * by an event loop instead requests /health asynchronously.
+     */
+    Task<Result<HealthResult, ErrorResponse>> checkHealthAsync(
+      internal::AsyncContext context);
+    /**
+     * @brief Uploads data already converted for upload
+     * @details
+     * The body shared by the overloads of {@link uploadContent}. data is sent
+     * without being copied.
+     * @param[in] contentStatus Status of the content
+     * @param[in] data Data to send
+     * @param[in] mime MIME to send the data with
+     * @param[in] options Whether unchanged content is skipped
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> uploadBytes(
+      const ContentStatus& contentStatus,
+      std::span<const std::uint8_t> data,
+      std::string_view mime,
+      UploadOptions options);
+    /**
+     * @brief Asynchronous version of {@link uploadBytes}
+     * @details
+     * contentStatus and data must stay valid until the task completes.
+     */
+    Task<Result<Response, ErrorResponse>> uploadBytesAsync(
+      internal::AsyncContext context,
+      const ContentStatus& contentStatus,
+      std::span<const std::uint8_t> data,
+      std::string mime,
+      UploadOptions options);
+    /**
+     * @brief Records the connection unless shutdownAsync() has started
+     * @details
+     * The check and the update are made while holding connectionMutex, which
+     * the shutdown also takes after cancelling shutdownSource. Therefore a
+     * recorded connection is always seen and disconnected by the shutdown.
+     * @param[in] id Room id
+     * @param[in] name Device name
+     * @return bool false if the shutdown has started
+     */
+    bool recordConnection(std::uint64_t id, std::string name);
+    /**
+     * @brief Disconnects from a room connected after the shutdown started
+     * @details
+     * Gives up at {@link shutdownDeadline}, like the shutdown itself.
+     */
+    Task<Result<_, ErrorResponse>> disconnectAfterShutdown(
+      Executor& executor,
+      std::uint64_t id,
+      std::string name);
+    /**
+     * @brief Body of {@link shutdownAsync}, which resumes on executor
+     *
+     */
+    Task<Result<_, ErrorResponse>> shutdownOn(
+      Executor& executor,
+      std::chrono::steady_clock::time_point deadline);
+    internal::AsyncContext makeContext(CancellationToken token) const;
+    /**
+     * @brief Starts getting the status of room id, which a synchronous
+     * method overlaps with its own request
+     * @details
+     * The request runs on the transport's I/O thread. A client driven by an
+     * event loop gets the status before returning instead, since the loop
+     * does not run while the caller waits.
+     *
+     */
+    internal::Pending<
+      Result<std::pair<ContentStatus, std::string>, ErrorResponse>>
+    startRoomStatusGet(std::uint64_t id);
+    /**
+     * @brief Starts sending data as the content of room id, like
+     * {@link startRoomStatusGet}
+     * @details
+     * data must stay valid until the result has been received.
+     *
+     */
+    internal::Pending<Result<_, ErrorResponse>> startContentPut(
+      std::uint64_t id,
+      std::span<const std::uint8_t> data,
+      std::string_view mime);
+    std::shared_ptr<const ConnectionStatus> loadConnectionStatus() const;
+    std::shared_ptr<const internal::ContentCache> loadContentCache() const;
+    std::shared_ptr<internal::RoomStatusCache> loadRoomStatusCache() const;
+    std::shared_ptr<internal::ContentPrefetcher> loadContentPrefetcher() const;
+    /**
+     * @brief Gets the status of the room through the room status cache
+     * @details
+     * Requests it directly when the cache is disabled. It fails with the
+     * error responses of {@link internal::ApiBridge::roomIdGet}.
+     */
+    Result<RoomStatus, ErrorResponse> fetchRoomStatus(std::uint64_t id);
+    /**
+     * @brief Asynchronous version of {@link fetchRoomStatus}
+     *
+     */
+    Task<Result<RoomStatus, ErrorResponse>> fetchRoomStatusAsync(
+      internal::AsyncContext context,
+      std::uint64_t id);
+    /**
+     * @brief Drops the cached status of the room after a request changed it
+     *
+     */
+    void invalidateRoomStatus(std::uint64_t id);
+    void storeConnectionStatus(ConnectionStatus status);
   };
 } // namespace octane
 
@@ -0,0 +1,233 @@
+/**
+ * @file api_options.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Options which change the behavior of {@link ApiClient}.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_API_OPTIONS_H_
+#define OCTANE_API_CLIENT_API_OPTIONS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace octane {
+  /**
+   * @brief Enum which represents how responses from the server are validated
+   * against their JSON schema.
+   *
+   */
+  enum struct ValidationMode {
+    /** @brief Every response is validated. */
+    Full,
+    /** @brief One in every N responses is validated. */
+    Sampled,
+    /**
+     * @brief Responses are not validated.
+     * @details
+     * Only use this mode when the server is trusted, since a malformed
+     * response is no longer detected before it is decoded.
+     * Error responses from the server are validated regardless of this mode.
+     */
+    Off,
+  };
+  /** @brief Default interval used with {@link ValidationMode::Sampled}. */
+  constexpr std::uint32_t DEFAULT_VALIDATION_SAMPLE_INTERVAL = 16;
+  /**
+   * @brief Default number of requests in flight used by the batch methods of
+   * {@link ApiClient}, such as {@link ApiClient::getRoomStatuses}.
+   */
+  constexpr std::size_t DEFAULT_BATCH_CONCURRENCY = 16;
+  /**
+   * @brief How long the destructor of {@link ApiClient} or
+   * {@link SessionManager} waits for the rooms still held to be
+   * disconnected, when it was not shut down beforehand.
+   */
+  constexpr std::chrono::milliseconds DEFAULT_SHUTDOWN_TIMEOUT
+    = std::chrono::seconds(1);
+  /**
+   * @brief Compression applied to the archive of a multiple file content.
+   * @details
+   * The archive is a tar file, which is compressed as a whole with the
+   * codec. The codec is advertised in the MIME of the content, and readers
+   * detect it from the data itself, so contents uploaded with any codec can
+   * be downloaded by this library.
+   */
+  enum struct CompressionCodec {
+    /** @brief Uncompressed tar, sent as application/x-tar. */
+    None,
+    /** @brief gzip, sent as application/gzip. */
+    Gzip,
+    /** @brief xz (LZMA2), sent as application/x-xz. */
+    Xz,
+    /**
+     * @brief Zstandard, sent as application/zstd.
+     * @details
+     * Only available when libarchive is built with libzstd. Otherwise
+     * compressing fails with ERR_COMPRESSION_FAILED.
+     */
+    Zstd,
+  };
+  /** @brief Level which selects the default level of each codec. */
+  constexpr int DEFAULT_COMPRESSION_LEVEL = -1;
+  /**
+   * @brief How the archive of a multiple file content is compressed.
+   *
+   */
+  struct CompressionOptions {
+    /**
+     * @brief Codec of the archive.
+     * @details
+     * Uncompressed by default, which readers built before compression was
+     * supported can still extract.
+     */
+    CompressionCodec codec = CompressionCodec::None;
+    /**
+     * @brief Level of the codec.
+     * @details
+     * 0 to 9 for gzip and xz, and 1 to 22 for Zstandard. Higher levels
+     * compress better and more slowly. Ignored without a codec. A level out
+     * of range makes compressing fail with ERR_COMPRESSION_FAILED.
+     */
+    int level = DEFAULT_COMPRESSION_LEVEL;
+  };
+  /**
+   * @brief Options of {@link ApiClient::watchContent}.
+   *
+   */
+  struct WatchOptions {
+    /** @brief Interval right after a change, which is also the shortest. */
+    std::chrono::milliseconds minInterval = std::chrono::milliseconds(500);
+    /** @brief Longest interval, reached while nothing changes. */
+    std::chrono::milliseconds maxInterval = std::chrono::seconds(30);
+    /** @brief Factor by which the interval grows on each unchanged poll. */
+    double backoffFactor = 2.0;
+    /**
+     * @brief Whether the content present when the watch starts is reported.
+     * @details
+     * If false, the first status is only remembered as the baseline.
+     */
+    bool notifyInitial = false;
+  };
+  /**
+   * @brief Options of {@link ApiClient::uploadContent}.
+   *
+   */
+  struct UploadOptions {
+    /**
+     * @brief Whether the content is not sent when the room already holds it.
+     * @details
+     * Costs one small GET of the status of the room, which is made while the
+     * content is hashed.
+     */
+    bool skipUnchanged = false;
+    /**
+     * @brief How a multiple file content is compressed.
+     * @details
+     * Ignored for other types of content.
+     */
+    CompressionOptions compression;
+  };
+  /**
+   * @brief Options of {@link ApiClient::subscribeRoom}.
+   *
+   */
+  struct SubscribeOptions {
+    /**
+     * @brief Interval of polling while the event stream is not connected.
+     */
+    std::chrono::milliseconds pollInterval = std::chrono::seconds(2);
+    /**
+     * @brief Delay before connecting the event stream again after it failed.
+     * @details
+     * Doubles on each consecutive failure up to {@link maxReconnectInterval},
+     * and changes are polled in the meantime.
+     */
+    std::chrono::milliseconds reconnectInterval = std::chrono::seconds(1);
+    /** @brief Longest delay before connecting the event stream again. */
+    std::chrono::milliseconds maxReconnectInterval = std::chrono::minutes(1);
+  };
+  /** @brief Default size limit of the content cache, which is 1 GiB. */
+  constexpr std::uint64_t DEFAULT_CONTENT_CACHE_SIZE = 1ull << 30;
+  /**
+   * @brief Options of {@link ApiClient::enableContentCache}.
+   *
+   */
+  struct ContentCacheOptions {
+    /**
+     * @brief Directory of the cache.
+     * @details
+     * It is created if missing, and may be shared by several clients and
+     * processes at the same time.
+     */
+    std::filesystem::path directory;
+    /**
+     * @brief Limit of the total size of the cached contents.
+     * @details
+     * The least recently used contents are removed once it is exceeded.
+     */
+    std::uint64_t maxBytes = DEFAULT_CONTENT_CACHE_SIZE;
+  };
+  /** @brief Default time to live of a cached room status. */
+  constexpr std::chrono::milliseconds DEFAULT_ROOM_STATUS_TTL
+    = std::chrono::seconds(1);
+  /** @brief Default number of shards of the room status cache. */
+  constexpr std::size_t DEFAULT_ROOM_STATUS_CACHE_SHARDS = 16;
+  /**
+   * @brief Options of {@link ApiClient::enableRoomStatusCache}.
+   *
+   */
+  struct RoomStatusCacheOptions {
+    /**
+     * @brief How long a fetched status is returned without asking the
+     * server again.
+     * @details
+     * Changes made by other clients are seen at most this late.
+     */
+    std::chrono::milliseconds ttl = DEFAULT_ROOM_STATUS_TTL;
+    /**
+     * @brief Number of locks the rooms are spread over.
+     * @details
+     * More shards let more threads read different rooms without contention.
+     */
+    std::size_t shards = DEFAULT_ROOM_STATUS_CACHE_SHARDS;
+  };
+  /** @brief Default limit of the size of a prefetched content, which is 64 MiB. */
+  constexpr std::uint64_t DEFAULT_PREFETCH_SIZE = 64ull << 20;
+  /**
+   * @brief Options of {@link ApiClient::enableContentPrefetch}.
+   *
+   */
+  struct PrefetchOptions {
+    /**
+     * @brief Limit of the size of the content held in memory.
+     * @details
+     * A larger content is not prefetched: its download is aborted as soon as
+     * it exceeds the limit, and it is then downloaded when requested. For a
+     * multiple file content, the limit also applies to the extracted files.
+     */
+    std::uint64_t maxBytes = DEFAULT_PREFETCH_SIZE;
+  };
+  /** @brief Default number of shards of the sessions of a SessionManager. */
+  constexpr std::size_t DEFAULT_SESSION_SHARDS = 16;
+  /**
+   * @brief Options of {@link SessionManager}.
+   *
+   */
+  struct SessionManagerOptions {
+    /**
+     * @brief Number of locks the rooms are spread over.
+     * @details
+     * More shards let more threads operate on different rooms without
+     * contention.
+     */
+    std::size_t shards = DEFAULT_SESSION_SHARDS;
+  };
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_API_OPTIONS_H_
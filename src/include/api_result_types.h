@@ -146,5 +146,38 @@ namespace octane {
   };
   bool operator==(const RoomId& a, const RoomId& b);
   std::ostream& operator<<(std::ostream& stream, const RoomId& roomId);
+  /**
+   * @brief Enum used in {@link RoomEvent}, represents what changed in the
+   * room.
+   *
+   */
+  enum struct RoomEventType {
+    /** @brief New content was uploaded to the room. */
+    ContentChanged,
+    /** @brief A device connected to the room. */
+    DeviceJoined,
+    /** @brief A device disconnected from the room. */
+    DeviceLeft,
+  };
+  /**
+   * @brief Structure passed to the callback of {@link
+   * ApiClient::subscribeRoom}, describes one change of the room.
+   *
+   */
+  struct RoomEvent {
+    /** @brief What changed. */
+    RoomEventType type;
+    /** @brief Id of the room. */
+    std::uint64_t roomId;
+    /** @brief Status of the new content, set for {@link
+     * RoomEventType::ContentChanged}. */
+    std::optional<ContentStatus> contentStatus;
+    /** @brief Hash of the new content, set for {@link
+     * RoomEventType::ContentChanged}. */
+    std::string hash;
+    /** @brief Device which joined or left, set for {@link
+     * RoomEventType::DeviceJoined} and {@link RoomEventType::DeviceLeft}. */
+    std::optional<Device> device;
+  };
 };     // namespace octane
 #endif // OCTANE_API_CLIENT_API_RESULT_TYPES_H_
\ No newline at end of file
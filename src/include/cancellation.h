@@ -0,0 +1,135 @@
+/**
+ * @file cancellation.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Cooperative cancellation of asynchronous operations.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_CANCELLATION_H_
+#define OCTANE_API_CLIENT_CANCELLATION_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace octane {
+  /**
+   * @brief Token observed by an asynchronous operation to know whether it
+   * should stop.
+   * @details
+   * A default constructed token is never cancelled. Tokens are cheap to copy
+   * and may be read from any thread.
+   *
+   * A token may also carry a deadline, after which it reads as cancelled, and
+   * may be linked with other tokens, in which case it is cancelled as soon as
+   * any of them is.
+   *
+   */
+  class CancellationToken {
+    friend class CancellationSource;
+    using Clock = std::chrono::steady_clock;
+
+    std::shared_ptr<const std::atomic<bool>> cancelled;
+    /** @brief Token linked by {@link linkedWith}, or null. */
+    std::shared_ptr<const CancellationToken> linked;
+    Clock::time_point deadline = Clock::time_point::max();
+
+    explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> state)
+      : cancelled(std::move(state)) {}
+
+  public:
+    CancellationToken() = default;
+
+    /**
+     * @brief Returns true if the operation has been asked to stop.
+     *
+     */
+    bool isCancelled() const noexcept {
+      if (cancelled != nullptr && cancelled->load(std::memory_order_acquire)) {
+        return true;
+      }
+      if (deadline != Clock::time_point::max() && Clock::now() >= deadline) {
+        return true;
+      }
+      return linked != nullptr && linked->isCancelled();
+    }
+    /**
+     * @brief Returns true if this token can ever be cancelled.
+     *
+     */
+    bool canBeCancelled() const noexcept {
+      return cancelled != nullptr || deadline != Clock::time_point::max()
+          || (linked != nullptr && linked->canBeCancelled());
+    }
+    /**
+     * @brief Returns a copy of this token which is also cancelled once
+     * deadline has passed.
+     *
+     */
+    CancellationToken withDeadline(Clock::time_point deadline) const {
+      auto token     = *this;
+      token.deadline = std::min(token.deadline, deadline);
+      return token;
+    }
+    /**
+     * @brief Returns a token which is cancelled as soon as either this token
+     * or other is.
+     *
+     */
+    CancellationToken linkedWith(CancellationToken other) const {
+      if (!other.canBeCancelled()) return *this;
+      if (!canBeCancelled()) return other;
+      auto token = *this;
+      if (token.linked != nullptr) {
+        other = token.linked->linkedWith(std::move(other));
+      }
+      token.linked
+        = std::make_shared<const CancellationToken>(std::move(other));
+      return token;
+    }
+  };
+
+  /**
+   * @brief Issues {@link CancellationToken}s and cancels them.
+   * @details
+   * Cancellation is cooperative: an operation that has already finished is
+   * not affected, and an operation in flight stops at its next check point.
+   * Requests in flight are aborted by the transport and report
+   * ERR_CANCELLED.
+   *
+   */
+  class CancellationSource {
+    std::shared_ptr<std::atomic<bool>> cancelled;
+
+  public:
+    CancellationSource() : cancelled(std::make_shared<std::atomic<bool>>()) {}
+
+    /**
+     * @brief Returns a token bound to this source.
+     *
+     */
+    CancellationToken token() const noexcept {
+      return CancellationToken(cancelled);
+    }
+    /**
+     * @brief Cancels every token issued by this source.
+     *
+     */
+    void cancel() noexcept {
+      cancelled->store(true, std::memory_order_release);
+    }
+    /**
+     * @brief Returns true if {@link cancel} has been called.
+     *
+     */
+    bool isCancelled() const noexcept {
+      return cancelled->load(std::memory_order_acquire);
+    }
+  };
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_CANCELLATION_H_
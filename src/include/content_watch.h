@@ -0,0 +1,56 @@
+/**
+ * @file content_watch.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Handle of a watch started by {@link ApiClient::watchContent}.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_CONTENT_WATCH_H_
+#define OCTANE_API_CLIENT_CONTENT_WATCH_H_
+
+#include <memory>
+
+namespace octane {
+  namespace internal {
+    class ContentWatcher;
+  } // namespace internal
+
+  /**
+   * @brief Handle of a watch started by {@link ApiClient::watchContent}.
+   * @details
+   * The watch runs until stop() is called or the handle is destroyed.
+   * Neither may be done from within the callback of the watch.
+   *
+   */
+  class [[nodiscard]] ContentWatch {
+    std::unique_ptr<internal::ContentWatcher> watcher;
+
+  public:
+    ContentWatch() noexcept;
+    explicit ContentWatch(std::unique_ptr<internal::ContentWatcher> watcher);
+    ContentWatch(ContentWatch&& other) noexcept;
+    ContentWatch& operator=(ContentWatch&& other) noexcept;
+    /**
+     * @brief Destroy the Content Watch object
+     * @details
+     * Stops the watch and waits for the callback in progress, if any.
+     */
+    ~ContentWatch() noexcept;
+
+    /**
+     * @brief Stops the watch and waits for the callback in progress, if any.
+     *
+     */
+    void stop() noexcept;
+    /**
+     * @brief Returns true until the watch is stopped.
+     *
+     */
+    bool isActive() const noexcept;
+  };
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_CONTENT_WATCH_H_
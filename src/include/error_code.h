@@ -46,6 +46,17 @@ namespace octane {
     = "ERR_CONTENT_TYPE_DATA_MISMATCH";
   constexpr auto ERR_COMPRESSION_FAILED   = "ERR_COMPRESSION_FAILED";
   constexpr auto ERR_DECOMPRESSION_FAILED = "ERR_DECOMPRESSION_FAILED";
+  /** @brief Used when an asynchronous operation was cancelled through its
+   * {@link CancellationToken}. */
+  constexpr auto ERR_CANCELLED = "ERR_CANCELLED";
+  /** @brief Used when the server does not provide the event stream of a
+   * room, so that changes have to be polled. */
+  constexpr auto ERR_EVENT_STREAM_UNAVAILABLE = "ERR_EVENT_STREAM_UNAVAILABLE";
+  /** @brief Used when a file to upload could not be opened or mapped into
+   * memory. */
+  constexpr auto ERR_FILE_OPEN_FAILED = "ERR_FILE_OPEN_FAILED";
+  /** @brief Used when downloaded content could not be written to a file. */
+  constexpr auto ERR_FILE_WRITE_FAILED = "ERR_FILE_WRITE_FAILED";
 } // namespace octane
 
 #endif // OCTANE_API_CLIENT_ERROR_CODE_H_
\ No newline at end of file
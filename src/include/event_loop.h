@@ -0,0 +1,87 @@
+/**
+ * @file event_loop.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Interface to drive the transport from an event loop of the
+ * application.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_EVENT_LOOP_H_
+#define OCTANE_API_CLIENT_EVENT_LOOP_H_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace octane {
+#ifdef _WIN32
+  /** @brief Native socket handle (SOCKET). */
+  using NativeSocket = std::uintptr_t;
+#else
+  /** @brief Native socket handle (file descriptor). */
+  using NativeSocket = int;
+#endif
+
+  /**
+   * @brief Readiness of a socket, used both for what to watch and for what
+   * happened.
+   *
+   */
+  enum struct SocketEvents : int {
+    None      = 0,
+    Read      = 1,
+    Write     = 2,
+    ReadWrite = Read | Write,
+  };
+  constexpr SocketEvents operator|(SocketEvents a, SocketEvents b) noexcept {
+    return static_cast<SocketEvents>(static_cast<int>(a) | static_cast<int>(b));
+  }
+  constexpr SocketEvents operator&(SocketEvents a, SocketEvents b) noexcept {
+    return static_cast<SocketEvents>(static_cast<int>(a) & static_cast<int>(b));
+  }
+
+  /**
+   * @brief Event loop of the application which drives the transfers of a
+   * client.
+   * @details
+   * Implement this interface on top of epoll, kqueue, libuv or similar, and
+   * pass it to {@link ApiClient}. The client then creates no I/O thread:
+   * it asks the loop to watch sockets and arm a timer, and the loop reports
+   * back through ApiClient::onSocketEvent() and ApiClient::onTimeout().
+   *
+   * Every method is called on the thread that runs the loop, from within
+   * the methods of the client.
+   *
+   */
+  class EventLoop {
+  public:
+    virtual ~EventLoop() noexcept = 0;
+    /**
+     * @brief Starts, changes or stops watching a socket.
+     * @details
+     * Replaces what was watched for the socket. With {@link
+     * SocketEvents::None}, stop watching it; the socket may be closed right
+     * after this call.
+     *
+     * @param[in] socket Socket to watch
+     * @param[in] events Readiness to wait for
+     */
+    virtual void watchSocket(NativeSocket socket, SocketEvents events) = 0;
+    /**
+     * @brief Arms the single timer of the client.
+     * @details
+     * Replaces the previous timer. When it expires, call
+     * ApiClient::onTimeout() once. std::nullopt disarms the timer, and zero
+     * means as soon as possible, but not from within this call.
+     *
+     * @param[in] timeout Time from now until the timer expires
+     */
+    virtual void setTimer(std::optional<std::chrono::milliseconds> timeout) = 0;
+  };
+  inline EventLoop::~EventLoop() noexcept {}
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_EVENT_LOOP_H_
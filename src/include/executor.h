@@ -0,0 +1,107 @@
+/**
+ * @file executor.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Executors which resume asynchronous operations of {@link ApiClient}.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_EXECUTOR_H_
+#define OCTANE_API_CLIENT_EXECUTOR_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace octane {
+  /**
+   * @brief Interface which runs work items.
+   * @details
+   * When a request issued by an asynchronous method completes, the awaiting
+   * coroutine is resumed through the executor selected on the client.
+   * Implement this interface to resume coroutines on the threads of another
+   * runtime, such as an event loop of an application.
+   *
+   */
+  class Executor {
+  public:
+    virtual ~Executor() noexcept = 0;
+    /**
+     * @brief Runs task at some point, possibly on another thread.
+     * @details
+     * This method may be called from any thread, including the transport's
+     * I/O thread, so it must not block.
+     *
+     * @param[in] task Work item to run
+     */
+    virtual void post(std::function<void()> task) = 0;
+  };
+
+  /**
+   * @brief Executor which runs every task immediately on the calling thread.
+   * @details
+   * With this executor, coroutines are resumed on the transport's I/O thread.
+   * Only use it when the code following each co_await is short and never
+   * blocks.
+   *
+   */
+  class InlineExecutor : public Executor {
+  public:
+    virtual void post(std::function<void()> task) override;
+  };
+
+  /**
+   * @brief Executor which runs tasks on a fixed number of threads.
+   *
+   */
+  class ThreadPoolExecutor : public Executor {
+    std::mutex mutex;
+    std::condition_variable available;
+    std::deque<std::function<void()>> tasks;
+    bool stopping;
+    std::vector<std::thread> threads;
+
+  public:
+    /**
+     * @brief Construct a new Thread Pool Executor object
+     *
+     * @param[in] threadCount Number of threads. 0 is treated as 1.
+     */
+    explicit ThreadPoolExecutor(std::size_t threadCount);
+    ThreadPoolExecutor(const ThreadPoolExecutor&)            = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+    /**
+     * @brief Destroy the Thread Pool Executor object
+     * @details
+     * Runs every task already posted, then joins the threads.
+     */
+    virtual ~ThreadPoolExecutor() noexcept;
+
+    virtual void post(std::function<void()> task) override;
+
+  private:
+    void run();
+  };
+
+  /**
+   * @brief Returns the executor used by clients which have not selected one.
+   * @details
+   * It is a {@link ThreadPoolExecutor} shared by the whole process, with as
+   * many threads as std::thread::hardware_concurrency() up to 4.
+   *
+   */
+  Executor& defaultExecutor();
+  /**
+   * @brief Returns an {@link InlineExecutor} shared by the whole process.
+   *
+   */
+  Executor& inlineExecutor();
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_EXECUTOR_H_
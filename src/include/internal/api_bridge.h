@@ -11,14 +11,51 @@
 #ifndef OCTANE_API_CLIENT_INTERNAL_API_BRIDGE_H_
 #define OCTANE_API_CLIENT_INTERNAL_API_BRIDGE_H_
 
+#include <functional>
+#include <type_traits>
+
+#include "include/api_options.h"
 #include "include/api_result_types.h"
 #include "include/error_response.h"
+#include "include/internal/endpoint.h"
+#include "include/internal/event_stream.h"
 #include "include/internal/fetch.h"
+#include "include/internal/revalidation_cache.h"
+#include "include/internal/single_flight.h"
+#include "include/internal/schema_registry.h"
 #include "include/result.h"
 
 namespace octane::internal {
+  /**
+   * @brief 条件付きGETで取得し、304のレスポンスには前回のデコード結果を返すエンドポイントであるか。
+   * @details
+   * ポーリングされるルームとコンテンツの状態だけを対象とする。
+   * コンテンツ本体は大きくなりうるのでメモリには覚えず、{@link ContentCache}に任せる。
+   *
+   */
+  template <typename Endpoint>
+  inline constexpr bool isRevalidated
+    = std::is_same_v<Endpoint, endpoint::RoomIdGet>
+   || std::is_same_v<Endpoint, endpoint::RoomIdStatusGet>;
+
   class ApiBridge {
+    /**
+     * @brief Endpointへの実行中のGETを、パスごとにまとめる。
+     *
+     */
+    template <typename Endpoint>
+    using Flights = SingleFlight<
+      std::string,
+      Result<typename Endpoint::ResponseType, ErrorResponse>>;
+
     FetchBase* fetch;
+    SchemaValidationPolicy validationPolicy;
+    RevalidationCache<RoomStatus> roomCache;
+    RevalidationCache<std::pair<ContentStatus, std::string>> statusCache;
+    Flights<endpoint::HealthGet> healthFlights;
+    Flights<endpoint::RoomIdGet> roomFlights;
+    Flights<endpoint::RoomIdContentGet> contentFlights;
+    Flights<endpoint::RoomIdStatusGet> statusFlights;
 
   public:
     /**
@@ -42,6 +79,19 @@ namespace octane::internal {
      * 成功した場合は何も返さず、失敗した場合は上記のエラーレスポンスを返す。
      */
     Result<_, ErrorResponse> init();
+    /**
+     * @brief レスポンスをJSONスキーマで検証するかどうかを設定する。
+     * @details
+     * 既定では{@link ValidationMode::Full}であり、全てのレスポンスを検証する。
+     * サーバから渡ってきたエラーレスポンスはこの設定にかかわらず常に検証する。
+     *
+     * @param[in] mode 検証のモード
+     * @param[in] sampleInterval
+     * {@link ValidationMode::Sampled}のときに何回に一回検証するか
+     */
+    void setValidationMode(ValidationMode mode,
+                           std::uint32_t sampleInterval
+                           = DEFAULT_VALIDATION_SAMPLE_INTERVAL);
     /**
      * @brief use get method for /health
      *
@@ -84,6 +134,7 @@ namespace octane::internal {
      * - ERR_INVALID_RESPONSE: レスポンスにエラーがあるとき
      * - ERR_CURL_CONNECTION_FAILED: CURLの接続に失敗したとき
      * また、2xx以外のレスポンスが返された時には、同様のエラーレスポンスの形式でサーバから渡ってきたエラーをそのまま返す。
+     * 前回のレスポンスから変更がなく、サーバが304を返した場合は前回の結果を返す。
      * @param[in] id　ルームのid
      * @return Result<RoomStatus, ErrorResponse>
      * 成功した場合はルームのステータス{@link
@@ -133,6 +184,23 @@ namespace octane::internal {
      */
     Result<std::vector<std::uint8_t>, ErrorResponse> roomIdContentGet(
       std::uint64_t id);
+    /**
+     * @brief 受信したコンテンツを届いた順にobserverへ渡しながら、/room/{id}/contentにGETリクエストを発行する。
+     * @details
+     * コンテンツを全て受け取る前にハッシュ値の計算やファイルへの書き込みを始めるために使う。
+     * コンテンツはobserverに渡すだけで保持しないので、大きさに関わらずメモリは一定である。
+     * observerにはコンテンツ以外のボディ部が渡されることもあるので、
+     * 成功した場合にのみ渡された値を使うこと。
+     * エラーレスポンスは{@link roomIdContentGet(std::uint64_t)}と同じ。
+     *
+     * @param[in] id ルームのid
+     * @param[in] observer 受信したコンテンツの一部を受け取る関数
+     * @return Result<_, ErrorResponse>
+     * 失敗した場合には上記のエラーレスポンスを返す。
+     */
+    Result<_, ErrorResponse> roomIdContentGet(
+      std::uint64_t id,
+      const BodyObserver& observer);
     /**
      * @brief use delete method for /room/{id}/content
      * @details
@@ -160,7 +228,7 @@ namespace octane::internal {
      */
     Result<_, ErrorResponse> roomIdContentPut(
       std::uint64_t id,
-      const std::vector<std::uint8_t>& contentData,
+      std::span<const std::uint8_t> contentData,
       std::string_view mime);
     /**
      * @brief use get method for /room/{id}/status
@@ -172,6 +240,7 @@ namespace octane::internal {
      * - ERR_INVALID_RESPONSE: レスポンスにエラーがあるとき
      * - ERR_CURL_CONNECTION_FAILED: CURLの接続に失敗したとき。
      * また、2xx以外のレスポンスが返された時には、同様のエラーレスポンスの形式でサーバから渡ってきたエラーをそのまま返す。
+     * 前回のレスポンスから変更がなく、サーバが304を返した場合は前回の結果を返す。
      * @param[in] id ルームのid
      * @return Result<std::pair<ContentStatus,std::string>, ErrorResponse>
      * 成功した場合にはコンテンツの状態{@link
@@ -206,6 +275,93 @@ namespace octane::internal {
     Result<_, ErrorResponse> roomIdStatusPut(std::uint64_t id,
                                              const ContentStatus& contentStatus,
                                              std::string_view hash);
+    /**
+     * @brief use get method for /room/{id}/events
+     * @details
+     * このメソッドは/room/{id}/eventsにServer-Sent
+     * Eventsのストリームを受け取るGETリクエストを発行し、
+     * 届いたイベントを{@link RoomEvent}に変換してonEventに渡す。
+     * 接続が閉じられるまで呼び出し元のスレッドをブロックする。
+     * contentイベントは/room/{id}/statusと同じ形式、deviceイベントは
+     * {"type": "joined" | "left", "name": デバイス名, "timestamp": 時刻}の形式のJSONを
+     * dataに持つ。それ以外のイベントは無視する。
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_EVENT_STREAM_UNAVAILABLE:
+     * サーバやfetchがストリームに対応していないとき(404, 405, 501のレスポンスを含む)
+     * - ERR_CANCELLED: tokenがキャンセルされたとき
+     * - ERR_JSON_PARSE_FAILED: イベントのdataが正常なJSONでないとき
+     * - ERR_INVALID_RESPONSE: イベントのdataにエラーがあるとき
+     * - ERR_CURL_CONNECTION_FAILED: CURLの接続に失敗したとき
+     * また、それ以外の2xx以外のレスポンスが返された時には、同様のエラーレスポンスの形式でサーバから渡ってきたエラーをそのまま返す。
+     * @param[in] id ルームのid
+     * @param[in] token ストリームを切断するためのトークン
+     * @param[in] onEvent 届いたイベントを受け取る関数
+     * @return Result<_, ErrorResponse>
+     * サーバが接続を閉じた場合には何も返さず、失敗した場合には上記のエラーレスポンスを返す。
+     */
+    Result<_, ErrorResponse> roomIdEventsGet(
+      std::uint64_t id,
+      CancellationToken token,
+      const std::function<void(RoomEvent)>& onEvent);
+    /**
+     * @brief {@link healthGet}の非同期版。
+     * @details
+     * 以下の*Asyncメソッドは全て、対応する同期版と同じエラーレスポンスに加えて、
+     * context.tokenがキャンセルされた場合はERR_CANCELLEDを返す。
+     * 完了したコルーチンはcontext.executorで再開される。
+     */
+    Task<Result<HealthResult, ErrorResponse>> healthGetAsync(
+      AsyncContext context);
+    /** @brief {@link roomPost}の非同期版。*/
+    Task<Result<RoomId, ErrorResponse>> roomPostAsync(AsyncContext context,
+                                                      std::string name);
+    /** @brief {@link roomIdGet}の非同期版。*/
+    Task<Result<RoomStatus, ErrorResponse>> roomIdGetAsync(AsyncContext context,
+                                                           std::uint64_t id);
+    /** @brief {@link roomIdDelete}の非同期版。*/
+    Task<Result<_, ErrorResponse>> roomIdDeleteAsync(AsyncContext context,
+                                                     std::uint64_t id);
+    /** @brief {@link roomIdPost}の非同期版。*/
+    Task<Result<_, ErrorResponse>> roomIdPostAsync(AsyncContext context,
+                                                   std::uint64_t id,
+                                                   std::string name,
+                                                   std::string request);
+    /** @brief {@link roomIdContentGet}の非同期版。*/
+    Task<Result<std::vector<std::uint8_t>, ErrorResponse>>
+    roomIdContentGetAsync(AsyncContext context, std::uint64_t id);
+    /**
+     * @brief {@link roomIdContentGet(std::uint64_t, const BodyObserver&)}の非同期版。
+     * @details
+     * observerはタスクが完了するまで有効でなければならない。
+     * また、observerは別のスレッドから呼び出されることがある。
+     */
+    Task<Result<_, ErrorResponse>> roomIdContentGetAsync(
+      AsyncContext context,
+      std::uint64_t id,
+      const BodyObserver& observer);
+    /** @brief {@link roomIdContentDelete}の非同期版。*/
+    Task<Result<_, ErrorResponse>> roomIdContentDeleteAsync(
+      AsyncContext context,
+      std::uint64_t id);
+    /**
+     * @brief {@link roomIdContentPut}の非同期版。
+     * @details
+     * contentDataはタスクが完了するまで有効でなければならない。
+     */
+    Task<Result<_, ErrorResponse>> roomIdContentPutAsync(
+      AsyncContext context,
+      std::uint64_t id,
+      std::span<const std::uint8_t> contentData,
+      std::string mime);
+    /** @brief {@link roomIdStatusGet}の非同期版。*/
+    Task<Result<std::pair<ContentStatus, std::string>, ErrorResponse>>
+    roomIdStatusGetAsync(AsyncContext context, std::uint64_t id);
+    /** @brief {@link roomIdStatusPut}の非同期版。*/
+    Task<Result<_, ErrorResponse>> roomIdStatusPutAsync(
+      AsyncContext context,
+      std::uint64_t id,
+      ContentStatus contentStatus,
+      std::string hash);
     /**
      * @brief check if the given status code is 2xx
      * @details
@@ -217,6 +373,132 @@ namespace octane::internal {
      */
     std::optional<error_t<ErrorResponse>> checkStatusCode(
       const internal::FetchResponse& response);
+
+  private:
+    /**
+     * @brief エンドポイントの記述子に従ってリクエストを発行し、レスポンスをデコードする。
+     * @details
+     * パスの組み立て、リクエストのシリアライズ、ステータスコードの確認、
+     * レスポンスの検証とデコードは全て{@link Endpoint}からコンパイル時に決定される。
+     * GETは冪等なので、同じパスへのGETが実行中であれば新たに送らず、その結果のコピーを返す。
+     * 実行中のGETが他の呼び出し元のキャンセルで中断した場合は、待っていた呼び出し元は自ら送り直す。
+     * 同期の呼び出しは非同期のGETには合流しない。
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_JSON_PARSE_FAILED:
+     * レスポンスのContent-Typeがapplication/jsonであったにもかかわらず正常なJSONデータがAPIから返却されなかったとき
+     * - ERR_INVALID_RESPONSE: レスポンスにエラーがあるとき
+     * - ERR_CURL_CONNECTION_FAILED: CURLの接続に失敗したとき
+     * また、2xx以外のレスポンスが返された時には、同様のエラーレスポンスの形式でサーバから渡ってきたエラーをそのまま返す。
+     *
+     * @tparam Endpoint エンドポイントの記述子
+     * @tparam PathParams ルートのプレースホルダを置き換える値の型
+     * @param[in] request リクエスト
+     * @param[in] params ルートのプレースホルダを置き換える値
+     * @return Result<typename Endpoint::ResponseType, ErrorResponse>
+     * 成功した場合はデコードしたレスポンスを返し、失敗した場合は上記のエラーレスポンスを返す。
+     */
+    template <typename Endpoint, typename... PathParams>
+    Result<typename Endpoint::ResponseType, ErrorResponse> call(
+      const typename Endpoint::RequestType& request,
+      PathParams... params);
+    /**
+     * @brief {@link call}の非同期版。
+     * @details
+     * requestはタスクが完了するまで有効でなければならない。
+     */
+    template <typename Endpoint, typename... PathParams>
+    Task<Result<typename Endpoint::ResponseType, ErrorResponse>> callAsync(
+      AsyncContext context,
+      const typename Endpoint::RequestType& request,
+      PathParams... params);
+    /**
+     * @brief {@link call}からまとめる処理を除いた、一つのリクエストの送信とデコード。
+     *
+     */
+    template <typename Endpoint>
+    Result<typename Endpoint::ResponseType, ErrorResponse> send(
+      const typename Endpoint::RequestType& request,
+      const std::string& path);
+    /**
+     * @brief {@link send}の非同期版。
+     * @details
+     * requestはタスクが完了するまで有効でなければならない。
+     */
+    template <typename Endpoint>
+    Task<Result<typename Endpoint::ResponseType, ErrorResponse>> sendAsync(
+      AsyncContext context,
+      const typename Endpoint::RequestType& request,
+      std::string path);
+    /**
+     * @brief GETのEndpointの実行中のリクエストを返す。
+     *
+     */
+    template <typename Endpoint>
+    Flights<Endpoint>& flightsOf();
+    /**
+     * @brief fetchのレスポンスを{@link Endpoint}に従ってデコードする。
+     * @details
+     * {@link call}と{@link callAsync}で共有する。
+     *
+     * @tparam Endpoint エンドポイントの記述子
+     * @param[in] response fetchのレスポンス。バイナリのボディはムーブされる。
+     * @return Result<typename Endpoint::ResponseType, ErrorResponse>
+     * 成功した場合はデコードしたレスポンスを返し、失敗した場合は{@link
+     * call}と同じエラーレスポンスを返す。
+     */
+    template <typename Endpoint>
+    Result<typename Endpoint::ResponseType, ErrorResponse> decodeResponse(
+      FetchBase::FetchResult& response);
+    /**
+     * @brief 条件付きGETのレスポンスをデコードし、304であれば前回の結果を返す。
+     * @details
+     * 2xxのレスポンスをデコードできた場合は、次の304のために結果を覚える。
+     *
+     * @tparam Endpoint {@link isRevalidated}なエンドポイントの記述子
+     * @param[in] path リクエストしたパス
+     * @param[in] response fetchのレスポンス
+     * @return std::optional<Result<typename Endpoint::ResponseType, ErrorResponse>>
+     * 304であるにもかかわらず前回の結果を覚えていない場合はnullopt、
+     * それ以外は{@link decodeResponse}と同じ結果を返す。
+     */
+    template <typename Endpoint>
+      requires isRevalidated<Endpoint>
+    std::optional<Result<typename Endpoint::ResponseType, ErrorResponse>>
+    decodeRevalidated(const std::string& path,
+                      FetchBase::FetchResult& response);
+    /**
+     * @brief Endpointのデコード結果を覚えておくキャッシュを返す。
+     *
+     */
+    template <typename Endpoint>
+      requires isRevalidated<Endpoint>
+    RevalidationCache<typename Endpoint::ResponseType>& revalidationCache();
+    /**
+     * @brief イベントストリームの一つのイベントを{@link RoomEvent}に変換する。
+     * @details
+     * 知らない種類のイベントはnulloptを返す。
+     * 失敗した場合は{@link roomIdEventsGet}と同じエラーレスポンスを返す。
+     *
+     * @param[in] id イベントを受け取ったルームのid
+     * @param[in] event 変換するイベント
+     * @return Result<std::optional<RoomEvent>, ErrorResponse>
+     */
+    Result<std::optional<RoomEvent>, ErrorResponse> decodeEvent(
+      std::uint64_t id,
+      const StreamEvent& event);
+    /**
+     * @brief 設定された検証のモードに従ってJSONをスキーマで検証する。
+     * @details
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_INVALID_RESPONSE: JSONがスキーマに適合しなかったとき
+     *
+     * @param[in] json 検証するJSON
+     * @param[in] schema 検証に用いるスキーマ
+     * @return std::optional<ErrorResponse>
+     * 適合した場合や検証を省略した場合は何も返さず、そうでない場合は上記のエラーレスポンスを返す。
+     */
+    std::optional<ErrorResponse> verifyJson(const Json& json,
+                                            SchemaId schema);
   };
 } // namespace octane::internal
 #endif // OCTANE_API_CLIENT_INTERNAL_API_BRIDGE_H_
\ No newline at end of file
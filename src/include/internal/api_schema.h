@@ -157,6 +157,28 @@ namespace octane::internal {
       "properties": {}
     }
   )";
+  constexpr auto SCHEMA_ROOM_ID_EVENTS_DEVICE = R"(
+    {
+      "$schema": "https://json-schema.org/draft/2020-12/schema",
+      "type": "object",
+      "properties": {
+        "type": {
+          "enum": ["joined", "left"],
+          "type": "string",
+          "title": "type"
+        },
+        "name": {
+          "type": "string",
+          "title": "name"
+        },
+        "timestamp": {
+          "type": "number",
+          "title": "timestamp"
+        }
+      },
+      "required": ["type", "name", "timestamp"]
+    }
+  )";
 } // namespace octane::internal
 
 #endif // OCTANE_API_CLIENT_API_SCHEMA_H_
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * @file async.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 非同期のリクエストをコルーチンから待機するためのユーティリティ。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_ASYNC_H_
+#define OCTANE_API_CLIENT_INTERNAL_ASYNC_H_
+
+#include <condition_variable>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+#include "./http_client.h"
+#include "include/cancellation.h"
+#include "include/executor.h"
+#include "include/task.h"
+
+namespace octane::internal {
+  /**
+   * @brief 非同期処理を再開するexecutorと、処理を中断するためのトークン。
+   * @details
+   * ApiClientからFetchまで、非同期のメソッドに値で渡していく。
+   */
+  struct AsyncContext {
+    /** @brief リクエストが完了したときにコルーチンを再開するexecutor。*/
+    Executor* executor;
+    /** @brief 処理を中断するためのトークン。*/
+    CancellationToken token;
+  };
+
+  /**
+   * @brief {@link HttpClientBase::requestAsync}を発行し、完了するまで待機する。
+   * @details
+   * 完了したコルーチンはcontext.executorで再開される。
+   * requestはco_awaitが終わるまで有効でなければならない。
+   *
+   */
+  class HttpRequestAwaiter {
+    HttpClientBase* client;
+    std::string_view origin;
+    const HttpRequest& request;
+    AsyncContext context;
+    std::optional<Result<HttpResponse, ErrorResponse>> result;
+
+  public:
+    HttpRequestAwaiter(HttpClientBase* client,
+                       std::string_view origin,
+                       const HttpRequest& request,
+                       AsyncContext context)
+      : client(client),
+        origin(origin),
+        request(request),
+        context(std::move(context)) {}
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      // コールバックはrequestAsyncの中で呼ばれることもあり、
+      // その場合は戻る前にコルーチンが再開されうるので、呼び出した後はメンバに触れない。
+      const auto executor = context.executor;
+      client->requestAsync(
+        origin,
+        request,
+        context.token,
+        [this, executor, handle](Result<HttpResponse, ErrorResponse> response) {
+          result.emplace(std::move(response));
+          executor->post([handle] { handle.resume(); });
+        });
+    }
+    Result<HttpResponse, ErrorResponse> await_resume() {
+      return std::move(result.value());
+    }
+  };
+
+  /**
+   * @brief 同期のメソッドが、自身のスレッドでの処理と並行させるために開始したTask。
+   * @details
+   * スレッドは作成せず、TaskのリクエストはトランスポートのI/Oスレッドで進む。
+   * 値を受け取るだけなので、Taskは{@link overlappedContext}で開始して
+   * I/Oスレッドのまま完了させる。
+   * イベントループで駆動する場合は待っている間ループが進まないので、
+   * {@link ready}で先に同期のリクエストの結果を渡す。
+   *
+   */
+  template <typename T>
+  class Pending {
+    struct State {
+      std::mutex mutex;
+      std::condition_variable finished;
+      std::optional<T> value;
+    };
+    // 例外などで待たずに破棄されても、完了したときに触れられるように共有する。
+    std::shared_ptr<State> state = std::make_shared<State>();
+
+    Pending() = default;
+
+  public:
+    /**
+     * @brief taskを開始する。
+     *
+     */
+    explicit Pending(Task<T> task) {
+      spawn(std::move(task), [state = state](T&& value) {
+        std::lock_guard lock(state->mutex);
+        state->value.emplace(std::move(value));
+        state->finished.notify_one();
+      });
+    }
+    /**
+     * @brief 既に得られている値を返す。
+     *
+     */
+    static Pending ready(T value) {
+      Pending pending;
+      pending.state->value.emplace(std::move(value));
+      return pending;
+    }
+    /**
+     * @brief 完了するまで呼び出し元のスレッドをブロックし、値を返す。
+     * @details
+     * 一度だけ呼び出せる。
+     */
+    T get() {
+      std::unique_lock lock(state->mutex);
+      state->finished.wait(lock, [this] { return state->value.has_value(); });
+      return std::move(state->value.value());
+    }
+  };
+  /**
+   * @brief {@link Pending}で開始するTaskに渡すコンテキスト。
+   * @details
+   * 同期のリクエストはキャンセルできないので、これもキャンセルしない。
+   */
+  inline AsyncContext overlappedContext() {
+    return AsyncContext{
+      .executor = &inlineExecutor(),
+      .token    = {},
+    };
+  }
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_ASYNC_H_
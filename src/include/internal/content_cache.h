@@ -0,0 +1,86 @@
+/**
+ * @file content_cache.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief コンテンツをハッシュ値で引くディスク上のキャッシュ。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_CONTENT_CACHE_H_
+#define OCTANE_API_CLIENT_INTERNAL_CONTENT_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "include/error_response.h"
+#include "include/internal/mapped_file.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief 取得したコンテンツをハッシュ値で引けるように保存するディスク上のキャッシュ。
+   * @details
+   * コンテンツはdirectory/objects/<先頭2文字>/<ハッシュ値>に置く。
+   * 書きかけのコンテンツはdirectory/tmpに書き、書き終えてから名前を変えて置くので、
+   * 置かれているコンテンツは常に完全である。
+   * 状態はファイルシステムにしか持たないため、複数のプロセスやスレッドが同じディレクトリを同時に使ってよい。
+   * 最後に使われた時刻はファイルの更新時刻で表し、合計がmaxBytesを超えたら古いものから削除する。
+   *
+   */
+  class ContentCache {
+    std::filesystem::path directory;
+    std::uint64_t maxBytes;
+
+    ContentCache(std::filesystem::path directory, std::uint64_t maxBytes);
+
+  public:
+    /**
+     * @brief directoryをキャッシュとして使う。
+     * @details
+     * ディレクトリがなければ作成する。
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_FILE_WRITE_FAILED: ディレクトリを作成できないとき
+     *
+     * @param[in] directory キャッシュのディレクトリ
+     * @param[in] maxBytes 保存するコンテンツの合計の上限
+     * @return Result<std::shared_ptr<ContentCache>, ErrorResponse>
+     */
+    static Result<std::shared_ptr<ContentCache>, ErrorResponse> open(
+      const std::filesystem::path& directory,
+      std::uint64_t maxBytes);
+
+    /**
+     * @brief hashのコンテンツをマップして返す。
+     * @details
+     * 見つかった場合は内容のハッシュ値を検証し、一致すれば最後に使われた時刻を更新する。
+     * 一致しなければ壊れたものとして削除し、nulloptを返す。
+     *
+     * @param[in] hash コンテンツのハッシュ値
+     * @return std::optional<MappedFile> 見つからなければnullopt
+     */
+    std::optional<MappedFile> lookup(std::string_view hash) const;
+    /**
+     * @brief dataをhashのコンテンツとして保存し、上限を超えた分を削除する。
+     * @details
+     * キャッシュは最善の努力で保存するので、失敗しても何もしない。
+     * 上限より大きいコンテンツは保存しない。
+     *
+     * @param[in] hash dataのハッシュ値。検証済みでなければならない。
+     * @param[in] data 保存するコンテンツ
+     */
+    void store(std::string_view hash, std::span<const std::uint8_t> data) const;
+
+  private:
+    std::optional<std::filesystem::path> objectPath(
+      std::string_view hash) const;
+    void evict() const;
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_CONTENT_CACHE_H_
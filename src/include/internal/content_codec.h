@@ -0,0 +1,97 @@
+/**
+ * @file content_codec.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 取得したコンテンツのデコードと、アップロードするコンテンツの変換。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_CONTENT_CODEC_H_
+#define OCTANE_API_CLIENT_INTERNAL_CONTENT_CODEC_H_
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "include/api_options.h"
+#include "include/api_result_types.h"
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief 取得したコンテンツをハッシュ値で検証し、種類に応じてデコードする。
+   *
+   * @param[in] contentStatus コンテンツの状態
+   * @param[in] hash コンテンツの状態に記録されていたハッシュ値
+   * @param[in] digest 受信しながら計算したコンテンツのハッシュ値
+   * @param[in] data 取得したコンテンツ
+   * @return Result<Content, ErrorResponse>
+   * 成功した場合はhealthとmessage以外を埋めたContentを返す。
+   */
+  Result<Content, ErrorResponse> decodeContent(
+    ContentStatus&& contentStatus,
+    std::string_view hash,
+    std::string_view digest,
+    std::vector<std::uint8_t>&& data);
+
+  /**
+   * @brief アップロードするデータとMIME。
+   *
+   */
+  struct UploadBody {
+    /**
+     * @brief PUTするコンテンツの状態。
+     * @details
+     * 複数ファイルの場合は、MIMEを圧縮したアーカイブのものに置き換える。
+     */
+    ContentStatus contentStatus;
+    /** @brief contentのデータを変換した場合に、その結果を保持する。*/
+    std::vector<std::uint8_t> storage;
+    /** @brief 呼び出し元のデータをそのまま送る場合に、それを指す。*/
+    std::optional<std::span<const std::uint8_t>> borrowed;
+    std::string mime;
+
+    std::span<const std::uint8_t> bytes() const {
+      return borrowed.value_or(storage);
+    }
+  };
+  /**
+   * @brief コンテンツの種類に応じて、アップロードに使うMIMEを返す。
+   * @details
+   * 複数ファイルの場合は、codecで圧縮したアーカイブのMIMEを返す。
+   */
+  std::string uploadMime(const ContentStatus& contentStatus,
+                         CompressionCodec codec = CompressionCodec::None);
+  /**
+   * @brief 呼び出し元のデータを、コピーせずにアップロードする形式にする。
+   * @details
+   * 失敗した場合は次のエラーレスポンスを返す。
+   * - ERR_CONTENT_TYPE_DATA_MISMATCH: 種類が複数ファイルのとき
+   * 戻り値はdataを指すため、dataより長く保持してはならない。
+   */
+  Result<UploadBody, ErrorResponse> prepareUpload(
+    const ContentStatus& contentStatus,
+    std::span<const std::uint8_t> data);
+  /**
+   * @brief contentをアップロードする形式に変換する。
+   * @details
+   * 失敗した場合は次のエラーレスポンスを返す。
+   * - ERR_CONTENT_TYPE_DATA_MISMATCH: 種類とデータが一致しないとき
+   * また、複数ファイルの圧縮に失敗した場合はそのエラーをそのまま返す。
+   * 戻り値がcontentのデータを指すことがあるため、contentより長く保持してはならない。
+   *
+   * @param[in] content アップロードするコンテンツ
+   * @param[in] compression 複数ファイルのアーカイブの圧縮方法
+   */
+  Result<UploadBody, ErrorResponse> prepareUpload(
+    const Content& content,
+    CompressionOptions compression = {});
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_CONTENT_CODEC_H_
@@ -0,0 +1,127 @@
+/**
+ * @file content_prefetcher.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 変化を検出したコンテンツを、求められる前に取得しておく。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_CONTENT_PREFETCHER_H_
+#define OCTANE_API_CLIENT_INTERNAL_CONTENT_PREFETCHER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "include/api_result_types.h"
+#include "include/cancellation.h"
+#include "include/error_response.h"
+#include "include/internal/content_watcher.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief 新しいコンテンツが通知されたら専用のスレッドで取得し、デコードした結果を一つだけ覚えておく。
+   * @details
+   * ルームのid、ハッシュ値、タイムスタンプが一致するコンテンツを同じものとみなす。
+   * 取得中に別のコンテンツが通知された場合は取得をキャンセルし、新しい方を取得し直す。
+   * 覚えている結果も古くなるので、通知された時点で捨てる。
+   * デコードした結果の大きさがmaxBytesを超える場合は覚えない。
+   * 取得に失敗した場合も何も覚えず、呼び出し元がふつうに取得する。
+   * スレッドセーフである。
+   *
+   */
+  class ContentPrefetcher {
+  public:
+    /**
+     * @brief observationのコンテンツを取得し、検証してデコードする関数。
+     * @details
+     * cancellationがキャンセルされたら速やかに戻らなければならない。
+     * 自身でキャンセルしてもよい。
+     */
+    using Download = std::function<Result<Content, ErrorResponse>(
+      const ContentObservation&,
+      CancellationSource)>;
+
+  private:
+    struct Prepared {
+      ContentObservation observation;
+      std::shared_ptr<const Content> content;
+    };
+
+    Download download;
+    std::uint64_t maxBytes;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    /** @brief 次に取得するコンテンツ。*/
+    std::optional<ContentObservation> pending;
+    /** @brief 取得中のコンテンツ。*/
+    std::optional<ContentObservation> running;
+    /** @brief 取得中のコンテンツをキャンセルする。*/
+    CancellationSource cancellation;
+    std::optional<Prepared> prepared;
+    bool stopping;
+    std::thread worker;
+
+  public:
+    /**
+     * @brief Construct a new Content Prefetcher object
+     *
+     * @param[in] download コンテンツを取得する関数
+     * @param[in] maxBytes 覚えておくコンテンツの大きさの上限
+     */
+    ContentPrefetcher(Download download, std::uint64_t maxBytes);
+    ContentPrefetcher(const ContentPrefetcher&)            = delete;
+    ContentPrefetcher& operator=(const ContentPrefetcher&) = delete;
+    /**
+     * @brief Destroy the Content Prefetcher object
+     * @details
+     * {@link stop}を呼び出す。
+     */
+    ~ContentPrefetcher() noexcept;
+
+    /**
+     * @brief observationのコンテンツが新しく現れたことを通知する。
+     * @details
+     * 既に覚えているか取得中であれば何もしない。
+     *
+     */
+    void notify(const ContentObservation& observation);
+    /**
+     * @brief 呼び出し元が取得したcontentを、observationの結果として覚える。
+     * @details
+     * 同じコンテンツを取得中であればキャンセルする。
+     *
+     */
+    void offer(const ContentObservation& observation, const Content& content);
+    /**
+     * @brief observationのコンテンツを覚えていれば返す。
+     *
+     * @return std::shared_ptr<const Content> 覚えていなければnullptr
+     */
+    std::shared_ptr<const Content> find(
+      const ContentObservation& observation) const;
+    /**
+     * @brief 取得中のコンテンツをキャンセルし、スレッドの終了を待つ。
+     *
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief contentのデータがメモリ上で占める大きさを返す。
+     *
+     */
+    static std::uint64_t sizeOf(const Content& content);
+
+  private:
+    void run();
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_CONTENT_PREFETCHER_H_
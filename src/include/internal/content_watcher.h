@@ -0,0 +1,117 @@
+/**
+ * @file content_watcher.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief ルームのコンテンツの状態をポーリングし、変化したときだけ取得する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_CONTENT_WATCHER_H_
+#define OCTANE_API_CLIENT_INTERNAL_CONTENT_WATCHER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "include/api_options.h"
+#include "include/api_result_types.h"
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief ポーリングで得たコンテンツの状態。
+   *
+   */
+  struct ContentObservation {
+    /** @brief 状態を取得したルームのid。*/
+    std::uint64_t roomId;
+    /** @brief コンテンツの状態。*/
+    ContentStatus contentStatus;
+    /** @brief コンテンツのハッシュ値。*/
+    std::string hash;
+  };
+
+  /**
+   * @brief コンテンツの状態をポーリングし、変化したときだけコンテンツを取得して通知する。
+   * @details
+   * ルームのid、ハッシュ値、タイムスタンプのいずれかが前回と異なる場合に変化したとみなす。
+   * 変化がない間はポーリングの間隔を{@link WatchOptions::backoffFactor}倍ずつ
+   * {@link WatchOptions::maxInterval}まで伸ばし、変化があれば{@link
+   * WatchOptions::minInterval}に戻す。
+   * 状態の取得とコンテンツの取得の間に更新されてハッシュ値が一致しなかった場合は、
+   * 通知せずにすぐにポーリングし直す。
+   * ポーリングは専用のスレッドで行い、コールバックもそのスレッドで呼び出される。
+   *
+   */
+  class ContentWatcher {
+  public:
+    /** @brief コンテンツの状態を取得する関数。*/
+    using Poll = std::function<Result<ContentObservation, ErrorResponse>()>;
+    /** @brief 変化したコンテンツを取得する関数。*/
+    using Download = std::function<Result<Content, ErrorResponse>(
+      const ContentObservation&)>;
+    /** @brief 取得したコンテンツやエラーを受け取る関数。*/
+    using Callback = std::function<void(Result<Content, ErrorResponse>)>;
+
+  private:
+    Poll poll;
+    Download download;
+    Callback callback;
+    WatchOptions options;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread worker;
+
+  public:
+    /**
+     * @brief Construct a new Content Watcher object
+     * @details
+     * 構築するとすぐにポーリングを開始する。
+     *
+     * @param[in] poll コンテンツの状態を取得する関数
+     * @param[in] download 変化したコンテンツを取得する関数
+     * @param[in] callback 取得したコンテンツやエラーを受け取る関数
+     * @param[in] options ポーリングの間隔など
+     */
+    ContentWatcher(Poll poll,
+                   Download download,
+                   Callback callback,
+                   WatchOptions options);
+    ContentWatcher(const ContentWatcher&)            = delete;
+    ContentWatcher& operator=(const ContentWatcher&) = delete;
+    /**
+     * @brief Destroy the Content Watcher object
+     * @details
+     * {@link stop}を呼び出す。
+     */
+    ~ContentWatcher() noexcept;
+
+    /**
+     * @brief ポーリングを停止し、スレッドの終了を待つ。
+     * @details
+     * コールバックの中から呼び出してはならない。
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief 変化がなかったときの次のポーリングの間隔を返す。
+     *
+     */
+    static std::chrono::milliseconds nextInterval(
+      std::chrono::milliseconds interval,
+      const WatchOptions& options);
+
+  private:
+    void run();
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_CONTENT_WATCHER_H_
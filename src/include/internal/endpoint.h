@@ -0,0 +1,236 @@
+/**
+ * @file endpoint.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief APIのエンドポイントをコンパイル時に記述するための型を定義する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_ENDPOINT_H_
+#define OCTANE_API_CLIENT_INTERNAL_ENDPOINT_H_
+
+#include <charconv>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "include/api_result_types.h"
+#include "include/internal/http_client.h"
+#include "include/internal/schema_registry.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief テンプレート引数として文字列リテラルを受け取るための型。
+   *
+   * @tparam N ゼロ終端を含む文字列の長さ
+   */
+  template <std::size_t N>
+  struct FixedString {
+    char value[N]{};
+    constexpr FixedString(const char (&str)[N]) {
+      for (std::size_t i = 0; i < N; ++i) {
+        value[i] = str[i];
+      }
+    }
+    constexpr std::string_view view() const noexcept {
+      return std::string_view(value, N - 1);
+    }
+  };
+
+  /**
+   * @brief レスポンスをスキーマで検証しないエンドポイントに指定する型。
+   *
+   */
+  struct NoSchema {};
+  /** @brief {@link NoSchema}の値。*/
+  inline constexpr NoSchema NO_SCHEMA{};
+
+  /** @brief ボディ部を持たないリクエストを表す。*/
+  struct NoBody {};
+  /** @brief POST /roomのリクエストを表す。*/
+  struct RoomPostRequest {
+    /** @brief ルームの名前。*/
+    std::string_view name;
+  };
+  /** @brief POST /room/{id}のリクエストを表す。*/
+  struct RoomIdPostRequest {
+    /** @brief ルームに接続する/接続解除するデバイスの名前。*/
+    std::string_view name;
+    /** @brief "connect"もしくは"disconnect"。*/
+    std::string_view request;
+  };
+  /** @brief PUT /room/{id}/contentのリクエストを表す。*/
+  struct RoomIdContentPutRequest {
+    /** @brief アップロードするデータ。コピーせずに送信する。*/
+    std::span<const std::uint8_t> data;
+    /** @brief アップロードするデータのMIME。*/
+    std::string_view mime;
+  };
+  /** @brief PUT /room/{id}/statusのリクエストを表す。*/
+  struct RoomIdStatusPutRequest {
+    /** @brief コンテンツの状態。*/
+    const ContentStatus& contentStatus;
+    /** @brief コンテンツのハッシュ値。*/
+    std::string_view hash;
+  };
+
+  /**
+   * @brief APIのエンドポイントを表す記述子。
+   * @details
+   * ルーティング、リクエストのシリアライズ、レスポンスのデコードと検証は
+   * この記述子からコンパイル時に生成される({@link ApiBridge::call})。
+   * ルートには"{id}"というプレースホルダを一つだけ含めることができ、
+   * ルームのidに置き換えられる。
+   *
+   * @code {.cpp}
+   * using RoomIdGet = Endpoint<HttpMethod::Get,
+   *                            "/room/{id}",
+   *                            NoBody,
+   *                            RoomStatus,
+   *                            SchemaId::RoomIdGet>;
+   * RoomIdGet::path(12); // "/room/12"
+   * @endcode
+   *
+   * @tparam Method リクエストに使用するHTTPメソッド
+   * @tparam Route ベースURLからのルート
+   * @tparam Request リクエストの型
+   * @tparam Response レスポンスをデコードした型
+   * @tparam Schema レスポンスの検証に使うスキーマ。検証しない場合は{@link
+   * NO_SCHEMA}
+   */
+  template <HttpMethod Method,
+            FixedString Route,
+            typename Request,
+            typename Response,
+            auto Schema>
+  struct Endpoint {
+    using RequestType  = Request;
+    using ResponseType = Response;
+
+    static constexpr HttpMethod method     = Method;
+    static constexpr std::string_view route = Route.view();
+    static constexpr auto schema            = Schema;
+    static constexpr bool hasSchema
+      = std::is_same_v<std::remove_cv_t<decltype(Schema)>, SchemaId>;
+
+  private:
+    static constexpr std::string_view PLACEHOLDER = "{id}";
+    static constexpr std::size_t placeholderPos   = route.find(PLACEHOLDER);
+
+  public:
+    static constexpr bool hasId = placeholderPos != std::string_view::npos;
+    static constexpr std::string_view prefix
+      = hasId ? route.substr(0, placeholderPos) : route;
+    static constexpr std::string_view suffix
+      = hasId ? route.substr(placeholderPos + PLACEHOLDER.size())
+              : std::string_view();
+
+    static_assert(suffix.find('{') == std::string_view::npos,
+                  "Only one {id} placeholder is supported.");
+    static_assert(!(Method == HttpMethod::Get || Method == HttpMethod::Delete)
+                    || std::is_same_v<Request, NoBody>,
+                  "GET and DELETE requests must not have a body.");
+
+    /**
+     * @brief プレースホルダを持たないルートのパスを返す。
+     *
+     * @return std::string パス
+     */
+    static std::string path()
+      requires(!hasId)
+    {
+      return std::string(route);
+    }
+    /**
+     * @brief プレースホルダをidで置き換えたパスを返す。
+     * @details
+     * 必要な長さを先に確保するため、メモリの確保は一度しか行わない。
+     *
+     * @param[in] id ルームのid
+     * @return std::string パス
+     */
+    static std::string path(std::uint64_t id)
+      requires hasId
+    {
+      char digits[20];
+      const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), id);
+      std::string path;
+      path.reserve(prefix.size() + (end - digits) + suffix.size());
+      path.append(prefix);
+      path.append(digits, end);
+      path.append(suffix);
+      return path;
+    }
+  };
+
+  namespace endpoint {
+    using HealthGet = Endpoint<HttpMethod::Get,
+                               "/health",
+                               NoBody,
+                               HealthResult,
+                               SchemaId::HealthGet>;
+    using RoomPost  = Endpoint<HttpMethod::Post,
+                              "/room",
+                              RoomPostRequest,
+                              RoomId,
+                              SchemaId::RoomPost>;
+    using RoomIdGet = Endpoint<HttpMethod::Get,
+                               "/room/{id}",
+                               NoBody,
+                               RoomStatus,
+                               SchemaId::RoomIdGet>;
+    using RoomIdDelete
+      = Endpoint<HttpMethod::Delete, "/room/{id}", NoBody, _, NO_SCHEMA>;
+    using RoomIdPost = Endpoint<HttpMethod::Post,
+                                "/room/{id}",
+                                RoomIdPostRequest,
+                                _,
+                                NO_SCHEMA>;
+    using RoomIdContentGet    = Endpoint<HttpMethod::Get,
+                                      "/room/{id}/content",
+                                      NoBody,
+                                      std::vector<std::uint8_t>,
+                                      NO_SCHEMA>;
+    using RoomIdContentDelete = Endpoint<HttpMethod::Delete,
+                                         "/room/{id}/content",
+                                         NoBody,
+                                         _,
+                                         NO_SCHEMA>;
+    using RoomIdContentPut    = Endpoint<HttpMethod::Put,
+                                      "/room/{id}/content",
+                                      RoomIdContentPutRequest,
+                                      _,
+                                      NO_SCHEMA>;
+    using RoomIdStatusGet     = Endpoint<HttpMethod::Get,
+                                     "/room/{id}/status",
+                                     NoBody,
+                                     std::pair<ContentStatus, std::string>,
+                                     SchemaId::RoomIdStatusGet>;
+    using RoomIdStatusDelete  = Endpoint<HttpMethod::Delete,
+                                        "/room/{id}/status",
+                                        NoBody,
+                                        _,
+                                        NO_SCHEMA>;
+    using RoomIdStatusPut     = Endpoint<HttpMethod::Put,
+                                     "/room/{id}/status",
+                                     RoomIdStatusPutRequest,
+                                     _,
+                                     NO_SCHEMA>;
+    // イベントストリームは通常のレスポンスとして受け取らないので、パスを組み立てるためだけに使う。
+    // contentイベントはSchemaId::RoomIdStatusGet、deviceイベントはこのスキーマで検証する。
+    using RoomIdEventsGet = Endpoint<HttpMethod::Get,
+                                     "/room/{id}/events",
+                                     NoBody,
+                                     RoomEvent,
+                                     SchemaId::RoomIdEventsDevice>;
+  } // namespace endpoint
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_ENDPOINT_H_
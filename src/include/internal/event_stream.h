@@ -0,0 +1,70 @@
+/**
+ * @file event_stream.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Server-Sent Eventsのストリームを解析する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_EVENT_STREAM_H_
+#define OCTANE_API_CLIENT_INTERNAL_EVENT_STREAM_H_
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace octane::internal {
+  /**
+   * @brief Server-Sent Eventsの一つのイベント。
+   *
+   */
+  struct StreamEvent {
+    /** @brief eventフィールド。省略された場合は"message"。*/
+    std::string event;
+    /** @brief dataフィールド。複数行の場合は改行で連結される。*/
+    std::string data;
+  };
+
+  /**
+   * @brief Server-Sent Eventsのストリームを、届いた断片ごとに解析する。
+   * @details
+   * 改行はLF、CRLF、CRのいずれも受け付ける。
+   * コロンで始まる行(キープアライブのコメント)や、event、data以外のフィールドは無視する。
+   * dataフィールドを一つも持たないイベントは通知しない。
+   *
+   * @see { @link https://html.spec.whatwg.org/multipage/server-sent-events.html }
+   */
+  class EventStreamParser {
+    /** @brief まだ改行が届いていない行。*/
+    std::string line;
+    /** @brief 組み立て中のイベント。*/
+    StreamEvent current;
+    /** @brief currentがdataフィールドを持つかどうか。*/
+    bool hasData = false;
+    /** @brief 直前の断片がCRで終わったかどうか。CRLFを一つの改行として扱うために使う。*/
+    bool pendingCr = false;
+
+  public:
+    /**
+     * @brief ストリームの断片を解析し、完成したイベントをonEventに渡す。
+     *
+     * @param[in] chunk ストリームの断片。行の途中で区切られていてもよい。
+     * @param[in] onEvent 完成したイベントを受け取る関数
+     */
+    void feed(std::string_view chunk,
+              const std::function<void(StreamEvent&&)>& onEvent);
+    /**
+     * @brief 組み立て中のイベントを破棄する。
+     * @details
+     * 接続し直すときに呼び出す。
+     */
+    void reset() noexcept;
+
+  private:
+    void processLine(const std::function<void(StreamEvent&&)>& onEvent);
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_EVENT_STREAM_H_
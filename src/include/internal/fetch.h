@@ -11,20 +11,21 @@
 #ifndef OCTANE_API_CLIENT_INTERNAL_FETCH_H_
 #define OCTANE_API_CLIENT_INTERNAL_FETCH_H_
 
-#include <rapidjson/document.h>
-#include <rapidjson/encodings.h>
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
-
+#include <deque>
 #include <map>
+#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
 
+#include "./async.h"
 #include "./http_client.h"
+#include "./json.h"
 #include "include/error_response.h"
 #include "include/result.h"
+#include "include/task.h"
 
 namespace octane::internal {
   /**
@@ -33,7 +34,7 @@ namespace octane::internal {
    */
   struct FetchResponse {
     /** @brief レスポンスのボディ部。*/
-    std::variant<rapidjson::Document, std::vector<std::uint8_t>> body;
+    std::variant<Json, std::vector<std::uint8_t>> body;
     /** @brief レスポンスのmime。*/
     std::string mime;
     /** @brief レスポンスのステータスコード。*/
@@ -42,6 +43,16 @@ namespace octane::internal {
     std::string statusLine;
     /** @brief レスポンスのヘッダ部(ステータスラインを除く)。 */
     std::map<std::string,std::string> header;
+
+    /**
+     * @brief nameのヘッダフィールドの値を返す。
+     * @details
+     * HTTP/2ではフィールド名が小文字で届くので、大文字と小文字を区別せずに探す。
+     *
+     * @param[in] name フィールド名
+     * @return const std::string* 見つからなければnullptr
+     */
+    const std::string* findHeader(std::string_view name) const;
   };
 
   /**
@@ -106,14 +117,14 @@ namespace octane::internal {
      */
     virtual FetchResult request(HttpMethod method,
                                 std::string_view url,
-                                const rapidjson::Document& body)
+                                const Json& body)
       = 0;
     /**
      * @brief APIへの任意のContent-Typeのボディ部を持つリクエストを発行する。
      * @details
      * このメソッドは任意のContent-Typeのボディを持つリクエストに使用する。
      * JSON形式のリクエストの場合は{@link Fetch::request(HttpMethod method,
-     * std::string_view url, const rapidjson::Document& body)}の使用を推奨する。
+     * std::string_view url, const Json& body)}の使用を推奨する。
      * GET及びDELETEリクエストはこのメソッドを使用してはならず、代わりに{@link
      * Fetch::request(HttpMethod method, std::string_view url)}を使用すること。
      * 失敗した場合は次のエラーレスポンスを返す。
@@ -133,6 +144,128 @@ namespace octane::internal {
                                 std::string_view mimeType,
                                 const std::vector<std::uint8_t>& body)
       = 0;
+    /**
+     * @brief {@link request(HttpMethod, std::string_view, std::string_view,
+     * const std::vector<std::uint8_t>&)}のボディ部をコピーせずに送信する版。
+     * @details
+     * bodyは呼び出し元のバッファを指したまま送信されるので、
+     * 呼び出しが戻るまで有効でなければならない。
+     * 既定の実装はbodyをstd::vectorにコピーしてから上記のメソッドを呼び出す。
+     */
+    virtual FetchResult request(HttpMethod method,
+                                std::string_view url,
+                                std::string_view mimeType,
+                                std::span<const std::uint8_t> body);
+
+    /**
+     * @brief {@link request(HttpMethod, std::string_view)}の非同期版。
+     * @details
+     * 完了したコルーチンはcontext.executorで再開される。
+     * tokenがキャンセルされた場合はERR_CANCELLEDを返す。
+     * 既定の実装は呼び出し元のスレッドで同期版を呼び出す。
+     *
+     */
+    virtual Task<FetchResult> requestAsync(AsyncContext context,
+                                           HttpMethod method,
+                                           std::string url);
+    /**
+     * @brief {@link request(HttpMethod, std::string_view, const Json&)}の非同期版。
+     *
+     */
+    virtual Task<FetchResult> requestAsync(AsyncContext context,
+                                           HttpMethod method,
+                                           std::string url,
+                                           Json body);
+    /**
+     * @brief {@link request(HttpMethod, std::string_view, std::string_view,
+     * std::span<const std::uint8_t>)}の非同期版。
+     * @details
+     * bodyはタスクが完了するまで有効でなければならない。
+     */
+    virtual Task<FetchResult> requestAsync(
+      AsyncContext context,
+      HttpMethod method,
+      std::string url,
+      std::string mimeType,
+      std::span<const std::uint8_t> body);
+
+    /**
+     * @brief APIからServer-Sent Eventsのストリームを受け取るGETリクエストを発行する。
+     * @details
+     * 2xxのレスポンスのボディ部は届いた順にonDataへ渡し、返り値のボディ部は空になる。
+     * 接続が閉じられるか、onDataがfalseを返すまで呼び出し元のスレッドをブロックする。
+     * 失敗した場合は{@link request(HttpMethod, std::string_view)}のエラーレスポンスに加え、
+     * 次のエラーレスポンスを返す。
+     * - ERR_CANCELLED: tokenがキャンセルされたとき
+     * - ERR_EVENT_STREAM_UNAVAILABLE: ストリームを受け取れない実装のとき
+     * 既定の実装はERR_EVENT_STREAM_UNAVAILABLEを返す。
+     *
+     * @param[in] url APIへのURL
+     * @param[in] token リクエストを中断するためのトークン
+     * @param[in] onData ボディ部を受け取る関数
+     * @return FetchResult
+     * 成功した場合はボディ部を除いたレスポンス、失敗した場合は上記のエラーレスポンスを返す。
+     */
+    virtual FetchResult stream(std::string_view url,
+                               CancellationToken token,
+                               const HttpClientBase::StreamCallback& onData);
+    /**
+     * @brief ボディ部を受信しながらobserverに渡すGETリクエストを発行する。
+     * @details
+     * 2xxのレスポンスのボディ部は、届いた順に一部ずつobserverへ渡し、返り値には格納しない。
+     * そのため大きなボディ部もメモリに溜めずに受け取れる。返り値のボディ部は空のバイナリになる。
+     * 2xx以外のレスポンスのボディ部は{@link request(HttpMethod, std::string_view)}と同様に返り値に格納する。
+     * エラーレスポンスは{@link request(HttpMethod, std::string_view)}と同じ。
+     * 既定の実装は{@link request(HttpMethod, std::string_view)}で受け取った後に、
+     * バイナリのボディ部をまとめてobserverへ渡す。
+     *
+     * @param[in] url APIへのURL
+     * @param[in] observer ボディ部を受け取る関数
+     * @return FetchResult
+     * 成功した場合はレスポンスのボディ部、失敗した場合は上記のエラーレスポンスを返す。
+     */
+    virtual FetchResult download(std::string_view url,
+                                 const BodyObserver& observer);
+    /**
+     * @brief {@link download}の非同期版。
+     * @details
+     * observerはタスクが完了するまで有効でなければならない。
+     * observerはHttpClientのI/Oスレッドから呼び出されることがある。
+     * 既定の実装は{@link requestAsync(AsyncContext, HttpMethod, std::string)}で受け取った後に、
+     * バイナリのボディ部をまとめてobserverへ渡す。
+     */
+    virtual Task<FetchResult> downloadAsync(AsyncContext context,
+                                            std::string url,
+                                            const BodyObserver& observer);
+    /**
+     * @brief 前回のレスポンスの検証子を付けた条件付きのGETリクエストを発行する。
+     * @details
+     * 前回の2xxのレスポンスにETagやLast-Modifiedがあれば、
+     * If-None-MatchやIf-Modified-Sinceとして送信する。
+     * 変更がなければボディ部が空の304のレスポンスを返すので、
+     * 呼び出し元は前回のレスポンスを覚えておかなければならない。
+     * エラーレスポンスは{@link request(HttpMethod, std::string_view)}と同じ。
+     * 既定の実装は検証子を持たず、{@link request(HttpMethod, std::string_view)}を呼び出す。
+     *
+     * @param[in] url APIへのURL
+     * @return FetchResult
+     * 成功した場合はレスポンス、失敗した場合は上記のエラーレスポンスを返す。
+     */
+    virtual FetchResult revalidate(std::string_view url);
+    /**
+     * @brief {@link revalidate}の非同期版。
+     *
+     */
+    virtual Task<FetchResult> revalidateAsync(AsyncContext context,
+                                              std::string url);
+    /**
+     * @brief urlについて覚えている検証子を捨てる。
+     * @details
+     * 呼び出し元が前回のレスポンスを失ったときに、次の{@link revalidate}で全体を受け取り直すために使う。
+     * 既定の実装は何もしない。
+     *
+     */
+    virtual void forgetValidators(std::string_view url);
   };
   /**
    * @brief HttpClientクラスを通じてHTTP通信を行う。
@@ -147,6 +280,22 @@ namespace octane::internal {
     std::string baseUrl;
     HttpClientBase* client;
 
+    /**
+     * @brief 条件付きリクエストに使う、前回のレスポンスの検証子。
+     *
+     */
+    struct Validators {
+      /** @brief ETagの値。*/
+      std::string etag;
+      /** @brief Last-Modifiedの値。*/
+      std::string lastModified;
+    };
+    /** @brief URLごとの検証子。数が上限に達したら古いものから捨てる。*/
+    std::map<std::string, Validators> validators;
+    /** @brief validatorsのURLを覚えた順に並べたもの。*/
+    std::deque<std::string> validatorOrder;
+    std::mutex validatorsMutex;
+
   public:
     /**
      * @brief Construct a new Fetch object
@@ -186,7 +335,7 @@ namespace octane::internal {
      */
     virtual FetchResult request(HttpMethod method,
                                 std::string_view url,
-                                const rapidjson::Document& body) override;
+                                const Json& body) override;
     /**
      * {@inheritDoc}
      */
@@ -194,6 +343,67 @@ namespace octane::internal {
                                 std::string_view url,
                                 std::string_view mimeType,
                                 const std::vector<std::uint8_t>& body) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual FetchResult request(HttpMethod method,
+                                std::string_view url,
+                                std::string_view mimeType,
+                                std::span<const std::uint8_t> body) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual Task<FetchResult> requestAsync(AsyncContext context,
+                                           HttpMethod method,
+                                           std::string url) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual Task<FetchResult> requestAsync(AsyncContext context,
+                                           HttpMethod method,
+                                           std::string url,
+                                           Json body) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual Task<FetchResult> requestAsync(
+      AsyncContext context,
+      HttpMethod method,
+      std::string url,
+      std::string mimeType,
+      std::span<const std::uint8_t> body) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual FetchResult stream(
+      std::string_view url,
+      CancellationToken token,
+      const HttpClientBase::StreamCallback& onData) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual FetchResult download(std::string_view url,
+                                 const BodyObserver& observer) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual Task<FetchResult> downloadAsync(
+      AsyncContext context,
+      std::string url,
+      const BodyObserver& observer) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual FetchResult revalidate(std::string_view url) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual Task<FetchResult> revalidateAsync(AsyncContext context,
+                                              std::string url) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual void forgetValidators(std::string_view url) override;
 
   private:
     /**
@@ -211,6 +421,8 @@ namespace octane::internal {
      * @param[in] url APIへのURL。baseUrlを含む。
      * @param[in] headers リクエストのヘッダフィールド
      * @param[in] body APIリクエストのボディ部
+     * @param[in] observer 2xxのレスポンスのボディ部を受信しながら渡す関数。nullptrであれば何もしない。
+     * HttpClientが受信中に渡さなかった部分は、受信し終えてから渡す。渡したボディ部は返り値に格納しない。
      * @return FetchResult
      * 成功した場合はレスポンスのボディ部、失敗した場合は上記のエラーレスポンスを返す。
      *
@@ -223,7 +435,45 @@ namespace octane::internal {
                         std::string_view origin,
                         std::string_view url,
                         const std::map<std::string, std::string>& headers,
-                        const std::vector<std::uint8_t>& body);
+                        std::span<const std::uint8_t> body,
+                        const BodyObserver* observer = nullptr);
+    /**
+     * @brief {@link request}の非同期版。
+     * @details
+     * リクエストはHttpClientBase::requestAsyncで発行する。
+     * bodyとobserverはタスクが完了するまで有効でなければならない。
+     */
+    Task<FetchResult> requestAsync(AsyncContext context,
+                                   HttpMethod method,
+                                   std::string origin,
+                                   std::string url,
+                                   std::map<std::string, std::string> headers,
+                                   std::span<const std::uint8_t> body,
+                                   const BodyObserver* observer = nullptr);
+    /**
+     * @brief {@link stream}の実装。リダイレクトのたびに呼び出し直される。
+     *
+     */
+    FetchResult stream(std::string_view origin,
+                       std::string_view url,
+                       const CancellationToken& token,
+                       const HttpClientBase::StreamCallback& onData);
+    /**
+     * @brief urlの検証子を条件付きリクエストのヘッダとして加えたヘッダフィールドを返す。
+     *
+     */
+    std::map<std::string, std::string> conditionalHeaders(
+      const std::string& url);
+    /**
+     * @brief 2xxのレスポンスであれば、その検証子をurlの検証子として覚える。
+     *
+     */
+    void rememberValidators(const std::string& url, const FetchResult& result);
+    /**
+     * @brief urlの検証子を捨てる。validatorsMutexを保持して呼び出す。
+     *
+     */
+    void eraseValidators(const std::string& url);
   };
 } // namespace octane::internal
 
@@ -11,8 +11,11 @@
 #ifndef OCTANE_API_CLIENT_INTERNAL_HASH_H_
 #define OCTANE_API_CLIENT_INTERNAL_HASH_H_
 
-#include <vector>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace octane::internal {
   /**
@@ -32,7 +35,40 @@ namespace octane::internal {
    * @param[in] src ハッシュを生成する値。
    * @return std::string 生成されたハッシュ値。
    */
-  std::string generateHash(const std::vector<std::uint8_t>& src);
+  std::string generateHash(std::span<const std::uint8_t> src);
+  /**
+   * @brief ハッシュ値をデータが届いた順に少しずつ計算する。
+   * @details
+   * 使用されるアルゴリズムはgenerateHashと同じblack2b-256であり、
+   * データをどのように分割して渡しても、まとめてgenerateHashに渡した場合と同じ値になる。
+   * 受信や送信と並行してハッシュ値を計算し、データをもう一度走査しないために使う。
+   *
+   */
+  class Hasher {
+    struct State;
+    std::unique_ptr<State> state;
+
+  public:
+    Hasher();
+    Hasher(Hasher&& other) noexcept;
+    Hasher& operator=(Hasher&& other) noexcept;
+    ~Hasher() noexcept;
+
+    /**
+     * @brief データの続きを渡す。
+     *
+     * @param[in] data データの続き
+     */
+    void update(std::span<const std::uint8_t> data);
+    /**
+     * @brief これまでに渡したデータのハッシュ値を返す。
+     * @details
+     * 呼び出した後は何も渡していない状態に戻る。
+     *
+     * @return std::string 16進数文字列のハッシュ値。
+     */
+    std::string finish();
+  };
 } // namespace octane::internal
 
 #endif // OCTANE_API_CLIENT_INTERNAL_HASH_H_
\ No newline at end of file
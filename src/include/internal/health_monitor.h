@@ -0,0 +1,204 @@
+/**
+ * @file health_monitor.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief APIサーバのヘルスチェックの結果を共有し、バックグラウンドで更新する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_HEALTH_MONITOR_H_
+#define OCTANE_API_CLIENT_INTERNAL_HEALTH_MONITOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "include/api_result_types.h"
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief {@link HealthMonitor}の更新間隔などを表す構造体。
+   *
+   */
+  struct HealthMonitorOptions {
+    /**
+     * @brief ヘルスチェックの結果が有効な期間。
+     * @details
+     * APIの制約上、ヘルスチェックは30分に一回行わなければならない。
+     */
+    std::chrono::steady_clock::duration ttl = std::chrono::minutes(30);
+    /** @brief Healthyのとき、期限が切れるどれだけ前に更新するか。*/
+    std::chrono::steady_clock::duration refreshAhead = std::chrono::minutes(1);
+    /**
+     * @brief Degraded及びFaultyのときの更新間隔。
+     * @details
+     * Faultyの結果はこの期間だけ有効となる。
+     */
+    std::chrono::steady_clock::duration degradedInterval
+      = std::chrono::minutes(1);
+    /** @brief バックグラウンドでの更新に失敗したときに再試行するまでの間隔。*/
+    std::chrono::steady_clock::duration retryInterval
+      = std::chrono::seconds(10);
+    /**
+     * @brief バックグラウンドのスレッドで更新するかどうか。
+     * @details
+     * falseの場合はスレッドを作成せず、期限が切れた後の{@link
+     * HealthMonitor::current}や{@link HealthMonitor::update}で更新する。
+     */
+    bool backgroundRefresh = true;
+  };
+
+  /**
+   * @brief APIサーバのヘルスチェックの結果を保持し、期限が切れる前に更新する。
+   * @details
+   * 結果は単調増加する時計(std::chrono::steady_clock)で管理する。
+   * 更新はバックグラウンドのスレッドで行われるため、
+   * {@link current}は通常ロックを取らずに、キャッシュされた結果を返す。
+   * 全てのメンバ関数は複数のスレッドから同時に呼び出してもよい。
+   * 結果が一度も得られていないときや期限が切れているときのみ、
+   * 呼び出し元のスレッドでヘルスチェックを行う。
+   * 同じオリジンとトークンに対するインスタンスは{@link shared}でプロセス全体で共有できる。
+   *
+   */
+  class HealthMonitor {
+  public:
+    using Clock = std::chrono::steady_clock;
+    /** @brief ヘルスチェックを行う関数。複数のスレッドから呼び出されることはない。*/
+    using Probe = std::function<Result<HealthResult, ErrorResponse>()>;
+
+    /**
+     * @brief ある時点でのヘルスチェックの結果を表す構造体。
+     *
+     */
+    struct Snapshot {
+      /** @brief ヘルスチェックの結果。*/
+      HealthResult health;
+      /** @brief ヘルスチェックを行った時刻。*/
+      Clock::time_point checkedAt;
+      /** @brief 結果が有効な期限。*/
+      Clock::time_point expiresAt;
+      /** @brief バックグラウンドで次に更新する時刻。*/
+      Clock::time_point nextRefreshAt;
+    };
+
+  private:
+    Probe probe;
+    HealthMonitorOptions options;
+    /**
+     * @brief 最新の結果。
+     * @details
+     * 公開した後は変更せず、更新時はポインタごと差し替える。
+     * 読み出しはロックを取らない。
+     * libstdc++の実装に対するThreadSanitizerの誤検知はtest/tsan.suppで抑制する。
+     */
+    std::atomic<std::shared_ptr<const Snapshot>> snapshot;
+    /** @brief ヘルスチェックが同時に複数行われないようにするミューテックス。*/
+    std::mutex refreshMutex;
+    /** @brief バックグラウンドのスレッドを起こすためのミューテックス。*/
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread worker;
+
+  public:
+    /**
+     * @brief Construct a new Health Monitor object
+     * @details
+     * バックグラウンドのスレッドは最初の結果が得られるまで何もしない。
+     *
+     * @param[in] probe ヘルスチェックを行う関数
+     * @param[in] options 更新間隔など
+     */
+    explicit HealthMonitor(Probe probe, HealthMonitorOptions options = {});
+    HealthMonitor(const HealthMonitor&)            = delete;
+    HealthMonitor& operator=(const HealthMonitor&) = delete;
+    /**
+     * @brief Destroy the Health Monitor object
+     * @details
+     * バックグラウンドのスレッドを停止し、終了を待つ。
+     */
+    ~HealthMonitor() noexcept;
+
+    /**
+     * @brief 有効なヘルスチェックの結果を返す。
+     * @details
+     * キャッシュされた結果が有効な場合はそれを返す。
+     * そうでない場合はヘルスチェックを行い、その結果を返す。
+     * 失敗した場合はヘルスチェックのエラーレスポンスをそのまま返す。
+     *
+     * @return Result<HealthResult, ErrorResponse>
+     * 成功した場合はヘルスチェックの結果、失敗した場合はエラーレスポンスを返す。
+     */
+    Result<HealthResult, ErrorResponse> current();
+    /**
+     * @brief キャッシュされている結果を返す。
+     *
+     * @return std::shared_ptr<const Snapshot> 一度も結果が得られていない場合はnullptr
+     */
+    std::shared_ptr<const Snapshot> peek() const noexcept;
+    /**
+     * @brief 他の経路で行ったヘルスチェックの結果を反映する。
+     * @details
+     * 非同期のリクエストでヘルスチェックを行ったときに使う。
+     * 結果の扱いはプローブで行った場合と同じである。
+     *
+     * @param[in] result ヘルスチェックの結果
+     */
+    void update(const Result<HealthResult, ErrorResponse>& result);
+
+    /**
+     * @brief プロセス全体で共有されるインスタンスを取得する。
+     * @details
+     * keyが同じであれば、同じインスタンスを返す。
+     * インスタンスは全ての参照がなくなったときに破棄される。
+     * makeProbeはインスタンスを新しく作成するときのみ呼び出される。
+     *
+     * @param[in] key インスタンスを識別するキー。オリジンとベースURL、トークンのハッシュ値など。
+     * @param[in] makeProbe ヘルスチェックを行う関数を作成する関数
+     * @return std::shared_ptr<HealthMonitor> 共有インスタンス
+     */
+    static std::shared_ptr<HealthMonitor> shared(
+      std::string_view key,
+      const std::function<Probe()>& makeProbe);
+
+  private:
+    /**
+     * @brief ヘルスチェックを行い、結果を保存する。
+     * @details
+     * refreshMutexを取得した状態で呼び出さなければならない。
+     * 失敗した場合は以前の結果を保持したまま、再試行の時刻だけを更新する。
+     */
+    Result<HealthResult, ErrorResponse> refreshLocked();
+    /**
+     * @brief ヘルスチェックの結果から新しいスナップショットを作成して保存する。
+     *
+     */
+    void apply(const Result<HealthResult, ErrorResponse>& result);
+    std::shared_ptr<const Snapshot> load() const;
+    void store(std::shared_ptr<const Snapshot> next);
+    void run();
+  };
+
+  /**
+   * @brief ヘルスチェックの結果を検証する。
+   * @details
+   * サーバがFaultyの場合はERR_SERVER_HEALTH_STATUS_FAULTYを返す。
+   *
+   * @param[in] result ヘルスチェックの結果
+   * @return Result<HealthResult, ErrorResponse>
+   * サーバが利用可能な場合はresultをそのまま返す。
+   */
+  Result<HealthResult, ErrorResponse> verifyHealth(
+    Result<HealthResult, ErrorResponse> result);
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_HEALTH_MONITOR_H_
@@ -13,10 +13,18 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "../cancellation.h"
+#include "../event_loop.h"
 #include "../error_response.h"
 #include "../result.h"
 
@@ -49,6 +57,11 @@ namespace octane::internal {
     /** @brief HTTP/3を表す。*/
     Http3,
   };
+  /**
+   * @brief 受信中のレスポンスのボディ部を、届いた順に一部ずつ受け取る関数。
+   *
+   */
+  using BodyObserver = std::function<void(std::span<const std::uint8_t>)>;
   /**
    * @brief HTTPのリクエストを表す構造体。
    *
@@ -62,8 +75,20 @@ namespace octane::internal {
     std::string uri;
     /** @brief リクエストに使用するHTTPヘッダフィールド。*/
     std::map<std::string, std::string> headerField;
-    /** @brief リクエストのボディ部。*/
-    const std::vector<std::uint8_t>* body;
+    /**
+     * @brief リクエストのボディ部。
+     * @details
+     * コピーせずに送信するので、リクエストが完了するまで有効でなければならない。
+     */
+    std::span<const std::uint8_t> body;
+    /**
+     * @brief 2xxのレスポンスのボディ部を受信しながら渡す関数。nullptrであれば何もしない。
+     * @details
+     * 渡したボディ部はレスポンスに格納しないので、大きなボディ部もメモリに溜めずに受け取れる。
+     * 対応していない実装は無視してレスポンスに格納するので、必ず渡されるとは限らない。
+     * リクエストの比較には含まれない。
+     */
+    const BodyObserver* bodyObserver = nullptr;
   };
   bool operator==(const HttpRequest& a, const HttpRequest& b);
   std::ostream& operator<<(std::ostream& stream, const HttpRequest& request);
@@ -149,19 +174,129 @@ namespace octane::internal {
      */
     virtual Result<HttpResponse, ErrorResponse>
     request(std::string_view origin, const HttpRequest& request) = 0;
+
+    /** @brief {@link requestAsync}が完了したときに呼び出される関数。*/
+    using RequestCallback
+      = std::function<void(Result<HttpResponse, ErrorResponse>)>;
+    /**
+     * @brief HTTPリクエストを非同期に発行する。
+     * @details
+     * リクエストが完了すると、その結果を引数としてcallbackを一度だけ呼び出す。
+     * callbackは任意のスレッドで呼び出され、このメソッドの中で呼び出されることもある。
+     * I/Oスレッドで呼び出されることもあるため、callbackはブロックしてはならない。
+     * requestとそのボディ部はcallbackが呼び出されるまで有効でなければならない。
+     * {@link request}のエラーレスポンスに加え、tokenがキャンセルされた場合は
+     * ERR_CANCELLEDを返す。
+     * 既定の実装は呼び出し元のスレッドで{@link request}を呼び出す。
+     *
+     * @param[in] origin リクエスト先のオリジン。"http://localhost:3000"など。
+     * @param[in] request リクエスト用のオブジェクト。
+     * @param[in] token リクエストを中断するためのトークン。
+     * @param[in] callback 完了したときに呼び出される関数。
+     */
+    virtual void requestAsync(std::string_view origin,
+                              const HttpRequest& request,
+                              CancellationToken token,
+                              RequestCallback callback);
+
+    /**
+     * @brief {@link stream}で受け取ったボディ部の一部を渡す関数。
+     * @details
+     * falseを返すとそこで受信を打ち切る。
+     */
+    using StreamCallback = std::function<bool(std::string_view)>;
+    /**
+     * @brief 終わりのないレスポンスを受け取るHTTPリクエストを発行する。
+     * @details
+     * 2xxのレスポンスのボディ部は溜めずに、届いた順にonDataへ渡す。
+     * それ以外のレスポンスのボディ部は{@link request}と同様に返り値に格納する。
+     * 接続が閉じられるか、onDataがfalseを返すまで呼び出し元のスレッドをブロックする。
+     * {@link request}のエラーレスポンスに加え、tokenがキャンセルされた場合は
+     * ERR_CANCELLEDを返す。
+     * 既定の実装は{@link request}でボディ部を全て受け取ってからonDataに渡す。
+     *
+     * @param[in] origin リクエスト先のオリジン。"http://localhost:3000"など。
+     * @param[in] request リクエスト用のオブジェクト。
+     * @param[in] token リクエストを中断するためのトークン。
+     * @param[in] onData ボディ部を受け取る関数。
+     * @return Result<HttpResponse, ErrorResponse>
+     * ボディ部を除いたレスポンス。
+     */
+    virtual Result<HttpResponse, ErrorResponse>
+    stream(std::string_view origin,
+           const HttpRequest& request,
+           CancellationToken token,
+           const StreamCallback& onData);
   };
   /**
    * @brief HTTP通信を行う。
+   * @details
+   * CURLのハンドルはリクエストのたびに作成せず、プールして使い回す。
+   * 確立した接続はハンドルごとに残るので、同じオリジンへの連続したリクエストはそれを再利用する。
+   * DNSとTLSセッションのキャッシュはハンドル間で共有する。
+   * 接続のキャッシュは、libcurlが同時に通信するハンドル間での共有に対応していないため共有しない。
+   * {@link request}は複数のスレッドから同時に呼び出してもよい。
+   *
+   * {@link requestAsync}はCURLのマルチインタフェースを使い、
+   * 最初の呼び出しで作成される一つのI/Oスレッドで全ての通信を多重化する。
+   * そのため、呼び出し元のスレッドの数によらず多数のリクエストを同時に処理できる。
+   *
+   * {@link EventLoop}を渡して構築した場合はI/Oスレッドを作成せず、
+   * curl_multi_socket_actionでアプリケーションのイベントループから通信を駆動する。
+   * このとき{@link requestAsync}、{@link onSocketEvent}、{@link onTimeout}は
+   * イベントループのスレッドで呼び出さなければならず、コールバックもそのスレッドで呼び出される。
    *
    */
   class HttpClient : public HttpClientBase {
     FRIEND_TEST(HttpClientTest, WriteCallback);
     FRIEND_TEST(HttpClientTest, ReadCallback);
     FRIEND_TEST(HttpClientTest, HeaderCallback);
+    FRIEND_TEST(HttpClientTest, ReserveFromContentLength);
     FRIEND_TEST(HttpClientTest, MakeHttpResponseOk);
     FRIEND_TEST(HttpClientTest, MakeHttpResponseErr);
+    FRIEND_TEST(HttpClientTest, HandlesAreReused);
+
+    /**
+     * @brief プールに保持するハンドルの最大数。
+     * @details
+     * ApiClientのバッチ処理の既定の並行数(16)で接続を使い回せるようにしている。
+     */
+    static constexpr std::size_t MAX_IDLE_HANDLES = 16;
+
+    /**
+     * @brief Content-Lengthから先に確保するボディ部の大きさの上限。
+     * @details
+     * これより大きなボディ部は受信しながら伸ばす。
+     * 誤った、あるいは悪意のあるContent-Lengthで大きな領域を確保しないようにしている。
+     */
+    static constexpr std::size_t MAX_RESERVED_BODY_SIZE = 1 << 20;
+
+    /**
+     * @brief キャンセルされうるリクエストの通信中に、I/Oスレッドが待機する最大の時間(ミリ秒)。
+     * @details
+     * 通信中のリクエストのキャンセルは、最大でこの時間だけ遅れて検出される。
+     * そのようなリクエストがなければ、I/Oスレッドは次の通信か停止まで起きない。
+     */
+    static constexpr int POLL_INTERVAL_MS = 100;
+
+    struct Connections;
+    std::unique_ptr<Connections> connections;
+    struct Transfer;
+    struct Multi;
+    std::unique_ptr<Multi> multi;
+    /** @brief {@link request}の期限(ミリ秒)。0の場合は期限を設けない。*/
+    std::atomic<long> timeoutMs = 0;
 
   public:
+    HttpClient();
+    /**
+     * @brief Construct a new Http Client object driven by loop
+     * @details
+     * loopはこのインスタンスより長く生存しなければならない。
+     *
+     * @param[in] loop 非同期のリクエストを駆動するイベントループ
+     */
+    explicit HttpClient(EventLoop& loop);
     virtual ~HttpClient() noexcept;
 
     /**
@@ -174,10 +309,106 @@ namespace octane::internal {
     virtual Result<HttpResponse, ErrorResponse> request(
       std::string_view origin,
       const HttpRequest& request) override;
+    /**
+     * {@inheritDoc}
+     */
+    virtual void requestAsync(std::string_view origin,
+                              const HttpRequest& request,
+                              CancellationToken token,
+                              RequestCallback callback) override;
+    /**
+     * {@inheritDoc}
+     * @details
+     * イベントループを渡して構築した場合も、呼び出し元のスレッドで通信する。
+     */
+    virtual Result<HttpResponse, ErrorResponse>
+    stream(std::string_view origin,
+           const HttpRequest& request,
+           CancellationToken token,
+           const StreamCallback& onData) override;
+    /**
+     * @brief イベントループが検出したソケットの状態を通知する。
+     * @details
+     * {@link EventLoop}を渡して構築した場合のみ有効で、そうでない場合は何もしない。
+     * 完了したリクエストのコールバックはこの中で呼び出される。
+     *
+     * @param[in] socket 状態が変化したソケット
+     * @param[in] events 読み書きが可能になったかどうか
+     */
+    void onSocketEvent(NativeSocket socket, SocketEvents events);
+    /**
+     * @brief {@link EventLoop::setTimer}で設定したタイマーの満了を通知する。
+     * @details
+     * {@link EventLoop}を渡して構築した場合のみ有効で、そうでない場合は何もしない。
+     */
+    void onTimeout();
+    /**
+     * @brief {@link request}の期限を設定する。
+     * @details
+     * 通信中のリクエストにも適用され、期限はそれぞれのリクエストを開始した時刻から数える。
+     * 期限を過ぎたリクエストはERR_CURL_CONNECTION_FAILEDで失敗する。
+     * トークンを受け取らない{@link request}を、イベントループを駆動せずに打ち切るために使う。
+     *
+     * @param[in] timeout 開始から受信完了までの期限。0の場合は期限を設けない。
+     */
+    void setRequestTimeout(std::chrono::milliseconds timeout) noexcept;
 
   private:
+    /**
+     * @brief requestに従ってtransferのハンドルを設定する。
+     *
+     * @return std::optional<ErrorResponse> 失敗した場合はエラーレスポンス
+     */
+    std::optional<ErrorResponse> prepare(Transfer& transfer,
+                                         std::string_view origin,
+                                         const HttpRequest& request);
+    /**
+     * @brief 通信が終わったtransferからレスポンスを作成する。
+     *
+     */
+    Result<HttpResponse, ErrorResponse> finish(Transfer& transfer, int code);
+    /**
+     * @brief I/Oスレッドで実行される、マルチインタフェースのイベントループ。
+     *
+     */
+    void runLoop();
+    /**
+     * @brief イベントループから駆動した後に、完了やキャンセルされたリクエストを処理する。
+     * @details
+     * 最後にイベントループのタイマーを設定し直す。
+     */
+    void processLoopEvents();
+    /**
+     * @brief curl_multi_timeoutに従ってイベントループのタイマーを設定する。
+     * @details
+     * キャンセルされうるリクエストがある間は、{@link
+     * POLL_INTERVAL_MS}より長い間隔にはしない。
+     */
+    void armLoopTimer();
+    /**
+     * @brief ハンドルをプールに返してからcallbackを呼び出す。
+     * @details
+     * コールバックの中で次のリクエストが発行されることがあるので、
+     * 先にハンドルをプールに返しておく。
+     */
+    static void complete(std::unique_ptr<Transfer> transfer,
+                         Result<HttpResponse, ErrorResponse> result);
+    /**
+     * @brief CURLがソケットの監視を変更するときに呼ばれるコールバック。
+     *
+     * @see { @link https://curl.se/libcurl/c/CURLMOPT_SOCKETFUNCTION.html }
+     */
+    static int socketCallback(void* handle,
+                              NativeSocket socket,
+                              int what,
+                              HttpClient* client,
+                              void* socketp);
+
     /**
      * @brief CURLでレスポンスのボディ部を受け取るためのコールバック。
+     * @details
+     * 最初に受け取ったときに、Content-Lengthの大きさを
+     * {@link MAX_RESERVED_BODY_SIZE}を上限として確保する。
      *
      * @see { @link https://curl.se/libcurl/c/CURLOPT_WRITEFUNCTION.html }
      *
@@ -191,6 +422,22 @@ namespace octane::internal {
                                 size_t size,
                                 size_t nmemb,
                                 HttpResponse* chunk);
+    /**
+     * @brief {@link HttpRequest::bodyObserver}が指定されたときに使うコールバック。
+     * @details
+     * 2xxのレスポンスであれば受け取った部分を格納せずにbodyObserverへ渡し、
+     * それ以外は{@link writeCallback}と同様にボディ部を格納する。
+     *
+     * @param[in] buffer ボディ部の一部が格納されているバッファ。
+     * @param[in] size 常に1。
+     * @param[in] nmemb バッファのサイズ。
+     * @param[in,out] transfer 受け取る通信。
+     * @return size_t 処理したバッファのバイト数。
+     */
+    static size_t observedWriteCallback(char* buffer,
+                                        size_t size,
+                                        size_t nmemb,
+                                        Transfer* transfer);
 
     /**
      * @brief CURLでリクエストのボディ部に書き込むためのコールバック。
@@ -207,7 +454,7 @@ namespace octane::internal {
       char* buffer,
       size_t size,
       size_t nmemb,
-      std::pair<const std::vector<std::uint8_t>*, size_t>* stream);
+      std::pair<std::span<const std::uint8_t>, size_t>* stream);
 
     /**
      * @brief CURLでレスポンスのヘッダ部を受け取るためのコールバック。
@@ -235,6 +482,26 @@ namespace octane::internal {
      */
     Result<HttpResponse, ErrorResponse> makeHttpResponse(
       HttpResponse&& responseHeader);
+    /**
+     * @brief プールからCURLのハンドルを借りる。
+     * @details
+     * プールが空の場合は新しく作成する。
+     * マルチハンドルに加えたハンドルは自身の接続を失うので、
+     * 同期のリクエストと非同期のリクエストとでプールを分ける。
+     *
+     * @param[in] multiplexed マルチハンドルで通信するか
+     * @return void* CURLのハンドル。作成に失敗した場合はnullptr
+     */
+    void* acquire(bool multiplexed = false);
+    /**
+     * @brief 借りたCURLのハンドルをプールに返す。
+     * @details
+     * オプションは初期化されるが、確立済みの接続は保持される。
+     *
+     * @param[in] handle {@link acquire}で借りたハンドル
+     * @param[in] multiplexed {@link acquire}に渡した値
+     */
+    void release(void* handle, bool multiplexed = false) noexcept;
   };
 } // namespace octane::internal
 
@@ -0,0 +1,229 @@
+/**
+ * @file json.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief パーサの実装に依存しないJSONの表現を定義する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_JSON_H_
+#define OCTANE_API_CLIENT_INTERNAL_JSON_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief JSONの値を表すクラス。
+   * @details
+   * パース自体はビルド時に選択されたバックエンド(rapidjsonもしくはsimdjson)が行い、
+   * その結果はこのクラスで表現される。
+   * そのためFetchやApiBridgeは特定のJSONライブラリに依存しない。
+   * オブジェクトのメンバはパースした順序を保持する。
+   *
+   */
+  class Json {
+  public:
+    using Array  = std::vector<Json>;
+    using Object = std::vector<std::pair<std::string, Json>>;
+
+  private:
+    std::variant<std::nullptr_t,
+                 bool,
+                 std::int64_t,
+                 std::uint64_t,
+                 double,
+                 std::string,
+                 Array,
+                 Object>
+      value;
+
+  public:
+    Json() noexcept : value(nullptr) {}
+    Json(std::nullptr_t) noexcept : value(nullptr) {}
+    Json(bool value) noexcept : value(value) {}
+    Json(int value) noexcept : Json(static_cast<std::int64_t>(value)) {}
+    Json(std::int64_t value) noexcept;
+    Json(std::uint64_t value) noexcept : value(value) {}
+    Json(double value) noexcept : value(value) {}
+    Json(const char* value) : value(std::string(value)) {}
+    Json(std::string_view value) : value(std::string(value)) {}
+    Json(std::string&& value) noexcept : value(std::move(value)) {}
+    Json(const std::string& value) : value(value) {}
+    Json(Array&& value) noexcept : value(std::move(value)) {}
+    Json(Object&& value) noexcept : value(std::move(value)) {}
+
+    /**
+     * @brief 空のオブジェクトを作成する。
+     *
+     * @return Json 空のオブジェクト
+     */
+    static Json object() {
+      return Json(Object());
+    }
+    /**
+     * @brief 空の配列を作成する。
+     *
+     * @return Json 空の配列
+     */
+    static Json array() {
+      return Json(Array());
+    }
+
+    bool isNull() const noexcept {
+      return std::holds_alternative<std::nullptr_t>(value);
+    }
+    bool isBool() const noexcept {
+      return std::holds_alternative<bool>(value);
+    }
+    /**
+     * @brief 符号付き整数として表現されているかどうか。
+     * @details
+     * 0以上の整数は常に符号なし整数として表現される。
+     */
+    bool isInt64() const noexcept {
+      return std::holds_alternative<std::int64_t>(value);
+    }
+    /** @brief 符号なし整数として表現されているかどうか。 */
+    bool isUint64() const noexcept {
+      return std::holds_alternative<std::uint64_t>(value);
+    }
+    bool isDouble() const noexcept {
+      return std::holds_alternative<double>(value);
+    }
+    bool isNumber() const noexcept {
+      return isInt64() || isUint64() || isDouble();
+    }
+    bool isString() const noexcept {
+      return std::holds_alternative<std::string>(value);
+    }
+    bool isArray() const noexcept {
+      return std::holds_alternative<Array>(value);
+    }
+    bool isObject() const noexcept {
+      return std::holds_alternative<Object>(value);
+    }
+
+    /**
+     * @brief 真偽値を取得する。値が真偽値でなければならない。
+     */
+    bool getBool() const;
+    /**
+     * @brief 符号付き整数を取得する。値が整数でなければならない。
+     */
+    std::int64_t getInt64() const;
+    /**
+     * @brief 符号なし整数を取得する。値が0以上の整数でなければならない。
+     */
+    std::uint64_t getUint64() const;
+    /**
+     * @brief 浮動小数点数を取得する。値が数値でなければならない。
+     */
+    double getDouble() const;
+    /**
+     * @brief 文字列を取得する。値が文字列でなければならない。
+     */
+    std::string_view getString() const;
+    /**
+     * @brief 配列を取得する。値が配列でなければならない。
+     */
+    const Array& getArray() const;
+    /**
+     * @brief オブジェクトを取得する。値がオブジェクトでなければならない。
+     */
+    const Object& getObject() const;
+
+    /**
+     * @brief オブジェクトのメンバを検索する。
+     *
+     * @param[in] key メンバ名
+     * @return const Json* 見つかった場合はメンバ、見つからない場合やオブジェクトでない場合はnullptr
+     */
+    const Json* find(std::string_view key) const noexcept;
+    /**
+     * @brief オブジェクトがメンバを持つかどうか。
+     *
+     * @param[in] key メンバ名
+     */
+    bool hasMember(std::string_view key) const noexcept {
+      return find(key) != nullptr;
+    }
+    /**
+     * @brief オブジェクトのメンバを取得する。
+     * @details
+     * メンバが存在しなければならない。存在しない場合はnullを返す。
+     *
+     * @param[in] key メンバ名
+     * @return const Json& メンバ
+     */
+    const Json& operator[](std::string_view key) const;
+
+    /**
+     * @brief オブジェクトにメンバを設定する。既に存在する場合は上書きする。
+     *
+     * @param[in] key メンバ名
+     * @param[in] member 値
+     * @return Json& *this
+     */
+    Json& set(std::string_view key, Json member) &;
+    Json&& set(std::string_view key, Json member) && {
+      return std::move(set(key, std::move(member)));
+    }
+    /**
+     * @brief オブジェクトの末尾にメンバを追加する。重複は確認しない。
+     * @details
+     * パーサがオブジェクトを組み立てるときに用いる。
+     *
+     * @param[in] key メンバ名
+     * @param[in] member 値
+     */
+    void append(std::string&& key, Json&& member);
+    /**
+     * @brief 配列の末尾に要素を追加する。
+     *
+     * @param[in] element 要素
+     */
+    void push(Json&& element);
+
+    /**
+     * @brief JSON文字列に変換する。
+     *
+     * @return std::string 空白を含まないJSON文字列
+     */
+    std::string stringify() const;
+
+    friend bool operator==(const Json& a, const Json& b);
+  };
+  std::ostream& operator<<(std::ostream& stream, const Json& json);
+
+  /**
+   * @brief JSON文字列をパースする。
+   * @details
+   * 使用されるパーサはビルド時のOCTANE_API_CLIENT_JSON_BACKENDで決まる。
+   * 失敗した場合は次のエラーレスポンスを返す。
+   * - ERR_JSON_PARSE_FAILED: 正常なJSONでなかったとき
+   *
+   * @param[in] text JSON文字列
+   * @return Result<Json, ErrorResponse>
+   * 成功した場合はパースしたJSON、失敗した場合は上記のエラーレスポンスを返す。
+   */
+  Result<Json, ErrorResponse> parseJson(std::string_view text);
+  /**
+   * @brief ビルド時に選択されたJSONのバックエンドの名前を返す。
+   *
+   * @return const char* "rapidjson"もしくは"simdjson"
+   */
+  const char* jsonBackendName() noexcept;
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_JSON_H_
@@ -0,0 +1,68 @@
+/**
+ * @file mapped_file.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief ファイルを読み取り専用でメモリにマップする。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_MAPPED_FILE_H_
+#define OCTANE_API_CLIENT_INTERNAL_MAPPED_FILE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief 読み取り専用でメモリにマップしたファイル。
+   * @details
+   * ファイルの内容はアクセスしたページだけがOSによって読み込まれるため、
+   * ファイルの大きさに関わらずハッシュ値の計算や送信に必要なメモリは一定である。
+   * マップしている間にファイルが書き換えられた場合の内容は保証しない。
+   *
+   */
+  class MappedFile {
+    const std::uint8_t* data;
+    std::size_t size;
+
+    MappedFile() noexcept;
+
+  public:
+    /**
+     * @brief pathのファイルをマップする。
+     * @details
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_FILE_OPEN_FAILED: ファイルを開けないか、マップできないとき
+     *
+     * @param[in] path マップするファイルのパス
+     * @return Result<MappedFile, ErrorResponse>
+     */
+    static Result<MappedFile, ErrorResponse> open(
+      const std::filesystem::path& path);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() noexcept;
+
+    /**
+     * @brief ファイルの内容を返す。
+     * @details
+     * 戻り値はこのオブジェクトが破棄されるまで有効である。
+     *
+     */
+    std::span<const std::uint8_t> bytes() const noexcept;
+
+  private:
+    void unmap() noexcept;
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_MAPPED_FILE_H_
@@ -1,8 +1,11 @@
 #ifndef OCTANE_API_CLIENT_INTERNAL_MULTI_FILE_H_
 #define OCTANE_API_CLIENT_INTERNAL_MULTI_FILE_H_
 
+#include <filesystem>
+#include <string_view>
 #include <vector>
 
+#include "../api_options.h"
 #include "../api_result_types.h"
 #include "../error_response.h"
 #include "../result.h"
@@ -10,13 +13,49 @@
 namespace octane::internal {
   class MultiFileCompressor {
   public:
+    /**
+     * @brief filesをtar形式にまとめ、optionsのコーデックで圧縮する。
+     * @details
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_COMPRESSION_FAILED: コーデックが使えないか、レベルが範囲外のときなど
+     *
+     * @param[in] files まとめるファイル
+     * @param[in] options 圧縮のコーデックとレベル
+     */
     static Result<std::vector<uint8_t>, ErrorResponse> compress(
-      const std::vector<FileInfo>& files);
+      const std::vector<FileInfo>& files,
+      CompressionOptions options = {});
+    /**
+     * @brief codecで圧縮したアーカイブのMIMEを返す。
+     *
+     */
+    static std::string_view mime(CompressionCodec codec);
   };
+  /**
+   * @brief {@link MultiFileCompressor}が作成したアーカイブを展開する。
+   * @details
+   * 圧縮の有無とコーデックはデータから判別するので、MIMEには依存しない。
+   *
+   */
   class MultiFileDecompressor {
   public:
     static Result<std::vector<FileInfo>, ErrorResponse> decompress(
       const std::vector<uint8_t>& data);
+    /**
+     * @brief archiveのファイルを、メモリに展開せずにdirectoryへ書き出す。
+     * @details
+     * directoryの外を指すパスや、通常のファイルとディレクトリ以外のエントリは拒否する。
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_DECOMPRESSION_FAILED: 展開に失敗したか、安全でないエントリがあるとき
+     * - ERR_FILE_WRITE_FAILED: ファイルを書き出せないとき
+     * 失敗するまでに書き出したファイルは残る。
+     *
+     * @param[in] archivePath 展開するアーカイブのパス
+     * @param[in] directory 書き出し先のディレクトリ。なければ作成する。
+     */
+    static Result<_, ErrorResponse> extract(
+      const std::filesystem::path& archivePath,
+      const std::filesystem::path& directory);
   };
 } // namespace octane::internal
 
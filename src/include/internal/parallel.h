@@ -0,0 +1,59 @@
+/**
+ * @file parallel.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 並行数を制限して処理を行うためのユーティリティ。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_PARALLEL_H_
+#define OCTANE_API_CLIENT_INTERNAL_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace octane::internal {
+  /**
+   * @brief 0からcount-1までの各インデックスについて、最大concurrency並行でfを呼び出す。
+   * @details
+   * 各ワーカーは共有のカウンタから次のインデックスを取り出して処理するため、
+   * 処理時間にばらつきがあってもワーカーが遊ぶことはない。
+   * 呼び出し元のスレッドもワーカーの一つとして働き、全ての処理が終わるまで戻らない。
+   * fは複数のスレッドから同時に呼び出される。
+   *
+   * @tparam F void(std::size_t)として呼び出せる型
+   * @param[in] count 処理する要素数
+   * @param[in] concurrency 最大の並行数。0は1として扱う。
+   * @param[in] f 各インデックスについて呼び出す関数
+   */
+  template <typename F>
+  void parallelFor(std::size_t count, std::size_t concurrency, F&& f) {
+    const auto workers = std::min(count, std::max<std::size_t>(concurrency, 1));
+    if (workers == 0) return;
+
+    std::atomic<std::size_t> next = 0;
+    const auto work                = [&] {
+      for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+           i      = next.fetch_add(1, std::memory_order_relaxed)) {
+        f(i);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t i = 1; i < workers; ++i) {
+      threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_PARALLEL_H_
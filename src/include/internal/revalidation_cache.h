@@ -0,0 +1,113 @@
+/**
+ * @file revalidation_cache.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 304のレスポンスに対して返す、前回のデコード結果を覚えておく。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_REVALIDATION_CACHE_H_
+#define OCTANE_API_CLIENT_INTERNAL_REVALIDATION_CACHE_H_
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace octane::internal {
+  /**
+   * @brief 条件付きGETのURLごとに、前回の2xxのレスポンスをデコードした結果を覚えておく小さなキャッシュ。
+   * @details
+   * 結果はそのレスポンスのETagとLast-Modifiedと一緒に覚え、304のレスポンスの検証子と一致するものだけを返す。
+   * 同じURLへの並行したリクエストによって{@link Fetch}の検証子と結果がずれても、
+   * 古い結果を返さずに受け取り直せる。
+   * 数がcapacityを超えたら、最も前に覚えたURLから捨てる。
+   * スレッドセーフである。
+   *
+   * @tparam T デコードした結果の型
+   */
+  template <typename T>
+  class RevalidationCache {
+    struct Entry {
+      std::string etag;
+      std::string lastModified;
+      T value;
+    };
+
+    std::size_t capacity;
+    mutable std::mutex mutex;
+    std::map<std::string, Entry, std::less<>> entries;
+    std::deque<std::string> order;
+
+  public:
+    explicit RevalidationCache(std::size_t capacity) : capacity(capacity) {}
+
+    /**
+     * @brief 304のレスポンスに対して、urlの前回の結果を返す。
+     * @details
+     * ETagがあればETagで、なければLast-Modifiedで照合する。
+     * どちらもなければ、どの結果に対する304か分からないので返さない。
+     *
+     * @param[in] url リクエストしたURL
+     * @param[in] etag 304のレスポンスのETag。なければnullptr
+     * @param[in] lastModified 304のレスポンスのLast-Modified。なければnullptr
+     * @return std::optional<T> 覚えていないか検証子が異なればnullopt
+     */
+    std::optional<T> find(std::string_view url,
+                          const std::string* etag,
+                          const std::string* lastModified) const {
+      std::lock_guard lock(mutex);
+      const auto it = entries.find(url);
+      if (it == entries.end()) return std::nullopt;
+      if (etag != nullptr) {
+        if (*etag != it->second.etag) return std::nullopt;
+      } else if (lastModified != nullptr) {
+        if (*lastModified != it->second.lastModified) return std::nullopt;
+      } else {
+        return std::nullopt;
+      }
+      return it->second.value;
+    }
+    /**
+     * @brief urlの2xxのレスポンスをデコードした結果を覚える。
+     *
+     * @param[in] url リクエストしたURL
+     * @param[in] etag レスポンスのETag。なければnullptr
+     * @param[in] lastModified レスポンスのLast-Modified。なければnullptr
+     * @param[in] value デコードした結果
+     * @return std::optional<std::string> 上限を超えたために捨てたURL
+     */
+    std::optional<std::string> store(std::string_view url,
+                                     const std::string* etag,
+                                     const std::string* lastModified,
+                                     const T& value) {
+      Entry entry{
+        .etag         = etag != nullptr ? *etag : "",
+        .lastModified = lastModified != nullptr ? *lastModified : "",
+        .value        = value,
+      };
+      std::lock_guard lock(mutex);
+      auto it = entries.find(url);
+      if (it != entries.end()) {
+        it->second = std::move(entry);
+        return std::nullopt;
+      }
+      std::optional<std::string> evicted;
+      if (entries.size() >= capacity && !order.empty()) {
+        evicted.emplace(std::move(order.front()));
+        order.pop_front();
+        entries.erase(evicted.value());
+      }
+      entries.emplace(std::string(url), std::move(entry));
+      order.emplace_back(url);
+      return evicted;
+    }
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_REVALIDATION_CACHE_H_
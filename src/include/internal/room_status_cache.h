@@ -0,0 +1,125 @@
+/**
+ * @file room_status_cache.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief ルームのステータスを一定時間覚えておくメモリ上のキャッシュ。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_ROOM_STATUS_CACHE_H_
+#define OCTANE_API_CLIENT_INTERNAL_ROOM_STATUS_CACHE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "include/api_result_types.h"
+#include "include/cancellation.h"
+#include "include/error_response.h"
+#include "include/executor.h"
+#include "include/internal/single_flight.h"
+#include "include/result.h"
+#include "include/task.h"
+
+namespace octane::internal {
+  /**
+   * @brief ルームのidごとに、取得したステータスをttlの間だけ覚えておくキャッシュ。
+   * @details
+   * ロックはidから決まるシャードごとに持つので、異なるルームを引くスレッド同士は競合しにくい。
+   * 覚えていないidを同時に引いた場合は、{@link SingleFlight}で一度の取得にまとめる。
+   * 取得中に{@link invalidate}された場合、その取得の結果は覚えない。
+   * スレッドセーフである。
+   *
+   */
+  class RoomStatusCache {
+  public:
+    using Fetch      = std::function<Result<RoomStatus, ErrorResponse>()>;
+    using FetchAsync = std::function<Task<Result<RoomStatus, ErrorResponse>>()>;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+      RoomStatus status;
+      Clock::time_point expiresAt;
+    };
+    struct Shard {
+      std::mutex mutex;
+      std::map<std::uint64_t, Entry> entries;
+      /** @brief このシャードのidが無効化された回数。取得中の無効化を検出する。*/
+      std::uint64_t generation = 0;
+    };
+
+    std::chrono::milliseconds ttl;
+    std::size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+    SingleFlight<std::uint64_t, Result<RoomStatus, ErrorResponse>> flights;
+
+  public:
+    /**
+     * @brief Construct a new Room Status Cache object
+     *
+     * @param[in] ttl ステータスを覚えておく時間
+     * @param[in] shardCount ロックを分ける数。0は1として扱う。
+     */
+    RoomStatusCache(std::chrono::milliseconds ttl, std::size_t shardCount);
+
+    /**
+     * @brief idのステータスを返す。覚えていなければfetchで取得して覚える。
+     * @details
+     * 同じidを取得中の呼び出しがあれば、その結果を待って返す。
+     * 失敗した結果は覚えない。
+     *
+     * @param[in] id ルームのid
+     * @param[in] fetch ステータスを取得する関数
+     * @return Result<RoomStatus, ErrorResponse> fetchと同じエラーレスポンスを返す。
+     */
+    Result<RoomStatus, ErrorResponse> get(std::uint64_t id, const Fetch& fetch);
+    /**
+     * @brief {@link get}の非同期版。
+     * @details
+     * 取得中の呼び出しを待つコルーチンはexecutor上で再開される。
+     * fetchはtokenで中断するものでなければならない。
+     * 他の呼び出し元がキャンセルした取得を待っていた場合は、自ら取得し直す。
+     */
+    Task<Result<RoomStatus, ErrorResponse>> getAsync(std::uint64_t id,
+                                                     Executor& executor,
+                                                     CancellationToken token,
+                                                     FetchAsync fetch);
+    /**
+     * @brief idのステータスを忘れる。
+     * @details
+     * ルームの状態を変えるリクエストが完了した後に呼び出す。
+     * 取得中の結果も覚えず、以降の{@link get}は新たに取得する。
+     *
+     */
+    void invalidate(std::uint64_t id);
+
+  private:
+    /**
+     * @brief {@link getAsync}で取得を担うときに、取得して覚える。
+     *
+     */
+    Task<Result<RoomStatus, ErrorResponse>> fetchAndStore(std::uint64_t id,
+                                                          FetchAsync fetch);
+    Shard& shardOf(std::uint64_t id) const;
+    std::optional<RoomStatus> find(std::uint64_t id) const;
+    std::uint64_t generationOf(std::uint64_t id) const;
+    /**
+     * @brief generationの後に無効化されていなければ、statusを覚える。
+     *
+     */
+    void store(std::uint64_t id,
+               const RoomStatus& status,
+               std::uint64_t generation) const;
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_ROOM_STATUS_CACHE_H_
@@ -0,0 +1,154 @@
+/**
+ * @file room_subscriber.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief ルームの変化をイベントストリームで受け取り、使えない間はポーリングで代替する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_ROOM_SUBSCRIBER_H_
+#define OCTANE_API_CLIENT_INTERNAL_ROOM_SUBSCRIBER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "include/api_options.h"
+#include "include/api_result_types.h"
+#include "include/cancellation.h"
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief ポーリングで得たルームの状態。
+   *
+   */
+  struct RoomSnapshot {
+    /** @brief 状態を取得したルームのid。*/
+    std::uint64_t roomId;
+    /** @brief コンテンツの状態とハッシュ値。コンテンツがない場合はnullopt。*/
+    std::optional<std::pair<ContentStatus, std::string>> content;
+    /** @brief ルームに接続しているデバイス。*/
+    std::vector<Device> devices;
+  };
+
+  /**
+   * @brief ルームの変化を購読し、{@link RoomEvent}として通知する。
+   * @details
+   * 専用のスレッドでイベントストリームに接続し、届いたイベントを通知する。
+   * ストリームが使えないか切断された間は{@link SubscribeOptions::pollInterval}ごとに
+   * ルームの状態をポーリングし、前回との差分をイベントとして通知する。
+   * ストリームには{@link SubscribeOptions::reconnectInterval}から倍々に
+   * {@link SubscribeOptions::maxReconnectInterval}まで間隔を伸ばして接続し直す。
+   *
+   * ストリームとポーリングで同じ変化を二度通知しないように、
+   * 最後に知っているコンテンツのハッシュ値とタイムスタンプ、接続しているデバイスを覚えておき、
+   * それと変わらないイベントは通知しない。
+   * 最初の状態は比較の基準として覚えるだけで通知しない。
+   * コールバックはスレッドから呼び出される。
+   * ポーリングのエラーはコールバックに通知するが、ストリームのエラーはポーリングに
+   * 切り替えるだけで通知しない。
+   *
+   */
+  class RoomSubscriber {
+  public:
+    /** @brief ストリームから届いたイベントを受け取る関数。*/
+    using EventSink = std::function<void(RoomEvent)>;
+    /**
+     * @brief イベントストリームに接続し、切断されるまでイベントをsinkに渡す関数。
+     * @details
+     * トークンがキャンセルされたら速やかに戻らなければならない。
+     */
+    using Stream = std::function<Result<_, ErrorResponse>(CancellationToken,
+                                                          const EventSink&)>;
+    /** @brief ルームの状態を取得する関数。*/
+    using Poll = std::function<Result<RoomSnapshot, ErrorResponse>()>;
+    /** @brief 変化やエラーを受け取る関数。*/
+    using Callback = std::function<void(Result<RoomEvent, ErrorResponse>)>;
+
+  private:
+    /**
+     * @brief 最後に知っているルームの状態。
+     * @details
+     * スレッドからのみ触れる。
+     */
+    struct Baseline {
+      std::uint64_t roomId;
+      /** @brief コンテンツのハッシュ値とタイムスタンプ。*/
+      std::optional<std::pair<std::string, std::uint64_t>> content;
+      /** @brief 接続しているデバイスの名前。*/
+      std::set<std::string> devices;
+    };
+
+    Stream stream;
+    Poll poll;
+    Callback callback;
+    SubscribeOptions options;
+    std::optional<Baseline> baseline;
+    CancellationSource cancellation;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread worker;
+
+  public:
+    /**
+     * @brief Construct a new Room Subscriber object
+     * @details
+     * 構築するとすぐに購読を開始する。
+     *
+     * @param[in] stream イベントストリームに接続する関数
+     * @param[in] poll ルームの状態を取得する関数
+     * @param[in] callback 変化やエラーを受け取る関数
+     * @param[in] options ポーリングや再接続の間隔
+     */
+    RoomSubscriber(Stream stream,
+                   Poll poll,
+                   Callback callback,
+                   SubscribeOptions options);
+    RoomSubscriber(const RoomSubscriber&)            = delete;
+    RoomSubscriber& operator=(const RoomSubscriber&) = delete;
+    /**
+     * @brief Destroy the Room Subscriber object
+     * @details
+     * {@link stop}を呼び出す。
+     */
+    ~RoomSubscriber() noexcept;
+
+    /**
+     * @brief 購読を停止し、スレッドの終了を待つ。
+     * @details
+     * 接続中のストリームはキャンセルする。
+     * コールバックの中から呼び出してはならない。
+     */
+    void stop() noexcept;
+
+  private:
+    void run();
+    /**
+     * @brief ルームの状態をポーリングし、基準との差分を通知する。
+     *
+     */
+    void refresh();
+    /**
+     * @brief eventを基準に反映する。
+     *
+     * @return true 基準が変化したとき
+     * @return false 既に知っている変化だったとき
+     */
+    bool apply(const RoomEvent& event);
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_ROOM_SUBSCRIBER_H_
@@ -0,0 +1,124 @@
+/**
+ * @file schema_registry.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief コンパイル済みのJSONスキーマを管理する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_SCHEMA_REGISTRY_H_
+#define OCTANE_API_CLIENT_INTERNAL_SCHEMA_REGISTRY_H_
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+#include "include/api_options.h"
+#include "include/error_response.h"
+#include "include/internal/json.h"
+
+namespace octane::internal {
+  /**
+   * @brief {@link api_schema.h}で定義されているスキーマを識別する列挙体。
+   *
+   */
+  enum struct SchemaId {
+    /** @brief SCHEMA_ERROR_RESPONSEを表す。*/
+    ErrorResponse,
+    /** @brief SCHEMA_HEALTH_GETを表す。*/
+    HealthGet,
+    /** @brief SCHEMA_ROOM_POSTを表す。*/
+    RoomPost,
+    /** @brief SCHEMA_ROOM_ID_GETを表す。*/
+    RoomIdGet,
+    /** @brief SCHEMA_ROOM_ID_DELETEを表す。*/
+    RoomIdDelete,
+    /** @brief SCHEMA_ROOM_ID_POSTを表す。*/
+    RoomIdPost,
+    /** @brief SCHEMA_ROOM_ID_STATUS_GETを表す。*/
+    RoomIdStatusGet,
+    /** @brief SCHEMA_ROOM_ID_STATUS_PUTを表す。*/
+    RoomIdStatusPut,
+    /** @brief SCHEMA_ROOM_ID_STATUS_DELETEを表す。*/
+    RoomIdStatusDelete,
+    /** @brief SCHEMA_ROOM_ID_EVENTS_DEVICEを表す。*/
+    RoomIdEventsDevice,
+  };
+  /** @brief {@link SchemaId}の要素数。*/
+  constexpr std::size_t SCHEMA_COUNT = 10;
+
+  /**
+   * @brief 各スキーマを一度だけコンパイルし、バリデータを使い回すためのレジストリ。
+   * @details
+   * スキーマのパースと{@link rapidjson::SchemaDocument}の構築はプロセス中で一度しか行わない。
+   * {@link rapidjson::SchemaValidator}はスレッドセーフではないため、
+   * スキーマごとにプールを持ち、検証のたびに貸し出して返却する。
+   * 検証する{@link Json}はSAXイベントとしてバリデータに渡すため、
+   * JSONのバックエンドにかかわらずrapidjsonのバリデータを使用できる。
+   *
+   */
+  class SchemaRegistry {
+    struct Entry;
+    std::unique_ptr<Entry[]> entries;
+
+    SchemaRegistry();
+
+  public:
+    ~SchemaRegistry();
+    SchemaRegistry(const SchemaRegistry&)            = delete;
+    SchemaRegistry& operator=(const SchemaRegistry&) = delete;
+
+    /**
+     * @brief プロセスで共有されるインスタンスを取得する。
+     *
+     * @return SchemaRegistry& 共有インスタンス
+     */
+    static SchemaRegistry& instance();
+    /**
+     * @brief JSONをスキーマで検証する。
+     * @details
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_INVALID_RESPONSE: JSONがスキーマに適合しなかったとき
+     *
+     * @param[in] json 検証するJSON
+     * @param[in] id 検証に用いるスキーマ
+     * @return std::optional<ErrorResponse>
+     * 適合した場合は何も返さず、そうでない場合は上記のエラーレスポンスを返す。
+     */
+    std::optional<ErrorResponse> validate(const Json& json, SchemaId id);
+  };
+
+  /**
+   * @brief {@link ValidationMode}に従ってレスポンスを検証するかどうかを決める。
+   * @details
+   * 複数のスレッドから同時に{@link shouldValidate}を呼び出してもよい。
+   *
+   */
+  class SchemaValidationPolicy {
+    std::atomic<ValidationMode> mode;
+    std::atomic<std::uint32_t> sampleInterval;
+    std::atomic<std::uint64_t> counter;
+
+  public:
+    SchemaValidationPolicy();
+    /**
+     * @brief 検証のモードを設定する。
+     *
+     * @param[in] mode 検証のモード
+     * @param[in] sampleInterval
+     * {@link ValidationMode::Sampled}のときに何回に一回検証するか。0は1として扱う。
+     */
+    void set(ValidationMode mode, std::uint32_t sampleInterval);
+    /**
+     * @brief 次のレスポンスを検証すべきかどうかを返す。
+     *
+     * @return true 検証すべきとき
+     * @return false 検証を省略してよいとき
+     */
+    bool shouldValidate() noexcept;
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_SCHEMA_REGISTRY_H_
@@ -0,0 +1,65 @@
+/**
+ * @file shutdown_latch.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 終了処理の完了を待ち合わせる。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_SHUTDOWN_LATCH_H_
+#define OCTANE_API_CLIENT_INTERNAL_SHUTDOWN_LATCH_H_
+
+#include <condition_variable>
+#include <mutex>
+
+namespace octane::internal {
+  /**
+   * @brief 終了処理が完了したことを記録し、デストラクタがその完了を待てるようにする。
+   * @details
+   * 終了処理は開始したことをCancellationSourceで伝えるが、それだけでは完了したかどうか分からない。
+   * 終了処理のコルーチンはメンバに触れるので、デストラクタは完了まで待たなければならない。
+   * 終了処理はコルーチンが完了したときも途中で破棄されたときも{@link Guard}が完了を記録する。
+   *
+   */
+  class ShutdownLatch {
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+
+  public:
+    /**
+     * @brief 破棄されるときに完了を記録する。
+     *
+     */
+    class Guard {
+      ShutdownLatch& latch;
+
+    public:
+      explicit Guard(ShutdownLatch& latch) noexcept : latch(latch) {}
+      Guard(const Guard&)            = delete;
+      Guard& operator=(const Guard&) = delete;
+      ~Guard() noexcept {
+        latch.finish();
+      }
+    };
+
+    void finish() noexcept {
+      // 待っていた側は戻るとすぐにこのインスタンスを破棄するので、ロックを保持したまま通知する。
+      std::lock_guard lock(mutex);
+      finished = true;
+      done.notify_all();
+    }
+    /**
+     * @brief 終了処理が完了するまで待つ。
+     *
+     */
+    void wait() {
+      std::unique_lock lock(mutex);
+      done.wait(lock, [this] { return finished; });
+    }
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_SHUTDOWN_LATCH_H_
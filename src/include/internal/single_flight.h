@@ -0,0 +1,239 @@
+/**
+ * @file single_flight.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 同じキーに対する並行した処理を一つにまとめる。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_SINGLE_FLIGHT_H_
+#define OCTANE_API_CLIENT_INTERNAL_SINGLE_FLIGHT_H_
+
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "include/cancellation.h"
+#include "include/executor.h"
+#include "include/task.h"
+
+namespace octane::internal {
+  /**
+   * @brief 同じキーに対して並行して呼び出された処理を一度だけ実行し、結果を全ての呼び出し元に渡す。
+   * @details
+   * 最初の呼び出し元(リーダ)が処理を実行し、実行中に同じキーで呼び出した側はその完了を待つ。
+   * 待っていた側にはリーダの結果のコピーを返すので、Tはコピーできなければならない。
+   * 完了した処理の結果は覚えないので、次の呼び出しは再び処理を実行する。
+   *
+   * リーダのトークンがキャンセルされていた場合や、リーダが例外を投げたり破棄されたりして
+   * 処理が結果を残さずに終わった場合、自身のトークンがキャンセルされていない待ち手はやり直す。
+   * そのため、他の呼び出し元のキャンセルが待ち手に伝わることはない。
+   *
+   * {@link run}は{@link runAsync}が始めた処理には合流せず、自ら処理を実行する。
+   * イベントループのスレッドで同期的に待つと、その処理を完了させるループを止めてしまうからである。
+   * スレッドセーフである。
+   *
+   * @tparam Key 処理を識別するキー
+   * @tparam T 処理の結果
+   */
+  template <typename Key, typename T>
+  class SingleFlight {
+    struct Flight {
+      /** @brief 処理の結果。結果を残さずに終わった場合はnullopt。*/
+      std::optional<T> value;
+      /** @brief 処理が終わったか。*/
+      bool finished = false;
+      /** @brief 処理が終わったときに、リーダのトークンがキャンセルされていたか。*/
+      bool cancelled = false;
+      /** @brief {@link runAsync}が始めた処理か。*/
+      bool async = false;
+      std::condition_variable done;
+      std::vector<std::function<void()>> waiters;
+    };
+
+    /**
+     * @brief リーダが処理を終えずに抜けても、待ち手を起こして処理を取り除く。
+     *
+     */
+    class Leader {
+      SingleFlight& owner;
+      Key key;
+      std::shared_ptr<Flight> flight;
+
+    public:
+      Leader(SingleFlight& owner, Key key, std::shared_ptr<Flight> flight)
+        : owner(owner),
+          key(std::move(key)),
+          flight(std::move(flight)) {}
+      Leader(const Leader&)            = delete;
+      Leader& operator=(const Leader&) = delete;
+      ~Leader() noexcept {
+        if (flight != nullptr) owner.complete(key, flight, nullptr, false);
+      }
+
+      void finish(const T& value, bool cancelled) {
+        owner.complete(key, std::exchange(flight, nullptr), &value, cancelled);
+      }
+    };
+
+    /**
+     * @brief 実行中の処理が完了するまでコルーチンを中断する。
+     * @details
+     * 完了したらexecutor上で再開する。既に完了していれば中断しない。
+     * 結果を受け取るべきでない場合はnulloptを返す。
+     */
+    struct Join {
+      SingleFlight& owner;
+      std::shared_ptr<Flight> flight;
+      Executor& executor;
+      const CancellationToken& token;
+
+      bool await_ready() const noexcept {
+        return false;
+      }
+      bool await_suspend(std::coroutine_handle<> handle) {
+        std::lock_guard lock(owner.mutex);
+        if (flight->finished) return false;
+        auto& target = executor;
+        flight->waiters.emplace_back(
+          [&target, handle] { target.post([handle] { handle.resume(); }); });
+        return true;
+      }
+      std::optional<T> await_resume() {
+        std::lock_guard lock(owner.mutex);
+        if (flight->cancelled && !token.isCancelled()) return std::nullopt;
+        return flight->value;
+      }
+    };
+
+    std::mutex mutex;
+    std::map<Key, std::shared_ptr<Flight>> flights;
+
+  public:
+    /**
+     * @brief keyの処理が実行中であれば完了を待ってその結果を返し、そうでなければfnを実行する。
+     * @details
+     * 呼び出し元のスレッドをブロックする。
+     *
+     * @param[in] key 処理を識別するキー
+     * @param[in] fn 処理。Tを返す。
+     * @return T 処理の結果
+     */
+    template <typename F>
+    T run(const Key& key, F&& fn) {
+      std::shared_ptr<Flight> flight;
+      {
+        std::unique_lock lock(mutex);
+        for (auto it = flights.find(key); it != flights.end();
+             it      = flights.find(key)) {
+          const auto joined = it->second;
+          if (joined->async) {
+            lock.unlock();
+            return std::forward<F>(fn)();
+          }
+          joined->done.wait(lock, [&] { return joined->finished; });
+          if (joined->value.has_value()) return joined->value.value();
+        }
+        flight = std::make_shared<Flight>();
+        flights.emplace(key, flight);
+      }
+      Leader leader(*this, key, std::move(flight));
+      auto value = std::forward<F>(fn)();
+      leader.finish(value, false);
+      return value;
+    }
+    /**
+     * @brief {@link run}の非同期版。
+     * @details
+     * 待つ側のコルーチンは、処理が完了したらexecutor上で再開される。
+     *
+     * @param[in] key 処理を識別するキー
+     * @param[in] executor 待っていたコルーチンを再開するexecutor
+     * @param[in] token 呼び出し元のトークン。fnもこのトークンで実行すること。
+     * @param[in] fn 処理。Task<T>を返す。
+     * @return Task<T> 処理の結果
+     */
+    template <typename F>
+    Task<T> runAsync(Key key,
+                     Executor& executor,
+                     CancellationToken token,
+                     F fn) {
+      std::shared_ptr<Flight> flight;
+      while (true) {
+        bool joined = false;
+        {
+          std::lock_guard lock(mutex);
+          if (auto it = flights.find(key); it != flights.end()) {
+            flight = it->second;
+            joined = true;
+          } else {
+            flight        = std::make_shared<Flight>();
+            flight->async = true;
+            flights.emplace(key, flight);
+          }
+        }
+        if (!joined) break;
+        // GCCはco_awaitの引数に書いた集成体の一時オブジェクトを早く破棄するので、一度変数に受ける。
+        Join join{ *this, std::move(flight), executor, token };
+        auto value = co_await join;
+        if (value.has_value()) co_return std::move(value.value());
+      }
+      Leader leader(*this, key, std::move(flight));
+      auto value = co_await fn();
+      leader.finish(value, token.isCancelled());
+      co_return std::move(value);
+    }
+    /**
+     * @brief keyの実行中の処理を忘れる。
+     * @details
+     * 既に待っている呼び出し元にはその処理の結果を返すが、
+     * 以降の呼び出しは新たに処理を実行する。
+     * 実行中の処理の結果が古くなったときに使う。
+     *
+     */
+    void forget(const Key& key) {
+      std::lock_guard lock(mutex);
+      flights.erase(key);
+    }
+
+  private:
+    /**
+     * @brief 処理を終え、待ち手を起こす。
+     *
+     * @param[in] value 処理の結果。結果を残さずに終わった場合はnullptr。
+     * @param[in] cancelled リーダのトークンがキャンセルされていたか
+     */
+    void complete(const Key& key,
+                  const std::shared_ptr<Flight>& flight,
+                  const T* value,
+                  bool cancelled) {
+      std::vector<std::function<void()>> waiters;
+      {
+        std::lock_guard lock(mutex);
+        if (value != nullptr) flight->value.emplace(*value);
+        flight->finished  = true;
+        flight->cancelled = cancelled;
+        // forgetされた後に始まった処理を消さないように、自身の場合だけ取り除く。
+        if (auto it = flights.find(key);
+            it != flights.end() && it->second == flight) {
+          flights.erase(it);
+        }
+        waiters.swap(flight->waiters);
+      }
+      flight->done.notify_all();
+      for (auto& waiter : waiters) {
+        waiter();
+      }
+    }
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_SINGLE_FLIGHT_H_
@@ -0,0 +1,96 @@
+/**
+ * @file temporary_file.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief 書き終えてから所定の場所に置く一時ファイルを提供する。
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_INTERNAL_TEMPORARY_FILE_H_
+#define OCTANE_API_CLIENT_INTERNAL_TEMPORARY_FILE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+
+#include "include/error_response.h"
+#include "include/result.h"
+
+namespace octane::internal {
+  /**
+   * @brief 少しずつ書き込み、書き終えてから所定の場所に置く一時ファイル。
+   * @details
+   * commitするまでは、書きかけの内容が置き換え先から見えることはない。
+   * commitせずに破棄された場合は、一時ファイルを削除する。
+   *
+   */
+  class TemporaryFile {
+    std::filesystem::path location;
+    std::ofstream stream;
+    bool failed;
+
+    TemporaryFile(std::filesystem::path location, std::ofstream stream);
+
+  public:
+    /**
+     * @brief directoryに一時ファイルを作成する。
+     * @details
+     * 置き換え先と同じファイルシステムであれば名前の変更だけで置けるので、
+     * directoryには置き換え先のディレクトリを渡すこと。
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_FILE_WRITE_FAILED: ファイルを作成できないとき
+     *
+     * @param[in] directory 一時ファイルを作成するディレクトリ
+     * @return Result<TemporaryFile, ErrorResponse>
+     */
+    static Result<TemporaryFile, ErrorResponse> create(
+      const std::filesystem::path& directory);
+
+    TemporaryFile(TemporaryFile&& other) noexcept;
+    TemporaryFile& operator=(TemporaryFile&& other) noexcept;
+    TemporaryFile(const TemporaryFile&)            = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+    ~TemporaryFile() noexcept;
+
+    /**
+     * @brief 一時ファイルのパスを返す。
+     *
+     */
+    const std::filesystem::path& path() const noexcept;
+    /**
+     * @brief dataを末尾に書き込む。
+     * @details
+     * 失敗した場合はそれ以降の書き込みを無視し、closeかcommitでエラーを返す。
+     *
+     * @param[in] data 書き込むデータ
+     */
+    void write(std::span<const std::uint8_t> data);
+    /**
+     * @brief 書き込みを終えて、ファイルを閉じる。
+     * @details
+     * 一時ファイルは破棄されるまで残る。
+     * 失敗した場合は次のエラーレスポンスを返す。
+     * - ERR_FILE_WRITE_FAILED: 書き込みに失敗していたとき
+     *
+     */
+    Result<_, ErrorResponse> close();
+    /**
+     * @brief 書き込みを終えて、destinationを一時ファイルで置き換える。
+     * @details
+     * 置き換える前に内容をディスクに書き出すので、destinationが中途半端な内容になることはない。
+     * 失敗した場合は次のエラーレスポンスを返し、destinationは変更しない。
+     * - ERR_FILE_WRITE_FAILED: 書き込みか書き出し、名前の変更に失敗したとき
+     *
+     * @param[in] destination 置き換えるファイルのパス
+     */
+    Result<_, ErrorResponse> commit(const std::filesystem::path& destination);
+
+  private:
+    void discard() noexcept;
+  };
+} // namespace octane::internal
+
+#endif // OCTANE_API_CLIENT_INTERNAL_TEMPORARY_FILE_H_
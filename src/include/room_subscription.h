@@ -0,0 +1,58 @@
+/**
+ * @file room_subscription.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Handle of a subscription started by {@link ApiClient::subscribeRoom}.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_ROOM_SUBSCRIPTION_H_
+#define OCTANE_API_CLIENT_ROOM_SUBSCRIPTION_H_
+
+#include <memory>
+
+namespace octane {
+  namespace internal {
+    class RoomSubscriber;
+  } // namespace internal
+
+  /**
+   * @brief Handle of a subscription started by {@link ApiClient::subscribeRoom}.
+   * @details
+   * The subscription runs until stop() is called or the handle is destroyed.
+   * Neither may be done from within the callback of the subscription.
+   *
+   */
+  class [[nodiscard]] RoomSubscription {
+    std::unique_ptr<internal::RoomSubscriber> subscriber;
+
+  public:
+    RoomSubscription() noexcept;
+    explicit RoomSubscription(
+      std::unique_ptr<internal::RoomSubscriber> subscriber);
+    RoomSubscription(RoomSubscription&& other) noexcept;
+    RoomSubscription& operator=(RoomSubscription&& other) noexcept;
+    /**
+     * @brief Destroy the Room Subscription object
+     * @details
+     * Stops the subscription and waits for the callback in progress, if any.
+     */
+    ~RoomSubscription() noexcept;
+
+    /**
+     * @brief Stops the subscription and waits for the callback in progress,
+     * if any.
+     *
+     */
+    void stop() noexcept;
+    /**
+     * @brief Returns true until the subscription is stopped.
+     *
+     */
+    bool isActive() const noexcept;
+  };
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_ROOM_SUBSCRIPTION_H_
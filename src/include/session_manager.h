@@ -0,0 +1,301 @@
+/**
+ * @file session_manager.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Holds connections to many rooms over one transport.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_SESSION_MANAGER_H_
+#define OCTANE_API_CLIENT_SESSION_MANAGER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./api_options.h"
+#include "./api_result_types.h"
+#include "./cancellation.h"
+#include "./config.h"
+#include "./error_response.h"
+#include "./executor.h"
+#include "./internal/api_bridge.h"
+#include "./internal/async.h"
+#include "./internal/fetch.h"
+#include "./internal/health_monitor.h"
+#include "./internal/http_client.h"
+#include "./internal/shutdown_latch.h"
+#include "./result.h"
+#include "./task.h"
+
+namespace octane {
+  /**
+   * @brief Connections to many rooms of one OctaneServer at the same time.
+   * @details
+   * Where an {@link ApiClient} is connected to a single room, a session
+   * manager is connected to any number of rooms, each addressed by its id.
+   * Every room shares the same pool of connections, health monitor and
+   * executor, so serving many rooms costs no more threads or sockets than
+   * serving one.
+   *
+   * The rooms are spread over several shards, each guarded by its own lock,
+   * which is held only while the session of a room is looked up or
+   * updated. Operations on different rooms therefore never wait for each
+   * other, and every method except init() and the destructor may be called
+   * from multiple threads at once.
+   *
+   * Operations on a room which is not connected fail with
+   * ERR_ROOM_DISCONNECTED, except getRoomStatus(), which may read any room.
+   *
+   */
+  class SessionManager {
+    /**
+     * @brief Transport owned by the manager.
+     * @details
+     * Null if the manager is constructed with a given transport.
+     *
+     */
+    std::unique_ptr<internal::HttpClient> transport;
+    std::unique_ptr<internal::Fetch> fetch;
+    internal::ApiBridge bridge;
+    std::shared_ptr<internal::HealthMonitor> healthMonitor;
+    /**
+     * @brief Executor which resumes the asynchronous methods.
+     *
+     */
+    std::atomic<Executor*> executor;
+    struct Session {
+      /**
+       * @brief An unique name for the device which is connected to the room.
+       *
+       */
+      std::string name;
+    };
+    struct Shard {
+      mutable std::mutex mutex;
+      std::map<std::uint64_t, Session> sessions;
+    };
+    std::size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+    /**
+     * @brief Cancelled by shutdownAsync().
+     * @details
+     * Every asynchronous operation observes it in addition to the token
+     * passed by the caller.
+     *
+     */
+    CancellationSource shutdownSource;
+    /**
+     * @brief Deadline passed to shutdownAsync().
+     * @details
+     * Stored before shutdownSource is cancelled. A connection completed
+     * after the shutdown started is undone within this deadline.
+     *
+     */
+    std::atomic<std::chrono::steady_clock::time_point> shutdownDeadline;
+    /**
+     * @brief Released once shutdownAsync() has finished.
+     * @details
+     * shutdownSource only tells that the shutdown has started. The
+     * destructor waits for this instead, since the shutdown still touches
+     * the members until it finishes.
+     *
+     */
+    internal::ShutdownLatch shutdownLatch;
+
+  public:
+    /**
+     * @brief Construct a new Session Manager object
+     *
+     * @param[in] token
+     * @param[in] origin http://localhost:3000
+     * @param[in] baseUrl /api/v1
+     * @param[in] options Number of shards
+     */
+    SessionManager(std::string_view token        = DEFAULT_API_TOKEN,
+                   std::string_view origin       = DEFAULT_API_ORIGIN,
+                   std::string_view baseUrl      = DEFAULT_API_BASE_URL,
+                   SessionManagerOptions options = {});
+    /**
+     * @brief Construct a new Session Manager object with the given transport
+     * @details
+     * The manager does not take ownership of the transport, which must
+     * outlive the manager and accept concurrent requests.
+     *
+     * @param[in] token
+     * @param[in] origin http://localhost:3000
+     * @param[in] baseUrl /api/v1
+     * @param[in] client Transport used for every request
+     * @param[in] options Number of shards
+     */
+    SessionManager(std::string_view token,
+                   std::string_view origin,
+                   std::string_view baseUrl,
+                   internal::HttpClientBase* client,
+                   SessionManagerOptions options = {});
+    SessionManager(const SessionManager&)            = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+    /**
+     * @brief Destroy the Session Manager object
+     * @details
+     * If shutdownAsync() has been started, the destructor waits for it to
+     * finish, which its deadline bounds as long as its executor runs.
+     * Otherwise the rooms still connected are disconnected as by
+     * shutdownAsync(), waiting at most {@link DEFAULT_SHUTDOWN_TIMEOUT}.
+     *
+     */
+    ~SessionManager() noexcept;
+
+    /**
+     * @brief Run this method at first.
+     * @details
+     * Same as {@link ApiClient::init}.
+     *
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> init();
+
+    /**
+     * @brief Connect to the room with the device name.
+     * @details
+     * Connecting to a room which is already connected replaces its device
+     * name once the server accepts it. If shutdownAsync() starts before the
+     * session is recorded, the room is disconnected again and ERR_CANCELLED
+     * is returned.
+     *
+     * @param[in] id Room id
+     * @param[in] name An unique name for the device
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> connect(std::uint64_t id,
+                                            std::string_view name);
+    /**
+     * @brief Disconnect from the room.
+     * @details
+     * If the room is not connected, ERR_ROOM_DISCONNECTED is returned.
+     *
+     * @param[in] id Room id
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> disconnect(std::uint64_t id);
+    /**
+     * @brief Whether the room is connected.
+     *
+     */
+    bool isConnected(std::uint64_t id) const;
+    /**
+     * @brief Ids of the connected rooms in ascending order.
+     *
+     */
+    std::vector<std::uint64_t> rooms() const;
+
+    /**
+     * @brief Get the status of the room.
+     * @details
+     * The room does not have to be connected.
+     *
+     * @param[in] id Room id
+     * @return Result<RoomStatus, ErrorResponse>
+     */
+    Result<RoomStatus, ErrorResponse> getRoomStatus(std::uint64_t id);
+    /**
+     * @brief Get the content of the connected room.
+     *
+     * @param[in] id Room id
+     * @return Result<Content, ErrorResponse>
+     */
+    Result<Content, ErrorResponse> getContent(std::uint64_t id);
+    /**
+     * @brief Upload the content to the connected room.
+     *
+     * @param[in] id Room id
+     * @param[in] content Content to upload
+     * @param[in] compression How a multiple file content is compressed
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> uploadContent(
+      std::uint64_t id,
+      const Content& content,
+      CompressionOptions compression = {});
+    /**
+     * @brief Delete the content of the connected room.
+     *
+     * @param[in] id Room id
+     * @return Result<Response, ErrorResponse>
+     */
+    Result<Response, ErrorResponse> deleteContent(std::uint64_t id);
+
+    /**
+     * @brief Asynchronous version of {@link getRoomStatus}.
+     *
+     */
+    Task<Result<RoomStatus, ErrorResponse>> getRoomStatusAsync(
+      std::uint64_t id,
+      CancellationToken token = {});
+    /**
+     * @brief Asynchronous version of {@link getContent}.
+     *
+     */
+    Task<Result<Content, ErrorResponse>> getContentAsync(
+      std::uint64_t id,
+      CancellationToken token = {});
+
+    /**
+     * @brief Select the executor which resumes the asynchronous methods.
+     * @details
+     * The executor must outlive every task started after this call.
+     *
+     */
+    void setExecutor(Executor& executor);
+    /**
+     * @brief Shuts the manager down before it is destroyed.
+     * @details
+     * Cancels every asynchronous operation in flight, which completes with
+     * ERR_CANCELLED, as does every asynchronous operation started
+     * afterwards. Then every connected room is disconnected concurrently,
+     * without checking the health of the server first. The requests still
+     * in flight are aborted with ERR_CANCELLED once deadline has passed.
+     * The rooms are forgotten even if their requests fail.
+     *
+     * Synchronous requests already in flight cannot be cancelled and run to
+     * completion.
+     *
+     * @param[in] deadline Time after which the disconnections are given up
+     * @return Task<Result<_, ErrorResponse>>
+     * On failure, it will return the first error response of the
+     * disconnections in the order of the room ids.
+     */
+    Task<Result<_, ErrorResponse>> shutdownAsync(
+      std::chrono::steady_clock::time_point deadline);
+
+  private:
+    Result<HealthResult, ErrorResponse> checkHealth();
+    Task<Result<HealthResult, ErrorResponse>> checkHealthAsync(
+      internal::AsyncContext context);
+    /**
+     * @brief Body of {@link shutdownAsync}, which resumes on executor.
+     *
+     */
+    Task<Result<_, ErrorResponse>> shutdownOn(
+      Executor& executor,
+      std::chrono::steady_clock::time_point deadline);
+    internal::AsyncContext makeContext(CancellationToken token) const;
+    Shard& shardOf(std::uint64_t id) const;
+    /**
+     * @brief Device name of the room, or nullopt if it is not connected.
+     *
+     */
+    std::optional<std::string> findSession(std::uint64_t id) const;
+  };
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_SESSION_MANAGER_H_
@@ -0,0 +1,314 @@
+/**
+ * @file task.h
+ * @author cosocaf (cosocaf@gmail.com)
+ * @brief Coroutine type returned by the asynchronous methods of {@link
+ * ApiClient}.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef OCTANE_API_CLIENT_TASK_H_
+#define OCTANE_API_CLIENT_TASK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./executor.h"
+
+namespace octane {
+  /**
+   * @brief Lazily started coroutine which produces a value of type T.
+   * @details
+   * A task does not run until it is awaited. Awaiting it starts the task on
+   * the awaiting thread; once the task suspends on a request, it is resumed
+   * through the {@link Executor} of the client and the awaiting coroutine
+   * continues on that executor. To run a task outside of a coroutine, use
+   * {@link syncWait} or {@link spawn}.
+   *
+   * Since this library does not use exceptions, an exception escaping a task
+   * terminates the program.
+   *
+   * @tparam T Type of the value. It must be move constructible.
+   */
+  template <typename T>
+  class [[nodiscard]] Task {
+    static_assert(!std::is_void_v<T>, "Task<void> is not supported");
+
+  public:
+    struct promise_type {
+      std::optional<T> value;
+      std::coroutine_handle<> continuation;
+
+      Task get_return_object() noexcept {
+        return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+      std::suspend_always initial_suspend() noexcept {
+        return {};
+      }
+      auto final_suspend() noexcept {
+        struct FinalAwaiter {
+          bool await_ready() noexcept {
+            return false;
+          }
+          std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<promise_type> handle) noexcept {
+            if (auto continuation = handle.promise().continuation) {
+              return continuation;
+            }
+            return std::noop_coroutine();
+          }
+          void await_resume() noexcept {}
+        };
+        return FinalAwaiter{};
+      }
+      template <typename U>
+      void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+      }
+      void unhandled_exception() noexcept {
+        std::terminate();
+      }
+    };
+
+  private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle(handle) {}
+
+  public:
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+      if (this != &other) {
+        if (handle) handle.destroy();
+        handle = std::exchange(other.handle, {});
+      }
+      return *this;
+    }
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() noexcept {
+      if (handle) handle.destroy();
+    }
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+    std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<> awaiting) noexcept {
+      handle.promise().continuation = awaiting;
+      return handle;
+    }
+    T await_resume() {
+      return std::move(handle.promise().value.value());
+    }
+  };
+
+  namespace internal {
+    /**
+     * @brief 開始するとそのまま実行され、終了すると自身を破棄するコルーチン。
+     *
+     */
+    struct Detached {
+      struct promise_type {
+        Detached get_return_object() noexcept {
+          return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+          return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+          return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+          std::terminate();
+        }
+      };
+    };
+    /**
+     * @brief taskを開始し、終了したら結果をcallbackに渡す。
+     *
+     */
+    template <typename T, typename F>
+    Detached awaitThen(Task<T> task, F callback) {
+      callback(co_await std::move(task));
+    }
+    /**
+     * @brief 呼び出したコルーチンをexecutor上で再開する。
+     * @details
+     * ブロックする処理をexecutorのスレッドに移すために使う。
+     */
+    struct ScheduleOn {
+      Executor& executor;
+
+      bool await_ready() const noexcept {
+        return false;
+      }
+      void await_suspend(std::coroutine_handle<> handle) {
+        executor.post([handle] { handle.resume(); });
+      }
+      void await_resume() const noexcept {}
+    };
+  } // namespace internal
+
+  /**
+   * @brief Starts task and calls callback with its value when it completes.
+   * @details
+   * The callback is called on the thread which completes the task, which is
+   * usually a thread of the client's executor.
+   *
+   * @param[in] task Task to start
+   * @param[in] callback Function called with the value of the task
+   */
+  template <typename T, typename F>
+  void spawn(Task<T> task, F&& callback) {
+    internal::awaitThen(std::move(task), std::forward<F>(callback));
+  }
+
+  /**
+   * @brief Starts task and blocks the calling thread until it completes.
+   * @details
+   * Do not call this function on a thread of the executor which resumes the
+   * task, since it may wait for itself.
+   *
+   * @param[in] task Task to run
+   * @return T Value of the task
+   */
+  template <typename T>
+  T syncWait(Task<T> task) {
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::optional<T> result;
+    spawn(std::move(task), [&](T&& value) {
+      // 待っている側が先に戻って変数を破棄しないように、ロックを取ったまま通知する。
+      std::lock_guard lock(mutex);
+      result.emplace(std::move(value));
+      finished.notify_one();
+    });
+    std::unique_lock lock(mutex);
+    finished.wait(lock, [&] { return result.has_value(); });
+    return std::move(result.value());
+  }
+
+  /**
+   * @brief Runs two tasks concurrently and returns both values.
+   * @details
+   * Both tasks are started before either is awaited, so their requests are
+   * in flight at the same time.
+   *
+   */
+  template <typename A, typename B>
+  Task<std::pair<A, B>> whenAll(Task<A> a, Task<B> b) {
+    struct State {
+      std::optional<A> a;
+      std::optional<B> b;
+      std::atomic<int> remaining = 2;
+      std::coroutine_handle<> continuation;
+
+      void done() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          continuation.resume();
+        }
+      }
+    };
+    struct Awaiter {
+      State& state;
+      Task<A>& a;
+      Task<B>& b;
+
+      bool await_ready() const noexcept {
+        return false;
+      }
+      void await_suspend(std::coroutine_handle<> handle) {
+        state.continuation = handle;
+        // 二つ目を開始した後はこのコルーチンが再開・破棄されている可能性があるので、
+        // メンバに触れてはならない。
+        auto& s = state;
+        internal::awaitThen(std::move(a), [&s](A&& value) {
+          s.a.emplace(std::move(value));
+          s.done();
+        });
+        internal::awaitThen(std::move(b), [&s](B&& value) {
+          s.b.emplace(std::move(value));
+          s.done();
+        });
+      }
+      void await_resume() const noexcept {}
+    };
+
+    State state;
+    co_await Awaiter{ state, a, b };
+    co_return std::pair<A, B>(std::move(state.a.value()),
+                              std::move(state.b.value()));
+  }
+  /**
+   * @brief Runs every task concurrently and returns their values in the same
+   * order.
+   * @details
+   * Every task is started before any is awaited.
+   *
+   */
+  template <typename T>
+  Task<std::vector<T>> whenAll(std::vector<Task<T>> tasks) {
+    struct State {
+      std::vector<std::optional<T>> values;
+      std::atomic<std::size_t> remaining;
+      std::coroutine_handle<> continuation;
+
+      void done() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          continuation.resume();
+        }
+      }
+    };
+    struct Awaiter {
+      State& state;
+      std::vector<Task<T>>& tasks;
+
+      bool await_ready() const noexcept {
+        return state.values.empty();
+      }
+      void await_suspend(std::coroutine_handle<> handle) {
+        state.continuation = handle;
+        // 最後のタスクを開始した後はこのコルーチンが再開・破棄されている可能性があるので、
+        // 開始するタスクは先にこのフレームから取り出しておく。
+        auto& s      = state;
+        auto started = std::move(tasks);
+        for (std::size_t i = 0; i < started.size(); ++i) {
+          internal::awaitThen(std::move(started[i]), [&s, i](T&& value) {
+            s.values[i].emplace(std::move(value));
+            s.done();
+          });
+        }
+      }
+      void await_resume() const noexcept {}
+    };
+
+    State state{
+      .values       = std::vector<std::optional<T>>(tasks.size()),
+      .remaining    = tasks.size(),
+      .continuation = nullptr,
+    };
+    // GCCはco_awaitの引数に書いた集成体の一時オブジェクトを早く破棄するので、一度変数に受ける。
+    Awaiter awaiter{ state, tasks };
+    co_await awaiter;
+    std::vector<T> values;
+    values.reserve(state.values.size());
+    for (auto& value : state.values) {
+      values.push_back(std::move(value.value()));
+    }
+    co_return std::move(values);
+  }
+} // namespace octane
+
+#endif // OCTANE_API_CLIENT_TASK_H_
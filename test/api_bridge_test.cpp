@@ -1,10 +1,12 @@
 #include "include/internal/api_bridge.h"
 
 #include <gtest/gtest.h>
-#include <rapidjson/error/en.h>
 
 #include <string_view>
+#include <thread>
+#include <vector>
 
+#include "./mock/fake_http_client.h"
 #include "./mock/mock_fetch.h"
 #include "include/error_code.h"
 
@@ -45,15 +47,13 @@ namespace octane::internal {
         .statusLine = std::string(statusLine),
       };
     }
-    rapidjson::Document makeJson(std::string_view data) {
-      rapidjson::Document doc;
-      doc.Parse(data.data(), data.size());
-      if (doc.HasParseError()) {
-        const auto message = rapidjson::GetParseError_En(doc.GetParseError());
-        std::cout << message << std::endl;
+    Json makeJson(std::string_view data) {
+      auto json = parseJson(data);
+      if (!json) {
+        std::cout << json.err() << std::endl;
         std::abort();
       }
-      return doc;
+      return std::move(json.get());
     }
     FetchResponse makeJsonResponse(std::string_view data,
                                    int statusCode = 200,
@@ -173,6 +173,29 @@ namespace octane::internal {
                 .message = "server faulty gomennasai",
               }));
   }
+  /**
+   * @brief
+   * 検証を省略しているときに、healthGetが知らないhealthをERR_INVALID_RESPONSEとして返すかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, healthGetUnknownHealth) {
+    test::MockFetch mockFetch;
+    EXPECT_CALL(mockFetch,
+                request(HttpMethod::Get, std::string_view("/health")))
+      .Times(1)
+      .WillOnce(testing::Return(ok(makeJsonResponse(
+        R"(
+          {
+            "health": "sleepy",
+            "message": ""
+          }
+        )"))));
+    ApiBridge apiBridge(&mockFetch);
+    apiBridge.setValidationMode(ValidationMode::Off, 1);
+    auto result = apiBridge.healthGet();
+    EXPECT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_INVALID_RESPONSE) << result.err();
+  }
   /**
    * @brief
    * healthGetにおいてFetchがjsonのパースで失敗した時にApiBridgeがエラーを返してくれるかどうかをテストする。
@@ -1253,4 +1276,220 @@ namespace octane::internal {
     EXPECT_FALSE(result);
     EXPECT_EQ(result.err().code, "ERR_BAD_REQUEST") << result.err();
   }
-} // namespace octane::internal
+  /**
+   * @brief
+   * roomIdEventsGetがストリームの断片からイベントを組み立て、知らないイベントを無視して変換するかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, roomIdEventsGetOk) {
+    test::MockFetch mockFetch;
+    EXPECT_CALL(mockFetch,
+                stream(std::string_view("/room/3/events"), testing::_, testing::_))
+      .Times(1)
+      .WillOnce([](std::string_view,
+                   CancellationToken,
+                   const HttpClientBase::StreamCallback& onData) {
+        onData(": ping\n\nevent: device\ndata: {\"type\": \"left\", ");
+        onData("\"name\": \"soon's macbook\", \"timestamp\": 20}\n\n");
+        onData("event: hello\ndata: {}\n\n");
+        onData(
+          "event: content\r\n"
+          "data: {\"device\": \"collodi\", \"timestamp\": 30, \"type\": \"file\",\r\n"
+          "data: \"name\": \"a.png\", \"mime\": \"image/png\", \"hash\": \"abcd\"}\r\n\r\n");
+        return ok(
+          makeBinaryResponse("", 200, "HTTP/2 200 OK", "text/event-stream"));
+      });
+    ApiBridge apiBridge(&mockFetch);
+    std::vector<RoomEvent> events;
+    auto result = apiBridge.roomIdEventsGet(
+      3, {}, [&](RoomEvent event) { events.push_back(std::move(event)); });
+    EXPECT_TRUE(result) << result.err();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, RoomEventType::DeviceLeft);
+    EXPECT_EQ(events[0].roomId, 3u);
+    EXPECT_EQ(events[0].device->name, "soon's macbook");
+    EXPECT_EQ(events[0].device->timestamp, 20u);
+    EXPECT_EQ(events[1].type, RoomEventType::ContentChanged);
+    EXPECT_EQ(events[1].hash, "abcd");
+    EXPECT_EQ(events[1].contentStatus->type, ContentType::File);
+    EXPECT_EQ(events[1].contentStatus->name, "a.png");
+    EXPECT_EQ(events[1].contentStatus->timestamp, 30u);
+  }
+  /**
+   * @brief
+   * サーバがイベントストリームを提供しないときに、roomIdEventsGetがERR_EVENT_STREAM_UNAVAILABLEを返すかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, roomIdEventsGetUnavailable) {
+    test::MockFetch mockFetch;
+    EXPECT_CALL(mockFetch,
+                stream(std::string_view("/room/3/events"), testing::_, testing::_))
+      .Times(2)
+      .WillOnce(testing::Return(ok(makeJsonResponse(
+        R"({"code": "ERR_NOT_FOUND", "reason": ""})", 404, "HTTP/2 404"))))
+      .WillOnce(testing::Return(ok(makeJsonResponse(R"({})"))));
+    ApiBridge apiBridge(&mockFetch);
+    auto result = apiBridge.roomIdEventsGet(3, {}, [](RoomEvent) {});
+    EXPECT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_EVENT_STREAM_UNAVAILABLE);
+    // 2xxでもイベントストリームでなければ使えない。
+    auto json = apiBridge.roomIdEventsGet(3, {}, [](RoomEvent) {});
+    EXPECT_FALSE(json);
+    EXPECT_EQ(json.err().code, ERR_EVENT_STREAM_UNAVAILABLE);
+  }
+  /**
+   * @brief
+   * 検証を省略しているときに、roomIdEventsGetが知らないデバイスのイベントでエラーを返すかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, roomIdEventsGetUnknownDeviceEvent) {
+    test::MockFetch mockFetch;
+    EXPECT_CALL(mockFetch,
+                stream(std::string_view("/room/3/events"), testing::_, testing::_))
+      .Times(1)
+      .WillOnce([](std::string_view,
+                   CancellationToken,
+                   const HttpClientBase::StreamCallback& onData) {
+        const bool more = onData(
+          "event: device\ndata: {\"type\": \"renamed\", "
+          "\"name\": \"collodi\", \"timestamp\": 20}\n\n");
+        EXPECT_FALSE(more);
+        return ok(
+          makeBinaryResponse("", 200, "HTTP/2 200 OK", "text/event-stream"));
+      });
+    ApiBridge apiBridge(&mockFetch);
+    apiBridge.setValidationMode(ValidationMode::Off, 1);
+    std::vector<RoomEvent> events;
+    auto result = apiBridge.roomIdEventsGet(
+      3, {}, [&](RoomEvent event) { events.push_back(std::move(event)); });
+    EXPECT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_INVALID_RESPONSE) << result.err();
+    EXPECT_TRUE(events.empty());
+  }
+  /**
+   * @brief
+   * 変更がなくサーバが304を返したときに、roomIdStatusGetが前回の結果を返すかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, roomIdStatusGetRevalidates) {
+    test::FakeHttpClient transport("/api/v1");
+    Fetch fetch("fake", "http://localhost:3000", "/api/v1", &transport);
+    ApiBridge apiBridge(&fetch);
+    ASSERT_TRUE(apiBridge.init());
+    transport.timestamp = 10;
+
+    auto first = apiBridge.roomIdStatusGet(1);
+    ASSERT_TRUE(first);
+    auto second = apiBridge.roomIdStatusGet(1);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(transport.notModified, 1u);
+    EXPECT_EQ(second.get().first.timestamp, 10u);
+    EXPECT_EQ(second.get().second, first.get().second);
+
+    // 変更されれば304にはならず、新しい状態を受け取る。
+    transport.timestamp = 20;
+    auto changed = apiBridge.roomIdStatusGet(1);
+    ASSERT_TRUE(changed);
+    EXPECT_EQ(changed.get().first.timestamp, 20u);
+    EXPECT_EQ(transport.notModified, 1u);
+
+    auto room = apiBridge.roomIdGet(1);
+    ASSERT_TRUE(room);
+    auto roomAsync = syncWait(apiBridge.roomIdGetAsync(
+      AsyncContext{ .executor = &inlineExecutor(), .token = {} }, 1));
+    ASSERT_TRUE(roomAsync);
+    EXPECT_EQ(roomAsync.get().name, "room 1");
+    EXPECT_EQ(transport.notModified, 2u);
+  }
+  /**
+   * @brief
+   * 検証子だけが残り前回の結果を覚えていないときに、roomIdGetが全体を受け取り直すかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, roomIdGetRefetchesWithoutCachedResult) {
+    test::FakeHttpClient transport("/api/v1");
+    Fetch fetch("fake", "http://localhost:3000", "/api/v1", &transport);
+    ApiBridge warm(&fetch);
+    ApiBridge cold(&fetch);
+    ASSERT_TRUE(warm.init());
+
+    ASSERT_TRUE(warm.roomIdGet(2));
+    // Fetchは検証子を覚えているが、coldは結果を覚えていない。
+    auto result = cold.roomIdGet(2);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result.get().id, 2u);
+    EXPECT_EQ(result.get().name, "room 2");
+    EXPECT_EQ(transport.notModified, 1u);
+    EXPECT_EQ(transport.requests, 3u);
+  }
+  /**
+   * @brief
+   * 同じパスへのGETを同時に発行したときに、一つのリクエストにまとめられるかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, concurrentGetsShareOneRequest) {
+    using namespace std::chrono_literals;
+    test::FakeHttpClient transport("/api/v1", 200ms);
+    Fetch fetch("fake", "http://localhost:3000", "/api/v1", &transport);
+    ApiBridge apiBridge(&fetch);
+    ASSERT_TRUE(apiBridge.init());
+    transport.timestamp = 10;
+
+    std::atomic<int> succeeded = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([&, i] {
+        auto result = apiBridge.roomIdStatusGet(i % 2 + 1);
+        if (result && result.get().first.timestamp == 10) ++succeeded;
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(succeeded.load(), 8);
+    // ルームごとに一つずつになる。
+    EXPECT_EQ(transport.statusRequests.load(), 2u);
+
+    // 完了したGETの結果は覚えないので、次のGETは改めて送られる。
+    ASSERT_TRUE(apiBridge.roomIdStatusGet(1));
+    EXPECT_EQ(transport.statusRequests.load(), 3u);
+  }
+  /**
+   * @brief
+   * 覚えきれずに捨てた結果の検証子も捨て、304を受けてから取り直す往復が生じないかどうかをテストする。
+   *
+   */
+  TEST(ApiBridgeTest, evictedResultForgetsValidators) {
+    test::FakeHttpClient transport("/api/v1");
+    Fetch fetch("fake", "http://localhost:3000", "/api/v1", &transport);
+    ApiBridge apiBridge(&fetch);
+    ASSERT_TRUE(apiBridge.init());
+
+    // 覚えておける数(64)より多くのルームを引き、最初のルームの結果を追い出す。
+    for (std::uint64_t id = 1; id <= 65; ++id) {
+      ASSERT_TRUE(apiBridge.roomIdStatusGet(id));
+    }
+    ASSERT_TRUE(apiBridge.roomIdStatusGet(1));
+    EXPECT_EQ(transport.notModified, 0u);
+    EXPECT_EQ(transport.statusRequests.load(), 66u);
+  }
+  /**
+   * @brief RevalidationCacheが、ETagのない304をLast-Modifiedで照合するかどうかをテストする。
+   *
+   */
+  TEST(RevalidationCacheTest, MatchesLastModified) {
+    RevalidationCache<int> cache(1);
+    const std::string etag  = "\"v1\"";
+    const std::string older = "Mon, 01 Jan 2024 00:00:00 GMT";
+    const std::string newer = "Tue, 02 Jan 2024 00:00:00 GMT";
+    EXPECT_FALSE(cache.store("/a", nullptr, &newer, 1).has_value());
+    EXPECT_EQ(cache.find("/a", nullptr, &newer), 1);
+    EXPECT_EQ(cache.find("/a", nullptr, &older), std::nullopt);
+    // 検証子のない304は、どの結果に対するものか分からない。
+    EXPECT_EQ(cache.find("/a", nullptr, nullptr), std::nullopt);
+
+    EXPECT_EQ(cache.store("/b", &etag, &older, 2), "/a");
+    EXPECT_EQ(cache.find("/b", &etag, nullptr), 2);
+    EXPECT_EQ(cache.find("/a", nullptr, &newer), std::nullopt);
+  }
+} // namespace octane::internal
\ No newline at end of file
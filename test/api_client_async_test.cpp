@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/api_client.h"
+#include "include/error_code.h"
+#include "./mock/fake_http_client.h"
+
+using namespace std::chrono_literals;
+
+namespace octane {
+  namespace {
+    constexpr auto BASE_URL = "/api/v1";
+
+    std::string deviceName(std::uint64_t id) {
+      return "device-" + std::to_string(id);
+    }
+  } // namespace
+
+  /**
+   * @brief 非同期版のメソッドで接続からコンテンツの取得までが行えるかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, RoundTrip) {
+    test::FakeHttpClient transport(BASE_URL);
+    ThreadPoolExecutor executor(2);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    client.setExecutor(executor);
+    ASSERT_TRUE(client.init());
+
+    const auto task = [&]() -> Task<Result<Content, ErrorResponse>> {
+      auto connected = co_await client.connectRoomAsync(1, deviceName(1));
+      if (!connected) co_return error(connected.err());
+      auto status = co_await client.getRoomStatusAsync();
+      if (!status) co_return error(status.err());
+      co_return co_await client.getContentAsync();
+    };
+    auto content = syncWait(task());
+    ASSERT_TRUE(content) << content.err().reason;
+    EXPECT_EQ(std::get<std::string>(content.get().data),
+              test::FakeHttpClient::CONTENT);
+    EXPECT_TRUE(syncWait(client.disconnectRoomAsync(1, deviceName(1))));
+  }
+  /**
+   * @brief コンテンツのアップロードが非同期版でも行えるかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, UploadContent) {
+    test::FakeHttpClient transport(BASE_URL);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, deviceName(1)));
+
+    Content content;
+    content.contentStatus.type = ContentType::Clipboard;
+    content.data               = std::string(test::FakeHttpClient::CONTENT);
+    const auto before          = transport.requests.load();
+    EXPECT_TRUE(syncWait(client.uploadContentAsync(std::move(content))));
+    // ステータスとコンテンツのPUT
+    EXPECT_EQ(transport.requests.load() - before, 2u);
+
+    Content mismatch;
+    mismatch.contentStatus.type = ContentType::MultiFile;
+    mismatch.data               = std::string("text");
+    auto result = syncWait(client.uploadContentAsync(std::move(mismatch)));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_CONTENT_TYPE_DATA_MISMATCH);
+  }
+  /**
+   * @brief skipUnchangedのとき、非同期版でもルームに同じコンテンツがあればPUTしないかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, UploadSkipsUnchangedContent) {
+    test::FakeHttpClient transport(BASE_URL);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, deviceName(1)));
+    const UploadOptions skip{ .skipUnchanged = true };
+
+    // FakeHttpClientは"fake"がアップロードしたCONTENTを持っている。
+    ContentStatus status;
+    status.device = "fake";
+    status.type   = ContentType::Clipboard;
+    EXPECT_TRUE(syncWait(client.uploadContentAsync(
+      status, test::FakeHttpClient::CONTENT, {}, skip)));
+    EXPECT_EQ(transport.contentPuts.load(), 0u);
+    EXPECT_EQ(transport.statusPuts.load(), 0u);
+
+    // 計算したハッシュ値は、内容が異なるときのステータスのPUTにも使う。
+    EXPECT_TRUE(syncWait(client.uploadContentAsync(status, "other", {}, skip)));
+    EXPECT_EQ(transport.contentPuts.load(), 1u);
+    EXPECT_EQ(transport.statusPuts.load(), 1u);
+  }
+  /**
+   * @brief キャンセル済みのトークンを渡したときにERR_CANCELLEDとなり、通信しないかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, CancelledBeforeStart) {
+    test::FakeHttpClient transport(BASE_URL);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+
+    CancellationSource source;
+    source.cancel();
+    const auto before = transport.requests.load();
+    auto result       = syncWait(client.getRoomStatusAsync(1, source.token()));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_CANCELLED);
+    EXPECT_EQ(transport.requests.load(), before);
+  }
+  /**
+   * @brief shutdownAsyncが接続しているルームから切断し、以降の非同期の操作を中断するかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, Shutdown) {
+    test::FakeHttpClient transport(BASE_URL);
+    std::size_t before = 0;
+    {
+      ApiClient client("token", "http://localhost", BASE_URL, &transport);
+      ASSERT_TRUE(client.init());
+      ASSERT_TRUE(client.connectRoom(1, deviceName(1)));
+
+      before = transport.requests.load();
+      EXPECT_TRUE(syncWait(client.shutdownAsync(
+        std::chrono::steady_clock::now() + std::chrono::seconds(5))));
+      // ヘルスチェックは行わずに切断する。
+      EXPECT_EQ(transport.requests.load() - before, 1u);
+
+      auto result = syncWait(client.getRoomStatusAsync(1));
+      ASSERT_FALSE(result);
+      EXPECT_EQ(result.err().code, ERR_CANCELLED);
+      before = transport.requests.load();
+    }
+    // シャットダウンした後の破棄では通信しない。
+    EXPECT_EQ(transport.requests.load(), before);
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief 実行中のshutdownAsyncが完了するまで、デストラクタが待つかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, DestroyedDuringShutdown) {
+    test::FakeHttpClient transport(BASE_URL, 50ms);
+    // 完了はテストの後になりうるので、結果の受け渡し先は共有する。
+    auto succeeded = std::make_shared<std::promise<bool>>();
+    auto finished  = succeeded->get_future();
+    std::thread shutdown;
+    {
+      ApiClient client("token", "http://localhost", BASE_URL, &transport);
+      ASSERT_TRUE(client.init());
+      ASSERT_TRUE(client.connectRoom(1, deviceName(1)));
+
+      const auto before = transport.requests.load();
+      shutdown          = std::thread([&] {
+        spawn(client.shutdownAsync(std::chrono::steady_clock::now() + 5s),
+              [succeeded](Result<_, ErrorResponse> result) {
+                succeeded->set_value(static_cast<bool>(result));
+              });
+      });
+      // 切断のリクエストが始まってから破棄する。
+      while (transport.requests.load() == before) {
+        std::this_thread::yield();
+      }
+    }
+    shutdown.join();
+    EXPECT_TRUE(finished.get());
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief 接続のリクエスト中に終了処理が始まった場合、接続を記録せずに切断するかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, ConnectRacingShutdown) {
+    for (const bool async : { false, true }) {
+      test::FakeHttpClient transport(BASE_URL, 50ms);
+      ApiClient client("token", "http://localhost", BASE_URL, &transport);
+      ASSERT_TRUE(client.init());
+
+      const auto before = transport.requests.load();
+      std::optional<Result<Response, ErrorResponse>> connected;
+      std::thread connect([&] {
+        connected.emplace(
+          async ? syncWait(client.connectRoomAsync(1, deviceName(1)))
+                : client.connectRoom(1, deviceName(1)));
+      });
+      // 接続のリクエストが始まってから終了処理を始める。
+      while (transport.requests.load() == before) {
+        std::this_thread::yield();
+      }
+      EXPECT_TRUE(
+        syncWait(client.shutdownAsync(std::chrono::steady_clock::now() + 5s)));
+      connect.join();
+
+      ASSERT_FALSE(connected.value());
+      EXPECT_EQ(connected.value().err().code, ERR_CANCELLED);
+      const auto content = client.getContent();
+      ASSERT_FALSE(content);
+      EXPECT_EQ(content.err().code, ERR_ROOM_DISCONNECTED);
+      EXPECT_EQ(transport.disconnections.load(), 1u);
+      EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+    }
+  }
+  /**
+   * @brief 期限を過ぎていれば、切断のリクエストを中断して戻るかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, ShutdownPastDeadline) {
+    test::FakeHttpClient transport(BASE_URL);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, deviceName(1)));
+
+    const auto before = transport.requests.load();
+    auto result
+      = syncWait(client.shutdownAsync(std::chrono::steady_clock::now()));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_CANCELLED);
+    EXPECT_EQ(transport.requests.load(), before);
+  }
+  /**
+   * @brief 少数のスレッドで多数の操作を同時に進められるかをテストする。
+   *
+   */
+  TEST(ApiClientAsyncTest, ManyConcurrentOperations) {
+    constexpr std::size_t OPERATIONS = 1000;
+
+    test::FakeHttpClient transport(BASE_URL, 10us);
+    ThreadPoolExecutor executor(2);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    client.setExecutor(executor);
+    ASSERT_TRUE(client.init());
+
+    std::atomic<std::size_t> completed = 0;
+    std::atomic<std::size_t> failures  = 0;
+    for (std::size_t i = 0; i < OPERATIONS; ++i) {
+      const std::uint64_t id = i % 4 + 1;
+      spawn(client.getRoomStatusAsync(id),
+            [&, id](Result<RoomStatus, ErrorResponse>&& result) {
+              if (!result || result.get().id != id) ++failures;
+              ++completed;
+            });
+    }
+    while (completed.load() < OPERATIONS) std::this_thread::yield();
+    EXPECT_EQ(failures.load(), 0u);
+    // ヘルスチェックの結果は全ての操作で共有される。
+    EXPECT_EQ(transport.healthRequests.load(), 1u);
+  }
+} // namespace octane
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/api_client.h"
+#include "include/error_code.h"
+#include "./mock/fake_http_client.h"
+
+using namespace std::chrono_literals;
+
+// 一つのApiClientを多数のスレッドから同時に使用する。
+// データ競合を検出するには、OCTANE_API_CLIENT_ENABLE_TSANを有効にしてビルドする。
+namespace octane {
+  namespace {
+    constexpr auto BASE_URL          = "/api/v1";
+    constexpr std::size_t THREADS    = 16;
+    constexpr std::size_t ITERATIONS = 200;
+    constexpr std::uint64_t ROOMS    = 4;
+
+    std::string deviceName(std::uint64_t id) {
+      return "device-" + std::to_string(id);
+    }
+
+    /**
+     * @brief countスレッドでf(スレッド番号)を同時に開始し、全ての終了を待つ。
+     *
+     */
+    template <typename F>
+    void runThreads(std::size_t count, F&& f) {
+      std::atomic<bool> start = false;
+      std::vector<std::thread> threads;
+      threads.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([&, i] {
+          while (!start.load()) std::this_thread::yield();
+          f(i);
+        });
+      }
+      start = true;
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+  } // namespace
+
+  /**
+   * @brief 読み取り系のメソッドを同時に呼び出しても全て成功するかをテストする。
+   *
+   */
+  TEST(ApiClientStressTest, ConcurrentReads) {
+    test::FakeHttpClient transport(BASE_URL, 20us);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, deviceName(1)));
+
+    std::atomic<std::size_t> failures = 0;
+    runThreads(THREADS, [&](std::size_t thread) {
+      for (std::size_t i = 0; i < ITERATIONS; ++i) {
+        const auto id = (thread + i) % ROOMS + 1;
+        switch (i % 3) {
+          case 0: {
+            auto result = client.getRoomStatus(id);
+            if (!result || result.get().id != id) ++failures;
+            break;
+          }
+          case 1: {
+            auto result = client.getContent();
+            if (!result
+                || std::get<std::string>(result.get().data)
+                     != test::FakeHttpClient::CONTENT) {
+              ++failures;
+            }
+            break;
+          }
+          case 2: {
+            if (!client.getRoomStatus()) ++failures;
+            break;
+          }
+        }
+      }
+    });
+    EXPECT_EQ(failures.load(), 0u);
+    // ヘルスチェックの結果は全てのスレッドで共有される。
+    EXPECT_EQ(transport.healthRequests.load(), 1u);
+  }
+  /**
+   * @brief 接続・切断と、接続中のルームを使用するメソッドを同時に呼び出したときに、
+   * ルームのidとデバイス名の組が崩れないかをテストする。
+   *
+   */
+  TEST(ApiClientStressTest, ConnectionStateIsConsistent) {
+    test::FakeHttpClient transport(BASE_URL);
+    std::atomic<std::size_t> failures = 0;
+    {
+      ApiClient client("token", "http://localhost", BASE_URL, &transport);
+      ASSERT_TRUE(client.init());
+
+      runThreads(THREADS, [&](std::size_t thread) {
+        for (std::size_t i = 0; i < ITERATIONS; ++i) {
+          const auto id = (thread + i) % ROOMS + 1;
+          if (thread % 4 == 0) {
+            if (i % 2 == 0) {
+              if (!client.connectRoom(id, deviceName(id))) ++failures;
+            } else {
+              if (!client.disconnectRoom(id, deviceName(id))) ++failures;
+            }
+            continue;
+          }
+
+          // 切断されている間はエラーになるが、それ以外の失敗はしない。
+          auto status = client.getRoomStatus();
+          if (!status && status.err().code != ERR_ROOM_ID_UNDEFINED) {
+            ++failures;
+          }
+          auto content = client.getContent();
+          if (!content && content.err().code != ERR_ROOM_DISCONNECTED) {
+            ++failures;
+          }
+        }
+      });
+
+      // 最後に接続した状態で破棄し、デストラクタでの切断も検査する。
+      ASSERT_TRUE(client.connectRoom(ROOMS, deviceName(ROOMS)));
+    }
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief バリデーションの設定を変更しながらリクエストを発行できるかをテストする。
+   *
+   */
+  TEST(ApiClientStressTest, ValidationModeChanges) {
+    test::FakeHttpClient transport(BASE_URL);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+
+    std::atomic<std::size_t> failures = 0;
+    runThreads(THREADS, [&](std::size_t thread) {
+      for (std::size_t i = 0; i < ITERATIONS; ++i) {
+        if (thread == 0) {
+          client.setValidationMode(i % 2 == 0 ? ValidationMode::Sampled
+                                              : ValidationMode::Full,
+                                   4);
+          continue;
+        }
+        if (!client.getRoomStatus(thread % ROOMS + 1)) ++failures;
+      }
+    });
+    EXPECT_EQ(failures.load(), 0u);
+  }
+  /**
+   * @brief バッチ処理を複数のスレッドから同時に呼び出せるかをテストする。
+   *
+   */
+  TEST(ApiClientStressTest, ConcurrentBatches) {
+    test::FakeHttpClient transport(BASE_URL, 20us);
+    ApiClient client("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(client.init());
+
+    std::vector<std::uint64_t> ids;
+    for (std::uint64_t id = 1; id <= 32; ++id) {
+      ids.push_back(id);
+    }
+    std::atomic<std::size_t> failures = 0;
+    runThreads(4, [&](std::size_t) {
+      auto result = client.getRoomStatuses(ids, 8);
+      if (!result) {
+        ++failures;
+        return;
+      }
+      for (std::size_t i = 0; i < ids.size(); ++i) {
+        const auto& status = result.get()[i];
+        if (!status || status.get().id != ids[i]) ++failures;
+      }
+    });
+    EXPECT_EQ(failures.load(), 0u);
+  }
+} // namespace octane
@@ -2,9 +2,179 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "./mock/fake_http_client.h"
+#include "include/error_code.h"
+
 using namespace octane;
 
 TEST(ApiClientTest, BasicAssertions) {
   ApiClient apiClient("", "http://localhost:3000", "/api/v1");
   
 }
+
+namespace {
+  Content clipboard(std::string_view text, std::string_view device) {
+    Content content;
+    content.contentStatus.device    = std::string(device);
+    content.contentStatus.timestamp = 1;
+    content.contentStatus.type      = ContentType::Clipboard;
+    content.contentStatus.mime      = "text/plain";
+    content.data                    = std::string(text);
+    return content;
+  }
+} // namespace
+
+/**
+ * @brief skipUnchangedのとき、ルームに同じコンテンツがあればPUTしないかをテストする。
+ *
+ */
+TEST(ApiClientTest, UploadSkipsUnchangedContent) {
+  test::FakeHttpClient transport("/api/v1");
+  ApiClient client("token", "http://localhost", "/api/v1", &transport);
+  ASSERT_TRUE(client.init());
+  ASSERT_TRUE(client.connectRoom(1, "device-1"));
+  const UploadOptions skip{ .skipUnchanged = true };
+
+  // FakeHttpClientは"fake"がアップロードしたCONTENTを持っている。
+  EXPECT_TRUE(client.uploadContent(
+    clipboard(test::FakeHttpClient::CONTENT, "fake"), skip));
+  EXPECT_EQ(transport.contentPuts.load(), 0u);
+  EXPECT_EQ(transport.statusPuts.load(), 0u);
+
+  // 内容が同じでもアップロードしたデバイスが異なれば、状態だけを更新する。
+  EXPECT_TRUE(client.uploadContent(
+    clipboard(test::FakeHttpClient::CONTENT, "device-1"), skip));
+  EXPECT_EQ(transport.contentPuts.load(), 0u);
+  EXPECT_EQ(transport.statusPuts.load(), 1u);
+
+  EXPECT_TRUE(client.uploadContent(clipboard("other", "fake"), skip));
+  EXPECT_EQ(transport.contentPuts.load(), 1u);
+  EXPECT_EQ(transport.statusPuts.load(), 2u);
+
+  // 既定では常にアップロードする。
+  EXPECT_TRUE(
+    client.uploadContent(clipboard(test::FakeHttpClient::CONTENT, "fake")));
+  EXPECT_EQ(transport.contentPuts.load(), 2u);
+  EXPECT_EQ(transport.statusPuts.load(), 3u);
+
+  EXPECT_TRUE(syncWait(client.uploadContentAsync(
+    clipboard(test::FakeHttpClient::CONTENT, "fake"), {}, skip)));
+  EXPECT_EQ(transport.contentPuts.load(), 2u);
+  EXPECT_EQ(transport.statusPuts.load(), 3u);
+}
+/**
+ * @brief 借りたバッファをコピーせずにアップロードするかをテストする。
+ *
+ */
+TEST(ApiClientTest, UploadBorrowedBuffer) {
+  test::FakeHttpClient transport("/api/v1");
+  ApiClient client("token", "http://localhost", "/api/v1", &transport);
+  ASSERT_TRUE(client.init());
+  ASSERT_TRUE(client.connectRoom(1, "device-1"));
+  const auto status = clipboard("", "fake").contentStatus;
+
+  const std::string text = "borrowed";
+  EXPECT_TRUE(client.uploadContent(status, text));
+  EXPECT_EQ(transport.contentPuts.load(), 1u);
+  EXPECT_EQ(transport.contentPutData.load(),
+            reinterpret_cast<const std::uint8_t*>(text.data()));
+
+  const std::vector<std::byte> bytes(4, std::byte{ 0x7f });
+  EXPECT_TRUE(syncWait(client.uploadContentAsync(status, bytes)));
+  EXPECT_EQ(transport.contentPuts.load(), 2u);
+  EXPECT_EQ(transport.contentPutData.load(),
+            reinterpret_cast<const std::uint8_t*>(bytes.data()));
+
+  // 借りたバッファのハッシュ値でも、ルームと同じ内容であれば送信しない。
+  EXPECT_TRUE(client.uploadContent(
+    status, test::FakeHttpClient::CONTENT, { .skipUnchanged = true }));
+  EXPECT_EQ(transport.contentPuts.load(), 2u);
+
+  auto multiFile = status;
+  multiFile.type = ContentType::MultiFile;
+  const auto result = client.uploadContent(multiFile, text);
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.err().code, ERR_CONTENT_TYPE_DATA_MISMATCH);
+}
+/**
+ * @brief uploadFileがファイルをマップしたまま、ハッシュ値の計算と送信を行うかをテストする。
+ *
+ */
+TEST(ApiClientTest, UploadFile) {
+  test::FakeHttpClient transport("/api/v1");
+  ApiClient client("token", "http://localhost", "/api/v1", &transport);
+  ASSERT_TRUE(client.init());
+  ASSERT_TRUE(client.connectRoom(1, "device-1"));
+  auto status = clipboard("", "fake").contentStatus;
+  status.type = ContentType::File;
+  status.name = "upload.bin";
+  status.mime = "application/octet-stream";
+
+  const auto path = std::filesystem::temp_directory_path()
+                  / "octane_api_client_upload_file_test.bin";
+  const auto write = [&](std::string_view data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc)
+      .write(data.data(), data.size());
+  };
+
+  // マップした内容のハッシュ値がルームと一致すれば送信しない。
+  write(test::FakeHttpClient::CONTENT);
+  EXPECT_TRUE(client.uploadFile(status, path, { .skipUnchanged = true }));
+  EXPECT_EQ(transport.contentPuts.load(), 0u);
+
+  write("mapped file");
+  EXPECT_TRUE(client.uploadFile(status, path));
+  EXPECT_EQ(transport.contentPuts.load(), 1u);
+  EXPECT_NE(transport.contentPutData.load(), nullptr);
+
+  write("");
+  EXPECT_TRUE(syncWait(client.uploadFileAsync(status, path)));
+  EXPECT_EQ(transport.contentPuts.load(), 2u);
+
+  std::filesystem::remove(path);
+  const auto result = syncWait(client.uploadFileAsync(status, path));
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.err().code, ERR_FILE_OPEN_FAILED);
+}
+/**
+ * @brief downloadContentが一時ファイルを経由してコンテンツを置き、一時ファイルを残さないかをテストする。
+ *
+ */
+TEST(ApiClientTest, DownloadContent) {
+  test::FakeHttpClient transport("/api/v1");
+  ApiClient client("token", "http://localhost", "/api/v1", &transport);
+  ASSERT_TRUE(client.init());
+  ASSERT_TRUE(client.connectRoom(1, "device-1"));
+
+  const auto directory = std::filesystem::temp_directory_path()
+                       / "octane_api_client_download_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  const auto path = directory / "content.txt";
+  std::ofstream(path) << "previous";
+
+  const auto status = client.downloadContent(path);
+  ASSERT_TRUE(status) << status.err().reason;
+  EXPECT_EQ(status.get().type, ContentType::Clipboard);
+  const auto read = [](const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), {});
+  };
+  EXPECT_EQ(read(path), test::FakeHttpClient::CONTENT);
+
+  std::filesystem::remove(path);
+  ASSERT_TRUE(syncWait(client.downloadContentAsync(path)));
+  EXPECT_EQ(read(path), test::FakeHttpClient::CONTENT);
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(directory),
+                          std::filesystem::directory_iterator()),
+            1);
+
+  std::filesystem::remove_all(directory);
+  const auto result = client.downloadContent(directory / "missing" / "a.txt");
+  ASSERT_FALSE(result);
+  EXPECT_EQ(result.err().code, ERR_FILE_WRITE_FAILED);
+}
@@ -0,0 +1,155 @@
+#include "include/internal/content_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "include/api_client.h"
+#include "include/internal/hash.h"
+#include "./mock/fake_http_client.h"
+
+namespace octane::internal {
+  namespace {
+    std::filesystem::path cacheDirectory() {
+      const auto directory = std::filesystem::temp_directory_path()
+                           / "octane_api_client_content_cache_test";
+      std::filesystem::remove_all(directory);
+      return directory;
+    }
+    std::span<const std::uint8_t> bytes(std::string_view str) {
+      return std::span(reinterpret_cast<const std::uint8_t*>(str.data()),
+                       str.size());
+    }
+    std::string hashOf(std::string_view str) {
+      return generateHash(bytes(str));
+    }
+    std::string read(const std::optional<MappedFile>& file) {
+      const auto data = file->bytes();
+      return std::string(data.begin(), data.end());
+    }
+  } // namespace
+
+  /**
+   * @brief 保存したコンテンツをハッシュ値で引けるかをテストする。
+   *
+   */
+  TEST(ContentCacheTest, StoreAndLookup) {
+    const auto directory = cacheDirectory();
+    auto cache           = ContentCache::open(directory, 1024);
+    ASSERT_TRUE(cache) << cache.err();
+
+    const auto hash = hashOf("cached");
+    EXPECT_FALSE(cache.get()->lookup(hash));
+    cache.get()->store(hash, bytes("cached"));
+    const auto file = cache.get()->lookup(hash);
+    ASSERT_TRUE(file);
+    EXPECT_EQ(read(file), "cached");
+    EXPECT_TRUE(std::filesystem::exists(directory / "objects"
+                                        / hash.substr(0, 2) / hash));
+
+    // 別のインスタンスからも引ける。
+    auto other = ContentCache::open(directory, 1024);
+    ASSERT_TRUE(other) << other.err();
+    EXPECT_EQ(read(other.get()->lookup(hash)), "cached");
+
+    // パスとして解釈される文字を含むハッシュ値は扱わない。
+    cache.get()->store("../escaped", bytes("escaped"));
+    EXPECT_FALSE(cache.get()->lookup("../escaped"));
+    EXPECT_FALSE(std::filesystem::exists(directory / "escaped"));
+
+    std::filesystem::remove_all(directory);
+  }
+  /**
+   * @brief 上限を超えたとき、最後に使われた時刻が古いものから削除するかをテストする。
+   *
+   */
+  TEST(ContentCacheTest, EvictsLeastRecentlyUsed) {
+    const auto directory = cacheDirectory();
+    auto cache           = ContentCache::open(directory, 10);
+    ASSERT_TRUE(cache) << cache.err();
+
+    const auto a = hashOf("1234");
+    const auto b = hashOf("5678");
+    const auto c = hashOf("9012");
+    cache.get()->store(a, bytes("1234"));
+    cache.get()->store(b, bytes("5678"));
+    EXPECT_TRUE(cache.get()->lookup(a));
+    cache.get()->store(c, bytes("9012"));
+    EXPECT_TRUE(cache.get()->lookup(a));
+    EXPECT_FALSE(cache.get()->lookup(b));
+    EXPECT_TRUE(cache.get()->lookup(c));
+
+    // 上限より大きいコンテンツは保存しない。
+    const auto d = hashOf("too large to cache");
+    cache.get()->store(d, bytes("too large to cache"));
+    EXPECT_FALSE(cache.get()->lookup(d));
+    EXPECT_TRUE(cache.get()->lookup(c));
+
+    std::filesystem::remove_all(directory);
+  }
+  /**
+   * @brief 内容がハッシュ値と一致しないエントリを返さずに削除するかをテストする。
+   *
+   */
+  TEST(ContentCacheTest, DiscardsCorruptedEntry) {
+    const auto directory = cacheDirectory();
+    auto cache           = ContentCache::open(directory, 1024);
+    ASSERT_TRUE(cache) << cache.err();
+
+    const auto hash = hashOf("cached");
+    cache.get()->store(hash, bytes("cached"));
+    const auto path = directory / "objects" / hash.substr(0, 2) / hash;
+    ASSERT_TRUE(std::filesystem::exists(path));
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "broken";
+
+    EXPECT_FALSE(cache.get()->lookup(hash));
+    EXPECT_FALSE(std::filesystem::exists(path));
+
+    // 削除した後は、保存し直せば再び引ける。
+    cache.get()->store(hash, bytes("cached"));
+    EXPECT_EQ(read(cache.get()->lookup(hash)), "cached");
+
+    std::filesystem::remove_all(directory);
+  }
+} // namespace octane::internal
+
+namespace octane {
+  /**
+   * @brief キャッシュを有効にしたとき、ApiClient::getContentが同じコンテンツを取得し直さないかをテストする。
+   *
+   */
+  TEST(ApiClientContentCacheTest, GetContentUsesCache) {
+    const auto directory = internal::cacheDirectory();
+    test::FakeHttpClient transport("/api/v1");
+    ApiClient client("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, "device-1"));
+    ASSERT_TRUE(client.enableContentCache({ .directory = directory }));
+
+    for (int i = 0; i < 3; ++i) {
+      auto content = i == 1 ? syncWait(client.getContentAsync())
+                            : client.getContent();
+      ASSERT_TRUE(content) << content.err().reason;
+      EXPECT_EQ(std::get<std::string>(content.get().data),
+                test::FakeHttpClient::CONTENT);
+    }
+    EXPECT_EQ(transport.contentRequests.load(), 1u);
+
+    // 別のクライアントも同じキャッシュを使う。
+    ApiClient other("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(other.init());
+    ASSERT_TRUE(other.connectRoom(1, "device-2"));
+    ASSERT_TRUE(other.enableContentCache({ .directory = directory }));
+    EXPECT_TRUE(other.getContent());
+    EXPECT_EQ(transport.contentRequests.load(), 1u);
+
+    client.disableContentCache();
+    EXPECT_TRUE(client.getContent());
+    EXPECT_EQ(transport.contentRequests.load(), 2u);
+
+    std::filesystem::remove_all(directory);
+  }
+} // namespace octane
@@ -0,0 +1,195 @@
+#include "include/internal/content_prefetcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <thread>
+
+#include "include/api_client.h"
+#include "include/error_code.h"
+#include "include/internal/hash.h"
+#include "./mock/fake_http_client.h"
+
+using namespace std::chrono_literals;
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief conditionがtrueになるか、limitを過ぎるまで待つ。
+     *
+     */
+    template <typename F>
+    bool waitUntil(F&& condition, std::chrono::milliseconds limit = 5s) {
+      const auto end = std::chrono::steady_clock::now() + limit;
+      while (!condition()) {
+        if (std::chrono::steady_clock::now() >= end) return false;
+        std::this_thread::sleep_for(1ms);
+      }
+      return true;
+    }
+
+    ContentObservation observe(std::string hash, std::uint64_t timestamp = 0) {
+      return ContentObservation{
+        .roomId        = 1,
+        .contentStatus = ContentStatus{
+          .device    = "fake",
+          .timestamp = timestamp,
+          .type      = ContentType::Clipboard,
+          .name      = std::nullopt,
+          .mime      = "text/plain",
+        },
+        .hash = std::move(hash),
+      };
+    }
+    Content makeContent(const ContentObservation& observation,
+                        std::string data) {
+      Content content;
+      content.contentStatus = observation.contentStatus;
+      content.data          = std::move(data);
+      return content;
+    }
+  } // namespace
+
+  /**
+   * @brief 通知されたコンテンツを一度だけ取得し、同じコンテンツに対して返すかをテストする。
+   *
+   */
+  TEST(ContentPrefetcherTest, PreparesNotifiedContent) {
+    std::atomic<int> downloads = 0;
+    ContentPrefetcher prefetcher(
+      [&](const ContentObservation& observation, CancellationSource)
+        -> Result<Content, ErrorResponse> {
+        ++downloads;
+        return ok(makeContent(observation, "data " + observation.hash));
+      },
+      1024);
+
+    EXPECT_EQ(prefetcher.find(observe("a")), nullptr);
+    prefetcher.notify(observe("a"));
+    ASSERT_TRUE(
+      waitUntil([&] { return prefetcher.find(observe("a")) != nullptr; }));
+    EXPECT_EQ(std::get<std::string>(prefetcher.find(observe("a"))->data),
+              "data a");
+    // タイムスタンプが異なれば別のコンテンツとみなす。
+    EXPECT_EQ(prefetcher.find(observe("a", 1)), nullptr);
+
+    prefetcher.notify(observe("a"));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(downloads.load(), 1);
+  }
+  /**
+   * @brief 取得中に新しいコンテンツが通知されたら、古い取得をキャンセルして新しい方を覚えるかをテストする。
+   *
+   */
+  TEST(ContentPrefetcherTest, CancelsOnNewerContent) {
+    std::atomic<int> cancelled = 0;
+    ContentPrefetcher prefetcher(
+      [&](const ContentObservation& observation,
+          CancellationSource cancellation) -> Result<Content, ErrorResponse> {
+        if (observation.hash == "old") {
+          // キャンセルされるまで受信し続けるとする。
+          while (!cancellation.isCancelled()) {
+            std::this_thread::sleep_for(1ms);
+          }
+          ++cancelled;
+          return makeError(ERR_CANCELLED, "");
+        }
+        return ok(makeContent(observation, observation.hash));
+      },
+      1024);
+
+    prefetcher.notify(observe("old"));
+    std::this_thread::sleep_for(20ms);
+    prefetcher.notify(observe("new"));
+    ASSERT_TRUE(
+      waitUntil([&] { return prefetcher.find(observe("new")) != nullptr; }));
+    EXPECT_EQ(cancelled.load(), 1);
+    EXPECT_EQ(prefetcher.find(observe("old")), nullptr);
+
+    // 新しいコンテンツが現れたら、覚えていた結果は捨てる。
+    prefetcher.notify(observe("newer"));
+    EXPECT_EQ(prefetcher.find(observe("new")), nullptr);
+  }
+  /**
+   * @brief 上限を超えるコンテンツを覚えないかをテストする。
+   *
+   */
+  TEST(ContentPrefetcherTest, DropsContentOverLimit) {
+    std::atomic<int> downloads = 0;
+    ContentPrefetcher prefetcher(
+      [&](const ContentObservation& observation, CancellationSource)
+        -> Result<Content, ErrorResponse> {
+        ++downloads;
+        return ok(makeContent(observation, std::string(16, 'x')));
+      },
+      8);
+
+    prefetcher.notify(observe("a"));
+    ASSERT_TRUE(waitUntil([&] { return downloads.load() == 1; }));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(prefetcher.find(observe("a")), nullptr);
+
+    prefetcher.offer(observe("b"), makeContent(observe("b"), "small"));
+    EXPECT_NE(prefetcher.find(observe("b")), nullptr);
+    prefetcher.offer(observe("c"), makeContent(observe("c"), "too large"));
+    EXPECT_EQ(prefetcher.find(observe("c")), nullptr);
+  }
+} // namespace octane::internal
+
+namespace octane {
+  /**
+   * @brief ポーリングで見つけた新しいコンテンツをプリフェッチし、getContentがそれを返すかをテストする。
+   *
+   */
+  TEST(ApiClientContentPrefetchTest, GetContentUsesPrefetchedContent) {
+    test::FakeHttpClient transport("/api/v1");
+    ApiClient client("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, "device-1"));
+    client.enableContentPrefetch();
+
+    SubscribeOptions options;
+    options.pollInterval      = 1ms;
+    options.reconnectInterval = 1ms;
+    auto subscription
+      = client.subscribeRoom([](Result<RoomEvent, ErrorResponse>) {}, options);
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return transport.statusRequests.load() >= 5; }));
+    EXPECT_EQ(transport.contentRequests.load(), 0u);
+
+    ++transport.timestamp;
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return transport.contentRequests.load() == 1; }));
+    subscription.stop();
+    // 受信したコンテンツをデコードし、プリフェッチした結果として覚えるまで待つ。
+    const auto prefetcher = client.loadContentPrefetcher();
+    const auto data       = test::FakeHttpClient::CONTENT;
+    const auto prefetched = internal::observe(
+      internal::generateHash(std::span(
+        reinterpret_cast<const std::uint8_t*>(data.data()), data.size())),
+      1);
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return prefetcher->find(prefetched) != nullptr; }));
+
+    for (int i = 0; i < 2; ++i) {
+      auto content = i == 0 ? client.getContent()
+                            : syncWait(client.getContentAsync());
+      ASSERT_TRUE(content) << content.err().reason;
+      EXPECT_EQ(std::get<std::string>(content.get().data),
+                test::FakeHttpClient::CONTENT);
+      EXPECT_EQ(content.get().contentStatus.timestamp, 1u);
+    }
+    EXPECT_EQ(transport.contentRequests.load(), 1u);
+
+    // 別のコンテンツに変われば、ふつうに取得する。
+    ++transport.timestamp;
+    ASSERT_TRUE(client.getContent());
+    EXPECT_EQ(transport.contentRequests.load(), 2u);
+
+    client.disableContentPrefetch();
+    ASSERT_TRUE(client.getContent());
+    EXPECT_EQ(transport.contentRequests.load(), 3u);
+  }
+} // namespace octane
@@ -0,0 +1,220 @@
+#include "include/internal/content_watcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "include/api_client.h"
+#include "include/error_code.h"
+#include "./mock/fake_http_client.h"
+
+using namespace std::chrono_literals;
+
+namespace octane::internal {
+  namespace {
+    WatchOptions fastOptions() {
+      WatchOptions options;
+      options.minInterval = 1ms;
+      options.maxInterval = 4ms;
+      return options;
+    }
+
+    /**
+     * @brief conditionがtrueになるか、limitを過ぎるまで待つ。
+     *
+     */
+    template <typename F>
+    bool waitUntil(F&& condition, std::chrono::milliseconds limit = 5s) {
+      const auto end = std::chrono::steady_clock::now() + limit;
+      while (!condition()) {
+        if (std::chrono::steady_clock::now() >= end) return false;
+        std::this_thread::sleep_for(1ms);
+      }
+      return true;
+    }
+
+    /**
+     * @brief 状態を変更できる偽のルーム。
+     *
+     */
+    struct FakeRoom {
+      std::mutex mutex;
+      std::string hash         = "a";
+      std::uint64_t timestamp  = 0;
+      std::atomic<int> polls   = 0;
+      std::atomic<int> fetches = 0;
+      /** @brief 残りの回数だけ、取得したコンテンツのハッシュ値を一致させない。*/
+      std::atomic<int> mismatches = 0;
+
+      ContentWatcher::Poll poll() {
+        return [this]() -> Result<ContentObservation, ErrorResponse> {
+          ++polls;
+          std::lock_guard lock(mutex);
+          ContentStatus status{
+            .device    = "fake",
+            .timestamp = timestamp,
+            .type      = ContentType::Clipboard,
+            .name      = std::nullopt,
+            .mime      = "text/plain",
+          };
+          return ok(ContentObservation{
+            .roomId        = 1,
+            .contentStatus = std::move(status),
+            .hash          = hash,
+          });
+        };
+      }
+      ContentWatcher::Download download() {
+        return [this](const ContentObservation& observation)
+                 -> Result<Content, ErrorResponse> {
+          ++fetches;
+          if (mismatches.load() > 0) {
+            --mismatches;
+            return makeError(ERR_CONTENT_HASH_MISMATCH, "");
+          }
+          Content content;
+          content.contentStatus = observation.contentStatus;
+          content.data          = observation.hash;
+          return ok(std::move(content));
+        };
+      }
+      void change(std::string next) {
+        std::lock_guard lock(mutex);
+        hash = std::move(next);
+        ++timestamp;
+      }
+    };
+  } // namespace
+
+  /**
+   * @brief 変化がない間はコンテンツを取得せず、変化したときだけ通知するかをテストする。
+   *
+   */
+  TEST(ContentWatcherTest, DownloadsOnlyOnChange) {
+    FakeRoom room;
+    std::mutex mutex;
+    std::vector<std::string> seen;
+    ContentWatcher watcher(
+      room.poll(),
+      room.download(),
+      [&](Result<Content, ErrorResponse> content) {
+        ASSERT_TRUE(content);
+        std::lock_guard lock(mutex);
+        seen.push_back(std::get<std::string>(content.get().data));
+      },
+      fastOptions());
+
+    ASSERT_TRUE(waitUntil([&] { return room.polls.load() >= 10; }));
+    EXPECT_EQ(room.fetches.load(), 0);
+
+    room.change("b");
+    ASSERT_TRUE(waitUntil([&] {
+      std::lock_guard lock(mutex);
+      return seen.size() == 1;
+    }));
+    const auto polls = room.polls.load();
+    ASSERT_TRUE(waitUntil([&] { return room.polls.load() >= polls + 10; }));
+    watcher.stop();
+
+    EXPECT_EQ(room.fetches.load(), 1);
+    EXPECT_EQ(seen, std::vector<std::string>{ "b" });
+  }
+  /**
+   * @brief notifyInitialが有効なとき、最初の状態も通知するかをテストする。
+   *
+   */
+  TEST(ContentWatcherTest, NotifyInitial) {
+    FakeRoom room;
+    std::atomic<int> notified = 0;
+    auto options              = fastOptions();
+    options.notifyInitial     = true;
+    ContentWatcher watcher(
+      room.poll(),
+      room.download(),
+      [&](Result<Content, ErrorResponse>) { ++notified; },
+      options);
+    ASSERT_TRUE(waitUntil([&] { return notified.load() == 1; }));
+    ASSERT_TRUE(waitUntil([&] { return room.polls.load() >= 5; }));
+    watcher.stop();
+    EXPECT_EQ(notified.load(), 1);
+  }
+  /**
+   * @brief ハッシュ値の不一致は一度だけ取得し直し、続けて不一致ならエラーを通知するかをテストする。
+   *
+   */
+  TEST(ContentWatcherTest, RetriesHashMismatchOnce) {
+    FakeRoom room;
+    room.mismatches = 1;
+    std::atomic<int> succeeded = 0;
+    std::atomic<int> failed    = 0;
+    auto options               = fastOptions();
+    options.notifyInitial      = true;
+    ContentWatcher watcher(
+      room.poll(),
+      room.download(),
+      [&](Result<Content, ErrorResponse> content) {
+        content ? ++succeeded : ++failed;
+      },
+      options);
+    ASSERT_TRUE(waitUntil([&] { return succeeded.load() == 1; }));
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_EQ(room.fetches.load(), 2);
+
+    room.mismatches = 2;
+    room.change("b");
+    ASSERT_TRUE(waitUntil([&] { return failed.load() == 1; }));
+    watcher.stop();
+    EXPECT_EQ(room.fetches.load(), 4);
+  }
+  /**
+   * @brief 変化がない間はポーリングの間隔が最大値まで伸びるかをテストする。
+   *
+   */
+  TEST(ContentWatcherTest, IntervalBacksOff) {
+    WatchOptions options;
+    options.minInterval   = 100ms;
+    options.maxInterval   = 1000ms;
+    options.backoffFactor = 3.0;
+    EXPECT_EQ(ContentWatcher::nextInterval(100ms, options), 300ms);
+    EXPECT_EQ(ContentWatcher::nextInterval(300ms, options), 900ms);
+    EXPECT_EQ(ContentWatcher::nextInterval(900ms, options), 1000ms);
+    EXPECT_EQ(ContentWatcher::nextInterval(0ms, options), 100ms);
+  }
+} // namespace octane::internal
+
+namespace octane {
+  /**
+   * @brief ApiClient::watchContentが状態だけをポーリングし、更新されたときにコンテンツを取得するかをテストする。
+   *
+   */
+  TEST(ApiClientWatchContentTest, PollsStatusOnly) {
+    test::FakeHttpClient transport("/api/v1");
+    ApiClient client("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, "device-1"));
+
+    std::atomic<int> notified = 0;
+    WatchOptions options;
+    options.minInterval = 1ms;
+    options.maxInterval = 4ms;
+    auto watch          = client.watchContent(
+      [&](Result<Content, ErrorResponse> content) {
+        EXPECT_TRUE(content);
+        ++notified;
+      },
+      options);
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return transport.statusRequests.load() >= 10; }));
+    EXPECT_EQ(transport.contentRequests.load(), 0u);
+
+    ++transport.timestamp;
+    ASSERT_TRUE(internal::waitUntil([&] { return notified.load() == 1; }));
+    watch.stop();
+    EXPECT_FALSE(watch.isActive());
+    EXPECT_EQ(transport.contentRequests.load(), 1u);
+  }
+} // namespace octane
@@ -0,0 +1,38 @@
+#include "include/internal/endpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+namespace octane::internal {
+  /**
+   * @brief ルートがコンパイル時にプレースホルダの前後に分割されるかをテストする。
+   *
+   */
+  TEST(EndpointTest, RouteIsSplitAtCompileTime) {
+    static_assert(endpoint::RoomIdContentGet::hasId);
+    static_assert(endpoint::RoomIdContentGet::prefix == "/room/");
+    static_assert(endpoint::RoomIdContentGet::suffix == "/content");
+    static_assert(endpoint::RoomIdGet::suffix.empty());
+    static_assert(!endpoint::HealthGet::hasId);
+    static_assert(endpoint::HealthGet::prefix == "/health");
+    static_assert(endpoint::RoomIdStatusGet::hasSchema);
+    static_assert(!endpoint::RoomIdContentGet::hasSchema);
+    SUCCEED();
+  }
+  /**
+   * @brief プレースホルダがidで置き換えられるかをテストする。
+   *
+   */
+  TEST(EndpointTest, Path) {
+    EXPECT_EQ(endpoint::HealthGet::path(), "/health");
+    EXPECT_EQ(endpoint::RoomPost::path(), "/room");
+    EXPECT_EQ(endpoint::RoomIdGet::path(7040782538), "/room/7040782538");
+    EXPECT_EQ(endpoint::RoomIdGet::path(0), "/room/0");
+    EXPECT_EQ(endpoint::RoomIdContentGet::path(7040782538),
+              "/room/7040782538/content");
+    EXPECT_EQ(endpoint::RoomIdStatusPut::path(
+                std::numeric_limits<std::uint64_t>::max()),
+              "/room/18446744073709551615/status");
+  }
+} // namespace octane::internal
@@ -0,0 +1,204 @@
+#include "include/internal/event_stream.h"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/error_code.h"
+#include "include/internal/http_client.h"
+
+using namespace std::chrono_literals;
+
+namespace octane::internal {
+  namespace {
+    std::vector<StreamEvent> parse(const std::vector<std::string_view>& chunks) {
+      EventStreamParser parser;
+      std::vector<StreamEvent> events;
+      for (const auto chunk : chunks) {
+        parser.feed(chunk, [&](StreamEvent&& event) {
+          events.push_back(std::move(event));
+        });
+      }
+      return events;
+    }
+
+    /**
+     * @brief 一つの接続にServer-Sent Eventsを返す最小限のHTTPサーバ。
+     * @details
+     * chunksを順に間を空けて送った後、holdがtrueであればクライアントが切断するまで接続を保つ。
+     */
+    class EventServer {
+      int listener = -1;
+      std::thread thread;
+
+    public:
+      std::uint16_t port = 0;
+
+      EventServer(std::string head, std::vector<std::string> chunks, bool hold) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port        = 0;
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener, 1);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        port   = ntohs(address.sin_port);
+        thread = std::thread([this,
+                              head   = std::move(head),
+                              chunks = std::move(chunks),
+                              hold] {
+          const int connection = ::accept(listener, nullptr, nullptr);
+          if (connection < 0) return;
+          std::string request;
+          char buffer[1024];
+          while (request.find("\r\n\r\n") == std::string::npos) {
+            const auto n = ::read(connection, buffer, sizeof(buffer));
+            if (n <= 0) break;
+            request.append(buffer, n);
+          }
+          [[maybe_unused]] auto written
+            = ::write(connection, head.data(), head.size());
+          for (const auto& chunk : chunks) {
+            std::this_thread::sleep_for(20ms);
+            written = ::write(connection, chunk.data(), chunk.size());
+          }
+          if (hold) {
+            while (::read(connection, buffer, sizeof(buffer)) > 0) {}
+          }
+          ::close(connection);
+        });
+      }
+      ~EventServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        thread.join();
+        ::close(listener);
+      }
+      std::string origin() const {
+        return "http://127.0.0.1:" + std::to_string(port);
+      }
+    };
+
+    constexpr auto STREAM_HEAD
+      = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+        "Connection: close\r\n\r\n";
+
+    HttpRequest eventsRequest() {
+      return HttpRequest{
+        .method      = HttpMethod::Get,
+        .version     = HttpVersion::Http1_1,
+        .uri         = "/api/v1/room/1/events",
+        .headerField = { { "Accept", "text/event-stream" } },
+        .body        = {},
+      };
+    }
+  } // namespace
+
+  /**
+   * @brief 行の途中で区切られた断片からイベントを組み立てるかをテストする。
+   *
+   */
+  TEST(EventStreamParserTest, SplitChunks) {
+    const auto events
+      = parse({ "event: con", "tent\ndata: {\"a\"", ": 1}\n", "\n" });
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].event, "content");
+    EXPECT_EQ(events[0].data, R"({"a": 1})");
+  }
+  /**
+   * @brief 改行の種類、コメント、複数行のdata、dataのないイベントを扱えるかをテストする。
+   *
+   */
+  TEST(EventStreamParserTest, LineEndingsAndComments) {
+    const auto events = parse({ ": ping\r\n\r\n",
+                                "data: first\r",
+                                "\ndata:second\r\rid: 3\nevent: only\n\n",
+                                "event: device\rdata: x\r\n\n" });
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].event, "message");
+    EXPECT_EQ(events[0].data, "first\nsecond");
+    EXPECT_EQ(events[1].event, "device");
+    EXPECT_EQ(events[1].data, "x");
+  }
+  /**
+   * @brief HttpClient::streamが、接続が閉じられる前に届いた断片を渡すかをテストする。
+   *
+   */
+  TEST(HttpClientStreamTest, DeliversChunksAsTheyArrive) {
+    EventServer server(
+      STREAM_HEAD, { "event: a\ndata: 1\n\n", "event: b\ndata: 2\n\n" }, true);
+    HttpClient client;
+    ASSERT_TRUE(client.init());
+
+    EventStreamParser parser;
+    std::vector<std::string> received;
+    auto result = client.stream(
+      server.origin(), eventsRequest(), {}, [&](std::string_view chunk) {
+        parser.feed(chunk, [&](StreamEvent&& event) {
+          received.push_back(event.event);
+        });
+        // 二つ目のイベントを受け取ったら、サーバが閉じる前に打ち切る。
+        return received.size() < 2;
+      });
+    ASSERT_TRUE(result) << result.err().reason;
+    EXPECT_EQ(result.get().statusCode, 200);
+    EXPECT_TRUE(result.get().body.empty());
+    EXPECT_EQ(received, (std::vector<std::string>{ "a", "b" }));
+  }
+  /**
+   * @brief 何も届かないストリームをキャンセルで中断できるかをテストする。
+   *
+   */
+  TEST(HttpClientStreamTest, CancelIdleStream) {
+    EventServer server(STREAM_HEAD, {}, true);
+    HttpClient client;
+    ASSERT_TRUE(client.init());
+
+    CancellationSource source;
+    std::thread canceller([&] {
+      std::this_thread::sleep_for(100ms);
+      source.cancel();
+    });
+    auto result = client.stream(server.origin(),
+                                eventsRequest(),
+                                source.token(),
+                                [](std::string_view) { return true; });
+    canceller.join();
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.err().code, ERR_CANCELLED);
+  }
+  /**
+   * @brief 2xx以外のレスポンスのボディ部は渡さずに返り値に格納するかをテストする。
+   *
+   */
+  TEST(HttpClientStreamTest, ErrorBodyIsBuffered) {
+    const std::string body = R"({"code":"ERR_NOT_FOUND","reason":""})";
+    EventServer server("HTTP/1.1 404 Not Found\r\nContent-Type: "
+                       "application/json\r\nContent-Length: "
+                         + std::to_string(body.size()) + "\r\n\r\n" + body,
+                       {},
+                       false);
+    HttpClient client;
+    ASSERT_TRUE(client.init());
+
+    bool streamed = false;
+    auto result   = client.stream(
+      server.origin(), eventsRequest(), {}, [&](std::string_view) {
+        streamed = true;
+        return true;
+      });
+    ASSERT_TRUE(result) << result.err().reason;
+    EXPECT_FALSE(streamed);
+    EXPECT_EQ(result.get().statusCode, 404);
+    EXPECT_EQ(std::string(result.get().body.begin(), result.get().body.end()),
+              body);
+  }
+} // namespace octane::internal
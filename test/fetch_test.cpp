@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 
 #include <iostream>
+#include <map>
+#include <string>
 
 #include "./mock/mock_http_client.h"
 #include "include/error_code.h"
@@ -76,11 +78,10 @@ namespace octane::internal {
 
     auto response = fetch.request(HttpMethod::Get, "/health");
     EXPECT_TRUE(response);
-    EXPECT_TRUE(
-      std::holds_alternative<rapidjson::Document>(response.get().body));
+    EXPECT_TRUE(std::holds_alternative<Json>(response.get().body));
 
-    auto& json = std::get<rapidjson::Document>(response.get().body);
-    EXPECT_TRUE(json.HasMember("health"));
+    auto& json = std::get<Json>(response.get().body);
+    EXPECT_TRUE(json.hasMember("health"));
     EXPECT_EQ(json["health"], "healthy");
   }
   /**
@@ -248,4 +249,170 @@ namespace octane::internal {
     EXPECT_EQ(response.get().statusCode, 200);
     EXPECT_EQ(response.get().mime, "text/html");
   }
+  /**
+   * @brief downloadがリダイレクト先のボディ部だけを、HttpClientが渡さなかった残りも含めてobserverに渡すかをテストする。
+   *
+   */
+  TEST(FetchTest, DownloadObservesBody) {
+    octane::test::MockHttpClient mockHttpClient;
+    EXPECT_CALL(mockHttpClient, init())
+      .Times(1)
+      .WillOnce(testing::Return(ok()));
+
+    const std::string moved = "moved";
+    HttpResponse httpResponse{
+      .statusCode  = 301,
+      .statusLine  = "HTTP/2 301 Moved Permanently",
+      .version     = HttpVersion::Http2,
+      .headerField = { { "Location", "/api/v1/room/1/content" } },
+      .body        = std::vector<std::uint8_t>(moved.begin(), moved.end()),
+    };
+    const std::string content = "0123456789";
+    HttpResponse httpResponse2{
+      .statusCode  = 200,
+      .statusLine  = "HTTP/2 200 OK",
+      .version     = HttpVersion::Http2,
+      .headerField = { { "Content-Type", "application/octet-stream" } },
+      .body        = std::vector<std::uint8_t>(content.begin(), content.end()),
+    };
+
+    testing::InSequence sequence;
+    EXPECT_CALL(mockHttpClient, request(testing::_, testing::_))
+      .WillOnce(testing::Return(ok(httpResponse)));
+    // 受信中に前半だけを渡し、残りをレスポンスに格納するHttpClientを模す。
+    EXPECT_CALL(mockHttpClient, request(testing::_, testing::_))
+      .WillOnce([&](std::string_view, const HttpRequest& request)
+                  -> Result<HttpResponse, ErrorResponse> {
+        EXPECT_NE(request.bodyObserver, nullptr);
+        (*request.bodyObserver)(
+          std::span<const std::uint8_t>(httpResponse2.body).first(4));
+        httpResponse2.body.erase(httpResponse2.body.begin(),
+                                 httpResponse2.body.begin() + 4);
+        return ok(httpResponse2);
+      });
+
+    Fetch fetch("mock", "http://localhost:3000", "/api/v1", &mockHttpClient);
+    EXPECT_TRUE(fetch.init());
+
+    std::vector<std::string> chunks;
+    auto response = fetch.download(
+      "/room/1/content", [&](std::span<const std::uint8_t> chunk) {
+        chunks.emplace_back(chunk.begin(), chunk.end());
+      });
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response.get().statusCode, 200);
+    EXPECT_EQ(chunks, (std::vector<std::string>{ "0123", "456789" }));
+    // observerに渡したボディ部は返り値に残さない。
+    EXPECT_TRUE(std::get<std::vector<std::uint8_t>>(response.get().body).empty());
+  }
+  /**
+   * @brief revalidateが前回の2xxのレスポンスの検証子を条件付きリクエストのヘッダとして送るかをテストする。
+   *
+   */
+  TEST(FetchTest, RevalidateSendsValidators) {
+    octane::test::MockHttpClient mockHttpClient;
+    EXPECT_CALL(mockHttpClient, init())
+      .Times(1)
+      .WillOnce(testing::Return(ok()));
+
+    const std::string body = R"({"id": 1, "name": "room", "devices": []})";
+    HttpResponse modified{
+      .statusCode  = 200,
+      .statusLine  = "HTTP/2 200 OK",
+      .version     = HttpVersion::Http2,
+      .headerField = { { "content-type", "application/json" },
+                       { "etag", "\"v1\"" },
+                       { "last-modified", "Wed, 21 Oct 2015 07:28:00 GMT" } },
+      .body        = std::vector<std::uint8_t>(body.begin(), body.end()),
+    };
+    HttpResponse notModified{
+      .statusCode  = 304,
+      .statusLine  = "HTTP/2 304",
+      .version     = HttpVersion::Http2,
+      .headerField = { { "etag", "\"v1\"" } },
+      .body        = {},
+    };
+
+    testing::InSequence sequence;
+    EXPECT_CALL(mockHttpClient, request(testing::_, testing::_))
+      .WillOnce([&](std::string_view, const HttpRequest& request)
+                  -> Result<HttpResponse, ErrorResponse> {
+        EXPECT_FALSE(request.headerField.contains("If-None-Match"));
+        return ok(modified);
+      });
+    EXPECT_CALL(mockHttpClient, request(testing::_, testing::_))
+      .Times(2)
+      .WillRepeatedly([&](std::string_view, const HttpRequest& request)
+                        -> Result<HttpResponse, ErrorResponse> {
+        EXPECT_EQ(request.headerField.at("If-None-Match"), "\"v1\"");
+        EXPECT_EQ(request.headerField.at("If-Modified-Since"),
+                  "Wed, 21 Oct 2015 07:28:00 GMT");
+        return ok(notModified);
+      });
+    EXPECT_CALL(mockHttpClient, request(testing::_, testing::_))
+      .WillOnce([&](std::string_view, const HttpRequest& request)
+                  -> Result<HttpResponse, ErrorResponse> {
+        EXPECT_FALSE(request.headerField.contains("If-None-Match"));
+        return ok(modified);
+      });
+
+    Fetch fetch("mock", "http://localhost:3000", "/api/v1", &mockHttpClient);
+    EXPECT_TRUE(fetch.init());
+
+    auto first = fetch.revalidate("/room/1");
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first.get().statusCode, 200);
+    EXPECT_EQ(*first.get().findHeader("ETag"), "\"v1\"");
+    // 304は検証子を変えないので、続けて送っても同じ検証子が付く。
+    for (int i = 0; i < 2; ++i) {
+      auto second = fetch.revalidate("/room/1");
+      ASSERT_TRUE(second);
+      EXPECT_EQ(second.get().statusCode, 304);
+      // 304に含まれない検証子は、送ったもので補われる。
+      EXPECT_EQ(*second.get().findHeader("Last-Modified"),
+                "Wed, 21 Oct 2015 07:28:00 GMT");
+    }
+    fetch.forgetValidators("/room/1");
+    EXPECT_TRUE(fetch.revalidate("/room/1"));
+  }
+  /**
+   * @brief 検証子の数が上限に達したとき、最も古く覚えたものから捨てるかをテストする。
+   *
+   */
+  TEST(FetchTest, EvictsOldestValidators) {
+    octane::test::MockHttpClient mockHttpClient;
+    EXPECT_CALL(mockHttpClient, init())
+      .Times(1)
+      .WillOnce(testing::Return(ok()));
+
+    const std::string body = R"({"id": 1, "name": "room", "devices": []})";
+    std::map<std::string, bool> sentValidators;
+    EXPECT_CALL(mockHttpClient, request(testing::_, testing::_))
+      .WillRepeatedly([&](std::string_view, const HttpRequest& request)
+                        -> Result<HttpResponse, ErrorResponse> {
+        sentValidators[request.uri]
+          = request.headerField.contains("If-None-Match");
+        return ok(HttpResponse{
+          .statusCode  = 200,
+          .statusLine  = "HTTP/2 200 OK",
+          .version     = HttpVersion::Http2,
+          .headerField = { { "content-type", "application/json" },
+                           { "etag", "\"v1\"" } },
+          .body        = std::vector<std::uint8_t>(body.begin(), body.end()),
+        });
+      });
+
+    Fetch fetch("mock", "http://localhost:3000", "/api/v1", &mockHttpClient);
+    EXPECT_TRUE(fetch.init());
+
+    // 辞書順では最後になるURLを最初に覚える。
+    ASSERT_TRUE(fetch.revalidate("/room/999"));
+    for (int i = 1; i <= 256; ++i) {
+      ASSERT_TRUE(fetch.revalidate("/room/" + std::to_string(i)));
+    }
+    ASSERT_TRUE(fetch.revalidate("/room/1"));
+    EXPECT_TRUE(sentValidators.at("/api/v1/room/1"));
+    ASSERT_TRUE(fetch.revalidate("/room/999"));
+    EXPECT_FALSE(sentValidators.at("/api/v1/room/999"));
+  }
 } // namespace octane::internal
\ No newline at end of file
@@ -52,4 +52,29 @@ namespace octane::internal {
     std::copy(message.begin(), message.end(), src.begin());
     EXPECT_EQ(generateHash(src), digest);
   }
+  /**
+   * @brief 分割して渡したデータのハッシュ値が、まとめて計算した場合と一致するかをテストする。
+   *
+   */
+  TEST(HashTest, HasherMatchesGenerateHash) {
+    std::string message = "Impossible is nothing.";
+    std::string digest
+      = "a61ad9c914a0a68c50c5f87537ae152c6d233ebb79ad321ad3e89787d7279aa2";
+
+    std::vector<std::uint8_t> src(message.begin(), message.end());
+    const std::span<const std::uint8_t> data(src);
+    for (std::size_t split = 0; split <= data.size(); ++split) {
+      Hasher hasher;
+      hasher.update(data.first(split));
+      hasher.update(data.subspan(split));
+      EXPECT_EQ(hasher.finish(), digest) << "split at " << split;
+    }
+
+    // finishの後は何も渡していない状態に戻る。
+    Hasher hasher;
+    hasher.update(data);
+    EXPECT_EQ(hasher.finish(), digest);
+    hasher.update(data);
+    EXPECT_EQ(hasher.finish(), digest);
+  }
 } // namespace octane::internal
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "include/internal/health_monitor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "include/error_code.h"
+
+using namespace std::chrono_literals;
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief テスト用の短い更新間隔。
+     *
+     */
+    HealthMonitorOptions testOptions() {
+      return HealthMonitorOptions{
+        .ttl              = 200ms,
+        .refreshAhead     = 150ms,
+        .degradedInterval = 20ms,
+        .retryInterval    = 20ms,
+      };
+    }
+    /**
+     * @brief 条件が満たされるまで最大timeoutだけ待つ。
+     *
+     */
+    template <typename F>
+    bool waitFor(F&& condition,
+                 std::chrono::milliseconds timeout = 2000ms) {
+      const auto deadline = std::chrono::steady_clock::now() + timeout;
+      while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) return true;
+        std::this_thread::sleep_for(1ms);
+      }
+      return condition();
+    }
+  } // namespace
+
+  /**
+   * @brief 有効な結果がある間はヘルスチェックを行わないかをテストする。
+   *
+   */
+  TEST(HealthMonitorTest, ResultIsCached) {
+    std::atomic<int> calls = 0;
+    HealthMonitor monitor(
+      [&]() -> Result<HealthResult, ErrorResponse> {
+        ++calls;
+        return ok(HealthResult{ .health = Health::Healthy });
+      },
+      HealthMonitorOptions{});
+
+    for (int i = 0; i < 100; ++i) {
+      auto result = monitor.current();
+      ASSERT_TRUE(result) << result.err();
+      EXPECT_EQ(result.get().health, Health::Healthy);
+    }
+    EXPECT_EQ(calls.load(), 1);
+  }
+  /**
+   * @brief 期限が切れる前にバックグラウンドで更新されるかをテストする。
+   *
+   */
+  TEST(HealthMonitorTest, RefreshesBeforeExpiry) {
+    std::atomic<int> calls = 0;
+    HealthMonitor monitor(
+      [&]() -> Result<HealthResult, ErrorResponse> {
+        ++calls;
+        return ok(HealthResult{ .health = Health::Healthy });
+      },
+      testOptions());
+
+    ASSERT_TRUE(monitor.current());
+    const auto first = monitor.peek();
+    ASSERT_NE(first, nullptr);
+
+    ASSERT_TRUE(waitFor([&] { return calls.load() >= 2; }));
+    const auto second = monitor.peek();
+    ASSERT_NE(second, nullptr);
+    EXPECT_LT(first->checkedAt, second->checkedAt);
+    // 更新は期限が切れる前に行われる。
+    EXPECT_LT(second->checkedAt, first->expiresAt);
+  }
+  /**
+   * @brief Degradedのときは短い間隔で更新されるかをテストする。
+   *
+   */
+  TEST(HealthMonitorTest, DegradedRefreshesFaster) {
+    std::atomic<int> calls = 0;
+    HealthMonitor monitor(
+      [&]() -> Result<HealthResult, ErrorResponse> {
+        ++calls;
+        return ok(HealthResult{ .health = Health::Degraded });
+      },
+      testOptions());
+
+    ASSERT_TRUE(monitor.current());
+    const auto snapshot = monitor.peek();
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->nextRefreshAt - snapshot->checkedAt, 20ms);
+    ASSERT_TRUE(waitFor([&] { return calls.load() >= 3; }));
+  }
+  /**
+   * @brief 失敗した結果がキャッシュされないかをテストする。
+   *
+   */
+  TEST(HealthMonitorTest, FailureIsNotCached) {
+    std::atomic<int> calls = 0;
+    HealthMonitor monitor(
+      [&]() -> Result<HealthResult, ErrorResponse> {
+        if (++calls == 1) {
+          return makeError(ERR_CURL_CONNECTION_FAILED, "Connection failed.");
+        }
+        return ok(HealthResult{ .health = Health::Healthy });
+      },
+      HealthMonitorOptions{});
+
+    auto failed = monitor.current();
+    ASSERT_FALSE(failed);
+    EXPECT_EQ(failed.err().code, ERR_CURL_CONNECTION_FAILED);
+    EXPECT_EQ(monitor.peek(), nullptr);
+
+    auto result = monitor.current();
+    ASSERT_TRUE(result) << result.err();
+    EXPECT_EQ(calls.load(), 2);
+  }
+  /**
+   * @brief 同じキーに対して同じインスタンスが返されるかをテストする。
+   *
+   */
+  TEST(HealthMonitorTest, SharedPerKey) {
+    int created      = 0;
+    const auto probe = [&] {
+      ++created;
+      return HealthMonitor::Probe([]() -> Result<HealthResult, ErrorResponse> {
+        return ok(HealthResult{ .health = Health::Healthy });
+      });
+    };
+
+    auto a = HealthMonitor::shared("https://a.example.com/api", probe);
+    auto b = HealthMonitor::shared("https://a.example.com/api", probe);
+    auto c = HealthMonitor::shared("https://b.example.com/api", probe);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(created, 2);
+
+    // 全ての参照がなくなれば、次は新しいインスタンスが作成される。
+    a.reset();
+    b.reset();
+    auto d = HealthMonitor::shared("https://a.example.com/api", probe);
+    EXPECT_EQ(created, 3);
+  }
+} // namespace octane::internal
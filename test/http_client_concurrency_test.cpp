@@ -0,0 +1,184 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/error_code.h"
+#include "include/internal/http_client.h"
+
+// 実際のHttpClientを、ループバックのサーバに対して多数のスレッドから同時に使う。
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief リクエストのパスをボディとして返す、キープアライブに対応したHTTPサーバ。
+     *
+     */
+    class EchoServer {
+      int listener = -1;
+      std::thread acceptor;
+      std::mutex mutex;
+      std::vector<int> clients;
+      std::vector<std::thread> workers;
+
+      static void serve(int connection) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+          const auto end = buffer.find("\r\n\r\n");
+          if (end == std::string::npos) {
+            const auto n = ::read(connection, chunk, sizeof(chunk));
+            if (n <= 0) return;
+            buffer.append(chunk, n);
+            continue;
+          }
+          // "GET /path HTTP/1.1"
+          const auto first  = buffer.find(' ');
+          const auto second = buffer.find(' ', first + 1);
+          const auto path   = buffer.substr(first + 1, second - first - 1);
+          buffer.erase(0, end + 4);
+
+          const std::string response
+            = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+              "Content-Length: "
+            + std::to_string(path.size()) + "\r\n\r\n" + path;
+          std::size_t written = 0;
+          while (written < response.size()) {
+            const auto n = ::write(connection,
+                                   response.data() + written,
+                                   response.size() - written);
+            if (n <= 0) return;
+            written += n;
+          }
+        }
+      }
+
+    public:
+      std::uint16_t port = 0;
+      std::atomic<std::size_t> connections = 0;
+
+      EchoServer() {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port        = 0;
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener, 64);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        port     = ntohs(address.sin_port);
+        acceptor = std::thread([this] {
+          while (true) {
+            const int connection = ::accept(listener, nullptr, nullptr);
+            if (connection < 0) return;
+            ++connections;
+            std::lock_guard lock(mutex);
+            clients.push_back(connection);
+            workers.emplace_back([connection] { serve(connection); });
+          }
+        });
+      }
+      ~EchoServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        acceptor.join();
+        for (const auto client : clients) {
+          ::shutdown(client, SHUT_RDWR);
+        }
+        for (auto& worker : workers) {
+          worker.join();
+        }
+        for (const auto client : clients) {
+          ::close(client);
+        }
+        ::close(listener);
+      }
+      std::string origin() const {
+        return "http://127.0.0.1:" + std::to_string(port);
+      }
+    };
+
+    HttpRequest echoRequest(const std::string& uri) {
+      return HttpRequest{
+        .method      = HttpMethod::Get,
+        .version     = HttpVersion::Http1_1,
+        .uri         = uri,
+        .headerField = {},
+        .body        = {},
+      };
+    }
+    std::string bodyOf(const HttpResponse& response) {
+      return std::string(response.body.begin(), response.body.end());
+    }
+  } // namespace
+
+  /**
+   * @brief 同期と非同期のリクエストを多数のスレッドから同時に発行しても、
+   * 全て自身のレスポンスを受け取り、接続が再利用されるかをテストする。
+   *
+   */
+  TEST(HttpClientConcurrencyTest, ConcurrentRequests) {
+    constexpr int THREADS    = 8;
+    constexpr int ITERATIONS = 20;
+    EchoServer server;
+    HttpClient client;
+    ASSERT_TRUE(client.init());
+
+    std::atomic<int> failures = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < ITERATIONS; ++i) {
+          const auto uri
+            = "/echo/" + std::to_string(t) + "/" + std::to_string(i);
+
+          const auto request = echoRequest(uri + "/sync");
+          auto response      = client.request(server.origin(), request);
+          if (!response || response.get().statusCode != 200
+              || bodyOf(response.get()) != uri + "/sync") {
+            ++failures;
+          }
+
+          // 非同期のリクエストはI/Oスレッドで、同期のリクエストと同時に通信する。
+          const auto asyncRequest = echoRequest(uri + "/async");
+          // 待つのを諦めた後に完了しても壊れないように、promiseは共有する。
+          auto promise = std::make_shared<
+            std::promise<Result<HttpResponse, ErrorResponse>>>();
+          auto future = promise->get_future();
+          client.requestAsync(
+            server.origin(),
+            asyncRequest,
+            {},
+            [promise](Result<HttpResponse, ErrorResponse> result) {
+              promise->set_value(std::move(result));
+            });
+          if (future.wait_for(std::chrono::seconds(10))
+              != std::future_status::ready) {
+            ++failures;
+            continue;
+          }
+          auto asyncResponse = future.get();
+          if (!asyncResponse || asyncResponse.get().statusCode != 200
+              || bodyOf(asyncResponse.get()) != uri + "/async") {
+            ++failures;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    // 同期のハンドルと、マルチハンドルがそれぞれ同時に使う数だけ接続する。
+    EXPECT_LE(server.connections.load(), THREADS * 2);
+  }
+} // namespace octane::internal
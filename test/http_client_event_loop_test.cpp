@@ -0,0 +1,261 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "include/error_code.h"
+#include "include/internal/http_client.h"
+
+using namespace std::chrono_literals;
+
+// アプリケーションのイベントループからHttpClientを駆動する。
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief poll(2)で実装した単一スレッドのイベントループ。
+     *
+     */
+    class PollLoop : public EventLoop {
+    public:
+      std::map<NativeSocket, SocketEvents> sockets;
+      std::optional<std::chrono::steady_clock::time_point> deadline;
+      std::thread::id thread = std::this_thread::get_id();
+      std::atomic<std::size_t> foreignCalls = 0;
+
+      virtual void watchSocket(NativeSocket socket,
+                               SocketEvents events) override {
+        if (std::this_thread::get_id() != thread) ++foreignCalls;
+        if (events == SocketEvents::None) {
+          sockets.erase(socket);
+        } else {
+          sockets[socket] = events;
+        }
+      }
+      virtual void setTimer(
+        std::optional<std::chrono::milliseconds> timeout) override {
+        if (std::this_thread::get_id() != thread) ++foreignCalls;
+        if (timeout) {
+          deadline = std::chrono::steady_clock::now() + timeout.value();
+        } else {
+          deadline.reset();
+        }
+      }
+
+      /**
+       * @brief doneがtrueを返すか、limitを過ぎるまでイベントを処理する。
+       *
+       */
+      template <typename F>
+      bool runUntil(HttpClient& client,
+                    F&& done,
+                    std::chrono::milliseconds limit = 10s) {
+        const auto end = std::chrono::steady_clock::now() + limit;
+        while (!done()) {
+          const auto now = std::chrono::steady_clock::now();
+          if (now >= end) return false;
+          auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            end - now);
+          if (deadline) {
+            wait = std::min(
+              wait,
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::max(deadline.value() - now,
+                         std::chrono::steady_clock::duration::zero())));
+          }
+
+          std::vector<pollfd> fds;
+          for (const auto& [socket, events] : sockets) {
+            short mask = 0;
+            if ((events & SocketEvents::Read) != SocketEvents::None) {
+              mask |= POLLIN;
+            }
+            if ((events & SocketEvents::Write) != SocketEvents::None) {
+              mask |= POLLOUT;
+            }
+            fds.push_back(pollfd{ .fd = socket, .events = mask, .revents = 0 });
+          }
+          ::poll(fds.data(), fds.size(), static_cast<int>(wait.count()));
+
+          for (const auto& fd : fds) {
+            auto events = SocketEvents::None;
+            if (fd.revents & (POLLIN | POLLHUP | POLLERR)) {
+              events = events | SocketEvents::Read;
+            }
+            if (fd.revents & POLLOUT) {
+              events = events | SocketEvents::Write;
+            }
+            if (events != SocketEvents::None) {
+              client.onSocketEvent(fd.fd, events);
+            }
+          }
+          if (deadline && std::chrono::steady_clock::now() >= deadline.value()) {
+            deadline.reset();
+            client.onTimeout();
+          }
+        }
+        return true;
+      }
+    };
+
+    /**
+     * @brief 一つの接続だけを受け付ける最小限のHTTPサーバ。
+     * @details
+     * respondがfalseの場合は、接続を受け付けた後に何も返さない。
+     */
+    class OneShotServer {
+      int listener = -1;
+      std::thread thread;
+
+    public:
+      std::uint16_t port = 0;
+
+      explicit OneShotServer(bool respond) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port        = 0;
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener, 1);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        port   = ntohs(address.sin_port);
+        thread = std::thread([this, respond] {
+          const int connection = ::accept(listener, nullptr, nullptr);
+          if (connection < 0) return;
+          std::string request;
+          char buffer[1024];
+          while (request.find("\r\n\r\n") == std::string::npos) {
+            const auto n = ::read(connection, buffer, sizeof(buffer));
+            if (n <= 0) break;
+            request.append(buffer, n);
+          }
+          if (respond) {
+            const std::string body = R"({"health":"healthy"})";
+            const std::string response
+              = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                "Content-Length: "
+              + std::to_string(body.size()) + "\r\n\r\n" + body;
+            [[maybe_unused]] auto written
+              = ::write(connection, response.data(), response.size());
+          } else {
+            // クライアントが切断するまで待つ。
+            while (::read(connection, buffer, sizeof(buffer)) > 0) {}
+          }
+          ::close(connection);
+        });
+      }
+      ~OneShotServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        thread.join();
+        ::close(listener);
+      }
+      std::string origin() const {
+        return "http://127.0.0.1:" + std::to_string(port);
+      }
+    };
+
+    HttpRequest healthRequest() {
+      return HttpRequest{
+        .method      = HttpMethod::Get,
+        .version     = HttpVersion::Http1_1,
+        .uri         = "/api/v1/health",
+        .headerField = {},
+        .body        = {},
+      };
+    }
+  } // namespace
+
+  /**
+   * @brief イベントループから駆動したリクエストが、ループのスレッドで完了するかをテストする。
+   *
+   */
+  TEST(HttpClientEventLoopTest, CompletesOnLoopThread) {
+    OneShotServer server(true);
+    PollLoop loop;
+    HttpClient client(loop);
+    ASSERT_TRUE(client.init());
+
+    const auto request = healthRequest();
+    std::optional<Result<HttpResponse, ErrorResponse>> response;
+    std::thread::id completedOn;
+    client.requestAsync(server.origin(),
+                        request,
+                        {},
+                        [&](Result<HttpResponse, ErrorResponse> result) {
+                          completedOn = std::this_thread::get_id();
+                          response.emplace(std::move(result));
+                        });
+    ASSERT_TRUE(loop.runUntil(client, [&] { return response.has_value(); }));
+    ASSERT_TRUE(response.value()) << response.value().err().reason;
+    EXPECT_EQ(response.value().get().statusCode, 200);
+    EXPECT_EQ(completedOn, std::this_thread::get_id());
+    EXPECT_EQ(loop.foreignCalls.load(), 0u);
+    // 完了した後はタイマーが解除される。
+    EXPECT_FALSE(loop.deadline.has_value());
+  }
+  /**
+   * @brief 応答のないリクエストをキャンセルしたときに、タイマーで検出されるかをテストする。
+   *
+   */
+  TEST(HttpClientEventLoopTest, CancelInFlight) {
+    OneShotServer server(false);
+    PollLoop loop;
+    HttpClient client(loop);
+    ASSERT_TRUE(client.init());
+
+    const auto request = healthRequest();
+    CancellationSource source;
+    std::optional<Result<HttpResponse, ErrorResponse>> response;
+    client.requestAsync(server.origin(),
+                        request,
+                        source.token(),
+                        [&](Result<HttpResponse, ErrorResponse> result) {
+                          response.emplace(std::move(result));
+                        });
+    // 接続が確立するまで進めてからキャンセルする。
+    loop.runUntil(
+      client, [] { return false; }, 200ms);
+    ASSERT_FALSE(response.has_value());
+    source.cancel();
+    ASSERT_TRUE(loop.runUntil(client, [&] { return response.has_value(); }));
+    ASSERT_FALSE(response.value());
+    EXPECT_EQ(response.value().err().code, ERR_CANCELLED);
+  }
+  /**
+   * @brief 通信中の同期のリクエストにも、後から設定した期限が適用されるかをテストする。
+   *
+   */
+  TEST(HttpClientEventLoopTest, TimeoutAppliesToRequestInFlight) {
+    OneShotServer server(false);
+    PollLoop loop;
+    HttpClient client(loop);
+    ASSERT_TRUE(client.init());
+
+    const auto request = healthRequest();
+    std::atomic<bool> finished = false;
+    std::optional<Result<HttpResponse, ErrorResponse>> response;
+    std::thread requester([&] {
+      response.emplace(client.request(server.origin(), request));
+      finished = true;
+    });
+    std::this_thread::sleep_for(200ms);
+    EXPECT_FALSE(finished.load());
+    const auto start = std::chrono::steady_clock::now();
+    client.setRequestTimeout(100ms);
+    requester.join();
+    // CURLは少なくとも1秒ごとに期限を確かめる。
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+    ASSERT_FALSE(response.value());
+    EXPECT_EQ(response.value().err().code, ERR_CURL_CONNECTION_FAILED);
+  }
+} // namespace octane::internal
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <future>
+
 #include "include/error_code.h"
 
 namespace octane::internal {
@@ -20,7 +22,7 @@ namespace octane::internal {
       .version     = HttpVersion::Http2,
       .uri         = "/api/v1/health",
       .headerField = {},
-      .body        = &body,
+      .body        = body,
     };
     auto response = client.request("http://localhost:3000", request);
     EXPECT_FALSE(response);
@@ -42,7 +44,7 @@ namespace octane::internal {
       .version     = HttpVersion::Http2,
       .uri         = "/api/v1/health",
       .headerField = {},
-      .body        = &body,
+      .body        = body,
     };
     auto response = client.request("http://localhost:3000", request);
     EXPECT_FALSE(response);
@@ -84,7 +86,7 @@ namespace octane::internal {
     std::vector<std::uint8_t> body;
     for (auto c : str) body.push_back(c);
 
-    std::pair<const std::vector<std::uint8_t>*, size_t> stream{ &body, 0 };
+    std::pair<std::span<const std::uint8_t>, size_t> stream{ body, 0 };
 
     std::string buffer;
     buffer.resize(30);
@@ -134,6 +136,31 @@ namespace octane::internal {
     EXPECT_EQ(responseHeaderField["Content-Type"], "text/html; charset=utf-8");
     EXPECT_EQ(responseHeaderField["Content-Length"], "500");
   }
+  /**
+   * @brief Content-Lengthから確保する大きさに上限があり、不正な値でも失敗しないかをテストする。
+   *
+   */
+  TEST(HttpClientTest, ReserveFromContentLength) {
+    char buffer[] = "ABCDEFGHIJ";
+    for (const auto [length, expected] :
+         { std::pair<std::string, size_t>{ "500", 500 },
+           { "99999999999999", HttpClient::MAX_RESERVED_BODY_SIZE },
+           { "invalid", 0 } }) {
+      HttpResponse response;
+      for (std::string header :
+           { std::string("HTTP/1.1 200 OK\r\n"),
+             "Content-Length: " + length + "\r\n" }) {
+        HttpClient::headerCallback(
+          header.data(), 1, header.size(), &response);
+      }
+      EXPECT_TRUE(response.body.empty());
+
+      ASSERT_EQ(HttpClient::writeCallback(buffer, 1, 10, &response), 10);
+      EXPECT_GE(response.body.capacity(), std::max<size_t>(expected, 10));
+      EXPECT_LE(response.body.capacity(),
+                std::max<size_t>(HttpClient::MAX_RESERVED_BODY_SIZE, 10));
+    }
+  }
   /**
    * @brief HttpClient::makeHttpResponseが正常に動作するかをテストする。
    *
@@ -184,4 +211,89 @@ namespace octane::internal {
     EXPECT_FALSE(result) << result.get();
     EXPECT_EQ(result.err().code, ERR_INVALID_RESPONSE) << result.err().code;
   }
-} // namespace octane::internal
\ No newline at end of file
+  /**
+   * @brief CURLのハンドルがリクエストごとに作成されず、プールから再利用されるかをテストする。
+   *
+   */
+  TEST(HttpClientTest, HandlesAreReused) {
+    HttpClient client;
+    client.init();
+
+    HttpRequest request{
+      .method      = HttpMethod::Get,
+      .version     = HttpVersion::Http2,
+      .uri         = "/api/v1/health",
+      .headerField = {},
+      .body        = {},
+    };
+    const auto handle = client.acquire();
+    ASSERT_NE(handle, nullptr);
+    client.release(handle);
+
+    // 対応していないスキームなので通信は行われずに失敗する。
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_FALSE(client.request("unsupported://localhost", request));
+    }
+
+    const auto reused = client.acquire();
+    EXPECT_EQ(reused, handle);
+    client.release(reused);
+  }
+  /**
+   * @brief 非同期のリクエストが失敗したときに、コールバックにエラーが渡されるかをテストする。
+   *
+   */
+  TEST(HttpClientTest, RequestAsyncReportsFailure) {
+    HttpClient client;
+    client.init();
+
+    HttpRequest request{
+      .method      = HttpMethod::Get,
+      .version     = HttpVersion::Http2,
+      .uri         = "/api/v1/health",
+      .headerField = {},
+      .body        = {},
+    };
+    std::promise<Result<HttpResponse, ErrorResponse>> promise;
+    auto future = promise.get_future();
+    client.requestAsync("unsupported://localhost",
+                        request,
+                        {},
+                        [&](Result<HttpResponse, ErrorResponse> response) {
+                          promise.set_value(std::move(response));
+                        });
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)),
+              std::future_status::ready);
+    auto response = future.get();
+    ASSERT_FALSE(response);
+    EXPECT_EQ(response.err().code, ERR_CURL_CONNECTION_FAILED);
+  }
+  /**
+   * @brief キャンセル済みのトークンを渡したときに、通信せずにERR_CANCELLEDとなるかをテストする。
+   *
+   */
+  TEST(HttpClientTest, RequestAsyncWithCancelledToken) {
+    HttpClient client;
+    client.init();
+
+    HttpRequest request{
+      .method      = HttpMethod::Get,
+      .version     = HttpVersion::Http2,
+      .uri         = "/api/v1/health",
+      .headerField = {},
+      .body        = {},
+    };
+    CancellationSource source;
+    source.cancel();
+    std::optional<Result<HttpResponse, ErrorResponse>> response;
+    client.requestAsync("http://localhost:3000",
+                        request,
+                        source.token(),
+                        [&](Result<HttpResponse, ErrorResponse> result) {
+                          response.emplace(std::move(result));
+                        });
+    ASSERT_TRUE(response.has_value());
+    ASSERT_FALSE(response.value());
+    EXPECT_EQ(response.value().err().code, ERR_CANCELLED);
+  }
+} // namespace octane::internal
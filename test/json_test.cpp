@@ -0,0 +1,123 @@
+#include "include/internal/json.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "include/error_code.h"
+
+namespace octane::internal {
+  /**
+   * @brief 各型の値が正しくパースされるかをテストする。
+   *
+   */
+  TEST(JsonTest, ParseValues) {
+    auto result = parseJson(R"(
+      {
+        "null": null,
+        "bool": true,
+        "uint": 7040782538,
+        "max": 18446744073709551615,
+        "int": -12,
+        "double": 0.5,
+        "string": "soon's \"room\"\n",
+        "array": [1, "two", false],
+        "object": { "nested": {} }
+      }
+    )");
+    ASSERT_TRUE(result) << result.err();
+    const auto& json = result.get();
+
+    ASSERT_TRUE(json.isObject());
+    EXPECT_TRUE(json["null"].isNull());
+    EXPECT_TRUE(json["bool"].getBool());
+    EXPECT_EQ(json["uint"].getUint64(), 7040782538u);
+    EXPECT_EQ(json["max"].getUint64(),
+              std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(json["int"].getInt64(), -12);
+    EXPECT_DOUBLE_EQ(json["double"].getDouble(), 0.5);
+    EXPECT_EQ(json["string"].getString(), "soon's \"room\"\n");
+
+    const auto& array = json["array"].getArray();
+    ASSERT_EQ(array.size(), 3u);
+    EXPECT_EQ(array[0], 1);
+    EXPECT_EQ(array[1], "two");
+    EXPECT_EQ(array[2], false);
+
+    EXPECT_TRUE(json["object"]["nested"].isObject());
+    EXPECT_FALSE(json.hasMember("missing"));
+    EXPECT_EQ(json.find("missing"), nullptr);
+  }
+  /**
+   * @brief 0以上の整数が常に符号なし整数として表現されるかをテストする。
+   *
+   */
+  TEST(JsonTest, NonNegativeIntegerIsUnsigned) {
+    EXPECT_TRUE(Json(0).isUint64());
+    EXPECT_TRUE(Json(std::int64_t(42)).isUint64());
+    EXPECT_TRUE(Json(-1).isInt64());
+    EXPECT_EQ(Json(std::int64_t(42)), Json(std::uint64_t(42)));
+    EXPECT_TRUE(parseJson("0").get().isUint64());
+  }
+  /**
+   * @brief 不正なJSONを与えたときにエラーを返すかをテストする。
+   *
+   */
+  TEST(JsonTest, ParseError) {
+    for (const auto text : {
+           "I am not a JSON!!!!",
+           R"({"health": )",
+           R"({"health": "healthy"} trailing)",
+           "",
+         }) {
+      auto result = parseJson(text);
+      ASSERT_FALSE(result) << text;
+      EXPECT_EQ(result.err().code, ERR_JSON_PARSE_FAILED);
+    }
+  }
+  /**
+   * @brief 末尾のゼロ終端がドキュメントの終わりとして扱われるかをテストする。
+   *
+   */
+  TEST(JsonTest, TrailingNullTerminator) {
+    constexpr char text[] = R"({"health": "healthy"})";
+    auto result           = parseJson(std::string_view(text, sizeof(text)));
+    ASSERT_TRUE(result) << result.err();
+    EXPECT_EQ(result.get()["health"], "healthy");
+  }
+  /**
+   * @brief 組み立てたJSONを文字列に変換し、再度パースしたときに一致するかをテストする。
+   *
+   */
+  TEST(JsonTest, StringifyRoundTrip) {
+    auto devices = Json::array();
+    devices.push(Json::object().set("name", "a").set("timestamp", 1));
+    devices.push(Json::object().set("name", "b\t\x01").set("timestamp", -1));
+    auto json = Json::object()
+                  .set("id", std::uint64_t(7040782538))
+                  .set("name", "soon's room")
+                  .set("ratio", 0.25)
+                  .set("devices", std::move(devices))
+                  .set("none", nullptr);
+
+    EXPECT_EQ(
+      json.stringify(),
+      R"({"id":7040782538,"name":"soon's room","ratio":0.25,"devices":[{"name":"a","timestamp":1},{"name":"b\t\u0001","timestamp":-1}],"none":null})");
+
+    auto parsed = parseJson(json.stringify());
+    ASSERT_TRUE(parsed) << parsed.err();
+    EXPECT_EQ(parsed.get(), json);
+  }
+  /**
+   * @brief オブジェクトの比較がメンバの順序に依存しないかをテストする。
+   *
+   */
+  TEST(JsonTest, ObjectEqualityIgnoresOrder) {
+    auto a = Json::object().set("x", 1).set("y", "z");
+    auto b = Json::object().set("y", "z").set("x", 1);
+    EXPECT_EQ(a, b);
+    b.set("x", 2);
+    EXPECT_NE(a, b);
+    EXPECT_NE(a, Json::object().set("x", 1));
+  }
+} // namespace octane::internal
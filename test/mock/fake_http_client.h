@@ -0,0 +1,199 @@
+#ifndef OCTANE_API_CLIENT_TEST_MOCK_FAKE_HTTP_CLIENT_H_
+#define OCTANE_API_CLIENT_TEST_MOCK_FAKE_HTTP_CLIENT_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "include/internal/hash.h"
+#include "include/internal/http_client.h"
+#include "include/internal/json.h"
+
+namespace octane::test {
+  /**
+   * @brief メモリ上でOctaneServerを模倣する、スレッドセーフなHttpClientBaseの実装。
+   * @details
+   * 全てのルームは常に存在し、コンテンツは固定のクリップボードを返す。
+   * 接続・切断のリクエストでは、デバイス名が"device-<ルームのid>"であるかを検査する。
+   * ルームとコンテンツの状態のGETにはETagを付け、If-None-Matchが一致すれば304を返す。
+   * gmockのモックと異なり、多数のスレッドから大量に呼び出すことを想定している。
+   *
+   */
+  class FakeHttpClient : public internal::HttpClientBase {
+    std::string baseUrl;
+    std::chrono::microseconds latency;
+
+  public:
+    /** @brief 受け取ったリクエストの数。*/
+    std::atomic<std::size_t> requests = 0;
+    /** @brief 受け取ったヘルスチェックの数。*/
+    std::atomic<std::size_t> healthRequests = 0;
+    /** @brief ルームのidとデバイス名が対応していない接続・切断の数。*/
+    std::atomic<std::size_t> mismatchedDevices = 0;
+    /** @brief 受け取った切断のPOSTの数。*/
+    std::atomic<std::size_t> disconnections = 0;
+    /** @brief 受け取ったルームのGETの数。*/
+    std::atomic<std::size_t> roomRequests = 0;
+    /** @brief 受け取ったコンテンツの状態のGETの数。*/
+    std::atomic<std::size_t> statusRequests = 0;
+    /** @brief 304を返したGETの数。*/
+    std::atomic<std::size_t> notModified = 0;
+    /** @brief 受け取ったコンテンツのGETの数。*/
+    std::atomic<std::size_t> contentRequests = 0;
+    /** @brief 受け取ったコンテンツのPUTの数。*/
+    std::atomic<std::size_t> contentPuts = 0;
+    /** @brief 受け取ったコンテンツの状態のPUTの数。*/
+    std::atomic<std::size_t> statusPuts = 0;
+    /** @brief 最後に受け取ったコンテンツのPUTのボディ部の先頭。コピーせずに送信されたかを調べる。*/
+    std::atomic<const std::uint8_t*> contentPutData = nullptr;
+    /** @brief コンテンツの状態として返すタイムスタンプ。更新をシミュレートするために変更する。*/
+    std::atomic<std::uint64_t> timestamp = 0;
+
+    static constexpr std::string_view CONTENT = "octane";
+
+    /**
+     * @brief /room/{id}/eventsのボディ部として返すServer-Sent Eventsを設定する。
+     * @details
+     * 空の場合は/room/{id}/eventsに404を返す。
+     */
+    void setEventStream(std::string events) {
+      std::lock_guard lock(eventsMutex);
+      eventStream = std::move(events);
+    }
+
+    explicit FakeHttpClient(std::string_view baseUrl,
+                            std::chrono::microseconds latency = {})
+      : baseUrl(baseUrl), latency(latency) {}
+
+    virtual Result<_, ErrorResponse> init() noexcept override {
+      return ok();
+    }
+
+    virtual Result<internal::HttpResponse, ErrorResponse> request(
+      std::string_view,
+      const internal::HttpRequest& request) override {
+      ++requests;
+      if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+      }
+
+      if (!request.uri.starts_with(baseUrl)) {
+        return ok(notFound());
+      }
+      const auto path = request.uri.substr(baseUrl.size());
+      if (path == "/health") {
+        ++healthRequests;
+        return ok(json(R"({"health": "healthy", "message": ""})"));
+      }
+
+      static const std::regex pattern(
+        R"(^/room/(\d+)(/status|/content|/events)?$)");
+      std::smatch match;
+      if (!std::regex_match(path, match, pattern)) {
+        return ok(notFound());
+      }
+      const auto id       = match[1].str();
+      const auto resource = match[2].str();
+
+      if (request.method == internal::HttpMethod::Get) {
+        if (resource.empty()) {
+          ++roomRequests;
+          return ok(conditional(request,
+                                "\"room-" + id + "\"",
+                                R"({"id": )" + id + R"(, "name": "room )" + id
+                                  + R"(", "devices": []})"));
+        }
+        if (resource == "/events") {
+          std::lock_guard lock(eventsMutex);
+          if (eventStream.empty()) return ok(notFound());
+          return ok(response(eventStream, "text/event-stream"));
+        }
+        if (resource == "/status") {
+          ++statusRequests;
+          const std::vector<std::uint8_t> content(CONTENT.begin(),
+                                                  CONTENT.end());
+          const auto current = std::to_string(timestamp.load());
+          return ok(conditional(
+            request,
+            "\"status-" + current + "\"",
+            R"({"device": "fake", "timestamp": )" + current
+              + R"(, "type": "clipboard", "mime": "text/plain", "hash": ")"
+              + internal::generateHash(content) + R"("})"));
+        }
+        ++contentRequests;
+        return ok(response(CONTENT, "text/plain"));
+      }
+      if (request.method == internal::HttpMethod::Put) {
+        ++(resource == "/status" ? statusPuts : contentPuts);
+        if (resource == "/content") contentPutData = request.body.data();
+      }
+      if (request.method == internal::HttpMethod::Post && resource.empty()) {
+        const auto body = std::string_view(
+          reinterpret_cast<const char*>(request.body.data()),
+          request.body.size());
+        auto parsed = internal::parseJson(body);
+        if (!parsed || parsed.get()["name"] != "device-" + id) {
+          ++mismatchedDevices;
+        }
+        if (parsed && parsed.get()["request"] == "disconnect") {
+          ++disconnections;
+        }
+      }
+      return ok(response("", ""));
+    }
+
+  private:
+    std::mutex eventsMutex;
+    std::string eventStream;
+
+    static internal::HttpResponse response(std::string_view body,
+                                           std::string_view mime,
+                                           int statusCode = 200) {
+      internal::HttpResponse response{
+        .statusCode  = statusCode,
+        .statusLine  = "HTTP/2 " + std::to_string(statusCode),
+        .version     = internal::HttpVersion::Http2,
+        .headerField = {},
+        .body        = std::vector<std::uint8_t>(body.begin(), body.end()),
+      };
+      if (!mime.empty()) {
+        response.headerField["Content-Type"] = std::string(mime);
+      }
+      return response;
+    }
+    static internal::HttpResponse json(std::string_view body) {
+      return response(body, "application/json");
+    }
+    /**
+     * @brief etagを付けたJSONのレスポンスを返す。If-None-Matchが一致すれば304を返す。
+     *
+     */
+    internal::HttpResponse conditional(const internal::HttpRequest& request,
+                                       const std::string& etag,
+                                       std::string_view body) {
+      const auto ifNoneMatch = request.headerField.find("If-None-Match");
+      if (ifNoneMatch != request.headerField.end()
+          && ifNoneMatch->second == etag) {
+        ++notModified;
+        auto notModifiedResponse = response("", "", 304);
+        notModifiedResponse.headerField["etag"] = etag;
+        return notModifiedResponse;
+      }
+      auto okResponse = json(body);
+      // HTTP/2と同じく小文字のフィールド名で返す。
+      okResponse.headerField["etag"] = etag;
+      return okResponse;
+    }
+    static internal::HttpResponse notFound() {
+      return response(R"({"code": "ERR_NOT_FOUND", "reason": ""})",
+                      "application/json",
+                      404);
+    }
+  };
+} // namespace octane::test
+
+#endif // OCTANE_API_CLIENT_TEST_MOCK_FAKE_HTTP_CLIENT_H_
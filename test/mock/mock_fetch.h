@@ -15,12 +15,16 @@ namespace octane::test {
                 (override));
     MOCK_METHOD((internal::Fetch::FetchResult),
                 request,
-                (internal::HttpMethod method, std::string_view url, const rapidjson::Document& body),
+                (internal::HttpMethod method, std::string_view url, const internal::Json& body),
                 (override));
     MOCK_METHOD((internal::Fetch::FetchResult),
                 request,
                 (internal::HttpMethod method, std::string_view url, std::string_view mimeType, const std::vector<std::uint8_t>& body),
                 (override));
+    MOCK_METHOD((internal::Fetch::FetchResult),
+                stream,
+                (std::string_view url, CancellationToken token, const internal::HttpClientBase::StreamCallback& onData),
+                (override));
   };
 } // namespace octane::test
 
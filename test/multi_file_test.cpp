@@ -2,7 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+
+#include "include/error_code.h"
 
 namespace octane::internal {
   namespace {
@@ -12,6 +17,20 @@ namespace octane::internal {
       std::copy(str.begin(), str.end(), std::back_inserter(vec));
       return vec;
     }
+    std::filesystem::path writeArchive(const std::vector<FileInfo>& files) {
+      auto data = MultiFileCompressor::compress(files);
+      EXPECT_TRUE(data) << data.err();
+      const auto path = std::filesystem::temp_directory_path()
+                      / "octane_api_client_multi_file_test.tar";
+      std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(data.get().data()),
+               data.get().size());
+      return path;
+    }
+    std::string readFile(const std::filesystem::path& path) {
+      std::ifstream stream(path, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(stream), {});
+    }
   } // namespace
   TEST(MultiFileCompressorTest, MultiFile) {
     auto data = MultiFileCompressor::compress({
@@ -35,4 +54,137 @@ namespace octane::internal {
     EXPECT_EQ(files.get()[0].filename, "hello.txt");
     EXPECT_EQ(files.get()[0].data, toBinary("Hello World"));
   }
-} // namespace octane::internal
\ No newline at end of file
+  /**
+   * @brief ブロックより大きなファイルも欠けずにメモリ上へ書き出せるかをテストする。
+   *
+   */
+  TEST(MultiFileCompressorTest, LargeFile) {
+    std::vector<std::uint8_t> large(100000);
+    for (std::size_t i = 0; i < large.size(); ++i) {
+      large[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    auto data = MultiFileCompressor::compress({
+      FileInfo{
+        .filename = "large.bin",
+        .data     = large,
+      },
+      FileInfo{
+        .filename = "empty.txt",
+        .data     = {},
+      },
+    });
+    ASSERT_TRUE(data) << data.err();
+    // tarは512バイトのブロック単位で書き出される。
+    EXPECT_EQ(data.get().size() % 512, 0u);
+    auto files = MultiFileDecompressor::decompress(data.get());
+    ASSERT_TRUE(files) << files.err();
+    ASSERT_EQ(files.get().size(), 2);
+    EXPECT_EQ(files.get()[0].data, large);
+    EXPECT_TRUE(files.get()[1].data.empty());
+  }
+  /**
+   * @brief どのコーデックで圧縮しても、コーデックを指定せずに展開できるかをテストする。
+   *
+   */
+  TEST(MultiFileCompressorTest, Codecs) {
+    const std::vector<FileInfo> input{
+      FileInfo{ .filename = "hello.txt", .data = toBinary("Hello World") },
+      FileInfo{ .filename = "aaa/bbb.txt", .data = toBinary("yahoo!") },
+    };
+    for (const auto codec : { CompressionCodec::None,
+                              CompressionCodec::Gzip,
+                              CompressionCodec::Xz,
+                              CompressionCodec::Zstd }) {
+      for (const int level : { DEFAULT_COMPRESSION_LEVEL, 1 }) {
+        auto data = MultiFileCompressor::compress(
+          input, { .codec = codec, .level = level });
+        if (!data && codec == CompressionCodec::Zstd) {
+          // libzstdなしでビルドされたlibarchiveでは使えない。
+          EXPECT_EQ(data.err().code, ERR_COMPRESSION_FAILED);
+          continue;
+        }
+        ASSERT_TRUE(data) << MultiFileCompressor::mime(codec) << data.err();
+        auto files = MultiFileDecompressor::decompress(data.get());
+        ASSERT_TRUE(files) << MultiFileCompressor::mime(codec) << files.err();
+        ASSERT_EQ(files.get().size(), 2);
+        EXPECT_EQ(files.get()[0].filename, "hello.txt");
+        EXPECT_EQ(files.get()[0].data, toBinary("Hello World"));
+        EXPECT_EQ(files.get()[1].data, toBinary("yahoo!"));
+      }
+    }
+  }
+  /**
+   * @brief 繰り返しの多いデータを圧縮すると小さくなるかをテストする。
+   *
+   */
+  TEST(MultiFileCompressorTest, CompressesRepetitiveData) {
+    std::string text;
+    while (text.size() < 100000) {
+      text += "The quick brown fox jumps over the lazy dog.\n";
+    }
+    const std::vector<FileInfo> input{
+      FileInfo{ .filename = "fox.txt", .data = toBinary(text) },
+    };
+    const auto plain = MultiFileCompressor::compress(input);
+    ASSERT_TRUE(plain) << plain.err();
+    for (const auto codec : { CompressionCodec::Gzip, CompressionCodec::Xz }) {
+      const auto data = MultiFileCompressor::compress(input, { .codec = codec });
+      ASSERT_TRUE(data) << data.err();
+      EXPECT_LT(data.get().size() * 10, plain.get().size())
+        << MultiFileCompressor::mime(codec);
+    }
+  }
+  /**
+   * @brief 範囲外のレベルを指定すると失敗するかをテストする。
+   *
+   */
+  TEST(MultiFileCompressorTest, InvalidLevel) {
+    const auto data = MultiFileCompressor::compress(
+      { FileInfo{ .filename = "hello.txt", .data = toBinary("Hello World") } },
+      { .codec = CompressionCodec::Gzip, .level = 100 });
+    ASSERT_FALSE(data);
+    EXPECT_EQ(data.err().code, ERR_COMPRESSION_FAILED);
+  }
+  /**
+   * @brief アーカイブのファイルをディレクトリに書き出せるかをテストする。
+   *
+   */
+  TEST(MultiFileDecompressorTest, Extract) {
+    const auto archive   = writeArchive({
+      FileInfo{ .filename = "hello.txt", .data = toBinary("Hello World") },
+      FileInfo{ .filename = "aaa/bbb.txt", .data = toBinary("yahoo!") },
+    });
+    const auto directory = std::filesystem::temp_directory_path()
+                         / "octane_api_client_extract_test";
+    std::filesystem::remove_all(directory);
+
+    auto result = MultiFileDecompressor::extract(archive, directory);
+    ASSERT_TRUE(result) << result.err();
+    EXPECT_EQ(readFile(directory / "hello.txt"), "Hello World");
+    EXPECT_EQ(readFile(directory / "aaa" / "bbb.txt"), "yahoo!");
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove(archive);
+  }
+  /**
+   * @brief ディレクトリの外を指すエントリを拒否するかをテストする。
+   *
+   */
+  TEST(MultiFileDecompressorTest, ExtractRefusesEscapingEntries) {
+    const auto directory = std::filesystem::temp_directory_path()
+                         / "octane_api_client_extract_test";
+    for (const auto name : { "../escaped.txt", "aaa/../../escaped.txt" }) {
+      std::filesystem::remove_all(directory);
+      const auto archive = writeArchive({
+        FileInfo{ .filename = name, .data = toBinary("escaped") },
+      });
+      auto result = MultiFileDecompressor::extract(archive, directory);
+      ASSERT_FALSE(result) << name;
+      EXPECT_EQ(result.err().code, ERR_DECOMPRESSION_FAILED);
+      EXPECT_FALSE(std::filesystem::exists(
+        std::filesystem::temp_directory_path() / "escaped.txt"));
+      std::filesystem::remove(archive);
+    }
+    std::filesystem::remove_all(directory);
+  }
+} // namespace octane::internal
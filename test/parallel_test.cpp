@@ -0,0 +1,55 @@
+#include "include/internal/parallel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace octane::internal {
+  /**
+   * @brief 全てのインデックスがちょうど一度ずつ処理されるかをテストする。
+   *
+   */
+  TEST(ParallelTest, VisitsEveryIndexOnce) {
+    constexpr std::size_t count = 1000;
+    std::vector<std::atomic<int>> visited(count);
+    parallelFor(count, 8, [&](std::size_t i) {
+      visited[i].fetch_add(1);
+    });
+    for (std::size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(visited[i].load(), 1) << i;
+    }
+  }
+  /**
+   * @brief 同時に実行される数が指定した並行数を超えないかをテストする。
+   *
+   */
+  TEST(ParallelTest, ConcurrencyIsBounded) {
+    std::atomic<int> running = 0;
+    std::atomic<int> peak    = 0;
+    parallelFor(64, 4, [&](std::size_t) {
+      const auto now = running.fetch_add(1) + 1;
+      auto prev      = peak.load();
+      while (prev < now && !peak.compare_exchange_weak(prev, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      running.fetch_sub(1);
+    });
+    EXPECT_LE(peak.load(), 4);
+    EXPECT_GE(peak.load(), 1);
+  }
+  /**
+   * @brief 要素数が0のときや並行数が0のときに正しく動作するかをテストする。
+   *
+   */
+  TEST(ParallelTest, EdgeCases) {
+    int calls = 0;
+    parallelFor(0, 8, [&](std::size_t) { ++calls; });
+    EXPECT_EQ(calls, 0);
+    // 並行数0は1として扱われるので、同期しなくてもよい。
+    parallelFor(5, 0, [&](std::size_t) { ++calls; });
+    EXPECT_EQ(calls, 5);
+  }
+} // namespace octane::internal
@@ -0,0 +1,175 @@
+#include "include/internal/room_status_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "include/api_client.h"
+#include "./mock/fake_http_client.h"
+
+namespace octane::internal {
+  namespace {
+    using namespace std::chrono_literals;
+
+    RoomStatus makeStatus(std::uint64_t id, std::string name) {
+      RoomStatus status;
+      status.id   = id;
+      status.name = std::move(name);
+      return status;
+    }
+    Task<Result<RoomStatus, ErrorResponse>> slowFetch(Executor& executor,
+                                                      std::atomic<int>& calls) {
+      co_await ScheduleOn{ executor };
+      ++calls;
+      std::this_thread::sleep_for(50ms);
+      co_return ok(makeStatus(1, "slow"));
+    }
+  } // namespace
+
+  /**
+   * @brief ttlの間は覚えたステータスを返し、過ぎたら取得し直すかをテストする。
+   *
+   */
+  TEST(RoomStatusCacheTest, ExpiresAfterTtl) {
+    RoomStatusCache cache(50ms, 4);
+    int calls        = 0;
+    const auto fetch = [&]() -> Result<RoomStatus, ErrorResponse> {
+      ++calls;
+      return ok(makeStatus(1, "room " + std::to_string(calls)));
+    };
+
+    EXPECT_EQ(cache.get(1, fetch).get().name, "room 1");
+    EXPECT_EQ(cache.get(1, fetch).get().name, "room 1");
+    EXPECT_EQ(calls, 1);
+
+    std::this_thread::sleep_for(60ms);
+    EXPECT_EQ(cache.get(1, fetch).get().name, "room 2");
+    EXPECT_EQ(calls, 2);
+
+    // 失敗した結果は覚えない。
+    const auto failing = [&]() -> Result<RoomStatus, ErrorResponse> {
+      ++calls;
+      return makeError("ERR_TEST", "");
+    };
+    EXPECT_FALSE(cache.get(2, failing));
+    EXPECT_FALSE(cache.get(2, failing));
+    EXPECT_EQ(calls, 4);
+  }
+  /**
+   * @brief 覚えていないidを同時に引いたときに、取得が一度にまとめられるかをテストする。
+   *
+   */
+  TEST(RoomStatusCacheTest, CoalescesConcurrentMisses) {
+    RoomStatusCache cache(1min, 4);
+    std::atomic<int> calls = 0;
+    const auto fetch       = [&]() -> Result<RoomStatus, ErrorResponse> {
+      ++calls;
+      std::this_thread::sleep_for(50ms);
+      return ok(makeStatus(1, "shared"));
+    };
+
+    std::vector<std::thread> threads;
+    std::atomic<int> succeeded = 0;
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([&] {
+        auto result = cache.get(1, fetch);
+        if (result && result.get().name == "shared") ++succeeded;
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(succeeded.load(), 8);
+  }
+  /**
+   * @brief 非同期版でも、同時に引いたときに取得が一度にまとめられるかをテストする。
+   *
+   */
+  TEST(RoomStatusCacheTest, CoalescesConcurrentMissesAsync) {
+    ThreadPoolExecutor pool(4);
+    RoomStatusCache cache(1min, 4);
+    std::atomic<int> calls = 0;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    int remaining = 8;
+    int succeeded = 0;
+    for (int i = 0; i < 8; ++i) {
+      spawn(cache.getAsync(1, pool, {}, [&] { return slowFetch(pool, calls); }),
+            [&](Result<RoomStatus, ErrorResponse>&& result) {
+              std::lock_guard lock(mutex);
+              if (result && result.get().name == "slow") ++succeeded;
+              --remaining;
+              finished.notify_one();
+            });
+    }
+    std::unique_lock lock(mutex);
+    finished.wait(lock, [&] { return remaining == 0; });
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(succeeded, 8);
+  }
+  /**
+   * @brief 取得中に無効化されたときに、その結果を覚えないかをテストする。
+   *
+   */
+  TEST(RoomStatusCacheTest, InvalidateDuringFetch) {
+    RoomStatusCache cache(1min, 1);
+    int calls = 0;
+    auto stale
+      = cache.get(1, [&]() -> Result<RoomStatus, ErrorResponse> {
+          ++calls;
+          // 取得している間に、このクライアントがルームを変更したとする。
+          cache.invalidate(1);
+          return ok(makeStatus(1, "stale"));
+        });
+    EXPECT_EQ(stale.get().name, "stale");
+
+    const auto fetch = [&]() -> Result<RoomStatus, ErrorResponse> {
+      ++calls;
+      return ok(makeStatus(1, "fresh"));
+    };
+    EXPECT_EQ(cache.get(1, fetch).get().name, "fresh");
+    EXPECT_EQ(cache.get(1, fetch).get().name, "fresh");
+    EXPECT_EQ(calls, 2);
+  }
+} // namespace octane::internal
+
+namespace octane {
+  /**
+   * @brief ApiClientがステータスを覚え、自身の接続・切断・削除で忘れるかをテストする。
+   *
+   */
+  TEST(ApiClientRoomStatusCacheTest, InvalidatedByOwnWrites) {
+    test::FakeHttpClient transport("/api/v1");
+    ApiClient client("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(client.init());
+    client.enableRoomStatusCache({ .ttl = std::chrono::minutes(1) });
+
+    for (int i = 0; i < 3; ++i) {
+      auto status = i == 1 ? syncWait(client.getRoomStatusAsync(1))
+                           : client.getRoomStatus(1);
+      ASSERT_TRUE(status) << status.err().reason;
+      EXPECT_EQ(status.get().name, "room 1");
+    }
+    EXPECT_EQ(transport.roomRequests.load(), 1u);
+
+    ASSERT_TRUE(client.connectRoom(1, "device-1"));
+    EXPECT_TRUE(client.getRoomStatus());
+    EXPECT_EQ(transport.roomRequests.load(), 2u);
+    ASSERT_TRUE(syncWait(client.disconnectRoomAsync(1, "device-1")));
+    EXPECT_TRUE(client.getRoomStatus(1));
+    EXPECT_EQ(transport.roomRequests.load(), 3u);
+    ASSERT_TRUE(client.deleteRoom(1));
+    EXPECT_TRUE(client.getRoomStatus(1));
+    EXPECT_EQ(transport.roomRequests.load(), 4u);
+
+    client.disableRoomStatusCache();
+    EXPECT_TRUE(client.getRoomStatus(1));
+    EXPECT_EQ(transport.roomRequests.load(), 5u);
+  }
+} // namespace octane
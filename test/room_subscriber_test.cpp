@@ -0,0 +1,313 @@
+#include "include/internal/room_subscriber.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "include/api_client.h"
+#include "include/error_code.h"
+#include "./mock/fake_http_client.h"
+
+using namespace std::chrono_literals;
+
+namespace octane::internal {
+  namespace {
+    SubscribeOptions fastOptions() {
+      SubscribeOptions options;
+      options.pollInterval         = 1ms;
+      options.reconnectInterval    = 2ms;
+      options.maxReconnectInterval = 8ms;
+      return options;
+    }
+
+    /**
+     * @brief conditionがtrueになるか、limitを過ぎるまで待つ。
+     *
+     */
+    template <typename F>
+    bool waitUntil(F&& condition, std::chrono::milliseconds limit = 5s) {
+      const auto end = std::chrono::steady_clock::now() + limit;
+      while (!condition()) {
+        if (std::chrono::steady_clock::now() >= end) return false;
+        std::this_thread::sleep_for(1ms);
+      }
+      return true;
+    }
+
+    ContentStatus contentStatus(std::uint64_t timestamp) {
+      return ContentStatus{
+        .device    = "fake",
+        .timestamp = timestamp,
+        .type      = ContentType::Clipboard,
+        .name      = std::nullopt,
+        .mime      = "text/plain",
+      };
+    }
+
+    /**
+     * @brief 状態を変更できる偽のルーム。
+     * @details
+     * streamingがtrueの間は、pushしたイベントをストリームで届ける。
+     */
+    struct FakeRoom {
+      std::mutex mutex;
+      std::string hash = "a";
+      std::uint64_t timestamp = 0;
+      std::vector<std::string> devices{ "device-1" };
+      std::vector<RoomEvent> queued;
+      std::atomic<bool> streaming = false;
+      std::atomic<int> polls      = 0;
+      std::atomic<int> connects   = 0;
+
+      RoomSubscriber::Stream stream() {
+        return [this](CancellationToken token,
+                      const RoomSubscriber::EventSink& sink)
+                 -> Result<_, ErrorResponse> {
+          ++connects;
+          if (!streaming) {
+            return makeError(ERR_EVENT_STREAM_UNAVAILABLE, "");
+          }
+          while (!token.isCancelled() && streaming) {
+            std::vector<RoomEvent> events;
+            {
+              std::lock_guard lock(mutex);
+              events.swap(queued);
+            }
+            for (auto& event : events) sink(std::move(event));
+            std::this_thread::sleep_for(1ms);
+          }
+          return ok();
+        };
+      }
+      RoomSubscriber::Poll poll() {
+        return [this]() -> Result<RoomSnapshot, ErrorResponse> {
+          ++polls;
+          std::lock_guard lock(mutex);
+          std::vector<Device> connected;
+          for (const auto& name : devices) {
+            connected.push_back(Device{ .name = name, .timestamp = 0 });
+          }
+          return ok(RoomSnapshot{
+            .roomId  = 1,
+            .content = std::make_pair(contentStatus(timestamp), hash),
+            .devices = std::move(connected),
+          });
+        };
+      }
+      void change(std::string next) {
+        std::lock_guard lock(mutex);
+        hash = std::move(next);
+        ++timestamp;
+      }
+      /**
+       * @brief 状態を変更し、同じ変化をストリームにも流す。
+       *
+       */
+      void push(std::string next) {
+        std::lock_guard lock(mutex);
+        hash = std::move(next);
+        ++timestamp;
+        queued.push_back(RoomEvent{
+          .type          = RoomEventType::ContentChanged,
+          .roomId        = 1,
+          .contentStatus = contentStatus(timestamp),
+          .hash          = hash,
+          .device        = std::nullopt,
+        });
+      }
+    };
+
+    /**
+     * @brief 受け取ったイベントを記録する。
+     *
+     */
+    struct Recorder {
+      std::mutex mutex;
+      std::vector<RoomEvent> events;
+      std::atomic<int> errors = 0;
+
+      RoomSubscriber::Callback callback() {
+        return [this](Result<RoomEvent, ErrorResponse> event) {
+          if (!event) {
+            ++errors;
+            return;
+          }
+          std::lock_guard lock(mutex);
+          events.push_back(std::move(event.get()));
+        };
+      }
+      std::size_t size() {
+        std::lock_guard lock(mutex);
+        return events.size();
+      }
+    };
+  } // namespace
+
+  /**
+   * @brief ストリームが使えないとき、ポーリングの差分をイベントとして通知するかをテストする。
+   *
+   */
+  TEST(RoomSubscriberTest, FallsBackToPolling) {
+    FakeRoom room;
+    Recorder recorder;
+    RoomSubscriber subscriber(
+      room.stream(), room.poll(), recorder.callback(), fastOptions());
+    ASSERT_TRUE(waitUntil([&] { return room.polls.load() >= 5; }));
+    EXPECT_EQ(recorder.size(), 0u);
+
+    room.change("b");
+    {
+      std::lock_guard lock(room.mutex);
+      room.devices = { "device-2" };
+    }
+    ASSERT_TRUE(waitUntil([&] { return recorder.size() == 3; }));
+    const auto polls = room.polls.load();
+    ASSERT_TRUE(waitUntil([&] { return room.polls.load() >= polls + 5; }));
+    subscriber.stop();
+
+    ASSERT_EQ(recorder.events.size(), 3u);
+    EXPECT_EQ(recorder.events[0].type, RoomEventType::ContentChanged);
+    EXPECT_EQ(recorder.events[0].hash, "b");
+    EXPECT_EQ(recorder.events[1].type, RoomEventType::DeviceJoined);
+    EXPECT_EQ(recorder.events[1].device->name, "device-2");
+    EXPECT_EQ(recorder.events[2].type, RoomEventType::DeviceLeft);
+    EXPECT_EQ(recorder.events[2].device->name, "device-1");
+    // ストリームにも接続し直し続けている。
+    EXPECT_GE(room.connects.load(), 2);
+  }
+  /**
+   * @brief ストリームとポーリングの両方で知った変化を一度だけ通知するかをテストする。
+   *
+   */
+  TEST(RoomSubscriberTest, StreamedEventsAreNotRepeated) {
+    FakeRoom room;
+    room.streaming = true;
+    Recorder recorder;
+    RoomSubscriber subscriber(
+      room.stream(), room.poll(), recorder.callback(), fastOptions());
+    ASSERT_TRUE(waitUntil([&] { return room.connects.load() == 1; }));
+
+    room.push("b");
+    ASSERT_TRUE(waitUntil([&] { return recorder.size() == 1; }));
+    // 切断されてポーリングに切り替わっても、同じ変化は通知しない。
+    room.streaming = false;
+    const auto polls = room.polls.load();
+    ASSERT_TRUE(waitUntil([&] { return room.polls.load() >= polls + 5; }));
+    EXPECT_EQ(recorder.size(), 1u);
+
+    // 切断されている間の変化はポーリングで通知する。
+    room.change("c");
+    ASSERT_TRUE(waitUntil([&] { return recorder.size() == 2; }));
+    subscriber.stop();
+    EXPECT_EQ(recorder.events[1].hash, "c");
+    EXPECT_EQ(recorder.errors.load(), 0);
+  }
+  /**
+   * @brief 接続中のストリームをstopで中断できるかをテストする。
+   *
+   */
+  TEST(RoomSubscriberTest, StopCancelsStream) {
+    FakeRoom room;
+    room.streaming = true;
+    Recorder recorder;
+    RoomSubscriber subscriber(
+      room.stream(), room.poll(), recorder.callback(), fastOptions());
+    ASSERT_TRUE(waitUntil([&] { return room.connects.load() == 1; }));
+    subscriber.stop();
+    EXPECT_EQ(room.connects.load(), 1);
+  }
+} // namespace octane::internal
+
+namespace octane {
+  /**
+   * @brief サーバがイベントストリームを提供しない場合、ApiClient::subscribeRoomがポーリングで変化を通知するかをテストする。
+   *
+   */
+  TEST(ApiClientSubscribeRoomTest, PollsWithoutEventStream) {
+    test::FakeHttpClient transport("/api/v1");
+    ApiClient client("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, "device-1"));
+
+    std::atomic<int> changed = 0;
+    SubscribeOptions options;
+    options.pollInterval      = 1ms;
+    options.reconnectInterval = 1ms;
+    auto subscription         = client.subscribeRoom(
+      [&](Result<RoomEvent, ErrorResponse> event) {
+        ASSERT_TRUE(event);
+        EXPECT_EQ(event.get().type, RoomEventType::ContentChanged);
+        EXPECT_EQ(event.get().roomId, 1u);
+        ++changed;
+      },
+      options);
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return transport.statusRequests.load() >= 5; }));
+    EXPECT_EQ(changed.load(), 0);
+
+    ++transport.timestamp;
+    ASSERT_TRUE(internal::waitUntil([&] { return changed.load() == 1; }));
+    subscription.stop();
+    EXPECT_FALSE(subscription.isActive());
+  }
+  /**
+   * @brief ApiClient::subscribeRoomがイベントストリームとポーリングの両方で知った変化を一度だけ通知するかをテストする。
+   * @details
+   * FakeHttpClientはストリームを一度に返して閉じるので、接続し直すたびに同じイベントが届く。
+   */
+  TEST(ApiClientSubscribeRoomTest, DeliversStreamedEventOnce) {
+    test::FakeHttpClient transport("/api/v1");
+    ApiClient client("token", "http://localhost", "/api/v1", &transport);
+    ASSERT_TRUE(client.init());
+    ASSERT_TRUE(client.connectRoom(1, "device-1"));
+
+    std::mutex mutex;
+    std::vector<RoomEvent> events;
+    SubscribeOptions options;
+    options.pollInterval         = 1ms;
+    options.reconnectInterval    = 1ms;
+    options.maxReconnectInterval = 1ms;
+    auto subscription            = client.subscribeRoom(
+      [&](Result<RoomEvent, ErrorResponse> event) {
+        ASSERT_TRUE(event) << event.err().reason;
+        std::lock_guard lock(mutex);
+        events.push_back(std::move(event.get()));
+      },
+      options);
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return transport.statusRequests.load() >= 5; }));
+
+    const std::string_view content = test::FakeHttpClient::CONTENT;
+    const auto hash = internal::generateHash(
+      std::vector<std::uint8_t>(content.begin(), content.end()));
+    transport.timestamp = 1;
+    transport.setEventStream(
+      ": keep-alive\n\n"
+      "event: content\n"
+      "data: {\"device\": \"fake\", \"timestamp\": 1, \"type\": \"clipboard\",\n"
+      "data: \"mime\": \"text/plain\", \"hash\": \""
+      + hash
+      + "\"}\n"
+        "\n"
+        "event: unknown\n"
+        "data: {}\n"
+        "\n");
+    ASSERT_TRUE(internal::waitUntil([&] {
+      std::lock_guard lock(mutex);
+      return !events.empty();
+    }));
+    const auto requests = transport.requests.load();
+    ASSERT_TRUE(internal::waitUntil(
+      [&] { return transport.requests.load() >= requests + 20; }));
+    subscription.stop();
+
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, RoomEventType::ContentChanged);
+    EXPECT_EQ(events[0].contentStatus->timestamp, 1u);
+    EXPECT_EQ(events[0].hash, hash);
+  }
+} // namespace octane
@@ -0,0 +1,77 @@
+#include "include/internal/schema_registry.h"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+#include "include/error_code.h"
+
+namespace octane::internal {
+  namespace {
+    Json makeJson(std::string_view data) {
+      auto json = parseJson(data);
+      if (!json) {
+        std::abort();
+      }
+      return std::move(json.get());
+    }
+  } // namespace
+  /**
+   * @brief スキーマに適合するJSONを検証したときに成功するかどうかをテストする。
+   *
+   */
+  TEST(SchemaRegistryTest, ValidateOk) {
+    auto json = makeJson(R"({"health": "healthy", "message": ""})");
+    auto err  = SchemaRegistry::instance().validate(json, SchemaId::HealthGet);
+    EXPECT_FALSE(err) << err.value();
+  }
+  /**
+   * @brief スキーマに適合しないJSONを検証したときにエラーを返すかどうかをテストする。
+   *
+   */
+  TEST(SchemaRegistryTest, ValidateErr) {
+    auto json = makeJson(R"({"healthiest": "healthy"})");
+    auto err  = SchemaRegistry::instance().validate(json, SchemaId::HealthGet);
+    ASSERT_TRUE(err);
+    EXPECT_EQ(err.value().code, ERR_INVALID_RESPONSE) << err.value();
+  }
+  /**
+   * @brief
+   * 検証に失敗したバリデータがプールに戻された後も、次の検証に影響しないかどうかをテストする。
+   *
+   */
+  TEST(SchemaRegistryTest, PooledValidatorIsReset) {
+    auto invalid = makeJson(R"({"ideco": 7040782538})");
+    auto valid   = makeJson(R"({"id": 7040782538})");
+    auto& registry = SchemaRegistry::instance();
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(registry.validate(invalid, SchemaId::RoomPost));
+      EXPECT_FALSE(registry.validate(valid, SchemaId::RoomPost));
+    }
+  }
+  /**
+   * @brief 各モードで検証を行うかどうかが正しく決まるかをテストする。
+   *
+   */
+  TEST(SchemaValidationPolicyTest, Modes) {
+    SchemaValidationPolicy policy;
+    EXPECT_TRUE(policy.shouldValidate());
+
+    policy.set(ValidationMode::Off, 1);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_FALSE(policy.shouldValidate());
+    }
+
+    policy.set(ValidationMode::Sampled, 4);
+    int validated = 0;
+    for (int i = 0; i < 16; ++i) {
+      if (policy.shouldValidate()) ++validated;
+    }
+    EXPECT_EQ(validated, 4);
+
+    policy.set(ValidationMode::Full, 4);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_TRUE(policy.shouldValidate());
+    }
+  }
+} // namespace octane::internal
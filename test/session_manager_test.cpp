@@ -0,0 +1,209 @@
+#include "include/session_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/error_code.h"
+#include "./mock/fake_http_client.h"
+
+namespace octane {
+  namespace {
+    constexpr auto BASE_URL = "/api/v1";
+
+    std::string deviceName(std::uint64_t id) {
+      return "device-" + std::to_string(id);
+    }
+  } // namespace
+
+  /**
+   * @brief 複数のルームに接続し、ルームごとに操作・切断できるかをテストする。
+   *
+   */
+  TEST(SessionManagerTest, ConnectsToManyRooms) {
+    test::FakeHttpClient transport(BASE_URL);
+    SessionManager manager("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(manager.init());
+
+    for (std::uint64_t id : { 3, 1, 2 }) {
+      ASSERT_TRUE(manager.connect(id, deviceName(id)));
+    }
+    EXPECT_EQ(manager.rooms(), (std::vector<std::uint64_t>{ 1, 2, 3 }));
+
+    auto status = manager.getRoomStatus(2);
+    ASSERT_TRUE(status) << status.err().reason;
+    EXPECT_EQ(status.get().name, "room 2");
+    auto content = manager.getContent(3);
+    ASSERT_TRUE(content) << content.err().reason;
+    EXPECT_EQ(std::get<std::string>(content.get().data),
+              test::FakeHttpClient::CONTENT);
+    const auto asyncContent = syncWait(manager.getContentAsync(1));
+    ASSERT_TRUE(asyncContent) << asyncContent.err().reason;
+
+    ASSERT_TRUE(manager.disconnect(2));
+    EXPECT_FALSE(manager.isConnected(2));
+    EXPECT_TRUE(manager.isConnected(1));
+    EXPECT_EQ(manager.rooms(), (std::vector<std::uint64_t>{ 1, 3 }));
+
+    // 接続していないルームのコンテンツは操作できないが、状態は取得できる。
+    const auto disconnected = manager.getContent(2);
+    ASSERT_FALSE(disconnected);
+    EXPECT_EQ(disconnected.err().code, ERR_ROOM_DISCONNECTED);
+    EXPECT_FALSE(manager.deleteContent(2));
+    EXPECT_FALSE(manager.disconnect(2));
+    EXPECT_TRUE(syncWait(manager.getRoomStatusAsync(2)));
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief 破棄するときに、接続している全てのルームから切断するかをテストする。
+   *
+   */
+  TEST(SessionManagerTest, DisconnectsOnDestruction) {
+    test::FakeHttpClient transport(BASE_URL);
+    std::size_t before = 0;
+    {
+      SessionManager manager(
+        "token", "http://localhost", BASE_URL, &transport, { .shards = 2 });
+      ASSERT_TRUE(manager.init());
+      for (std::uint64_t id = 1; id <= 8; ++id) {
+        ASSERT_TRUE(manager.connect(id, deviceName(id)));
+      }
+      ASSERT_TRUE(manager.disconnect(4));
+      before = transport.requests.load();
+    }
+    // 残っている7つのルームから切断する。ヘルスチェックは行わない。
+    EXPECT_EQ(transport.requests.load() - before, 7u);
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief shutdownAsyncが全てのルームから並行に切断し、以降の非同期の操作を中断するかをテストする。
+   *
+   */
+  TEST(SessionManagerTest, Shutdown) {
+    test::FakeHttpClient transport(BASE_URL);
+    std::size_t before = 0;
+    {
+      SessionManager manager("token", "http://localhost", BASE_URL, &transport);
+      ASSERT_TRUE(manager.init());
+      for (std::uint64_t id = 1; id <= 8; ++id) {
+        ASSERT_TRUE(manager.connect(id, deviceName(id)));
+      }
+
+      before = transport.requests.load();
+      EXPECT_TRUE(syncWait(manager.shutdownAsync(
+        std::chrono::steady_clock::now() + std::chrono::seconds(5))));
+      EXPECT_EQ(transport.requests.load() - before, 8u);
+      EXPECT_TRUE(manager.rooms().empty());
+
+      auto result = syncWait(manager.getRoomStatusAsync(1));
+      ASSERT_FALSE(result);
+      EXPECT_EQ(result.err().code, ERR_CANCELLED);
+      before = transport.requests.load();
+    }
+    // シャットダウンした後の破棄では通信しない。
+    EXPECT_EQ(transport.requests.load(), before);
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief 実行中のshutdownAsyncが完了するまで、デストラクタが待つかをテストする。
+   *
+   */
+  TEST(SessionManagerTest, DestroyedDuringShutdown) {
+    test::FakeHttpClient transport(BASE_URL, std::chrono::milliseconds(50));
+    // 完了はテストの後になりうるので、結果の受け渡し先は共有する。
+    auto succeeded = std::make_shared<std::promise<bool>>();
+    auto finished  = succeeded->get_future();
+    std::thread shutdown;
+    {
+      SessionManager manager("token", "http://localhost", BASE_URL, &transport);
+      ASSERT_TRUE(manager.init());
+      for (std::uint64_t id : { 1, 2 }) {
+        ASSERT_TRUE(manager.connect(id, deviceName(id)));
+      }
+
+      const auto before = transport.requests.load();
+      shutdown          = std::thread([&] {
+        spawn(manager.shutdownAsync(std::chrono::steady_clock::now()
+                                    + std::chrono::seconds(5)),
+              [succeeded](Result<_, ErrorResponse> result) {
+                succeeded->set_value(static_cast<bool>(result));
+              });
+      });
+      // 切断のリクエストが始まってから破棄する。
+      while (transport.requests.load() == before) {
+        std::this_thread::yield();
+      }
+    }
+    shutdown.join();
+    EXPECT_TRUE(finished.get());
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief 接続のリクエスト中に終了処理が始まった場合、セッションを残さずに切断するかをテストする。
+   *
+   */
+  TEST(SessionManagerTest, ConnectRacingShutdown) {
+    test::FakeHttpClient transport(BASE_URL, std::chrono::milliseconds(50));
+    SessionManager manager("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(manager.init());
+
+    const auto before = transport.requests.load();
+    std::optional<Result<Response, ErrorResponse>> connected;
+    std::thread connect(
+      [&] { connected.emplace(manager.connect(1, deviceName(1))); });
+    // 接続のリクエストが始まってから終了処理を始める。
+    while (transport.requests.load() == before) {
+      std::this_thread::yield();
+    }
+    EXPECT_TRUE(syncWait(manager.shutdownAsync(
+      std::chrono::steady_clock::now() + std::chrono::seconds(5))));
+    connect.join();
+
+    ASSERT_FALSE(connected.value());
+    EXPECT_EQ(connected.value().err().code, ERR_CANCELLED);
+    EXPECT_FALSE(manager.isConnected(1));
+    EXPECT_EQ(transport.disconnections.load(), 1u);
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+  /**
+   * @brief 多数のスレッドが別々のルームを同時に操作しても、全て成功するかをテストする。
+   *
+   */
+  TEST(SessionManagerTest, ConcurrentRooms) {
+    constexpr std::uint64_t ROOMS = 32;
+    test::FakeHttpClient transport(BASE_URL);
+    SessionManager manager("token", "http://localhost", BASE_URL, &transport);
+    ASSERT_TRUE(manager.init());
+
+    std::atomic<std::size_t> failures = 0;
+    std::vector<std::thread> threads;
+    for (std::uint64_t id = 1; id <= ROOMS; ++id) {
+      threads.emplace_back([&, id] {
+        if (!manager.connect(id, deviceName(id))) ++failures;
+        for (int i = 0; i < 10; ++i) {
+          Content content;
+          content.contentStatus.device = deviceName(id);
+          content.contentStatus.type   = ContentType::Clipboard;
+          content.data                 = "data " + std::to_string(i);
+          if (!manager.uploadContent(id, content)) ++failures;
+          if (!manager.getContent(id)) ++failures;
+          if (!manager.getRoomStatus(id)) ++failures;
+        }
+        if (id % 2 == 0 && !manager.disconnect(id)) ++failures;
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_EQ(manager.rooms().size(), ROOMS / 2);
+    EXPECT_EQ(transport.mismatchedDevices.load(), 0u);
+  }
+} // namespace octane
@@ -0,0 +1,175 @@
+#include "include/internal/single_flight.h"
+
+#include <gtest/gtest.h>
+
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace octane::internal {
+  namespace {
+    /**
+     * @brief openされるまでコルーチンを中断する。
+     *
+     */
+    class Gate {
+      std::mutex mutex;
+      std::coroutine_handle<> waiter;
+      bool opened = false;
+
+    public:
+      struct Awaiter {
+        Gate& gate;
+
+        bool await_ready() const noexcept {
+          return false;
+        }
+        bool await_suspend(std::coroutine_handle<> handle) {
+          std::lock_guard lock(gate.mutex);
+          if (gate.opened) return false;
+          gate.waiter = handle;
+          return true;
+        }
+        void await_resume() const noexcept {}
+      };
+
+      Awaiter wait() {
+        return Awaiter{ *this };
+      }
+      void open() {
+        std::coroutine_handle<> handle;
+        {
+          std::lock_guard lock(mutex);
+          opened = true;
+          handle = std::exchange(waiter, {});
+        }
+        if (handle) handle.resume();
+      }
+    };
+
+    /**
+     * @brief gateが開くまで待ち、tokenがキャンセルされていれば-1を返す。
+     *
+     */
+    Task<int> waitGate(Gate& gate, CancellationToken token, int value) {
+      co_await gate.wait();
+      co_return token.isCancelled() ? -1 : value;
+    }
+    Task<int> immediate(int value) {
+      co_return value;
+    }
+  } // namespace
+
+  /**
+   * @brief 待っている側が、リーダの結果を受け取るかをテストする。
+   *
+   */
+  TEST(SingleFlightTest, FollowerSharesResult) {
+    SingleFlight<int, int> flights;
+    Gate gate;
+    int calls = 0;
+    std::optional<int> leader, follower;
+    spawn(flights.runAsync(1,
+                           inlineExecutor(),
+                           {},
+                           [&] {
+                             ++calls;
+                             return waitGate(gate, {}, 10);
+                           }),
+          [&](int value) { leader = value; });
+    spawn(flights.runAsync(1,
+                           inlineExecutor(),
+                           {},
+                           [&] {
+                             ++calls;
+                             return immediate(20);
+                           }),
+          [&](int value) { follower = value; });
+    EXPECT_FALSE(follower.has_value());
+
+    gate.open();
+    EXPECT_EQ(leader, 10);
+    EXPECT_EQ(follower, 10);
+    EXPECT_EQ(calls, 1);
+  }
+  /**
+   * @brief リーダがキャンセルされても、待っている側は自ら処理をやり直すかをテストする。
+   *
+   */
+  TEST(SingleFlightTest, FollowerRetriesOnLeaderCancellation) {
+    SingleFlight<int, int> flights;
+    Gate gate;
+    CancellationSource source;
+    std::optional<int> leader, follower, cancelledFollower;
+    spawn(flights.runAsync(1,
+                           inlineExecutor(),
+                           source.token(),
+                           [&] { return waitGate(gate, source.token(), 10); }),
+          [&](int value) { leader = value; });
+    spawn(flights.runAsync(
+            1, inlineExecutor(), {}, [&] { return immediate(20); }),
+          [&](int value) { follower = value; });
+    // 自身もキャンセルされていれば、やり直さずにリーダの結果を受け取る。
+    spawn(flights.runAsync(
+            1, inlineExecutor(), source.token(), [&] { return immediate(30); }),
+          [&](int value) { cancelledFollower = value; });
+
+    source.cancel();
+    gate.open();
+    EXPECT_EQ(leader, -1);
+    EXPECT_EQ(follower, 20);
+    EXPECT_EQ(cancelledFollower, -1);
+  }
+  /**
+   * @brief リーダのTaskが完了前に破棄されても、待っている側が取り残されないかをテストする。
+   *
+   */
+  TEST(SingleFlightTest, DestroyedLeaderReleasesFollowers) {
+    SingleFlight<int, int> flights;
+    Gate gate;
+    std::optional<int> follower;
+    {
+      auto leader = flights.runAsync(
+        1, inlineExecutor(), {}, [&] { return waitGate(gate, {}, 10); });
+      // 開始してgateで中断させる。
+      leader.await_suspend(std::noop_coroutine()).resume();
+      spawn(flights.runAsync(
+              1, inlineExecutor(), {}, [&] { return immediate(20); }),
+            [&](int value) { follower = value; });
+      EXPECT_FALSE(follower.has_value());
+    }
+    EXPECT_EQ(follower, 20);
+    // 処理は取り除かれているので、次の呼び出しは待たずに実行する。
+    EXPECT_EQ(flights.run(1, [] { return 30; }), 30);
+  }
+  /**
+   * @brief 処理が例外を投げても、以降の呼び出しが待ち続けないかをテストする。
+   *
+   */
+  TEST(SingleFlightTest, ThrowingLeaderReleasesKey) {
+    SingleFlight<int, int> flights;
+    EXPECT_THROW(
+      flights.run(1, []() -> int { throw std::runtime_error("failed"); }),
+      std::runtime_error);
+    EXPECT_EQ(flights.run(1, [] { return 10; }), 10);
+  }
+  /**
+   * @brief 同期の呼び出しが、非同期の処理に合流せずに自ら実行するかをテストする。
+   *
+   */
+  TEST(SingleFlightTest, RunDoesNotJoinAsyncFlight) {
+    SingleFlight<int, int> flights;
+    Gate gate;
+    std::optional<int> leader;
+    spawn(flights.runAsync(
+            1, inlineExecutor(), {}, [&] { return waitGate(gate, {}, 10); }),
+          [&](int value) { leader = value; });
+    // 合流すると、gateを開くこのスレッドが自身を待ってしまう。
+    EXPECT_EQ(flights.run(1, [] { return 20; }), 20);
+
+    gate.open();
+    EXPECT_EQ(leader, 10);
+  }
+} // namespace octane::internal
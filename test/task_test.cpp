@@ -0,0 +1,178 @@
+#include "include/task.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/cancellation.h"
+#include "include/executor.h"
+#include "include/internal/async.h"
+
+namespace octane {
+  namespace {
+    Task<int> value(int n) {
+      co_return n;
+    }
+    Task<int> add(int a, int b) {
+      const auto x = co_await value(a);
+      const auto y = co_await value(b);
+      co_return x + y;
+    }
+    /**
+     * @brief executorのスレッドに移ってから値を返す。
+     *
+     */
+    Task<std::thread::id> hop(Executor& executor) {
+      co_await internal::ScheduleOn{ executor };
+      co_return std::this_thread::get_id();
+    }
+  } // namespace
+
+  /**
+   * @brief awaitしたタスクの値が呼び出し元に返るかをテストする。
+   *
+   */
+  TEST(TaskTest, AwaitChain) {
+    EXPECT_EQ(syncWait(add(1, 2)), 3);
+  }
+  /**
+   * @brief タスクがawaitされるまで開始されないかをテストする。
+   *
+   */
+  TEST(TaskTest, IsLazy) {
+    bool started = false;
+    // ラムダ式のキャプチャはコルーチンが終わるまで生存しなければならない。
+    const auto f = [&]() -> Task<int> {
+      started = true;
+      co_return 1;
+    };
+    auto task = f();
+    EXPECT_FALSE(started);
+    EXPECT_EQ(syncWait(std::move(task)), 1);
+    EXPECT_TRUE(started);
+  }
+  /**
+   * @brief ScheduleOnでexecutorのスレッドに移るかをテストする。
+   *
+   */
+  TEST(TaskTest, ScheduleOnExecutor) {
+    ThreadPoolExecutor executor(1);
+    const auto id = syncWait(hop(executor));
+    EXPECT_NE(id, std::this_thread::get_id());
+  }
+  /**
+   * @brief whenAllが両方のタスクを並行に実行し、両方の値を返すかをテストする。
+   *
+   */
+  TEST(TaskTest, WhenAll) {
+    ThreadPoolExecutor executor(2);
+    std::atomic<int> arrived = 0;
+    // 両方のタスクが開始されていなければ、どちらも先に進めない。
+    const auto wait = [&](int n) -> Task<int> {
+      co_await internal::ScheduleOn{ executor };
+      ++arrived;
+      while (arrived.load() < 2) std::this_thread::yield();
+      co_return n;
+    };
+    const auto [a, b] = syncWait(whenAll(wait(1), wait(2)));
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 2);
+  }
+  /**
+   * @brief whenAllが全てのタスクを並行に実行し、値を同じ順序で返すかをテストする。
+   *
+   */
+  TEST(TaskTest, WhenAllVector) {
+    ThreadPoolExecutor executor(4);
+    std::atomic<int> arrived = 0;
+    // 全てのタスクが開始されていなければ、どれも先に進めない。
+    const auto wait = [&](int n) -> Task<int> {
+      co_await internal::ScheduleOn{ executor };
+      ++arrived;
+      while (arrived.load() < 4) std::this_thread::yield();
+      co_return n;
+    };
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 4; ++i) {
+      tasks.push_back(wait(i));
+    }
+    EXPECT_EQ(syncWait(whenAll(std::move(tasks))),
+              (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_TRUE(syncWait(whenAll(std::vector<Task<int>>())).empty());
+  }
+  /**
+   * @brief spawnしたタスクの値がコールバックに渡されるかをテストする。
+   *
+   */
+  TEST(TaskTest, Spawn) {
+    std::string result;
+    spawn(value(7), [&](int n) { result = std::to_string(n); });
+    EXPECT_EQ(result, "7");
+  }
+  /**
+   * @brief Pendingが開始したタスクの値を、別のスレッドで完了した後に受け取れるかをテストする。
+   *
+   */
+  TEST(TaskTest, Pending) {
+    ThreadPoolExecutor executor(1);
+    internal::Pending pending(hop(executor));
+    EXPECT_NE(pending.get(), std::this_thread::get_id());
+    EXPECT_EQ(internal::Pending<int>::ready(3).get(), 3);
+  }
+  /**
+   * @brief ThreadPoolExecutorが破棄される前に、積まれたタスクを全て実行するかをテストする。
+   *
+   */
+  TEST(TaskTest, ThreadPoolDrainsOnDestruction) {
+    std::atomic<int> count = 0;
+    {
+      ThreadPoolExecutor executor(2);
+      for (int i = 0; i < 100; ++i) {
+        executor.post([&] { ++count; });
+      }
+    }
+    EXPECT_EQ(count.load(), 100);
+  }
+  /**
+   * @brief CancellationSourceのキャンセルがトークンに伝わるかをテストする。
+   *
+   */
+  TEST(TaskTest, Cancellation) {
+    CancellationToken none;
+    EXPECT_FALSE(none.canBeCancelled());
+    EXPECT_FALSE(none.isCancelled());
+
+    CancellationSource source;
+    const auto token = source.token();
+    EXPECT_TRUE(token.canBeCancelled());
+    EXPECT_FALSE(token.isCancelled());
+    source.cancel();
+    EXPECT_TRUE(token.isCancelled());
+    EXPECT_TRUE(source.isCancelled());
+  }
+  /**
+   * @brief 期限を過ぎたトークンと、結び付けたトークンがキャンセルされるかをテストする。
+   *
+   */
+  TEST(TaskTest, CancellationDeadlineAndLink) {
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_TRUE(CancellationToken().withDeadline(now).isCancelled());
+    const auto later
+      = CancellationToken().withDeadline(now + std::chrono::hours(1));
+    EXPECT_TRUE(later.canBeCancelled());
+    EXPECT_FALSE(later.isCancelled());
+
+    CancellationSource a;
+    CancellationSource b;
+    const auto linked = a.token().linkedWith(b.token()).linkedWith(later);
+    EXPECT_FALSE(linked.isCancelled());
+    b.cancel();
+    EXPECT_TRUE(linked.isCancelled());
+    EXPECT_FALSE(a.token().isCancelled());
+    EXPECT_FALSE(CancellationToken().linkedWith({}).canBeCancelled());
+  }
+} // namespace octane